@@ -403,6 +403,37 @@ extern DECLSPEC SDL_AudioStatus SDLCALL
 SDL_GetAudioDeviceStatus(SDL_AudioDeviceID dev);
 /* @} *//* Audio State */
 
+/**
+ *  Where an output device's audio thread has spent its time since the
+ *  device was opened. Times are in SDL_GetPerformanceCounter() ticks.
+ */
+typedef struct SDL_AudioDeviceStats
+{
+    Uint64 callbacks;           /**< Number of times the callback has run (or the queue was read) */
+    Uint64 buffers;             /**< Number of buffers handed to the device */
+    Uint64 callback_ticks;      /**< Time spent in the callback (or reading the queue) */
+    Uint64 convert_ticks;       /**< Time spent converting format and channels */
+    Uint64 resample_ticks;      /**< Time spent resampling */
+    Uint64 play_ticks;          /**< Time spent handing buffers to the device */
+    Uint64 wait_ticks;          /**< Time spent waiting for the device to want more */
+    Uint64 max_callback_ticks;  /**< The longest single callback */
+    Uint64 max_iteration_ticks; /**< The longest trip around the audio thread's loop, not counting waiting */
+} SDL_AudioDeviceStats;
+
+/**
+ *  Get timing statistics for an opened output device's audio thread.
+ *
+ *  Together with the "disk" audio driver, which doesn't wait for anything
+ *  when SDL_DISKAUDIODELAY is 0, this lets you measure how fast the whole
+ *  audio path runs without a sound card.
+ *
+ *  \param dev The device to query
+ *  \param stats Filled in with the statistics
+ *  \return 0 on success, or -1 on error (such as a capture device).
+ */
+extern DECLSPEC int SDLCALL SDL_GetAudioDeviceStats(SDL_AudioDeviceID dev,
+                                                    SDL_AudioDeviceStats * stats);
+
 /**
  *  \name Pause audio functions
  *
@@ -434,8 +465,12 @@ extern DECLSPEC void SDLCALL SDL_PauseAudioDevice(SDL_AudioDeviceID dev,
  *  done with it.
  *
  *  This function returns NULL and sets the SDL error message if the
- *  wave file cannot be opened, uses an unknown data format, or is
- *  corrupt.  Currently raw and MS-ADPCM WAVE files are supported.
+ *  wave file cannot be opened, uses an unknown data format, is corrupt,
+ *  or decodes to more than 4 GB (SDL_OpenWAVStream_RW() can read those a
+ *  piece at a time).  Currently raw and MS-ADPCM WAVE files are supported.
+ *
+ *  If \c freesrc is zero, \c src is left at the end of the RIFF chunk
+ *  once the RIFF header has been read, whether or not the rest could be.
  */
 extern DECLSPEC SDL_AudioSpec *SDLCALL SDL_LoadWAV_RW(SDL_RWops * src,
                                                       int freesrc,
@@ -556,6 +591,62 @@ extern DECLSPEC int SDLCALL SDL_AudioStreamPut(SDL_AudioStream *stream, const vo
  */
 extern DECLSPEC int SDLCALL SDL_AudioStreamGet(SDL_AudioStream *stream, void *buf, int len);
 
+/**
+ *  Look at converted/resampled data in the stream without copying it out.
+ *
+ *  All the available data is in one contiguous block, so this reports the
+ *  same amount as SDL_AudioStreamAvailable(). The data stays in the stream
+ *  until you call SDL_AudioStreamCommit(). The pointer is only valid until
+ *  the next call to any other function on this stream.
+ *
+ *  \param stream The stream the audio is being requested from
+ *  \param buf Filled in with a pointer to the converted audio data
+ *  \return The number of bytes at *buf, or -1 on error
+ *
+ *  \sa SDL_AudioStreamCommit
+ *  \sa SDL_AudioStreamGet
+ *  \sa SDL_AudioStreamAvailable
+ */
+extern DECLSPEC int SDLCALL SDL_AudioStreamPeek(SDL_AudioStream *stream, const void **buf);
+
+/**
+ *  Remove data from the stream after reading it with SDL_AudioStreamPeek().
+ *
+ *  \param stream The stream the audio was peeked from
+ *  \param len The number of bytes that were used, a whole number of sample
+ *              frames no larger than what SDL_AudioStreamPeek() reported
+ *  \return 0 on success, or -1 on error
+ *
+ *  \sa SDL_AudioStreamPeek
+ */
+extern DECLSPEC int SDLCALL SDL_AudioStreamCommit(SDL_AudioStream *stream, int len);
+
+/**
+ *  Change how fast a resampling stream consumes its input, without
+ *  resetting it.
+ *
+ *  This is meant for small corrections, like keeping the amount of buffered
+ *  audio steady when the app's clock drifts against the audio device's.
+ *  An adjustment of 1.0 resamples from src_rate to dst_rate as usual; 1.01
+ *  treats the input as if it were 1% faster, so it makes 1% less output.
+ *  The new ratio applies from the next SDL_AudioStreamPut() on, and the
+ *  output stays continuous across the change.
+ *
+ *  The stream must have been created with different source and destination
+ *  rates. While a stream's rate is adjusted away from 1.0, the built-in
+ *  resampler skips the precomputed tables it might otherwise use, which
+ *  costs a little more CPU time. Setting it back to 1.0 returns to the
+ *  usual resampling.
+ *
+ *  \param stream The stream to adjust
+ *  \param adjust How fast to consume input compared to src_rate, between 0.9 and 1.1
+ *  \return 0 on success, or -1 on error
+ *
+ *  \sa SDL_NewAudioStream
+ *  \sa SDL_AudioStreamPut
+ */
+extern DECLSPEC int SDLCALL SDL_AudioStreamSetRateAdjust(SDL_AudioStream *stream, float adjust);
+
 /**
  * Get the number of converted/resampled bytes available. The stream may be
  *  buffering data behind the scenes until it has enough to resample
@@ -612,6 +703,86 @@ extern DECLSPEC void SDLCALL SDL_AudioStreamClear(SDL_AudioStream *stream);
  */
 extern DECLSPEC void SDLCALL SDL_FreeAudioStream(SDL_AudioStream *stream);
 
+
+/* Decoding WAVE files a piece at a time */
+struct _SDL_WAVStream;
+typedef struct _SDL_WAVStream SDL_WAVStream;
+
+/**
+ *  Open a WAVE file for decoding a piece at a time, instead of all at once
+ *  like SDL_LoadWAV_RW() does. Only the headers are read here; \c spec is
+ *  filled in with the format that SDL_ReadWAVStream() will produce, which
+ *  is the same one SDL_LoadWAV_RW() would report.
+ *
+ *  Each stream keeps its own decoder state, so several can be decoded at
+ *  once, from different threads. The source is closed with the stream if
+ *  \c freesrc is non-zero (even if this function fails). If it's zero and
+ *  the headers after the RIFF header can't be used, \c src is left at the
+ *  end of the RIFF chunk, as SDL_LoadWAV_RW() leaves it.
+ *
+ *  \param src The data source to read the WAVE file from
+ *  \param freesrc Non-zero to close \c src when the stream is closed
+ *  \param spec Filled in with the decoded audio format (may be NULL)
+ *  \return a new stream on success, NULL on error.
+ *
+ *  \sa SDL_ReadWAVStream
+ *  \sa SDL_ReadWAVStreamToAudioStream
+ *  \sa SDL_CloseWAVStream
+ */
+extern DECLSPEC SDL_WAVStream *SDLCALL SDL_OpenWAVStream_RW(SDL_RWops * src,
+                                                            int freesrc,
+                                                            SDL_AudioSpec * spec);
+
+/**
+ *  Opens a WAV file for streaming.
+ */
+#define SDL_OpenWAVStream(file, spec) \
+    SDL_OpenWAVStream_RW(SDL_RWFromFile(file, "rb"), 1, spec)
+
+/**
+ *  Decode up to \c len bytes of audio from a WAVE stream into \c buf.
+ *
+ *  \c len must be a multiple of the sample frame size. Less than \c len
+ *  bytes are returned only at the end of the data.
+ *
+ *  \param stream The stream to decode from
+ *  \param buf The buffer to fill with decoded audio
+ *  \param len The size of \c buf, in bytes
+ *  \return the number of bytes decoded, 0 at the end of the data, or -1 on error.
+ *
+ *  \sa SDL_OpenWAVStream_RW
+ *  \sa SDL_ReadWAVStreamToAudioStream
+ *  \sa SDL_CloseWAVStream
+ */
+extern DECLSPEC int SDLCALL SDL_ReadWAVStream(SDL_WAVStream *stream, void *buf, int len);
+
+/**
+ *  Decode up to \c len bytes of audio from a WAVE stream and put them into
+ *  an audio stream, which must have been created with the input format
+ *  reported by SDL_OpenWAVStream_RW(). Any partial sample frame at the end
+ *  of \c len is left for later.
+ *
+ *  \param stream The stream to decode from
+ *  \param audiostream The audio stream to put the decoded data into
+ *  \param len The most decoded bytes to put
+ *  \return the number of bytes put, 0 at the end of the data, or -1 on error.
+ *
+ *  \sa SDL_OpenWAVStream_RW
+ *  \sa SDL_ReadWAVStream
+ *  \sa SDL_CloseWAVStream
+ *  \sa SDL_NewAudioStream
+ */
+extern DECLSPEC int SDLCALL SDL_ReadWAVStreamToAudioStream(SDL_WAVStream *stream, SDL_AudioStream *audiostream, int len);
+
+/**
+ *  Close a WAVE stream, and its data source if it was opened with \c freesrc.
+ *
+ *  \sa SDL_OpenWAVStream_RW
+ *  \sa SDL_ReadWAVStream
+ *  \sa SDL_ReadWAVStreamToAudioStream
+ */
+extern DECLSPEC void SDLCALL SDL_CloseWAVStream(SDL_WAVStream *stream);
+
 #define SDL_MIX_MAXVOLUME 128
 /**
  *  This takes two audio buffers of the playing audio format and mixes
@@ -633,6 +804,37 @@ extern DECLSPEC void SDLCALL SDL_MixAudioFormat(Uint8 * dst,
                                                 SDL_AudioFormat format,
                                                 Uint32 len, int volume);
 
+/**
+ *  This mixes several buffers of the given format into \c dst at once.
+ *
+ *  Each of the \c num_src buffers in \c src is scaled by the matching entry
+ *  in \c volume (0 - ::SDL_MIX_MAXVOLUME) and added to \c dst, as if by one
+ *  SDL_MixAudioFormat() call per buffer. The difference is that the sum is
+ *  kept in floating point and only clipped once, when it is written back to
+ *  \c dst, so sources don't clip each other and it is much faster than many
+ *  separate calls. AUDIO_S32 is summed in 64-bit integers instead, so unless
+ *  separate calls would have clipped, the result is exactly theirs. Unsigned
+ *  formats are mixed around their silence value, and AUDIO_U8 output tops
+ *  out at 0xFE like SDL_MixAudioFormat()'s does. Float output isn't clipped.
+ *  NULL entries in \c src and zero volumes are skipped, and if that leaves
+ *  nothing to mix, \c dst isn't touched.
+ *
+ *  \param dst     The buffer to mix into, also \c len bytes
+ *  \param src     An array of \c num_src buffers of \c len bytes each
+ *  \param volume  An array of \c num_src volumes
+ *  \param num_src The number of buffers to mix in
+ *  \param format  The format of all of the buffers
+ *  \param len     The length of each buffer in bytes
+ *
+ *  \sa SDL_MixAudioFormat
+ */
+extern DECLSPEC void SDLCALL SDL_MixAudioFormatMulti(Uint8 * dst,
+                                                     const Uint8 * const * src,
+                                                     const int * volume,
+                                                     int num_src,
+                                                     SDL_AudioFormat format,
+                                                     Uint32 len);
+
 /**
  *  Queue more audio on non-callback devices.
  *
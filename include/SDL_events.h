@@ -603,6 +603,38 @@ extern DECLSPEC int SDLCALL SDL_PeepEvents(SDL_Event * events, int numevents,
                                            Uint32 minType, Uint32 maxType);
 /* @} */
 
+/**
+ *  Precise times for a queued event, in SDL_GetPerformanceCounter() units.
+ *
+ *  The difference between the two is how long the platform took to hand
+ *  the event to SDL; the time from \c queued until the event is taken from
+ *  the queue is how long it waited there.
+ */
+typedef struct SDL_EventTimestamp
+{
+    Uint64 source;  /**< When the device or window system produced the event, or 0 if SDL doesn't know */
+    Uint64 queued;  /**< When the event was added to the queue */
+} SDL_EventTimestamp;
+
+/**
+ *  Like SDL_PeepEvents(), but also passes the times for each event.
+ *
+ *  For ::SDL_ADDEVENT, the \c source time of each event is read from
+ *  \c timestamps, and the \c queued time is filled in. For ::SDL_PEEKEVENT
+ *  and ::SDL_GETEVENT, both are filled in for each event returned.
+ *
+ *  \param timestamps An array of \c numevents timestamps, or NULL.
+ *
+ *  \return The number of events actually stored, or -1 if there was an error.
+ *
+ *  \sa SDL_PeepEvents()
+ */
+extern DECLSPEC int SDLCALL SDL_PeepEventsWithTimestamps(SDL_Event * events,
+                                                         SDL_EventTimestamp * timestamps,
+                                                         int numevents,
+                                                         SDL_eventaction action,
+                                                         Uint32 minType, Uint32 maxType);
+
 /**
  *  Checks to see if certain event types are in the event queue.
  */
@@ -628,6 +660,27 @@ extern DECLSPEC void SDLCALL SDL_FlushEvents(Uint32 minType, Uint32 maxType);
  */
 extern DECLSPEC int SDLCALL SDL_PollEvent(SDL_Event * event);
 
+/**
+ *  \brief Polls for several pending events at once.
+ *
+ *  This pumps the event loop once, then removes up to \c numevents events
+ *  with types between \c minType and \c maxType, inclusive, from the front
+ *  of the event queue. It's like calling SDL_PollEvent() until it returns 0,
+ *  but the queue is only locked once.
+ *
+ *  \param events An array of at least \c numevents events to fill in.
+ *  \param numevents The most events to remove.
+ *  \param minType The lowest event type to remove, ::SDL_FIRSTEVENT for all.
+ *  \param maxType The highest event type to remove, ::SDL_LASTEVENT for all.
+ *
+ *  \return The number of events stored in \c events, or -1 on error.
+ *
+ *  \sa SDL_PollEvent()
+ *  \sa SDL_PeepEvents()
+ */
+extern DECLSPEC int SDLCALL SDL_PollEvents(SDL_Event * events, int numevents,
+                                           Uint32 minType, Uint32 maxType);
+
 /**
  *  \brief Waits indefinitely for the next available event.
  *
@@ -676,7 +729,9 @@ typedef int (SDLCALL * SDL_EventFilter) (void *userdata, SDL_Event * event);
  *  dynamically arriving events.
  *
  *  \warning  Be very careful of what you do in the event filter function, as
- *            it may run in a different thread!
+ *            it may run in a different thread!  It's called without any lock
+ *            held, so if events are pushed from more than one thread, it can
+ *            run on several of them at once.
  *
  *  There is one caveat when dealing with the ::SDL_QuitEvent event type.  The
  *  event filter is only called when the window manager desires to close the
@@ -698,6 +753,13 @@ extern DECLSPEC SDL_bool SDLCALL SDL_GetEventFilter(SDL_EventFilter * filter,
 
 /**
  *  Add a function which is called when an event is added to the queue.
+ *
+ *  \warning  Like the event filter, watchers are called without any lock
+ *            held, in whichever thread adds the event, so they can run on
+ *            several threads at once.  A watcher removed while an event is
+ *            being dispatched isn't called again, but a call already under
+ *            way on another thread can still be running when
+ *            SDL_DelEventWatch() returns.
  */
 extern DECLSPEC void SDLCALL SDL_AddEventWatch(SDL_EventFilter filter,
                                                void *userdata);
@@ -743,6 +805,32 @@ extern DECLSPEC Uint8 SDLCALL SDL_EventState(Uint32 type, int state);
  */
 extern DECLSPEC Uint32 SDLCALL SDL_RegisterEvents(int numevents);
 
+#define SDL_EVENT_LATENCY_BUCKETS 24
+
+/**
+ *  How long events of one type waited in the queue before being taken out,
+ *  collected while ::SDL_HINT_EVENT_LATENCY_HISTOGRAM is set.
+ */
+typedef struct SDL_EventLatencyHistogram
+{
+    Uint32 count;  /**< Number of events taken from the queue */
+    Uint32 buckets[SDL_EVENT_LATENCY_BUCKETS];  /**< buckets[0] counts waits under 1 microsecond, buckets[i] waits from 2^(i-1) up to 2^i microseconds, and the last one everything longer */
+    Uint64 total_ticks;  /**< All the waits added up, in SDL_GetPerformanceCounter() units */
+    Uint64 max_ticks;  /**< The longest wait */
+} SDL_EventLatencyHistogram;
+
+/**
+ *  Get how long events of a type have waited in the queue.
+ *
+ *  \param type The event type to query
+ *  \param histogram Filled in with the waits so far, all zero if none
+ *  \return 0 on success, or -1 on error.
+ *
+ *  \sa SDL_HINT_EVENT_LATENCY_HISTOGRAM
+ */
+extern DECLSPEC int SDLCALL SDL_GetEventLatencyHistogram(Uint32 type,
+                                                         SDL_EventLatencyHistogram * histogram);
+
 /* Ends C function definitions when using C++ */
 #ifdef __cplusplus
 }
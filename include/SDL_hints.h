@@ -153,6 +153,42 @@ extern "C" {
  */
 #define SDL_HINT_RENDER_VSYNC               "SDL_RENDER_VSYNC"
 
+/**
+ *  \brief  A variable controlling whether the software renderer only updates the parts of the window that were drawn to.
+ *
+ *  This variable can be set to the following values:
+ *    "0"       - Update the whole window surface on every SDL_RenderPresent()
+ *    "1"       - Update only the rectangles touched since the last present
+ *
+ *  By default the software renderer tracks damaged rectangles. Applications that redraw the whole window every frame can disable this to skip the bookkeeping. It can be changed at any time; turning it back on updates the whole window at the next present.
+ */
+#define SDL_HINT_RENDER_SOFTWARE_DAMAGE_TRACKING "SDL_RENDER_SOFTWARE_DAMAGE_TRACKING"
+
+/**
+ *  \brief  A variable setting how many bytes of destroyed textures a renderer keeps for reuse.
+ *
+ *  This variable is read when the renderer is created and can be set to the following values:
+ *    "0"       - Textures are freed as soon as they are destroyed
+ *    "N"       - Keep up to N bytes of destroyed textures and recycle them for new textures with the same format, access and size
+ *
+ *  By default textures are not recycled. The budget can also be changed with SDL_RenderSetTexturePoolBudget().
+ */
+#define SDL_HINT_RENDER_TEXTURE_POOL_BUDGET "SDL_RENDER_TEXTURE_POOL_BUDGET"
+
+/**
+ *  \brief  A variable controlling how many buffers back a streaming texture.
+ *
+ *  This variable is read when a streaming texture is created and can be set to the following values:
+ *    "1"       - SDL_LockTexture() always returns the same buffer
+ *    "2"       - Double buffering, each SDL_UnlockTexture() switches to the other buffer
+ *    "3"       - Triple buffering
+ *
+ *  With more than one buffer, the texture contents are kept in memory and copied to the renderer when the texture is drawn, so a new frame can be written while the previous one is still pending. Partial locks start from a copy of the latest frame.
+ *
+ *  By default streaming textures use a single buffer.
+ */
+#define SDL_HINT_RENDER_STREAMING_BUFFERS "SDL_RENDER_STREAMING_BUFFERS"
+
 /**
  *  \brief  A variable controlling whether the screensaver is enabled. 
  *
@@ -271,6 +307,23 @@ extern "C" {
  */
 #define SDL_HINT_MOUSE_RELATIVE_MODE_WARP    "SDL_MOUSE_RELATIVE_MODE_WARP"
 
+/**
+ *  \brief  A variable controlling whether SDL draws the mouse cursor itself when the video driver can't show one
+ *
+ *  This variable can be set to the following values:
+ *    "0"       - There is no cursor if the video driver doesn't have one
+ *    "1"       - SDL draws the cursor into the window surface whenever it is
+ *                updated, and puts back what was under it afterwards. Moving
+ *                the mouse only needs SDL_UpdateWindowSurfaceRects() with no
+ *                rects to show the cursor in its new place.
+ *
+ *  By default SDL doesn't draw a cursor.
+ *
+ *  This hint is checked when the video subsystem is initialized, and only
+ *  affects windows that use SDL_GetWindowSurface() or the software renderer.
+ */
+#define SDL_HINT_MOUSE_SOFTWARE_CURSOR    "SDL_MOUSE_SOFTWARE_CURSOR"
+
 /**
  *  \brief Allow mouse click events when clicking to focus an SDL window
  *
@@ -293,6 +346,64 @@ extern "C" {
  */
 #define SDL_HINT_TOUCH_MOUSE_EVENTS    "SDL_TOUCH_MOUSE_EVENTS"
 
+/**
+ *  \brief  A variable controlling whether mouse motion events are merged while they wait in the event queue
+ *
+ *  This variable can be set to the following values:
+ *    "0"       - Every mouse motion event is queued separately
+ *    "1"       - A mouse motion event is merged into the last unread one from the same mouse and window:
+ *                the position is updated and xrel/yrel are added together
+ *
+ *  SDL looks back over the last few unread events for one to merge into. It only looks past
+ *  motion from other mice or windows, never past any other kind of event, so each mouse's
+ *  motion keeps its order relative to button presses and everything else. Motion from
+ *  different mice or windows can end up in a different order relative to each other.
+ *
+ *  Setting SDL_EVENT_QUEUE_STATISTICS reports how many events were merged.
+ *
+ *  By default SDL will queue every mouse motion event.
+ */
+#define SDL_HINT_COALESCE_MOUSE_MOTION "SDL_COALESCE_MOUSE_MOTION"
+
+/**
+ *  \brief  A variable controlling whether touch finger motion events are merged while they wait in the event queue
+ *
+ *  This variable can be set to the following values:
+ *    "0"       - Every finger motion event is queued separately
+ *    "1"       - A finger motion event is merged into the last unread one for the same finger:
+ *                the position and pressure are updated and dx/dy are added together
+ *
+ *  Like SDL_HINT_COALESCE_MOUSE_MOTION, this only looks back past motion of other fingers.
+ *
+ *  By default SDL will queue every finger motion event.
+ */
+#define SDL_HINT_COALESCE_FINGER_MOTION "SDL_COALESCE_FINGER_MOTION"
+
+/**
+ *  \brief  A variable controlling whether game controller axis events are merged while they wait in the event queue
+ *
+ *  This variable can be set to the following values:
+ *    "0"       - Every axis motion event is queued separately
+ *    "1"       - An axis motion event replaces the value of the last unread one for the same controller and axis
+ *
+ *  Like SDL_HINT_COALESCE_MOUSE_MOTION, this only looks back past motion of other axes and controllers.
+ *
+ *  By default SDL will queue every controller axis motion event.
+ */
+#define SDL_HINT_COALESCE_CONTROLLER_AXIS_MOTION "SDL_COALESCE_CONTROLLER_AXIS_MOTION"
+
+/**
+ *  \brief  A variable controlling whether SDL keeps track of how long events wait in the queue
+ *
+ *  This variable can be set to the following values:
+ *    "0"       - Don't keep track
+ *    "1"       - Count each event taken from the queue in a histogram for its type,
+ *                see SDL_GetEventLatencyHistogram()
+ *
+ *  By default SDL doesn't keep track.
+ */
+#define SDL_HINT_EVENT_LATENCY_HISTOGRAM "SDL_EVENT_LATENCY_HISTOGRAM"
+
 /**
  *  \brief Minimize your SDL_Window if it loses key focus when in fullscreen mode. Defaults to true.
  *
@@ -875,7 +986,10 @@ extern "C" {
  *  for capture. SDL_AudioCVT always uses the default resampler (although this
  *  might change for SDL 2.1).
  *
- *  This hint is currently only checked at audio subsystem initialization.
+ *  The libsamplerate settings are only checked at audio subsystem
+ *  initialization. The internal tiers ("linear", "cubic" and "short_sinc")
+ *  trade quality for speed, and are checked whenever an SDL_AudioCVT or
+ *  SDL_AudioStream is created, so they apply to both.
  *
  *  This variable can be set to the following values:
  *
@@ -883,9 +997,51 @@ extern "C" {
  *    "1" or "fast"    - Use fast, slightly higher quality resampling, if available
  *    "2" or "medium"  - Use medium quality resampling, if available
  *    "3" or "best"    - Use high quality resampling, if available
+ *    "linear"         - Use SDL's internal linear interpolation (lowest quality, fastest)
+ *    "cubic"          - Use SDL's internal cubic interpolation
+ *    "short_sinc"     - Use SDL's internal resampler with a shorter filter
  */
 #define SDL_HINT_AUDIO_RESAMPLING_MODE   "SDL_AUDIO_RESAMPLING_MODE"
 
+/**
+ *  \brief  A variable controlling whether SDL's internal resampler uses precomputed filter phases.
+ *
+ *  When the source and destination rates reduce to a small ratio (44100 to 48000 is 147:160),
+ *  SDL computes the filter taps for every position between two input samples once, and
+ *  resamples with SIMD dot products. Other rates always use the general resampler.
+ *
+ *  This variable is checked when an SDL_AudioCVT or SDL_AudioStream is converted or created,
+ *  and can be set to the following values:
+ *    "0"       - Always use the general resampler
+ *    "1"       - Use precomputed filter phases when possible
+ *
+ *  By default SDL uses precomputed filter phases when possible.
+ */
+#define SDL_HINT_AUDIO_RESAMPLING_POLYPHASE   "SDL_AUDIO_RESAMPLING_POLYPHASE"
+
+/**
+ *  \brief  A variable controlling how queued audio is stored.
+ *
+ *  By default, SDL_QueueAudio() and SDL_DequeueAudio() use a queue that grows
+ *  as needed, and the app and the audio thread take turns with it under the
+ *  device lock. If this is set to a number of bytes, devices opened without
+ *  a callback use a fixed-size ring buffer of at least that many bytes
+ *  (rounded up to a power of two, and never less than two device buffers)
+ *  that needs no lock, so the audio thread never waits on the app.
+ *
+ *  With a ring buffer, SDL_QueueAudio() fails if all of the data won't fit,
+ *  and capture data that arrives while the ring is full is dropped. Only one
+ *  thread at a time should queue (or dequeue) audio on a device.
+ *
+ *  This variable is checked when the audio device is opened, and can be set
+ *  to the following values:
+ *    "0"       - Use a queue that grows as needed
+ *    "N"       - Use a lock-free ring buffer of at least N bytes
+ *
+ *  By default SDL uses a queue that grows as needed.
+ */
+#define SDL_HINT_AUDIO_QUEUE_CAPACITY   "SDL_AUDIO_QUEUE_CAPACITY"
+
 /**
  *  \brief  A variable controlling the audio category on iOS and Mac OS X
  *
@@ -868,6 +868,41 @@ extern DECLSPEC void SDLCALL SDL_RenderPresent(SDL_Renderer * renderer);
  */
 extern DECLSPEC void SDLCALL SDL_DestroyTexture(SDL_Texture * texture);
 
+/**
+ *  \brief Set how much texture storage a renderer keeps for reuse.
+ *
+ *  \param renderer The renderer.
+ *  \param budget   The approximate number of bytes of destroyed textures to
+ *                  keep, or 0 to disable texture recycling.
+ *
+ *  While the budget is non-zero, SDL_DestroyTexture() keeps the texture
+ *  storage and a later SDL_CreateTexture() with the same format, access and
+ *  size reuses it instead of allocating new storage.  The least recently
+ *  destroyed textures are released first when the budget is exceeded.
+ *
+ *  \return 0 on success, or -1 on error
+ *
+ *  \note The contents of a recycled texture are not defined, just like those
+ *        of a newly created texture.
+ *
+ *  \sa SDL_RenderTrimTexturePool()
+ *  \sa SDL_HINT_RENDER_TEXTURE_POOL_BUDGET
+ */
+extern DECLSPEC int SDLCALL SDL_RenderSetTexturePoolBudget(SDL_Renderer * renderer, size_t budget);
+
+/**
+ *  \brief Release the texture storage a renderer keeps for reuse.
+ *
+ *  \param renderer The renderer.
+ *  \param size     The approximate number of bytes to keep, or 0 to release
+ *                  everything.
+ *
+ *  \return 0 on success, or -1 on error
+ *
+ *  \sa SDL_RenderSetTexturePoolBudget()
+ */
+extern DECLSPEC int SDLCALL SDL_RenderTrimTexturePool(SDL_Renderer * renderer, size_t size);
+
 /**
  *  \brief Destroy the rendering context for a window and free associated
  *         textures.
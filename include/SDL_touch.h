@@ -72,6 +72,10 @@ extern DECLSPEC int SDLCALL SDL_GetNumTouchFingers(SDL_TouchID touchID);
 
 /**
  *  \brief Get the finger object of the given touch, with the given index.
+ *
+ *  The returned pointer belongs to SDL and is only valid until the next
+ *  touch event is reported, or the device is removed. Copy the finger if
+ *  you need it for longer.
  */
 extern DECLSPEC SDL_Finger * SDLCALL SDL_GetTouchFinger(SDL_TouchID touchID, int index);
 
@@ -516,10 +516,110 @@ SDL_RemoveAudioDevice(const int iscapture, void *handle)
 
 /* buffer queueing support... */
 
+static SDL_AudioRing *
+SDL_NewAudioRing(Uint32 size)
+{
+    SDL_AudioRing *ring = (SDL_AudioRing *) SDL_calloc(1, sizeof (SDL_AudioRing));
+    Uint32 pow2 = 1;
+
+    if (!ring) {
+        return NULL;
+    }
+
+    /* positions wrap at 32 bits, so this has to stay well under that. */
+    size = SDL_min(size, 1u << 30);
+    while (pow2 < size) {
+        pow2 <<= 1;
+    }
+
+    ring->data = (Uint8 *) SDL_malloc(pow2);
+    if (!ring->data) {
+        SDL_free(ring);
+        return NULL;
+    }
+    ring->size = pow2;
+    return ring;
+}
+
+static void
+SDL_FreeAudioRing(SDL_AudioRing *ring)
+{
+    if (ring) {
+        SDL_free(ring->data);
+        SDL_free(ring);
+    }
+}
+
+static Uint32
+SDL_CountAudioRing(SDL_AudioRing *ring)
+{
+    const Uint32 tail = (Uint32) SDL_AtomicGet(&ring->tail);
+    const Uint32 head = (Uint32) SDL_AtomicGet(&ring->head);
+    return head - tail;
+}
+
+/* Producer side. Writes as much of buf as fits and returns how much that was. */
+static Uint32
+SDL_WriteToAudioRing(SDL_AudioRing *ring, const void *buf, Uint32 len)
+{
+    const Uint32 head = (Uint32) SDL_AtomicGet(&ring->head);
+    const Uint32 tail = (Uint32) SDL_AtomicGet(&ring->tail);
+    const Uint32 pos = head & (ring->size - 1);
+    Uint32 first;
+
+    /* don't touch the free space until the consumer is done reading it. */
+    SDL_MemoryBarrierAcquire();
+
+    len = SDL_min(len, ring->size - (head - tail));
+    first = SDL_min(len, ring->size - pos);
+    SDL_memcpy(ring->data + pos, buf, first);
+    SDL_memcpy(ring->data, ((const Uint8 *) buf) + first, len - first);
+
+    /* publish the data before the new head. */
+    SDL_MemoryBarrierRelease();
+    SDL_AtomicSet(&ring->head, (int) (head + len));
+    return len;
+}
+
+/* Consumer side. Returns how much was read, or 0 if a clear raced with
+   the read, in which case what ended up in buf can't be trusted. */
+static Uint32
+SDL_ReadFromAudioRing(SDL_AudioRing *ring, void *buf, Uint32 len)
+{
+    const Uint32 tail = (Uint32) SDL_AtomicGet(&ring->tail);
+    const Uint32 head = (Uint32) SDL_AtomicGet(&ring->head);
+    const Uint32 pos = tail & (ring->size - 1);
+    Uint32 first;
+
+    /* don't read the data until we've seen the head that published it. */
+    SDL_MemoryBarrierAcquire();
+
+    len = SDL_min(len, head - tail);
+    first = SDL_min(len, ring->size - pos);
+    SDL_memcpy(buf, ring->data + pos, first);
+    SDL_memcpy(((Uint8 *) buf) + first, ring->data, len - first);
+
+    /* finish reading before handing the space back. A compare-and-swap
+       instead of a plain store, so we can't undo a clear from another thread. */
+    SDL_MemoryBarrierRelease();
+    return SDL_AtomicCAS(&ring->tail, (int) tail, (int) (tail + len)) ? len : 0;
+}
+
+/* Either side. Drops everything written so far. */
+static void
+SDL_ClearAudioRing(SDL_AudioRing *ring)
+{
+    int tail;
+    do {
+        tail = SDL_AtomicGet(&ring->tail);
+    } while (!SDL_AtomicCAS(&ring->tail, tail, SDL_AtomicGet(&ring->head)));
+}
+
 static void SDLCALL
 SDL_BufferQueueDrainCallback(void *userdata, Uint8 *stream, int len)
 {
-    /* this function always holds the mixer lock before being called. */
+    /* this function always holds the mixer lock before being called,
+       unless the device uses a lock-free ring queue. */
     SDL_AudioDevice *device = (SDL_AudioDevice *) userdata;
     size_t dequeued;
 
@@ -527,6 +627,14 @@ SDL_BufferQueueDrainCallback(void *userdata, Uint8 *stream, int len)
     SDL_assert(!device->iscapture);  /* this shouldn't ever happen, right?! */
     SDL_assert(len >= 0);  /* this shouldn't ever happen, right?! */
 
+    if (device->ring_queue) {
+        dequeued = SDL_ReadFromAudioRing(device->ring_queue, stream, (Uint32) len);
+        if (len > (int) dequeued) {  /* ran dry (or got cleared); the rest is silence. */
+            SDL_memset(stream + dequeued, device->spec.silence, len - dequeued);
+        }
+        return;
+    }
+
     dequeued = SDL_ReadFromDataQueue(device->buffer_queue, stream, len);
     stream += dequeued;
     len -= (int) dequeued;
@@ -540,13 +648,21 @@ SDL_BufferQueueDrainCallback(void *userdata, Uint8 *stream, int len)
 static void SDLCALL
 SDL_BufferQueueFillCallback(void *userdata, Uint8 *stream, int len)
 {
-    /* this function always holds the mixer lock before being called. */
+    /* this function always holds the mixer lock before being called,
+       unless the device uses a lock-free ring queue. */
     SDL_AudioDevice *device = (SDL_AudioDevice *) userdata;
 
     SDL_assert(device != NULL);  /* this shouldn't ever happen, right?! */
     SDL_assert(device->iscapture);  /* this shouldn't ever happen, right?! */
     SDL_assert(len >= 0);  /* this shouldn't ever happen, right?! */
 
+    if (device->ring_queue) {
+        /* if the app isn't keeping up and the ring is full, the newest
+           data gets dropped. */
+        SDL_WriteToAudioRing(device->ring_queue, stream, (Uint32) len);
+        return;
+    }
+
     /* note that if this needs to allocate more space and run out of memory,
        we have no choice but to quietly drop the data and hope it works out
        later, but you probably have bigger problems in this case anyhow. */
@@ -567,12 +683,25 @@ SDL_QueueAudio(SDL_AudioDeviceID devid, const void *data, Uint32 len)
         return SDL_SetError("Audio device has a callback, queueing not allowed");
     }
 
-    if (len > 0) {
-        current_audio.impl.LockDevice(device);
-        rc = SDL_WriteToDataQueue(device->buffer_queue, data, len);
-        current_audio.impl.UnlockDevice(device);
+    if (len == 0) {
+        return 0;
+    }
+
+    if (device->ring_queue) {
+        /* only this thread adds data, so the free space can only grow
+           between the check and the write. */
+        SDL_AudioRing *ring = device->ring_queue;
+        if (len > (ring->size - SDL_CountAudioRing(ring))) {
+            return SDL_SetError("Not enough room in the audio queue");
+        }
+        SDL_WriteToAudioRing(ring, data, len);
+        return 0;
     }
 
+    current_audio.impl.LockDevice(device);
+    rc = SDL_WriteToDataQueue(device->buffer_queue, data, len);
+    current_audio.impl.UnlockDevice(device);
+
     return rc;
 }
 
@@ -589,6 +718,10 @@ SDL_DequeueAudio(SDL_AudioDeviceID devid, void *data, Uint32 len)
         return 0;  /* just report zero bytes dequeued. */
     }
 
+    if (device->ring_queue) {
+        return SDL_ReadFromAudioRing(device->ring_queue, data, len);
+    }
+
     current_audio.impl.LockDevice(device);
     rc = (Uint32) SDL_ReadFromDataQueue(device->buffer_queue, data, len);
     current_audio.impl.UnlockDevice(device);
@@ -606,7 +739,14 @@ SDL_GetQueuedAudioSize(SDL_AudioDeviceID devid)
     }
 
     /* Nothing to do unless we're set up for queueing. */
-    if (device->callbackspec.callback == SDL_BufferQueueDrainCallback) {
+    if (device->ring_queue) {
+        retval = SDL_CountAudioRing(device->ring_queue);
+        if (!device->iscapture) {
+            current_audio.impl.LockDevice(device);
+            retval += current_audio.impl.GetPendingBytes(device);
+            current_audio.impl.UnlockDevice(device);
+        }
+    } else if (device->callbackspec.callback == SDL_BufferQueueDrainCallback) {
         current_audio.impl.LockDevice(device);
         retval = ((Uint32) SDL_CountDataQueue(device->buffer_queue)) + current_audio.impl.GetPendingBytes(device);
         current_audio.impl.UnlockDevice(device);
@@ -628,6 +768,11 @@ SDL_ClearQueuedAudio(SDL_AudioDeviceID devid)
         return;  /* nothing to do. */
     }
 
+    if (device->ring_queue) {
+        SDL_ClearAudioRing(device->ring_queue);
+        return;
+    }
+
     /* Blank out the device and release the mutex. Free it afterwards. */
     current_audio.impl.LockDevice(device);
 
@@ -645,6 +790,8 @@ SDL_RunAudio(void *devicep)
     SDL_AudioDevice *device = (SDL_AudioDevice *) devicep;
     void *udata = device->callbackspec.userdata;
     SDL_AudioCallback callback = device->callbackspec.callback;
+    /* a lock-free ring queue doesn't need the mixer lock. */
+    const SDL_bool uselock = device->ring_queue ? SDL_FALSE : SDL_TRUE;
     int data_len = 0;
     Uint8 *data;
 
@@ -657,8 +804,16 @@ SDL_RunAudio(void *devicep)
     device->threadid = SDL_ThreadID();
     current_audio.impl.ThreadInit(device);
 
+    if (device->stream) {
+        SDL_AudioStreamCollectStats(device->stream);
+    }
+
     /* Loop, filling the audio buffers */
     while (!SDL_AtomicGet(&device->shutdown)) {
+        const Uint64 iteration_start = SDL_GetPerformanceCounter();
+        Uint64 now, callback_ticks, convert_ticks = 0, resample_ticks = 0;
+        Uint64 play_ticks = 0, wait_ticks = 0, buffers = 0, callbacks = 0;
+
         current_audio.impl.BeginLoopIteration(device);
         data_len = device->callbackspec.size;
 
@@ -681,13 +836,20 @@ SDL_RunAudio(void *devicep)
         }
 
         /* !!! FIXME: this should be LockDevice. */
-        SDL_LockMutex(device->mixer_lock);
+        now = SDL_GetPerformanceCounter();
+        if (uselock) {
+            SDL_LockMutex(device->mixer_lock);
+        }
         if (SDL_AtomicGet(&device->paused)) {
             SDL_memset(data, device->spec.silence, data_len);
         } else {
             callback(udata, data, data_len);
+            callbacks = 1;
         }
-        SDL_UnlockMutex(device->mixer_lock);
+        if (uselock) {
+            SDL_UnlockMutex(device->mixer_lock);
+        }
+        callback_ticks = SDL_GetPerformanceCounter() - now;
 
         if (device->stream) {
             /* Stream available audio to device, converting/resampling. */
@@ -700,6 +862,7 @@ SDL_RunAudio(void *devicep)
                 got = SDL_AudioStreamGet(device->stream, data ? data : device->work_buffer, device->spec.size);
                 SDL_assert((got < 0) || (got == device->spec.size));
 
+                now = SDL_GetPerformanceCounter();
                 if (data == NULL) {  /* device is having issues... */
                     const Uint32 delay = ((device->spec.samples * 1000) / device->spec.freq);
                     SDL_Delay(delay);  /* wait for as long as this buffer would have played. Maybe device recovers later? */
@@ -708,18 +871,44 @@ SDL_RunAudio(void *devicep)
                         SDL_memset(data, device->spec.silence, device->spec.size);
                     }
                     current_audio.impl.PlayDevice(device);
+                    play_ticks += SDL_GetPerformanceCounter() - now;
+                    buffers++;
+                    now = SDL_GetPerformanceCounter();
                     current_audio.impl.WaitDevice(device);
                 }
+                wait_ticks += SDL_GetPerformanceCounter() - now;
             }
+            SDL_AudioStreamTakeStats(device->stream, &convert_ticks, &resample_ticks);
         } else if (data == device->work_buffer) {
             /* nothing to do; pause like we queued a buffer to play. */
             const Uint32 delay = ((device->spec.samples * 1000) / device->spec.freq);
+            now = SDL_GetPerformanceCounter();
             SDL_Delay(delay);
+            wait_ticks = SDL_GetPerformanceCounter() - now;
         } else {  /* writing directly to the device. */
             /* queue this buffer and wait for it to finish playing. */
+            now = SDL_GetPerformanceCounter();
             current_audio.impl.PlayDevice(device);
+            play_ticks = SDL_GetPerformanceCounter() - now;
+            buffers = 1;
+            now = SDL_GetPerformanceCounter();
             current_audio.impl.WaitDevice(device);
+            wait_ticks = SDL_GetPerformanceCounter() - now;
         }
+
+        /* add up where the time went. */
+        now = SDL_GetPerformanceCounter() - iteration_start - wait_ticks;
+        SDL_AtomicLock(&device->stats_lock);
+        device->stats.callbacks += callbacks;
+        device->stats.buffers += buffers;
+        device->stats.callback_ticks += callback_ticks;
+        device->stats.convert_ticks += convert_ticks;
+        device->stats.resample_ticks += resample_ticks;
+        device->stats.play_ticks += play_ticks;
+        device->stats.wait_ticks += wait_ticks;
+        device->stats.max_callback_ticks = SDL_max(device->stats.max_callback_ticks, callback_ticks);
+        device->stats.max_iteration_ticks = SDL_max(device->stats.max_iteration_ticks, now);
+        SDL_AtomicUnlock(&device->stats_lock);
     }
 
     current_audio.impl.PrepareToClose(device);
@@ -744,6 +933,8 @@ SDL_CaptureAudio(void *devicep)
     Uint8 *data;
     void *udata = device->callbackspec.userdata;
     SDL_AudioCallback callback = device->callbackspec.callback;
+    /* a lock-free ring queue doesn't need the mixer lock. */
+    const SDL_bool uselock = device->ring_queue ? SDL_FALSE : SDL_TRUE;
 
     SDL_assert(device->iscapture);
 
@@ -816,19 +1007,27 @@ SDL_CaptureAudio(void *devicep)
                 }
 
                 /* !!! FIXME: this should be LockDevice. */
-                SDL_LockMutex(device->mixer_lock);
+                if (uselock) {
+                    SDL_LockMutex(device->mixer_lock);
+                }
                 if (!SDL_AtomicGet(&device->paused)) {
                     callback(udata, device->work_buffer, device->callbackspec.size);
                 }
-                SDL_UnlockMutex(device->mixer_lock);
+                if (uselock) {
+                    SDL_UnlockMutex(device->mixer_lock);
+                }
             }
         } else {  /* feeding user callback directly without streaming. */
             /* !!! FIXME: this should be LockDevice. */
-            SDL_LockMutex(device->mixer_lock);
+            if (uselock) {
+                SDL_LockMutex(device->mixer_lock);
+            }
             if (!SDL_AtomicGet(&device->paused)) {
                 callback(udata, data, device->callbackspec.size);
             }
-            SDL_UnlockMutex(device->mixer_lock);
+            if (uselock) {
+                SDL_UnlockMutex(device->mixer_lock);
+            }
         }
     }
 
@@ -1079,6 +1278,7 @@ close_audio_device(SDL_AudioDevice * device)
     }
 
     SDL_FreeDataQueue(device->buffer_queue);
+    SDL_FreeAudioRing(device->ring_queue);
 
     SDL_free(device);
 }
@@ -1159,7 +1359,9 @@ open_audio_device(const char *devname, int iscapture,
     void *handle = NULL;
     int i = 0;
 
-    if (!SDL_WasInit(SDL_INIT_AUDIO)) {
+    /* SDL_AudioQuit() can leave the subsystem marked as initialized with no
+       driver loaded, so check for the driver itself. */
+    if (!SDL_WasInit(SDL_INIT_AUDIO) || !current_audio.name) {
         SDL_SetError("Audio subsystem is not initialized");
         return 0;
     }
@@ -1345,12 +1547,24 @@ open_audio_device(const char *devname, int iscapture,
     }
 
     if (device->spec.callback == NULL) {  /* use buffer queueing? */
-        /* pool a few packets to start. Enough for two callbacks. */
-        device->buffer_queue = SDL_NewDataQueue(SDL_AUDIOBUFFERQUEUE_PACKETLEN, obtained->size * 2);
-        if (!device->buffer_queue) {
-            close_audio_device(device);
-            SDL_SetError("Couldn't create audio buffer queue");
-            return 0;
+        const char *hint = SDL_GetHint(SDL_HINT_AUDIO_QUEUE_CAPACITY);
+        const int capacity = hint ? SDL_atoi(hint) : 0;
+        if (capacity > 0) {
+            /* a fixed-size lock-free ring, always big enough for two callbacks. */
+            device->ring_queue = SDL_NewAudioRing(SDL_max((Uint32) capacity, obtained->size * 2));
+            if (!device->ring_queue) {
+                close_audio_device(device);
+                SDL_OutOfMemory();
+                return 0;
+            }
+        } else {
+            /* pool a few packets to start. Enough for two callbacks. */
+            device->buffer_queue = SDL_NewDataQueue(SDL_AUDIOBUFFERQUEUE_PACKETLEN, obtained->size * 2);
+            if (!device->buffer_queue) {
+                close_audio_device(device);
+                SDL_SetError("Couldn't create audio buffer queue");
+                return 0;
+            }
         }
         device->callbackspec.callback = iscapture ? SDL_BufferQueueFillCallback : SDL_BufferQueueDrainCallback;
         device->callbackspec.userdata = device;
@@ -1454,6 +1668,24 @@ SDL_GetAudioDeviceStatus(SDL_AudioDeviceID devid)
     return status;
 }
 
+int
+SDL_GetAudioDeviceStats(SDL_AudioDeviceID devid, SDL_AudioDeviceStats * stats)
+{
+    SDL_AudioDevice *device = get_audio_device(devid);
+    if (!device) {
+        return -1;
+    } else if (device->iscapture) {
+        return SDL_SetError("Audio device is a capture device");
+    } else if (!stats) {
+        return SDL_InvalidParamError("stats");
+    }
+
+    SDL_AtomicLock(&device->stats_lock);
+    *stats = device->stats;
+    SDL_AtomicUnlock(&device->stats_lock);
+    return 0;
+}
+
 
 SDL_AudioStatus
 SDL_GetAudioStatus(void)
@@ -69,6 +69,10 @@ extern SDL_AudioFilter SDL_Convert_F32_to_S16;
 extern SDL_AudioFilter SDL_Convert_F32_to_U16;
 extern SDL_AudioFilter SDL_Convert_F32_to_S32;
 
+/* Audio device threads use these to see where an SDL_AudioStream spends its time. */
+extern void SDL_AudioStreamCollectStats(SDL_AudioStream *stream);
+extern void SDL_AudioStreamTakeStats(SDL_AudioStream *stream, Uint64 *convert_ticks, Uint64 *resample_ticks);
+
 /* You need to call SDL_PrepareResampleFilter() before using the internal resampler.
    SDL_AudioQuit() calls SDL_FreeResamplerFilter(), you should never call it yourself. */
 extern int SDL_PrepareResampleFilter(void);
@@ -31,15 +31,23 @@
 
 #include "SDL_loadso.h"
 #include "SDL_assert.h"
-#include "../SDL_dataqueue.h"
 #include "SDL_cpuinfo.h"
 
 #define DEBUG_AUDIOSTREAM 0
 
+#ifdef __SSE__
+#define HAVE_SSE_INTRINSICS 1
+#endif
+
 #ifdef __SSE3__
 #define HAVE_SSE3_INTRINSICS 1
 #endif
 
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define HAVE_NEON_INTRINSICS 1
+#include <arm_neon.h>
+#endif
+
 #if HAVE_SSE3_INTRINSICS
 /* Convert from stereo to mono. Average left and right. */
 static void SDLCALL
@@ -381,6 +389,9 @@ SDL_Convert51To71(SDL_AudioCVT * cvt, SDL_AudioFormat format)
 #define RESAMPLER_BITS_PER_SAMPLE 16
 #define RESAMPLER_SAMPLES_PER_ZERO_CROSSING  (1 << ((RESAMPLER_BITS_PER_SAMPLE / 2) + 1))
 #define RESAMPLER_FILTER_SIZE ((RESAMPLER_SAMPLES_PER_ZERO_CROSSING * RESAMPLER_ZERO_CROSSINGS) + 1)
+#define RESAMPLER_SHORT_ZERO_CROSSINGS 4
+#define RESAMPLER_SHORT_SAMPLES_PER_ZERO_CROSSING 256
+#define RESAMPLER_SHORT_FILTER_SIZE ((RESAMPLER_SHORT_SAMPLES_PER_ZERO_CROSSING * RESAMPLER_SHORT_ZERO_CROSSINGS) + 2)
 
 /* This is a "modified" bessel function, so you can't use POSIX j0() */
 static double
@@ -427,9 +438,65 @@ kaiser_and_sinc(float *table, float *diffs, const int tablelen, const double bet
 }
 
 
+/* build a short kaiser-windowed sinc for the "short_sinc" tier; unlike
+   kaiser_and_sinc(), x is in zero crossings and no difference table is kept,
+   since ShortSincWeight() interpolates on the fly. */
+static void
+short_kaiser_and_sinc(float *table, const int tablelen, const double beta)
+{
+    const double bessel_beta = bessel(beta);
+    int i;
+
+    table[0] = 1.0f;
+    for (i = 1; i < tablelen; i++) {
+        const double x = ((double) i) / RESAMPLER_SHORT_SAMPLES_PER_ZERO_CROSSING;
+        if (x >= RESAMPLER_SHORT_ZERO_CROSSINGS) {
+            table[i] = 0.0f;
+        } else {
+            const double px = M_PI * x;
+            const double w = x / RESAMPLER_SHORT_ZERO_CROSSINGS;
+            table[i] = (float) ((SDL_sin(px) / px) * (bessel(beta * SDL_sqrt(1.0 - (w * w))) / bessel_beta));
+        }
+    }
+}
+
+/* Polyphase resampling: when the two rates reduce to a ratio of small
+   integers (44100:48000 is 147:160), every output frame falls on one of a
+   fixed number of positions ("phases") between two input frames. The filter
+   taps of each phase are computed once, and each output frame is then a
+   plain dot product of those taps with the input around it. */
+#define RESAMPLER_POLYPHASE_TAPS 12    /* 11 frames of filter, padded to a multiple of 4 */
+#define RESAMPLER_POLYPHASE_LEFT 5     /* frames before the current input frame */
+#define RESAMPLER_MAX_PHASES 1024
+#define RESAMPLER_MAX_POLYPHASE_TABLES 16
+
+typedef void (*SDL_PolyphaseKernel)(const float *taps, const int chans, const float *src, float *dst);
+
+typedef struct
+{
+    int inrate;
+    int outrate;
+    int chans;
+    int phases;     /* outrate / gcd */
+    int step;       /* inrate / gcd */
+    float *taps;    /* phases * RESAMPLER_POLYPHASE_TAPS taps, each repeated for every channel */
+} SDL_PolyphaseTable;
+
+/* The built-in resampling tiers, picked with SDL_HINT_AUDIO_RESAMPLING_MODE */
+typedef enum
+{
+    RESAMPLER_SINC,         /* the bandlimited resampler above */
+    RESAMPLER_LINEAR,
+    RESAMPLER_CUBIC,
+    RESAMPLER_SHORT_SINC    /* Kaiser windowed sinc, RESAMPLER_SHORT_ZERO_CROSSINGS wide */
+} SDL_ResamplerMode;
+
 static SDL_SpinLock ResampleFilterSpinlock = 0;
+static float ResamplerShortFilter[RESAMPLER_SHORT_FILTER_SIZE];
 static float *ResamplerFilter = NULL;
 static float *ResamplerFilterDifference = NULL;
+static SDL_PolyphaseTable *PolyphaseTables[RESAMPLER_MAX_POLYPHASE_TABLES];
+static SDL_PolyphaseKernel PolyphaseKernel = NULL;
 
 int
 SDL_PrepareResampleFilter(void)
@@ -455,6 +522,7 @@ SDL_PrepareResampleFilter(void)
             return SDL_OutOfMemory();
         }
         kaiser_and_sinc(ResamplerFilter, ResamplerFilterDifference, RESAMPLER_FILTER_SIZE, beta);
+        short_kaiser_and_sinc(ResamplerShortFilter, RESAMPLER_SHORT_FILTER_SIZE, 8.0);
     }
     SDL_AtomicUnlock(&ResampleFilterSpinlock);
     return 0;
@@ -463,6 +531,15 @@ SDL_PrepareResampleFilter(void)
 void
 SDL_FreeResampleFilter(void)
 {
+    int i;
+
+    for (i = 0; i < RESAMPLER_MAX_POLYPHASE_TABLES; i++) {
+        if (PolyphaseTables[i]) {
+            SDL_free(PolyphaseTables[i]->taps);
+            SDL_free(PolyphaseTables[i]);
+            PolyphaseTables[i] = NULL;
+        }
+    }
     SDL_free(ResamplerFilter);
     SDL_free(ResamplerFilterDifference);
     ResamplerFilter = NULL;
@@ -536,6 +613,427 @@ SDL_ResampleAudio(const int chans, const int inrate, const int outrate,
     return outframes * chans * sizeof (float);
 }
 
+/* Each kernel computes one output frame:
+     dst[chan] = sum of src[i] * taps[i] for every i that is (chan) mod (chans).
+   src and taps hold RESAMPLER_POLYPHASE_TAPS * chans floats, always a
+   multiple of 4. */
+static void
+SDL_PolyphaseKernel_Scalar(const float *taps, const int chans, const float *src, float *dst)
+{
+    const int total = RESAMPLER_POLYPHASE_TAPS * chans;
+    int i, chan;
+
+    for (chan = 0; chan < chans; chan++) {
+        float sum = 0.0f;
+        for (i = chan; i < total; i += chans) {
+            sum += src[i] * taps[i];
+        }
+        dst[chan] = sum;
+    }
+}
+
+#if HAVE_SSE_INTRINSICS
+static void
+SDL_PolyphaseKernel_SSE(const float *taps, const int chans, const float *src, float *dst)
+{
+    if (chans == 1) {
+        __m128 sum = _mm_mul_ps(_mm_loadu_ps(src), _mm_loadu_ps(taps));
+        float result[4];
+        sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(src + 4), _mm_loadu_ps(taps + 4)));
+        sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(src + 8), _mm_loadu_ps(taps + 8)));
+        _mm_storeu_ps(result, sum);
+        dst[0] = (result[0] + result[1]) + (result[2] + result[3]);
+    } else if (chans == 2) {
+        __m128 sum = _mm_setzero_ps();
+        float result[4];
+        int i;
+        for (i = 0; i < RESAMPLER_POLYPHASE_TAPS * 2; i += 4) {
+            sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(src + i), _mm_loadu_ps(taps + i)));
+        }
+        _mm_storeu_ps(result, sum);
+        dst[0] = result[0] + result[2];
+        dst[1] = result[1] + result[3];
+    } else if (chans == 4) {
+        __m128 sum = _mm_setzero_ps();
+        int i;
+        for (i = 0; i < RESAMPLER_POLYPHASE_TAPS * 4; i += 4) {
+            sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(src + i), _mm_loadu_ps(taps + i)));
+        }
+        _mm_storeu_ps(dst, sum);
+    } else {
+        SDL_PolyphaseKernel_Scalar(taps, chans, src, dst);
+    }
+}
+#endif
+
+#if HAVE_NEON_INTRINSICS
+static void
+SDL_PolyphaseKernel_NEON(const float *taps, const int chans, const float *src, float *dst)
+{
+    if (chans == 1) {
+        float32x4_t sum = vmulq_f32(vld1q_f32(src), vld1q_f32(taps));
+        float32x2_t half;
+        sum = vmlaq_f32(sum, vld1q_f32(src + 4), vld1q_f32(taps + 4));
+        sum = vmlaq_f32(sum, vld1q_f32(src + 8), vld1q_f32(taps + 8));
+        half = vadd_f32(vget_low_f32(sum), vget_high_f32(sum));
+        dst[0] = vget_lane_f32(vpadd_f32(half, half), 0);
+    } else if (chans == 2) {
+        float32x4_t sum = vdupq_n_f32(0.0f);
+        float32x2_t half;
+        int i;
+        for (i = 0; i < RESAMPLER_POLYPHASE_TAPS * 2; i += 4) {
+            sum = vmlaq_f32(sum, vld1q_f32(src + i), vld1q_f32(taps + i));
+        }
+        half = vadd_f32(vget_low_f32(sum), vget_high_f32(sum));
+        vst1_f32(dst, half);
+    } else if (chans == 4) {
+        float32x4_t sum = vdupq_n_f32(0.0f);
+        int i;
+        for (i = 0; i < RESAMPLER_POLYPHASE_TAPS * 4; i += 4) {
+            sum = vmlaq_f32(sum, vld1q_f32(src + i), vld1q_f32(taps + i));
+        }
+        vst1q_f32(dst, sum);
+    } else {
+        SDL_PolyphaseKernel_Scalar(taps, chans, src, dst);
+    }
+}
+#endif
+
+static int
+gcd(int a, int b)
+{
+    while (b != 0) {
+        const int t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+/* Build the taps for every phase, sampling the same interpolated filter
+   table as SDL_ResampleAudio(). */
+static SDL_PolyphaseTable *
+SDL_BuildPolyphaseTable(const int inrate, const int outrate, const int chans)
+{
+    const int divisor = gcd(inrate, outrate);
+    const int phases = outrate / divisor;
+    const int taps_per_phase = RESAMPLER_POLYPHASE_TAPS * chans;
+    SDL_PolyphaseTable *table;
+    int phase, j, chan;
+
+    table = (SDL_PolyphaseTable *) SDL_calloc(1, sizeof (*table));
+    if (!table) {
+        return NULL;
+    }
+    table->taps = (float *) SDL_malloc(phases * taps_per_phase * sizeof (float));
+    if (!table->taps) {
+        SDL_free(table);
+        return NULL;
+    }
+    table->inrate = inrate;
+    table->outrate = outrate;
+    table->chans = chans;
+    table->phases = phases;
+    table->step = inrate / divisor;
+
+    for (phase = 0; phase < phases; phase++) {
+        const double interpolation1 = ((double) phase) / ((double) phases);
+        const int filterindex1 = (int) (interpolation1 * RESAMPLER_SAMPLES_PER_ZERO_CROSSING);
+        const double interpolation2 = 1.0 - interpolation1;
+        const int filterindex2 = (int) (interpolation2 * RESAMPLER_SAMPLES_PER_ZERO_CROSSING);
+        float taps[RESAMPLER_POLYPHASE_TAPS];
+        float *dst = table->taps + (phase * taps_per_phase);
+
+        SDL_zero(taps);
+        for (j = 0; (filterindex1 + (j * RESAMPLER_SAMPLES_PER_ZERO_CROSSING)) < RESAMPLER_FILTER_SIZE; j++) {
+            const int filt_ind = filterindex1 + (j * RESAMPLER_SAMPLES_PER_ZERO_CROSSING);
+            taps[RESAMPLER_POLYPHASE_LEFT - j] = (float) (ResamplerFilter[filt_ind] + (interpolation1 * ResamplerFilterDifference[filt_ind]));
+        }
+        for (j = 0; (filterindex2 + (j * RESAMPLER_SAMPLES_PER_ZERO_CROSSING)) < RESAMPLER_FILTER_SIZE; j++) {
+            const int filt_ind = filterindex2 + (j * RESAMPLER_SAMPLES_PER_ZERO_CROSSING);
+            taps[RESAMPLER_POLYPHASE_LEFT + 1 + j] = (float) (ResamplerFilter[filt_ind] + (interpolation2 * ResamplerFilterDifference[filt_ind]));
+        }
+
+        for (j = 0; j < RESAMPLER_POLYPHASE_TAPS; j++) {
+            for (chan = 0; chan < chans; chan++) {
+                *(dst++) = taps[j];
+            }
+        }
+    }
+    return table;
+}
+
+/* Returns a shared polyphase table, or NULL if the rates don't reduce to
+   few enough phases. You need to call SDL_PrepareResampleFilter() first. */
+static const SDL_PolyphaseTable *
+SDL_GetPolyphaseTable(const int inrate, const int outrate, const int chans)
+{
+    SDL_PolyphaseTable *table = NULL;
+    int i;
+
+    if ((outrate / gcd(inrate, outrate)) > RESAMPLER_MAX_PHASES) {
+        return NULL;
+    }
+    if (!SDL_GetHintBoolean(SDL_HINT_AUDIO_RESAMPLING_POLYPHASE, SDL_TRUE)) {
+        return NULL;
+    }
+
+    SDL_AtomicLock(&ResampleFilterSpinlock);
+    if (!PolyphaseKernel) {
+        PolyphaseKernel = SDL_PolyphaseKernel_Scalar;
+#if HAVE_SSE_INTRINSICS
+        if (SDL_HasSSE()) {
+            PolyphaseKernel = SDL_PolyphaseKernel_SSE;
+        }
+#endif
+#if HAVE_NEON_INTRINSICS
+        if (SDL_HasNEON()) {
+            PolyphaseKernel = SDL_PolyphaseKernel_NEON;
+        }
+#endif
+    }
+    for (i = 0; i < RESAMPLER_MAX_POLYPHASE_TABLES; i++) {
+        SDL_PolyphaseTable *entry = PolyphaseTables[i];
+        if (!entry) {
+            table = SDL_BuildPolyphaseTable(inrate, outrate, chans);
+            PolyphaseTables[i] = table;
+            break;
+        } else if (entry->inrate == inrate && entry->outrate == outrate && entry->chans == chans) {
+            table = entry;
+            break;
+        }
+    }
+    SDL_AtomicUnlock(&ResampleFilterSpinlock);
+
+    return table;
+}
+
+/* Same as SDL_ResampleAudio(), but the output frame positions are exact
+   multiples of table->step / table->phases input frames. */
+static int
+SDL_ResampleAudioPolyphase(const SDL_PolyphaseTable *table,
+                           const float *lpadding, const float *rpadding,
+                           const float *inbuf, const int inbuflen,
+                           float *outbuf, const int outbuflen)
+{
+    const SDL_PolyphaseKernel kernel = PolyphaseKernel;
+    const int chans = table->chans;
+    const int phases = table->phases;
+    const int step_frames = table->step / phases;
+    const int step_phase = table->step % phases;
+    const int taps_per_phase = RESAMPLER_POLYPHASE_TAPS * chans;
+    const int paddinglen = ResamplerPadding(table->inrate, table->outrate);
+    const double ratio = ((float) table->outrate) / ((float) table->inrate);
+    const int framelen = chans * (int)sizeof (float);
+    const int inframes = inbuflen / framelen;
+    const int wantedoutframes = (int) ((inbuflen / framelen) * ratio);  /* outbuflen isn't total to write, it's total available. */
+    const int maxoutframes = outbuflen / framelen;
+    const int outframes = SDL_min(wantedoutframes, maxoutframes);
+    float window[RESAMPLER_POLYPHASE_TAPS * 8];
+    float *dst = outbuf;
+    int srcindex = 0;
+    int phase = 0;
+    int i, j;
+
+    SDL_assert(chans <= 8);
+
+    for (i = 0; i < outframes; i++) {
+        const int first = srcindex - RESAMPLER_POLYPHASE_LEFT;
+        const float *src;
+
+        if (first >= 0 && (first + RESAMPLER_POLYPHASE_TAPS) <= inframes) {
+            src = inbuf + (first * chans);
+        } else {
+            /* Near the edges, gather the frames from the padding. */
+            for (j = 0; j < RESAMPLER_POLYPHASE_TAPS; j++) {
+                const int srcframe = first + j;
+                const float *frame;
+                if (srcframe < 0) {
+                    frame = lpadding + ((paddinglen + srcframe) * chans);
+                } else if (srcframe >= inframes) {
+                    frame = rpadding + ((srcframe - inframes) * chans);
+                } else {
+                    frame = inbuf + (srcframe * chans);
+                }
+                SDL_memcpy(window + (j * chans), frame, framelen);
+            }
+            src = window;
+        }
+
+        kernel(table->taps + (phase * taps_per_phase), chans, src, dst);
+        dst += chans;
+
+        srcindex += step_frames;
+        phase += step_phase;
+        if (phase >= phases) {
+            phase -= phases;
+            srcindex++;
+        }
+    }
+
+    return outframes * framelen;
+}
+
+static SDL_ResamplerMode
+SDL_GetResamplerModeHint(void)
+{
+    const char *hint = SDL_GetHint(SDL_HINT_AUDIO_RESAMPLING_MODE);
+
+    if (hint) {
+        if (SDL_strcasecmp(hint, "linear") == 0) {
+            return RESAMPLER_LINEAR;
+        } else if (SDL_strcasecmp(hint, "cubic") == 0) {
+            return RESAMPLER_CUBIC;
+        } else if (SDL_strcasecmp(hint, "short_sinc") == 0) {
+            return RESAMPLER_SHORT_SINC;
+        }
+    }
+    return RESAMPLER_SINC;
+}
+
+static SDL_INLINE const float *
+ResamplerFrame(const int srcframe, const int chans, const int paddinglen, const int inframes,
+               const float *lpadding, const float *rpadding, const float *inbuf)
+{
+    if (srcframe < 0) {
+        return lpadding + ((paddinglen + srcframe) * chans);
+    } else if (srcframe >= inframes) {
+        return rpadding + ((srcframe - inframes) * chans);
+    }
+    return inbuf + (srcframe * chans);
+}
+
+static SDL_INLINE float
+ShortSincWeight(const float distance)  /* distance must be >= 0 */
+{
+    const float pos = distance * RESAMPLER_SHORT_SAMPLES_PER_ZERO_CROSSING;
+    const int index = (int) pos;
+    if (index >= RESAMPLER_SHORT_FILTER_SIZE - 1) {
+        return 0.0f;
+    }
+    return ResamplerShortFilter[index] + ((pos - index) * (ResamplerShortFilter[index + 1] - ResamplerShortFilter[index]));
+}
+
+/* Writes one output frame at (t) of the way from input frame (srcindex)
+   to the next one. The cheaper tiers only look at a few frames around the
+   position; RESAMPLER_SINC uses the same filter as SDL_ResampleAudio(). */
+static SDL_INLINE void
+SDL_ResampleFrame(const SDL_ResamplerMode mode, const int chans,
+                  const int srcindex, const float t,
+                  const float *lpadding, const int paddinglen,
+                  const float *rpadding, const float *inbuf,
+                  const int inframes, float *dst)
+{
+    int j, chan;
+
+    if (mode == RESAMPLER_LINEAR) {
+        const float *a = ResamplerFrame(srcindex, chans, paddinglen, inframes, lpadding, rpadding, inbuf);
+        const float *b = ResamplerFrame(srcindex + 1, chans, paddinglen, inframes, lpadding, rpadding, inbuf);
+        for (chan = 0; chan < chans; chan++) {
+            dst[chan] = a[chan] + ((b[chan] - a[chan]) * t);
+        }
+    } else if (mode == RESAMPLER_CUBIC) {
+        /* Catmull-Rom spline through the four frames around the position */
+        const float *p0 = ResamplerFrame(srcindex - 1, chans, paddinglen, inframes, lpadding, rpadding, inbuf);
+        const float *p1 = ResamplerFrame(srcindex, chans, paddinglen, inframes, lpadding, rpadding, inbuf);
+        const float *p2 = ResamplerFrame(srcindex + 1, chans, paddinglen, inframes, lpadding, rpadding, inbuf);
+        const float *p3 = ResamplerFrame(srcindex + 2, chans, paddinglen, inframes, lpadding, rpadding, inbuf);
+        const float t2 = t * t;
+        const float t3 = t2 * t;
+        const float w0 = 0.5f * (-t3 + (2.0f * t2) - t);
+        const float w1 = 0.5f * ((3.0f * t3) - (5.0f * t2) + 2.0f);
+        const float w2 = 0.5f * ((-3.0f * t3) + (4.0f * t2) + t);
+        const float w3 = 0.5f * (t3 - t2);
+        for (chan = 0; chan < chans; chan++) {
+            dst[chan] = (p0[chan] * w0) + (p1[chan] * w1) + (p2[chan] * w2) + (p3[chan] * w3);
+        }
+    } else if (mode == RESAMPLER_SHORT_SINC) {
+        const float *frames[RESAMPLER_SHORT_ZERO_CROSSINGS * 2];
+        float weights[RESAMPLER_SHORT_ZERO_CROSSINGS * 2];
+        float total = 0.0f;
+
+        for (j = 0; j < RESAMPLER_SHORT_ZERO_CROSSINGS * 2; j++) {
+            const int offset = j - (RESAMPLER_SHORT_ZERO_CROSSINGS - 1);
+            frames[j] = ResamplerFrame(srcindex + offset, chans, paddinglen, inframes, lpadding, rpadding, inbuf);
+            weights[j] = ShortSincWeight((offset > 0) ? (((float) offset) - t) : (t - ((float) offset)));
+            total += weights[j];
+        }
+        /* normalize, so a constant signal stays constant */
+        total = 1.0f / total;
+        for (j = 0; j < RESAMPLER_SHORT_ZERO_CROSSINGS * 2; j++) {
+            weights[j] *= total;
+        }
+        for (chan = 0; chan < chans; chan++) {
+            float outsample = 0.0f;
+            for (j = 0; j < RESAMPLER_SHORT_ZERO_CROSSINGS * 2; j++) {
+                outsample += frames[j][chan] * weights[j];
+            }
+            dst[chan] = outsample;
+        }
+    } else {
+        const double interpolation1 = t;
+        const int filterindex1 = (int) (interpolation1 * RESAMPLER_SAMPLES_PER_ZERO_CROSSING);
+        const double interpolation2 = 1.0 - interpolation1;
+        const int filterindex2 = (int) (interpolation2 * RESAMPLER_SAMPLES_PER_ZERO_CROSSING);
+
+        for (chan = 0; chan < chans; chan++) {
+            float outsample = 0.0f;
+            for (j = 0; (filterindex1 + (j * RESAMPLER_SAMPLES_PER_ZERO_CROSSING)) < RESAMPLER_FILTER_SIZE; j++) {
+                const int filt_ind = filterindex1 + (j * RESAMPLER_SAMPLES_PER_ZERO_CROSSING);
+                const float *frame = ResamplerFrame(srcindex - j, chans, paddinglen, inframes, lpadding, rpadding, inbuf);
+                outsample += (float)(frame[chan] * (ResamplerFilter[filt_ind] + (interpolation1 * ResamplerFilterDifference[filt_ind])));
+            }
+            for (j = 0; (filterindex2 + (j * RESAMPLER_SAMPLES_PER_ZERO_CROSSING)) < RESAMPLER_FILTER_SIZE; j++) {
+                const int filt_ind = filterindex2 + (j * RESAMPLER_SAMPLES_PER_ZERO_CROSSING);
+                const float *frame = ResamplerFrame(srcindex + 1 + j, chans, paddinglen, inframes, lpadding, rpadding, inbuf);
+                outsample += (float)(frame[chan] * (ResamplerFilter[filt_ind] + (interpolation2 * ResamplerFilterDifference[filt_ind])));
+            }
+            dst[chan] = outsample;
+        }
+    }
+}
+
+/* The cheaper tiers. Same contract as SDL_ResampleAudio(); they only look at
+   a few frames around each output position, which the padding always covers. */
+static int
+SDL_ResampleAudioInterpolated(const SDL_ResamplerMode mode, const int chans,
+                              const int inrate, const int outrate,
+                              const float *lpadding, const float *rpadding,
+                              const float *inbuf, const int inbuflen,
+                              float *outbuf, const int outbuflen)
+{
+    const double ratio = ((float) outrate) / ((float) inrate);
+    const int paddinglen = ResamplerPadding(inrate, outrate);
+    const int framelen = chans * (int)sizeof (float);
+    const int inframes = inbuflen / framelen;
+    const int wantedoutframes = (int) ((inbuflen / framelen) * ratio);  /* outbuflen isn't total to write, it's total available. */
+    const int maxoutframes = outbuflen / framelen;
+    const int outframes = SDL_min(wantedoutframes, maxoutframes);
+    const int step_frames = inrate / outrate;
+    const int step_fraction = inrate % outrate;
+    const float fraction_scale = 1.0f / ((float) outrate);
+    float *dst = outbuf;
+    int srcindex = 0;
+    int fraction = 0;
+    int i;
+
+    for (i = 0; i < outframes; i++) {
+        const float t = fraction * fraction_scale;
+
+        SDL_ResampleFrame(mode, chans, srcindex, t, lpadding, paddinglen, rpadding, inbuf, inframes, dst);
+        dst += chans;
+
+        srcindex += step_frames;
+        fraction += step_fraction;
+        if (fraction >= outrate) {
+            fraction -= outrate;
+            srcindex++;
+        }
+    }
+
+    return outframes * framelen;
+}
+
 int
 SDL_ConvertAudio(SDL_AudioCVT * cvt)
 {
@@ -704,7 +1202,7 @@ SDL_BuildAudioTypeCVTFromFloat(SDL_AudioCVT *cvt, const SDL_AudioFormat dst_fmt)
 }
 
 static void
-SDL_ResampleCVT(SDL_AudioCVT *cvt, const int chans, const SDL_AudioFormat format)
+SDL_ResampleCVT(SDL_AudioCVT *cvt, const int chans, const SDL_AudioFormat format, const SDL_ResamplerMode mode)
 {
     /* !!! FIXME in 2.1: there are ten slots in the filter list, and the theoretical maximum we use is six (seven with NULL terminator).
        !!! FIXME in 2.1:   We need to store data for this resampler, because the cvt structure doesn't store the original sample rates,
@@ -719,6 +1217,7 @@ SDL_ResampleCVT(SDL_AudioCVT *cvt, const int chans, const SDL_AudioFormat format
     float *dst = (float *) (cvt->buf + srclen);
     const int dstlen = (cvt->len * cvt->len_mult) - srclen;
     const int paddingsamples = (ResamplerPadding(inrate, outrate) * chans);
+    const SDL_PolyphaseTable *table = (mode == RESAMPLER_SINC) ? SDL_GetPolyphaseTable(inrate, outrate, chans) : NULL;
     float *padding;
 
     SDL_assert(format == AUDIO_F32SYS);
@@ -730,7 +1229,13 @@ SDL_ResampleCVT(SDL_AudioCVT *cvt, const int chans, const SDL_AudioFormat format
         return;
     }
 
-    cvt->len_cvt = SDL_ResampleAudio(chans, inrate, outrate, padding, padding, src, srclen, dst, dstlen);
+    if (mode != RESAMPLER_SINC) {
+        cvt->len_cvt = SDL_ResampleAudioInterpolated(mode, chans, inrate, outrate, padding, padding, src, srclen, dst, dstlen);
+    } else if (table) {
+        cvt->len_cvt = SDL_ResampleAudioPolyphase(table, padding, padding, src, srclen, dst, dstlen);
+    } else {
+        cvt->len_cvt = SDL_ResampleAudio(chans, inrate, outrate, padding, padding, src, srclen, dst, dstlen);
+    }
 
     SDL_free(padding);
 
@@ -745,32 +1250,47 @@ SDL_ResampleCVT(SDL_AudioCVT *cvt, const int chans, const SDL_AudioFormat format
    !!! FIXME:  store channel info, so we have to have function entry
    !!! FIXME:  points for each supported channel count and multiple
    !!! FIXME:  vs arbitrary. When we rev the ABI, clean this up. */
-#define RESAMPLER_FUNCS(chans) \
+#define RESAMPLER_FUNCS(name, mode, chans) \
     static void SDLCALL \
-    SDL_ResampleCVT_c##chans(SDL_AudioCVT *cvt, SDL_AudioFormat format) { \
-        SDL_ResampleCVT(cvt, chans, format); \
-    }
-RESAMPLER_FUNCS(1)
-RESAMPLER_FUNCS(2)
-RESAMPLER_FUNCS(4)
-RESAMPLER_FUNCS(6)
-RESAMPLER_FUNCS(8)
+    SDL_ResampleCVT##name##_c##chans(SDL_AudioCVT *cvt, SDL_AudioFormat format) { \
+        SDL_ResampleCVT(cvt, chans, format, mode); \
+    }
+#define RESAMPLER_MODE_FUNCS(name, mode) \
+    RESAMPLER_FUNCS(name, mode, 1) \
+    RESAMPLER_FUNCS(name, mode, 2) \
+    RESAMPLER_FUNCS(name, mode, 4) \
+    RESAMPLER_FUNCS(name, mode, 6) \
+    RESAMPLER_FUNCS(name, mode, 8)
+RESAMPLER_MODE_FUNCS(, RESAMPLER_SINC)
+RESAMPLER_MODE_FUNCS(_Linear, RESAMPLER_LINEAR)
+RESAMPLER_MODE_FUNCS(_Cubic, RESAMPLER_CUBIC)
+RESAMPLER_MODE_FUNCS(_ShortSinc, RESAMPLER_SHORT_SINC)
+#undef RESAMPLER_MODE_FUNCS
 #undef RESAMPLER_FUNCS
 
+#define RESAMPLER_CHOOSE(name) \
+    switch (dst_channels) { \
+        case 1: return SDL_ResampleCVT##name##_c1; \
+        case 2: return SDL_ResampleCVT##name##_c2; \
+        case 4: return SDL_ResampleCVT##name##_c4; \
+        case 6: return SDL_ResampleCVT##name##_c6; \
+        case 8: return SDL_ResampleCVT##name##_c8; \
+        default: break; \
+    }
+
 static SDL_AudioFilter
-ChooseCVTResampler(const int dst_channels)
+ChooseCVTResampler(const int dst_channels, const SDL_ResamplerMode mode)
 {
-    switch (dst_channels) {
-        case 1: return SDL_ResampleCVT_c1;
-        case 2: return SDL_ResampleCVT_c2;
-        case 4: return SDL_ResampleCVT_c4;
-        case 6: return SDL_ResampleCVT_c6;
-        case 8: return SDL_ResampleCVT_c8;
-        default: break;
+    switch (mode) {
+        case RESAMPLER_LINEAR: RESAMPLER_CHOOSE(_Linear); break;
+        case RESAMPLER_CUBIC: RESAMPLER_CHOOSE(_Cubic); break;
+        case RESAMPLER_SHORT_SINC: RESAMPLER_CHOOSE(_ShortSinc); break;
+        default: RESAMPLER_CHOOSE(); break;
     }
 
     return NULL;
 }
+#undef RESAMPLER_CHOOSE
 
 static int
 SDL_BuildAudioResampleCVT(SDL_AudioCVT * cvt, const int dst_channels,
@@ -782,7 +1302,7 @@ SDL_BuildAudioResampleCVT(SDL_AudioCVT * cvt, const int dst_channels,
         return 0;  /* no conversion necessary. */
     }
 
-    filter = ChooseCVTResampler(dst_channels);
+    filter = ChooseCVTResampler(dst_channels, SDL_GetResamplerModeHint());
     if (filter == NULL) {
         return SDL_SetError("No conversion available for these rates");
     }
@@ -1084,7 +1604,11 @@ struct _SDL_AudioStream
 {
     SDL_AudioCVT cvt_before_resampling;
     SDL_AudioCVT cvt_after_resampling;
-    SDL_DataQueue *queue;
+    Uint8 *output_base;  /* maybe unaligned pointer from SDL_malloc(). */
+    Uint8 *output;  /* converted data lives at output[output_start..output_start+output_len). */
+    int output_capacity;
+    int output_start;
+    int output_len;
     SDL_bool first_run;
     Uint8 *staging_buffer;
     int staging_buffer_size;
@@ -1099,19 +1623,25 @@ struct _SDL_AudioStream
     SDL_AudioFormat dst_format;
     Uint8 dst_channels;
     int dst_rate;
-    double rate_incr;
+    double rate_incr;  /* output frames per input frame, including any SDL_AudioStreamSetRateAdjust(). */
+    double resample_position;  /* where the next output frame falls in the next input, for variable rates. */
     Uint8 pre_resample_channels;
     int packetlen;
     int resampler_padding_samples;
     float *resampler_padding;
     void *resampler_state;
+    SDL_ResamplerMode resampler_mode;
+    const SDL_PolyphaseTable *polyphase;
     SDL_ResampleAudioStreamFunc resampler_func;
     SDL_ResetAudioStreamResamplerFunc reset_resampler_func;
     SDL_CleanupAudioStreamResamplerFunc cleanup_resampler_func;
+    SDL_bool collect_stats;  /* time the conversion and resampling steps? */
+    Uint64 convert_ticks;
+    Uint64 resample_ticks;
 };
 
 static Uint8 *
-EnsureStreamBufferSize(SDL_AudioStream *stream, const int newlen)
+EnsureStreamBufferSize(SDL_AudioStream *stream, int newlen)
 {
     Uint8 *ptr;
     size_t offset;
@@ -1119,6 +1649,8 @@ EnsureStreamBufferSize(SDL_AudioStream *stream, const int newlen)
     if (stream->work_buffer_len >= newlen) {
         ptr = stream->work_buffer_base;
     } else {
+        /* grow geometrically, so varying put sizes don't realloc every time. */
+        newlen = SDL_max(newlen, stream->work_buffer_len * 2);
         ptr = (Uint8 *) SDL_realloc(stream->work_buffer_base, newlen + 32);
         if (!ptr) {
             SDL_OutOfMemory();
@@ -1133,6 +1665,56 @@ EnsureStreamBufferSize(SDL_AudioStream *stream, const int newlen)
     return offset ? ptr + (16 - offset) : ptr;
 }
 
+/* Converted data is kept in one contiguous block, so it can be handed out
+   with SDL_AudioStreamPeek() and the last conversion step can write straight
+   into it. Returns a pointer just past the end of the converted data with
+   room for at least len bytes; a put only commits what it really produced,
+   so len can cover intermediate steps that need more space than that. */
+static Uint8 *
+ReserveStreamOutput(SDL_AudioStream *stream, const int len)
+{
+    if (stream->output_len == 0) {
+        stream->output_start = 0;  /* empty? Start over at the aligned front. */
+    }
+
+    if ((stream->output_start + stream->output_len + len) > stream->output_capacity) {
+        const int needed = stream->output_len + len;
+        if (needed <= stream->output_capacity) {
+            /* there's room if we slide what's left down to the front. Readers
+               usually drain most of it, so this doesn't move much. */
+            SDL_memmove(stream->output, stream->output + stream->output_start, stream->output_len);
+        } else {
+            const int capacity = SDL_max(needed, stream->output_capacity * 2);
+            Uint8 *base = (Uint8 *) SDL_malloc(capacity + 16);
+            Uint8 *ptr;
+            if (!base) {
+                SDL_OutOfMemory();
+                return NULL;
+            }
+            /* Make sure we're aligned to 16 bytes for SIMD code. */
+            ptr = base + ((16 - (((size_t) base) & 15)) & 15);
+            if (stream->output_len) {
+                SDL_memcpy(ptr, stream->output + stream->output_start, stream->output_len);
+            }
+            SDL_free(stream->output_base);
+            stream->output_base = base;
+            stream->output = ptr;
+            stream->output_capacity = capacity;
+        }
+        stream->output_start = 0;
+    }
+
+    return stream->output + stream->output_start + stream->output_len;
+}
+
+static void
+ConsumeStreamOutput(SDL_AudioStream *stream, const int len)
+{
+    SDL_assert(len <= stream->output_len);
+    stream->output_start += len;
+    stream->output_len -= len;
+}
+
 #ifdef HAVE_LIBSAMPLERATE_H
 static int
 SDL_ResampleAudioStream_SRC(SDL_AudioStream *stream, const void *_inbuf, const int inbuflen, void *_outbuf, const int outbuflen)
@@ -1234,19 +1816,67 @@ SDL_ResampleAudioStream(SDL_AudioStream *stream, const void *_inbuf, const int i
 
     SDL_assert(inbuf != ((const float *) outbuf));  /* SDL_AudioStreamPut() shouldn't allow in-place resamples. */
 
-    retval = SDL_ResampleAudio(chans, inrate, outrate, lpadding, rpadding, inbuf, inbuflen, outbuf, outbuflen);
+    if (stream->resampler_mode != RESAMPLER_SINC) {
+        retval = SDL_ResampleAudioInterpolated(stream->resampler_mode, chans, inrate, outrate, lpadding, rpadding, inbuf, inbuflen, outbuf, outbuflen);
+    } else if (stream->polyphase) {
+        retval = SDL_ResampleAudioPolyphase(stream->polyphase, lpadding, rpadding, inbuf, inbuflen, outbuf, outbuflen);
+    } else {
+        retval = SDL_ResampleAudio(chans, inrate, outrate, lpadding, rpadding, inbuf, inbuflen, outbuf, outbuflen);
+    }
 
     /* update our left padding with end of current input, for next run. */
     SDL_memcpy((lpadding + paddingsamples) - (cpy / sizeof (float)), inbufend - cpy, cpy);
     return retval;
 }
 
+/* Used instead of SDL_ResampleAudioStream() while the app has the rate
+   adjusted away from nominal. The fixed-rate resamplers start every put at input frame 0 and
+   drop whatever fraction of an output frame is left at the end; this one
+   keeps that fraction in stream->resample_position, so the output stays
+   continuous while the ratio moves around. */
+static int
+SDL_ResampleAudioStreamVariable(SDL_AudioStream *stream, const void *_inbuf, const int inbuflen, void *_outbuf, const int outbuflen)
+{
+    const Uint8 *inbufend = ((const Uint8 *) _inbuf) + inbuflen;
+    const float *inbuf = (const float *) _inbuf;
+    float *dst = (float *) _outbuf;
+    const int chans = (int) stream->pre_resample_channels;
+    const int framelen = chans * (int) sizeof (float);
+    const int inframes = inbuflen / framelen;
+    const int maxoutframes = outbuflen / framelen;
+    const int paddingsamples = stream->resampler_padding_samples;
+    const int paddingbytes = paddingsamples * sizeof (float);
+    float *lpadding = (float *) stream->resampler_state;
+    const float *rpadding = (const float *) inbufend; /* we set this up so there are valid padding samples at the end of the input buffer. */
+    const int cpy = SDL_min(inbuflen, paddingbytes);
+    const double step = 1.0 / stream->rate_incr;
+    double position = stream->resample_position;
+    int outframes = 0;
+
+    SDL_assert(inbuf != ((const float *) dst));  /* SDL_AudioStreamPut() shouldn't allow in-place resamples. */
+
+    while ((position < inframes) && (outframes < maxoutframes)) {
+        const int srcindex = (int) SDL_floor(position);
+        SDL_ResampleFrame(stream->resampler_mode, chans, srcindex, (float) (position - srcindex),
+                          lpadding, paddingsamples / chans, rpadding, inbuf, inframes, dst);
+        dst += chans;
+        outframes++;
+        position += step;
+    }
+    stream->resample_position = position - inframes;
+
+    /* update our left padding with end of current input, for next run. */
+    SDL_memcpy((lpadding + paddingsamples) - (cpy / sizeof (float)), inbufend - cpy, cpy);
+    return outframes * framelen;
+}
+
 static void
 SDL_ResetAudioStreamResampler(SDL_AudioStream *stream)
 {
     /* set all the padding to silence. */
     const int len = stream->resampler_padding_samples;
     SDL_memset(stream->resampler_state, '\0', len * sizeof (float));
+    stream->resample_position = 0.0;
 }
 
 static void
@@ -1343,6 +1973,10 @@ SDL_NewAudioStream(const SDL_AudioFormat src_format,
                 return NULL;
             }
 
+            retval->resampler_mode = SDL_GetResamplerModeHint();
+            if (retval->resampler_mode == RESAMPLER_SINC) {
+                retval->polyphase = SDL_GetPolyphaseTable(src_rate, dst_rate, pre_resample_channels);
+            }
             retval->resampler_func = SDL_ResampleAudioStream;
             retval->reset_resampler_func = SDL_ResetAudioStreamResampler;
             retval->cleanup_resampler_func = SDL_CleanupAudioStreamResampler;
@@ -1355,10 +1989,9 @@ SDL_NewAudioStream(const SDL_AudioFormat src_format,
         }
     }
 
-    retval->queue = SDL_NewDataQueue(packetlen, packetlen * 2);
-    if (!retval->queue) {
+    if (!ReserveStreamOutput(retval, packetlen * 2)) {
         SDL_FreeAudioStream(retval);
-        return NULL;  /* SDL_NewDataQueue should have called SDL_SetError. */
+        return NULL;  /* ReserveStreamOutput should have called SDL_SetError. */
     }
 
     return retval;
@@ -1367,10 +2000,12 @@ SDL_NewAudioStream(const SDL_AudioFormat src_format,
 static int
 SDL_AudioStreamPutInternal(SDL_AudioStream *stream, const void *buf, int len, int *maxputbytes)
 {
+    const SDL_bool resampling = (stream->dst_rate != stream->src_rate);
     int buflen = len;
-    int workbuflen;
-    Uint8 *workbuf;
-    Uint8 *resamplebuf = NULL;
+    int workbuflen = 0;
+    Uint8 *workbuf = NULL;
+    int outbuflen;
+    Uint8 *outbuf;
     int resamplebuflen = 0;
     int neededpaddingbytes;
     int paddingbytes;
@@ -1388,57 +2023,73 @@ SDL_AudioStreamPutInternal(SDL_AudioStream *stream, const void *buf, int len, in
     paddingbytes = stream->first_run ? 0 : neededpaddingbytes;
     stream->first_run = SDL_FALSE;
 
-    /* Make sure the work buffer can hold all the data we need at once... */
-    workbuflen = buflen;
-    if (stream->cvt_before_resampling.needed) {
-        workbuflen *= stream->cvt_before_resampling.len_mult;
-    }
-
-    if (stream->dst_rate != stream->src_rate) {
-        /* resamples can't happen in place, so make space for second buf. */
+    /* The last step writes straight into the output block, so we only need
+       the work buffer for the steps before the resampler, which can't
+       work in place. */
+    outbuflen = buflen;
+    if (resampling) {
         const int framesize = stream->pre_resample_channels * sizeof (float);
-        const int frames = workbuflen / framesize;
+        int frames;
+
+        workbuflen = buflen;
+        if (stream->cvt_before_resampling.needed) {
+            workbuflen *= stream->cvt_before_resampling.len_mult;
+        }
+
+        frames = workbuflen / framesize;
         resamplebuflen = ((int) SDL_ceil(frames * stream->rate_incr)) * framesize;
+        if (stream->resampler_func == SDL_ResampleAudioStreamVariable) {
+            resamplebuflen += framesize;  /* for the fraction a variable rate carries over. */
+        }
         #if DEBUG_AUDIOSTREAM
         printf("AUDIOSTREAM: will resample %d bytes to %d (ratio=%.6f)\n", workbuflen, resamplebuflen, stream->rate_incr);
         #endif
-        workbuflen += resamplebuflen;
+        workbuflen += neededpaddingbytes;
+        outbuflen = resamplebuflen;
     }
 
     if (stream->cvt_after_resampling.needed) {
-        /* !!! FIXME: buffer might be big enough already? */
-        workbuflen *= stream->cvt_after_resampling.len_mult;
+        outbuflen *= stream->cvt_after_resampling.len_mult;
     }
 
-    workbuflen += neededpaddingbytes;
-
     #if DEBUG_AUDIOSTREAM
-    printf("AUDIOSTREAM: Putting %d bytes of preconverted audio, need %d byte work buffer\n", buflen, workbuflen);
+    printf("AUDIOSTREAM: Putting %d bytes of preconverted audio, need %d byte work buffer and %d output bytes\n", buflen, workbuflen, outbuflen);
     #endif
 
-    workbuf = EnsureStreamBufferSize(stream, workbuflen);
-    if (!workbuf) {
-        return -1;  /* probably out of memory. */
+    if (resampling) {
+        workbuf = EnsureStreamBufferSize(stream, workbuflen);
+        if (!workbuf) {
+            return -1;  /* probably out of memory. */
+        }
     }
 
-    resamplebuf = workbuf;  /* default if not resampling. */
+    outbuf = ReserveStreamOutput(stream, outbuflen);
+    if (!outbuf) {
+        return -1;  /* probably out of memory. */
+    }
 
-    SDL_memcpy(workbuf + paddingbytes, buf, buflen);
+    if (!resampling) {
+        SDL_memcpy(outbuf, buf, buflen);
+    } else {
+        SDL_memcpy(workbuf + paddingbytes, buf, buflen);
+
+        if (stream->cvt_before_resampling.needed) {
+            const Uint64 start = stream->collect_stats ? SDL_GetPerformanceCounter() : 0;
+            stream->cvt_before_resampling.buf = workbuf + paddingbytes;
+            stream->cvt_before_resampling.len = buflen;
+            if (SDL_ConvertAudio(&stream->cvt_before_resampling) == -1) {
+                return -1;   /* uhoh! */
+            }
+            buflen = stream->cvt_before_resampling.len_cvt;
+            if (stream->collect_stats) {
+                stream->convert_ticks += SDL_GetPerformanceCounter() - start;
+            }
 
-    if (stream->cvt_before_resampling.needed) {
-        stream->cvt_before_resampling.buf = workbuf + paddingbytes;
-        stream->cvt_before_resampling.len = buflen;
-        if (SDL_ConvertAudio(&stream->cvt_before_resampling) == -1) {
-            return -1;   /* uhoh! */
+            #if DEBUG_AUDIOSTREAM
+            printf("AUDIOSTREAM: After initial conversion we have %d bytes\n", buflen);
+            #endif
         }
-        buflen = stream->cvt_before_resampling.len_cvt;
 
-        #if DEBUG_AUDIOSTREAM
-        printf("AUDIOSTREAM: After initial conversion we have %d bytes\n", buflen);
-        #endif
-    }
-
-    if (stream->dst_rate != stream->src_rate) {
         /* save off some samples at the end; they are used for padding now so
            the resampler is coherent and then used at the start of the next
            put operation. Prepend last put operation's padding, too. */
@@ -1452,10 +2103,13 @@ SDL_AudioStreamPutInternal(SDL_AudioStream *stream, const void *buf, int len, in
         /* save off the data at the end for the next run. */
         SDL_memcpy(stream->resampler_padding, workbuf + (buflen - neededpaddingbytes), neededpaddingbytes);
 
-        resamplebuf = workbuf + buflen;  /* skip to second piece of workbuf. */
         SDL_assert(buflen >= neededpaddingbytes);
         if (buflen > neededpaddingbytes) {
-            buflen = stream->resampler_func(stream, workbuf, buflen - neededpaddingbytes, resamplebuf, resamplebuflen);
+            const Uint64 start = stream->collect_stats ? SDL_GetPerformanceCounter() : 0;
+            buflen = stream->resampler_func(stream, workbuf, buflen - neededpaddingbytes, outbuf, resamplebuflen);
+            if (stream->collect_stats) {
+                stream->resample_ticks += SDL_GetPerformanceCounter() - start;
+            }
         } else {
             buflen = 0;
         }
@@ -1466,12 +2120,16 @@ SDL_AudioStreamPutInternal(SDL_AudioStream *stream, const void *buf, int len, in
     }
 
     if (stream->cvt_after_resampling.needed && (buflen > 0)) {
-        stream->cvt_after_resampling.buf = resamplebuf;
+        const Uint64 start = stream->collect_stats ? SDL_GetPerformanceCounter() : 0;
+        stream->cvt_after_resampling.buf = outbuf;
         stream->cvt_after_resampling.len = buflen;
         if (SDL_ConvertAudio(&stream->cvt_after_resampling) == -1) {
             return -1;   /* uhoh! */
         }
         buflen = stream->cvt_after_resampling.len_cvt;
+        if (stream->collect_stats) {
+            stream->convert_ticks += SDL_GetPerformanceCounter() - start;
+        }
 
         #if DEBUG_AUDIOSTREAM
         printf("AUDIOSTREAM: After final conversion we have %d bytes\n", buflen);
@@ -1489,8 +2147,9 @@ SDL_AudioStreamPutInternal(SDL_AudioStream *stream, const void *buf, int len, in
         *maxputbytes -= buflen;
     }
 
-    /* resamplebuf holds the final output, even if we didn't resample. */
-    return buflen ? SDL_WriteToDataQueue(stream->queue, resamplebuf, buflen) : 0;
+    /* outbuf holds the final output, right where the reader will find it. */
+    stream->output_len += buflen;
+    return 0;
 }
 
 int
@@ -1521,10 +2180,17 @@ SDL_AudioStreamPut(SDL_AudioStream *stream, const void *buf, int len)
     if (!stream->cvt_before_resampling.needed &&
         (stream->dst_rate == stream->src_rate) &&
         !stream->cvt_after_resampling.needed) {
+        Uint8 *outbuf;
         #if DEBUG_AUDIOSTREAM
         printf("AUDIOSTREAM: no conversion needed at all, queueing %d bytes.\n", len);
         #endif
-        return SDL_WriteToDataQueue(stream->queue, buf, len);
+        outbuf = ReserveStreamOutput(stream, len);
+        if (!outbuf) {
+            return -1;
+        }
+        SDL_memcpy(outbuf, buf, len);
+        stream->output_len += len;
+        return 0;
     }
 
     while (len > 0) {
@@ -1628,14 +2294,93 @@ SDL_AudioStreamGet(SDL_AudioStream *stream, void *buf, int len)
         return SDL_SetError("Can't request partial sample frames");
     }
 
-    return (int) SDL_ReadFromDataQueue(stream->queue, buf, len);
+    len = SDL_min(len, stream->output_len);
+    SDL_memcpy(buf, stream->output + stream->output_start, len);
+    ConsumeStreamOutput(stream, len);
+    return len;
+}
+
+/* look at converted/resampled data without copying it out */
+int
+SDL_AudioStreamPeek(SDL_AudioStream *stream, const void **buf)
+{
+    if (!stream) {
+        return SDL_InvalidParamError("stream");
+    } else if (!buf) {
+        return SDL_InvalidParamError("buf");
+    }
+
+    *buf = stream->output + stream->output_start;
+    return stream->output_len;
+}
+
+/* drop data that the app read with SDL_AudioStreamPeek() */
+int
+SDL_AudioStreamCommit(SDL_AudioStream *stream, int len)
+{
+    if (!stream) {
+        return SDL_InvalidParamError("stream");
+    } else if ((len < 0) || (len > stream->output_len)) {
+        return SDL_InvalidParamError("len");
+    } else if ((len % stream->dst_sample_frame_size) != 0) {
+        return SDL_SetError("Can't commit partial sample frames");
+    }
+
+    ConsumeStreamOutput(stream, len);
+    return 0;
+}
+
+/* nudge the resampling ratio of a live stream */
+int
+SDL_AudioStreamSetRateAdjust(SDL_AudioStream *stream, float adjust)
+{
+    if (!stream) {
+        return SDL_InvalidParamError("stream");
+    } else if (stream->src_rate == stream->dst_rate) {
+        return SDL_SetError("Stream doesn't resample");
+    } else if ((adjust < 0.9f) || (adjust > 1.1f)) {
+        return SDL_InvalidParamError("adjust");
+    }
+
+    /* libsamplerate picks up a new ratio smoothly by itself; our own
+       resamplers switch to the one that keeps its position between puts,
+       and back to the fixed-rate one once the ratio is nominal again. */
+    if (adjust == 1.0f) {
+        stream->rate_incr = ((double) stream->dst_rate) / ((double) stream->src_rate);
+        if (stream->resampler_func == SDL_ResampleAudioStreamVariable) {
+            stream->resampler_func = SDL_ResampleAudioStream;
+            stream->resample_position = 0.0;
+        }
+    } else {
+        stream->rate_incr = ((double) stream->dst_rate) / (((double) stream->src_rate) * adjust);
+        if (stream->resampler_func == SDL_ResampleAudioStream) {
+            stream->resampler_func = SDL_ResampleAudioStreamVariable;
+        }
+    }
+    return 0;
+}
+
+/* start timing the conversion and resampling steps, for the device thread */
+void
+SDL_AudioStreamCollectStats(SDL_AudioStream *stream)
+{
+    stream->collect_stats = SDL_TRUE;
+}
+
+/* hand over the time spent since the last call, in performance counter ticks */
+void
+SDL_AudioStreamTakeStats(SDL_AudioStream *stream, Uint64 *convert_ticks, Uint64 *resample_ticks)
+{
+    *convert_ticks = stream->convert_ticks;
+    *resample_ticks = stream->resample_ticks;
+    stream->convert_ticks = stream->resample_ticks = 0;
 }
 
 /* number of converted/resampled bytes available */
 int
 SDL_AudioStreamAvailable(SDL_AudioStream *stream)
 {
-    return stream ? (int) SDL_CountDataQueue(stream->queue) : 0;
+    return stream ? stream->output_len : 0;
 }
 
 void
@@ -1644,7 +2389,7 @@ SDL_AudioStreamClear(SDL_AudioStream *stream)
     if (!stream) {
         SDL_InvalidParamError("stream");
     } else {
-        SDL_ClearDataQueue(stream->queue, stream->packetlen * 2);
+        stream->output_start = stream->output_len = 0;
         if (stream->reset_resampler_func) {
             stream->reset_resampler_func(stream);
         }
@@ -1661,7 +2406,7 @@ SDL_FreeAudioStream(SDL_AudioStream *stream)
         if (stream->cleanup_resampler_func) {
             stream->cleanup_resampler_func(stream);
         }
-        SDL_FreeDataQueue(stream->queue);
+        SDL_free(stream->output_base);
         SDL_free(stream->staging_buffer);
         SDL_free(stream->work_buffer_base);
         SDL_free(stream->resampler_padding);
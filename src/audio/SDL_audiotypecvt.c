@@ -25,13 +25,15 @@
 #include "SDL_cpuinfo.h"
 #include "SDL_assert.h"
 
-/* !!! FIXME: write NEON code. */
-#define HAVE_NEON_INTRINSICS 0
-
 #ifdef __SSE2__
 #define HAVE_SSE2_INTRINSICS 1
 #endif
 
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define HAVE_NEON_INTRINSICS 1
+#include <arm_neon.h>
+#endif
+
 #if defined(__x86_64__) && HAVE_SSE2_INTRINSICS
 #define NEED_SCALAR_CONVERTER_FALLBACKS 0  /* x86_64 guarantees SSE2. */
 #elif __MACOSX__ && HAVE_SSE2_INTRINSICS
@@ -481,7 +483,7 @@ SDL_Convert_U16_to_F32_SSE2(SDL_AudioCVT *cvt, SDL_AudioFormat format)
     if ((((size_t) src) & 15) == 0) {
         /* Aligned! Do SSE blocks as long as we have 16 bytes available. */
         const __m128 divby32768 = _mm_set1_ps(DIVBY32768);
-        const __m128 minus1 = _mm_set1_ps(1.0f);
+        const __m128 minus1 = _mm_set1_ps(-1.0f);
         while (i >= 8) {   /* 8 * 16-bit */
             const __m128i ints = _mm_load_si128((__m128i const *) src);  /* get 8 sint16 into an XMM register. */
             /* treat as int32, shift left to clear every other sint16, then back right with zero-extend. Now sint32. */
@@ -778,6 +780,425 @@ SDL_Convert_F32_to_S32_SSE2(SDL_AudioCVT *cvt, SDL_AudioFormat format)
 }
 #endif
 
+#if HAVE_NEON_INTRINSICS
+/* Unlike the SSE2 converters, these truncate and clip exactly like the
+   scalar versions do, so the output doesn't depend on which path a sample
+   happened to take. NEON loads and stores don't need aligned addresses. */
+static void SDLCALL
+SDL_Convert_S8_to_F32_NEON(SDL_AudioCVT *cvt, SDL_AudioFormat format)
+{
+    const Sint8 *src = ((const Sint8 *) (cvt->buf + cvt->len_cvt)) - 1;
+    float *dst = ((float *) (cvt->buf + cvt->len_cvt * 4)) - 1;
+    int i = cvt->len_cvt;
+
+    LOG_DEBUG_CONVERT("AUDIO_S8", "AUDIO_F32 (using NEON)");
+
+    src -= 15; dst -= 15;  /* adjust to read NEON blocks from the start. */
+
+    {
+        /* The buffer is growing, so work back from the end, 16 samples at a time. */
+        const float32x4_t divby128 = vdupq_n_f32(DIVBY128);
+        while (i >= 16) {   /* 16 * 8-bit */
+            const int8x16_t bytes = vld1q_s8(src);  /* get 16 sint8 into a NEON register. */
+            /* sign-extend to sint16, then again to sint32, convert to float, multiply. */
+            const int16x8_t shorts1 = vmovl_s8(vget_low_s8(bytes));
+            const int16x8_t shorts2 = vmovl_s8(vget_high_s8(bytes));
+            vst1q_f32(dst, vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(shorts1))), divby128));
+            vst1q_f32(dst+4, vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(shorts1))), divby128));
+            vst1q_f32(dst+8, vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(shorts2))), divby128));
+            vst1q_f32(dst+12, vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(shorts2))), divby128));
+            i -= 16; src -= 16; dst -= 16;
+        }
+    }
+
+    src += 15; dst += 15;  /* adjust for any scalar finishing. */
+
+    /* Finish off any leftovers with scalar operations. */
+    while (i) {
+        *dst = ((float) *src) * DIVBY128;
+        i--; src--; dst--;
+    }
+
+    cvt->len_cvt *= 4;
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index](cvt, AUDIO_F32SYS);
+    }
+}
+
+static void SDLCALL
+SDL_Convert_U8_to_F32_NEON(SDL_AudioCVT *cvt, SDL_AudioFormat format)
+{
+    const Uint8 *src = ((const Uint8 *) (cvt->buf + cvt->len_cvt)) - 1;
+    float *dst = ((float *) (cvt->buf + cvt->len_cvt * 4)) - 1;
+    int i = cvt->len_cvt;
+
+    LOG_DEBUG_CONVERT("AUDIO_U8", "AUDIO_F32 (using NEON)");
+
+    src -= 15; dst -= 15;  /* adjust to read NEON blocks from the start. */
+
+    {
+        /* The buffer is growing, so work back from the end, 16 samples at a time. */
+        const float32x4_t divby128 = vdupq_n_f32(DIVBY128);
+        const float32x4_t minus1 = vdupq_n_f32(-1.0f);
+        while (i >= 16) {   /* 16 * 8-bit */
+            const uint8x16_t bytes = vld1q_u8(src);  /* get 16 uint8 into a NEON register. */
+            /* zero-extend to uint16, then again to uint32, convert to float, multiply, add. */
+            const uint16x8_t shorts1 = vmovl_u8(vget_low_u8(bytes));
+            const uint16x8_t shorts2 = vmovl_u8(vget_high_u8(bytes));
+            vst1q_f32(dst, vaddq_f32(vmulq_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(shorts1))), divby128), minus1));
+            vst1q_f32(dst+4, vaddq_f32(vmulq_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(shorts1))), divby128), minus1));
+            vst1q_f32(dst+8, vaddq_f32(vmulq_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(shorts2))), divby128), minus1));
+            vst1q_f32(dst+12, vaddq_f32(vmulq_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(shorts2))), divby128), minus1));
+            i -= 16; src -= 16; dst -= 16;
+        }
+    }
+
+    src += 15; dst += 15;  /* adjust for any scalar finishing. */
+
+    /* Finish off any leftovers with scalar operations. */
+    while (i) {
+        *dst = (((float) *src) * DIVBY128) - 1.0f;
+        i--; src--; dst--;
+    }
+
+    cvt->len_cvt *= 4;
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index](cvt, AUDIO_F32SYS);
+    }
+}
+
+static void SDLCALL
+SDL_Convert_S16_to_F32_NEON(SDL_AudioCVT *cvt, SDL_AudioFormat format)
+{
+    const Sint16 *src = ((const Sint16 *) (cvt->buf + cvt->len_cvt)) - 1;
+    float *dst = ((float *) (cvt->buf + cvt->len_cvt * 2)) - 1;
+    int i = cvt->len_cvt / sizeof (Sint16);
+
+    LOG_DEBUG_CONVERT("AUDIO_S16", "AUDIO_F32 (using NEON)");
+
+    src -= 7; dst -= 7;  /* adjust to read NEON blocks from the start. */
+
+    {
+        /* The buffer is growing, so work back from the end, 8 samples at a time. */
+        const float32x4_t divby32768 = vdupq_n_f32(DIVBY32768);
+        while (i >= 8) {   /* 8 * 16-bit */
+            const int16x8_t ints = vld1q_s16(src);  /* get 8 sint16 into a NEON register. */
+            /* sign-extend to sint32, convert to float, multiply, store. */
+            vst1q_f32(dst, vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(ints))), divby32768));
+            vst1q_f32(dst+4, vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(ints))), divby32768));
+            i -= 8; src -= 8; dst -= 8;
+        }
+    }
+
+    src += 7; dst += 7;  /* adjust for any scalar finishing. */
+
+    /* Finish off any leftovers with scalar operations. */
+    while (i) {
+        *dst = ((float) *src) * DIVBY32768;
+        i--; src--; dst--;
+    }
+
+    cvt->len_cvt *= 2;
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index](cvt, AUDIO_F32SYS);
+    }
+}
+
+static void SDLCALL
+SDL_Convert_U16_to_F32_NEON(SDL_AudioCVT *cvt, SDL_AudioFormat format)
+{
+    const Uint16 *src = ((const Uint16 *) (cvt->buf + cvt->len_cvt)) - 1;
+    float *dst = ((float *) (cvt->buf + cvt->len_cvt * 2)) - 1;
+    int i = cvt->len_cvt / sizeof (Uint16);
+
+    LOG_DEBUG_CONVERT("AUDIO_U16", "AUDIO_F32 (using NEON)");
+
+    src -= 7; dst -= 7;  /* adjust to read NEON blocks from the start. */
+
+    {
+        /* The buffer is growing, so work back from the end, 8 samples at a time. */
+        const float32x4_t divby32768 = vdupq_n_f32(DIVBY32768);
+        const float32x4_t minus1 = vdupq_n_f32(-1.0f);
+        while (i >= 8) {   /* 8 * 16-bit */
+            const uint16x8_t ints = vld1q_u16(src);  /* get 8 uint16 into a NEON register. */
+            /* zero-extend to uint32, convert to float, multiply, add, store. */
+            vst1q_f32(dst, vaddq_f32(vmulq_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(ints))), divby32768), minus1));
+            vst1q_f32(dst+4, vaddq_f32(vmulq_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(ints))), divby32768), minus1));
+            i -= 8; src -= 8; dst -= 8;
+        }
+    }
+
+    src += 7; dst += 7;  /* adjust for any scalar finishing. */
+
+    /* Finish off any leftovers with scalar operations. */
+    while (i) {
+        *dst = (((float) *src) * DIVBY32768) - 1.0f;
+        i--; src--; dst--;
+    }
+
+    cvt->len_cvt *= 2;
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index](cvt, AUDIO_F32SYS);
+    }
+}
+
+static void SDLCALL
+SDL_Convert_S32_to_F32_NEON(SDL_AudioCVT *cvt, SDL_AudioFormat format)
+{
+    const Sint32 *src = (const Sint32 *) cvt->buf;
+    float *dst = (float *) cvt->buf;
+    int i = cvt->len_cvt / sizeof (Sint32);
+
+    LOG_DEBUG_CONVERT("AUDIO_S32", "AUDIO_F32 (using NEON)");
+
+    {
+        /* Converting to float rounds the same way the scalar path's trip
+           through double does, and scaling by a power of two is exact, so
+           we don't need double precision for this one. */
+        const float32x4_t divby2147483648 = vdupq_n_f32((float) DIVBY2147483648);
+        while (i >= 4) {   /* 4 * sint32 */
+            vst1q_f32(dst, vmulq_f32(vcvtq_f32_s32(vld1q_s32(src)), divby2147483648));
+            i -= 4; src += 4; dst += 4;
+        }
+    }
+
+    /* Finish off any leftovers with scalar operations. */
+    while (i) {
+        *dst = (float) (((double) *src) * DIVBY2147483648);
+        i--; src++; dst++;
+    }
+
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index](cvt, AUDIO_F32SYS);
+    }
+}
+
+static void SDLCALL
+SDL_Convert_F32_to_S8_NEON(SDL_AudioCVT *cvt, SDL_AudioFormat format)
+{
+    const float *src = (const float *) cvt->buf;
+    Sint8 *dst = (Sint8 *) cvt->buf;
+    int i = cvt->len_cvt / sizeof (float);
+
+    LOG_DEBUG_CONVERT("AUDIO_F32", "AUDIO_S8 (using NEON)");
+
+    {
+        /* clamp to [-1, 1], multiply, truncate to sint32, narrow. */
+        const float32x4_t one = vdupq_n_f32(1.0f);
+        const float32x4_t minus1 = vdupq_n_f32(-1.0f);
+        const float32x4_t mulby127 = vdupq_n_f32(127.0f);
+        while (i >= 16) {   /* 16 * float32 */
+            const int32x4_t ints1 = vcvtq_s32_f32(vmulq_f32(vminq_f32(vmaxq_f32(vld1q_f32(src), minus1), one), mulby127));
+            const int32x4_t ints2 = vcvtq_s32_f32(vmulq_f32(vminq_f32(vmaxq_f32(vld1q_f32(src+4), minus1), one), mulby127));
+            const int32x4_t ints3 = vcvtq_s32_f32(vmulq_f32(vminq_f32(vmaxq_f32(vld1q_f32(src+8), minus1), one), mulby127));
+            const int32x4_t ints4 = vcvtq_s32_f32(vmulq_f32(vminq_f32(vmaxq_f32(vld1q_f32(src+12), minus1), one), mulby127));
+            const int16x8_t shorts1 = vcombine_s16(vmovn_s32(ints1), vmovn_s32(ints2));
+            const int16x8_t shorts2 = vcombine_s16(vmovn_s32(ints3), vmovn_s32(ints4));
+            vst1q_s8(dst, vcombine_s8(vmovn_s16(shorts1), vmovn_s16(shorts2)));  /* pack down, store out. */
+            i -= 16; src += 16; dst += 16;
+        }
+    }
+
+    /* Finish off any leftovers with scalar operations. */
+    while (i) {
+        const float sample = *src;
+        if (sample > 1.0f) {
+            *dst = 127;
+        } else if (sample < -1.0f) {
+            *dst = -127;
+        } else {
+            *dst = (Sint8)(sample * 127.0f);
+        }
+        i--; src++; dst++;
+    }
+
+    cvt->len_cvt /= 4;
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index](cvt, AUDIO_S8);
+    }
+}
+
+static void SDLCALL
+SDL_Convert_F32_to_U8_NEON(SDL_AudioCVT *cvt, SDL_AudioFormat format)
+{
+    const float *src = (const float *) cvt->buf;
+    Uint8 *dst = (Uint8 *) cvt->buf;
+    int i = cvt->len_cvt / sizeof (float);
+
+    LOG_DEBUG_CONVERT("AUDIO_F32", "AUDIO_U8 (using NEON)");
+
+    {
+        /* clamp to [-1, 1], add one, multiply, truncate to uint32, narrow.
+           The scalar path clips anything over 1.0 to 255, not 254, so
+           patch those lanes in with a mask. */
+        const float32x4_t one = vdupq_n_f32(1.0f);
+        const float32x4_t minus1 = vdupq_n_f32(-1.0f);
+        const float32x4_t mulby127 = vdupq_n_f32(127.0f);
+        const uint32x4_t max = vdupq_n_u32(255);
+        while (i >= 16) {   /* 16 * float32 */
+            const float32x4_t floats1 = vld1q_f32(src);
+            const float32x4_t floats2 = vld1q_f32(src+4);
+            const float32x4_t floats3 = vld1q_f32(src+8);
+            const float32x4_t floats4 = vld1q_f32(src+12);
+            const uint32x4_t ints1 = vbslq_u32(vcgtq_f32(floats1, one), max, vcvtq_u32_f32(vmulq_f32(vaddq_f32(vminq_f32(vmaxq_f32(floats1, minus1), one), one), mulby127)));
+            const uint32x4_t ints2 = vbslq_u32(vcgtq_f32(floats2, one), max, vcvtq_u32_f32(vmulq_f32(vaddq_f32(vminq_f32(vmaxq_f32(floats2, minus1), one), one), mulby127)));
+            const uint32x4_t ints3 = vbslq_u32(vcgtq_f32(floats3, one), max, vcvtq_u32_f32(vmulq_f32(vaddq_f32(vminq_f32(vmaxq_f32(floats3, minus1), one), one), mulby127)));
+            const uint32x4_t ints4 = vbslq_u32(vcgtq_f32(floats4, one), max, vcvtq_u32_f32(vmulq_f32(vaddq_f32(vminq_f32(vmaxq_f32(floats4, minus1), one), one), mulby127)));
+            const uint16x8_t shorts1 = vcombine_u16(vmovn_u32(ints1), vmovn_u32(ints2));
+            const uint16x8_t shorts2 = vcombine_u16(vmovn_u32(ints3), vmovn_u32(ints4));
+            vst1q_u8(dst, vcombine_u8(vmovn_u16(shorts1), vmovn_u16(shorts2)));  /* pack down, store out. */
+            i -= 16; src += 16; dst += 16;
+        }
+    }
+
+    /* Finish off any leftovers with scalar operations. */
+    while (i) {
+        const float sample = *src;
+        if (sample > 1.0f) {
+            *dst = 255;
+        } else if (sample < -1.0f) {
+            *dst = 0;
+        } else {
+            *dst = (Uint8)((sample + 1.0f) * 127.0f);
+        }
+        i--; src++; dst++;
+    }
+
+    cvt->len_cvt /= 4;
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index](cvt, AUDIO_U8);
+    }
+}
+
+static void SDLCALL
+SDL_Convert_F32_to_S16_NEON(SDL_AudioCVT *cvt, SDL_AudioFormat format)
+{
+    const float *src = (const float *) cvt->buf;
+    Sint16 *dst = (Sint16 *) cvt->buf;
+    int i = cvt->len_cvt / sizeof (float);
+
+    LOG_DEBUG_CONVERT("AUDIO_F32", "AUDIO_S16 (using NEON)");
+
+    {
+        /* clamp to [-1, 1], multiply, truncate to sint32, narrow. */
+        const float32x4_t one = vdupq_n_f32(1.0f);
+        const float32x4_t minus1 = vdupq_n_f32(-1.0f);
+        const float32x4_t mulby32767 = vdupq_n_f32(32767.0f);
+        while (i >= 8) {   /* 8 * float32 */
+            const int32x4_t ints1 = vcvtq_s32_f32(vmulq_f32(vminq_f32(vmaxq_f32(vld1q_f32(src), minus1), one), mulby32767));
+            const int32x4_t ints2 = vcvtq_s32_f32(vmulq_f32(vminq_f32(vmaxq_f32(vld1q_f32(src+4), minus1), one), mulby32767));
+            vst1q_s16(dst, vcombine_s16(vmovn_s32(ints1), vmovn_s32(ints2)));  /* pack to sint16, store out. */
+            i -= 8; src += 8; dst += 8;
+        }
+    }
+
+    /* Finish off any leftovers with scalar operations. */
+    while (i) {
+        const float sample = *src;
+        if (sample > 1.0f) {
+            *dst = 32767;
+        } else if (sample < -1.0f) {
+            *dst = -32767;
+        } else {
+            *dst = (Sint16)(sample * 32767.0f);
+        }
+        i--; src++; dst++;
+    }
+
+    cvt->len_cvt /= 2;
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index](cvt, AUDIO_S16SYS);
+    }
+}
+
+static void SDLCALL
+SDL_Convert_F32_to_U16_NEON(SDL_AudioCVT *cvt, SDL_AudioFormat format)
+{
+    const float *src = (const float *) cvt->buf;
+    Uint16 *dst = (Uint16 *) cvt->buf;
+    int i = cvt->len_cvt / sizeof (float);
+
+    LOG_DEBUG_CONVERT("AUDIO_F32", "AUDIO_U16 (using NEON)");
+
+    {
+        /* clamp to [-1, 1], add one, multiply, truncate to uint32, narrow.
+           Unlike SSE2, NEON can narrow to unsigned 16-bit directly. */
+        const float32x4_t one = vdupq_n_f32(1.0f);
+        const float32x4_t minus1 = vdupq_n_f32(-1.0f);
+        const float32x4_t mulby32767 = vdupq_n_f32(32767.0f);
+        while (i >= 8) {   /* 8 * float32 */
+            const uint32x4_t ints1 = vcvtq_u32_f32(vmulq_f32(vaddq_f32(vminq_f32(vmaxq_f32(vld1q_f32(src), minus1), one), one), mulby32767));
+            const uint32x4_t ints2 = vcvtq_u32_f32(vmulq_f32(vaddq_f32(vminq_f32(vmaxq_f32(vld1q_f32(src+4), minus1), one), one), mulby32767));
+            vst1q_u16(dst, vcombine_u16(vmovn_u32(ints1), vmovn_u32(ints2)));  /* pack to uint16, store out. */
+            i -= 8; src += 8; dst += 8;
+        }
+    }
+
+    /* Finish off any leftovers with scalar operations. */
+    while (i) {
+        const float sample = *src;
+        if (sample > 1.0f) {
+            *dst = 65534;
+        } else if (sample < -1.0f) {
+            *dst = 0;
+        } else {
+            *dst = (Uint16)((sample + 1.0f) * 32767.0f);
+        }
+        i--; src++; dst++;
+    }
+
+    cvt->len_cvt /= 2;
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index](cvt, AUDIO_U16SYS);
+    }
+}
+
+static void SDLCALL
+SDL_Convert_F32_to_S32_NEON(SDL_AudioCVT *cvt, SDL_AudioFormat format)
+{
+    const float *src = (const float *) cvt->buf;
+    Sint32 *dst = (Sint32 *) cvt->buf;
+    int i = cvt->len_cvt / sizeof (float);
+
+    LOG_DEBUG_CONVERT("AUDIO_F32", "AUDIO_S32 (using NEON)");
+
+#ifdef __aarch64__
+    {
+        /* The scalar path multiplies in double precision, and a float only
+           holds 24 bits, so widen to double here too. 32-bit ARM NEON has no
+           double lanes, so it does this one with scalar operations. */
+        const float32x4_t one = vdupq_n_f32(1.0f);
+        const float32x4_t minus1 = vdupq_n_f32(-1.0f);
+        const float64x2_t mulby2147483647 = vdupq_n_f64(2147483647.0);
+        while (i >= 4) {   /* 4 * float32 */
+            const float32x4_t floats = vminq_f32(vmaxq_f32(vld1q_f32(src), minus1), one);
+            const float64x2_t doubles1 = vmulq_f64(vcvt_f64_f32(vget_low_f32(floats)), mulby2147483647);
+            const float64x2_t doubles2 = vmulq_f64(vcvt_high_f64_f32(floats), mulby2147483647);
+            vst1q_s32(dst, vcombine_s32(vmovn_s64(vcvtq_s64_f64(doubles1)), vmovn_s64(vcvtq_s64_f64(doubles2))));
+            i -= 4; src += 4; dst += 4;
+        }
+    }
+#endif
+
+    /* Finish off any leftovers with scalar operations. */
+    while (i) {
+        const float sample = *src;
+        if (sample > 1.0f) {
+            *dst = 2147483647;
+        } else if (sample < -1.0f) {
+            *dst = -2147483647;
+        } else {
+            *dst = (Sint32)((double)sample * 2147483647.0);
+        }
+        i--; src++; dst++;
+    }
+
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index](cvt, AUDIO_S32SYS);
+    }
+}
+#endif
+
 
 void SDL_ChooseAudioConverters(void)
 {
@@ -807,6 +1228,13 @@ void SDL_ChooseAudioConverters(void)
     }
 #endif
 
+#if HAVE_NEON_INTRINSICS
+    if (SDL_HasNEON()) {
+        SET_CONVERTER_FUNCS(NEON);
+        return;
+    }
+#endif
+
 #if NEED_SCALAR_CONVERTER_FALLBACKS
     SET_CONVERTER_FUNCS(Scalar);
 #endif
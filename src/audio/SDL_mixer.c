@@ -27,6 +27,15 @@
 #include "SDL_audio.h"
 #include "SDL_sysaudio.h"
 
+#ifdef __SSE2__
+#define HAVE_SSE2_INTRINSICS 1
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define HAVE_NEON_INTRINSICS 1
+#include <arm_neon.h>
+#endif
+
 /* This table is used to add two sound values together and pin
  * the value to avoid overflow.  (used with permission from ARDI)
  * Changed to use 0xFE instead of 0xFF for better sound quality.
@@ -85,6 +94,265 @@ static const Uint8 mix8[] = {
 #define ADJUST_VOLUME(s, v) (s = (s*v)/SDL_MIX_MAXVOLUME)
 #define ADJUST_VOLUME_U8(s, v)  (s = (((s-128)*v)/SDL_MIX_MAXVOLUME)+128)
 
+/* The SIMD mixers below give exactly the same results as the scalar loops in
+   SDL_MixAudioFormat(). SDL_MIX_MAXVOLUME is 128, so ADJUST_VOLUME's divide
+   is an arithmetic shift right by 7, with 127 added first to negative
+   products so it rounds toward zero like C division. Each mixer handles the
+   native-endian formats in whole blocks and returns how many bytes it did;
+   the scalar code finishes the rest. Volumes above SDL_MIX_MAXVOLUME can
+   overflow the lanes, so those always take the scalar path. */
+#define MIX_VOLUME_SHIFT 7
+
+#if HAVE_SSE2_INTRINSICS
+static Uint32
+SDL_MixAudioFormat_SSE2(Uint8 * dst, const Uint8 * src, SDL_AudioFormat format,
+                        Uint32 len, int volume)
+{
+    Uint32 i = 0;
+
+    switch (format) {
+    case AUDIO_U8:
+        {
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i vol = _mm_set1_epi16(volume);
+            const __m128i bias = _mm_set1_epi16(128);
+            const __m128i round = _mm_set1_epi16(SDL_MIX_MAXVOLUME - 1);
+            const __m128i max = _mm_set1_epi16(0xFE);  /* matches the mix8 table. */
+            for (; i + 16 <= len; i += 16) {   /* 16 * 8-bit */
+                const __m128i s = _mm_loadu_si128((const __m128i *) (src + i));
+                const __m128i d = _mm_loadu_si128((const __m128i *) (dst + i));
+                /* zero-extend to 16 bits and center on zero, then scale. */
+                __m128i lo = _mm_mullo_epi16(_mm_sub_epi16(_mm_unpacklo_epi8(s, zero), bias), vol);
+                __m128i hi = _mm_mullo_epi16(_mm_sub_epi16(_mm_unpackhi_epi8(s, zero), bias), vol);
+                lo = _mm_srai_epi16(_mm_add_epi16(lo, _mm_and_si128(_mm_srai_epi16(lo, 15), round)), MIX_VOLUME_SHIFT);
+                hi = _mm_srai_epi16(_mm_add_epi16(hi, _mm_and_si128(_mm_srai_epi16(hi, 15), round)), MIX_VOLUME_SHIFT);
+                /* add to dst, clip to 0 - 0xFE, pack down. */
+                lo = _mm_min_epi16(_mm_max_epi16(_mm_add_epi16(_mm_unpacklo_epi8(d, zero), lo), zero), max);
+                hi = _mm_min_epi16(_mm_max_epi16(_mm_add_epi16(_mm_unpackhi_epi8(d, zero), hi), zero), max);
+                _mm_storeu_si128((__m128i *) (dst + i), _mm_packus_epi16(lo, hi));
+            }
+        }
+        break;
+
+    case AUDIO_S8:
+        {
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i vol = _mm_set1_epi16(volume);
+            const __m128i round = _mm_set1_epi16(SDL_MIX_MAXVOLUME - 1);
+            for (; i + 16 <= len; i += 16) {   /* 16 * 8-bit */
+                const __m128i s = _mm_loadu_si128((const __m128i *) (src + i));
+                const __m128i d = _mm_loadu_si128((const __m128i *) (dst + i));
+                /* sign-extend to 16 bits by unpacking into the top byte, then scale. */
+                __m128i lo = _mm_mullo_epi16(_mm_srai_epi16(_mm_unpacklo_epi8(zero, s), 8), vol);
+                __m128i hi = _mm_mullo_epi16(_mm_srai_epi16(_mm_unpackhi_epi8(zero, s), 8), vol);
+                lo = _mm_srai_epi16(_mm_add_epi16(lo, _mm_and_si128(_mm_srai_epi16(lo, 15), round)), MIX_VOLUME_SHIFT);
+                hi = _mm_srai_epi16(_mm_add_epi16(hi, _mm_and_si128(_mm_srai_epi16(hi, 15), round)), MIX_VOLUME_SHIFT);
+                /* the scaled samples still fit in 8 bits; a saturating add does the clipping. */
+                _mm_storeu_si128((__m128i *) (dst + i), _mm_adds_epi8(d, _mm_packs_epi16(lo, hi)));
+            }
+        }
+        break;
+
+    case AUDIO_S16SYS:
+        {
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i vol = _mm_set1_epi32(volume);  /* (volume, 0) pairs for _mm_madd_epi16 */
+            const __m128i round = _mm_set1_epi32(SDL_MIX_MAXVOLUME - 1);
+            for (; i + 16 <= len; i += 16) {   /* 8 * 16-bit */
+                const __m128i s = _mm_loadu_si128((const __m128i *) (src + i));
+                const __m128i d = _mm_loadu_si128((const __m128i *) (dst + i));
+                /* pair each sample with a zero so madd gives us sample*volume as sint32. */
+                __m128i lo = _mm_madd_epi16(_mm_unpacklo_epi16(s, zero), vol);
+                __m128i hi = _mm_madd_epi16(_mm_unpackhi_epi16(s, zero), vol);
+                lo = _mm_srai_epi32(_mm_add_epi32(lo, _mm_and_si128(_mm_srai_epi32(lo, 31), round)), MIX_VOLUME_SHIFT);
+                hi = _mm_srai_epi32(_mm_add_epi32(hi, _mm_and_si128(_mm_srai_epi32(hi, 31), round)), MIX_VOLUME_SHIFT);
+                /* the scaled samples still fit in 16 bits; a saturating add does the clipping. */
+                _mm_storeu_si128((__m128i *) (dst + i), _mm_adds_epi16(d, _mm_packs_epi32(lo, hi)));
+            }
+        }
+        break;
+
+    case AUDIO_U16SYS:
+        {
+            /* unsigned, so the divide is a plain shift: the high half of
+               sample * (volume << 9) is (sample * volume) >> 7. That doesn't
+               fit in 16 bits at full volume, where there's nothing to scale. */
+            const __m128i vol = _mm_set1_epi16((Sint16) (volume << (16 - MIX_VOLUME_SHIFT)));
+            for (; i + 16 <= len; i += 16) {   /* 8 * 16-bit */
+                const __m128i s = _mm_loadu_si128((const __m128i *) (src + i));
+                const __m128i d = _mm_loadu_si128((const __m128i *) (dst + i));
+                const __m128i scaled = (volume == SDL_MIX_MAXVOLUME) ? s : _mm_mulhi_epu16(s, vol);
+                _mm_storeu_si128((__m128i *) (dst + i), _mm_adds_epu16(d, scaled));
+            }
+        }
+        break;
+
+    case AUDIO_S32SYS:
+        {
+            /* SSE2 has no 32-bit multiply, but doubles hold sample*volume
+               exactly, and the sums too, so do it in there. */
+            const __m128d scale = _mm_set1_pd(((double) volume) / SDL_MIX_MAXVOLUME);
+            const __m128d max = _mm_set1_pd(2147483647.0);
+            const __m128d min = _mm_set1_pd(-2147483648.0);
+            for (; i + 16 <= len; i += 16) {   /* 4 * 32-bit */
+                const __m128i s = _mm_loadu_si128((const __m128i *) (src + i));
+                const __m128i d = _mm_loadu_si128((const __m128i *) (dst + i));
+                /* scale, truncate, add dst, clip, for the low two samples and then the high two. */
+                const __m128i slo = _mm_cvttpd_epi32(_mm_mul_pd(_mm_cvtepi32_pd(s), scale));
+                const __m128i shi = _mm_cvttpd_epi32(_mm_mul_pd(_mm_cvtepi32_pd(_mm_srli_si128(s, 8)), scale));
+                const __m128d lo = _mm_add_pd(_mm_cvtepi32_pd(slo), _mm_cvtepi32_pd(d));
+                const __m128d hi = _mm_add_pd(_mm_cvtepi32_pd(shi), _mm_cvtepi32_pd(_mm_srli_si128(d, 8)));
+                const __m128i ilo = _mm_cvttpd_epi32(_mm_max_pd(_mm_min_pd(lo, max), min));
+                const __m128i ihi = _mm_cvttpd_epi32(_mm_max_pd(_mm_min_pd(hi, max), min));
+                _mm_storeu_si128((__m128i *) (dst + i), _mm_unpacklo_epi64(ilo, ihi));
+            }
+        }
+        break;
+
+    case AUDIO_F32SYS:
+        {
+            /* the scalar path adds in double precision and then rounds, which
+               is the same as a float add, except that it clips to FLT_MAX
+               where a float add goes infinite. The operand order keeps NaNs. */
+            const __m128 fvolume = _mm_set1_ps((float) volume);
+            const __m128 fmaxvolume = _mm_set1_ps(1.0f / ((float) SDL_MIX_MAXVOLUME));
+            const __m128 max = _mm_set1_ps(3.402823466e+38F);
+            const __m128 min = _mm_set1_ps(-3.402823466e+38F);
+            for (; i + 16 <= len; i += 16) {   /* 4 * float32 */
+                const __m128 s = _mm_mul_ps(_mm_mul_ps(_mm_loadu_ps((const float *) (src + i)), fvolume), fmaxvolume);
+                const __m128 sum = _mm_add_ps(s, _mm_loadu_ps((const float *) (dst + i)));
+                _mm_storeu_ps((float *) (dst + i), _mm_max_ps(min, _mm_min_ps(max, sum)));
+            }
+        }
+        break;
+
+    default:
+        break;
+    }
+
+    return i;
+}
+#endif
+
+#if HAVE_NEON_INTRINSICS
+static Uint32
+SDL_MixAudioFormat_NEON(Uint8 * dst, const Uint8 * src, SDL_AudioFormat format,
+                        Uint32 len, int volume)
+{
+    Uint32 i = 0;
+
+    switch (format) {
+    case AUDIO_U8:
+        {
+            const int16x8_t vol = vdupq_n_s16(volume);
+            const int16x8_t bias = vdupq_n_s16(128);
+            const int16x8_t round = vdupq_n_s16(SDL_MIX_MAXVOLUME - 1);
+            const int16x8_t zero = vdupq_n_s16(0);
+            const int16x8_t max = vdupq_n_s16(0xFE);  /* matches the mix8 table. */
+            for (; i + 16 <= len; i += 16) {   /* 16 * 8-bit */
+                const uint8x16_t s = vld1q_u8(src + i);
+                const uint8x16_t d = vld1q_u8(dst + i);
+                /* zero-extend to 16 bits and center on zero, then scale. */
+                int16x8_t lo = vmulq_s16(vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(vget_low_u8(s))), bias), vol);
+                int16x8_t hi = vmulq_s16(vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(vget_high_u8(s))), bias), vol);
+                lo = vshrq_n_s16(vaddq_s16(lo, vandq_s16(vshrq_n_s16(lo, 15), round)), MIX_VOLUME_SHIFT);
+                hi = vshrq_n_s16(vaddq_s16(hi, vandq_s16(vshrq_n_s16(hi, 15), round)), MIX_VOLUME_SHIFT);
+                /* add to dst, clip to 0 - 0xFE, pack down. */
+                lo = vminq_s16(vmaxq_s16(vaddq_s16(vreinterpretq_s16_u16(vmovl_u8(vget_low_u8(d))), lo), zero), max);
+                hi = vminq_s16(vmaxq_s16(vaddq_s16(vreinterpretq_s16_u16(vmovl_u8(vget_high_u8(d))), hi), zero), max);
+                vst1q_u8(dst + i, vcombine_u8(vqmovun_s16(lo), vqmovun_s16(hi)));
+            }
+        }
+        break;
+
+    case AUDIO_S8:
+        {
+            const int16x8_t vol = vdupq_n_s16(volume);
+            const int16x8_t round = vdupq_n_s16(SDL_MIX_MAXVOLUME - 1);
+            for (; i + 16 <= len; i += 16) {   /* 16 * 8-bit */
+                const int8x16_t s = vld1q_s8((const Sint8 *) (src + i));
+                const int8x16_t d = vld1q_s8((const Sint8 *) (dst + i));
+                int16x8_t lo = vmulq_s16(vmovl_s8(vget_low_s8(s)), vol);
+                int16x8_t hi = vmulq_s16(vmovl_s8(vget_high_s8(s)), vol);
+                lo = vshrq_n_s16(vaddq_s16(lo, vandq_s16(vshrq_n_s16(lo, 15), round)), MIX_VOLUME_SHIFT);
+                hi = vshrq_n_s16(vaddq_s16(hi, vandq_s16(vshrq_n_s16(hi, 15), round)), MIX_VOLUME_SHIFT);
+                /* the scaled samples still fit in 8 bits; a saturating add does the clipping. */
+                vst1q_s8((Sint8 *) (dst + i), vqaddq_s8(d, vcombine_s8(vmovn_s16(lo), vmovn_s16(hi))));
+            }
+        }
+        break;
+
+    case AUDIO_S16SYS:
+        {
+            const int16x4_t vol = vdup_n_s16(volume);
+            const int32x4_t round = vdupq_n_s32(SDL_MIX_MAXVOLUME - 1);
+            for (; i + 16 <= len; i += 16) {   /* 8 * 16-bit */
+                const int16x8_t s = vld1q_s16((const Sint16 *) (src + i));
+                const int16x8_t d = vld1q_s16((const Sint16 *) (dst + i));
+                int32x4_t lo = vmull_s16(vget_low_s16(s), vol);
+                int32x4_t hi = vmull_s16(vget_high_s16(s), vol);
+                lo = vshrq_n_s32(vaddq_s32(lo, vandq_s32(vshrq_n_s32(lo, 31), round)), MIX_VOLUME_SHIFT);
+                hi = vshrq_n_s32(vaddq_s32(hi, vandq_s32(vshrq_n_s32(hi, 31), round)), MIX_VOLUME_SHIFT);
+                /* the scaled samples still fit in 16 bits; a saturating add does the clipping. */
+                vst1q_s16((Sint16 *) (dst + i), vqaddq_s16(d, vcombine_s16(vmovn_s32(lo), vmovn_s32(hi))));
+            }
+        }
+        break;
+
+    case AUDIO_U16SYS:
+        {
+            const uint16x4_t vol = vdup_n_u16(volume);
+            for (; i + 16 <= len; i += 16) {   /* 8 * 16-bit */
+                const uint16x8_t s = vld1q_u16((const Uint16 *) (src + i));
+                const uint16x8_t d = vld1q_u16((const Uint16 *) (dst + i));
+                const uint16x4_t lo = vshrn_n_u32(vmull_u16(vget_low_u16(s), vol), MIX_VOLUME_SHIFT);
+                const uint16x4_t hi = vshrn_n_u32(vmull_u16(vget_high_u16(s), vol), MIX_VOLUME_SHIFT);
+                vst1q_u16((Uint16 *) (dst + i), vqaddq_u16(d, vcombine_u16(lo, hi)));
+            }
+        }
+        break;
+
+    case AUDIO_S32SYS:
+        {
+            const int32x2_t vol = vdup_n_s32(volume);
+            const int64x2_t round = vdupq_n_s64(SDL_MIX_MAXVOLUME - 1);
+            for (; i + 16 <= len; i += 16) {   /* 4 * 32-bit */
+                const int32x4_t s = vld1q_s32((const Sint32 *) (src + i));
+                const int32x4_t d = vld1q_s32((const Sint32 *) (dst + i));
+                int64x2_t lo = vmull_s32(vget_low_s32(s), vol);
+                int64x2_t hi = vmull_s32(vget_high_s32(s), vol);
+                lo = vshrq_n_s64(vaddq_s64(lo, vandq_s64(vshrq_n_s64(lo, 63), round)), MIX_VOLUME_SHIFT);
+                hi = vshrq_n_s64(vaddq_s64(hi, vandq_s64(vshrq_n_s64(hi, 63), round)), MIX_VOLUME_SHIFT);
+                /* add dst in 64 bits; the saturating narrow does the clipping. */
+                lo = vaddq_s64(lo, vmovl_s32(vget_low_s32(d)));
+                hi = vaddq_s64(hi, vmovl_s32(vget_high_s32(d)));
+                vst1q_s32((Sint32 *) (dst + i), vcombine_s32(vqmovn_s64(lo), vqmovn_s64(hi)));
+            }
+        }
+        break;
+
+    case AUDIO_F32SYS:
+        {
+            const float32x4_t fvolume = vdupq_n_f32((float) volume);
+            const float32x4_t fmaxvolume = vdupq_n_f32(1.0f / ((float) SDL_MIX_MAXVOLUME));
+            const float32x4_t max = vdupq_n_f32(3.402823466e+38F);
+            const float32x4_t min = vdupq_n_f32(-3.402823466e+38F);
+            for (; i + 16 <= len; i += 16) {   /* 4 * float32 */
+                const float32x4_t s = vmulq_f32(vmulq_f32(vld1q_f32((const float *) (src + i)), fvolume), fmaxvolume);
+                const float32x4_t sum = vaddq_f32(s, vld1q_f32((const float *) (dst + i)));
+                vst1q_f32((float *) (dst + i), vmaxq_f32(vminq_f32(sum, max), min));
+            }
+        }
+        break;
+
+    default:
+        break;
+    }
+
+    return i;
+}
+#endif
+
 
 void
 SDL_MixAudioFormat(Uint8 * dst, const Uint8 * src, SDL_AudioFormat format,
@@ -94,6 +362,22 @@ SDL_MixAudioFormat(Uint8 * dst, const Uint8 * src, SDL_AudioFormat format,
         return;
     }
 
+    if ((volume > 0) && (volume <= SDL_MIX_MAXVOLUME)) {
+        Uint32 done = 0;
+#if HAVE_SSE2_INTRINSICS
+        if (SDL_HasSSE2()) {
+            done = SDL_MixAudioFormat_SSE2(dst, src, format, len, volume);
+        }
+#elif HAVE_NEON_INTRINSICS
+        if (SDL_HasNEON()) {
+            done = SDL_MixAudioFormat_NEON(dst, src, format, len, volume);
+        }
+#endif
+        dst += done;
+        src += done;
+        len -= done;
+    }
+
     switch (format) {
 
     case AUDIO_U8:
@@ -366,4 +650,265 @@ SDL_MixAudioFormat(Uint8 * dst, const Uint8 * src, SDL_AudioFormat format,
     }
 }
 
+/* SDL_MixAudioFormatMulti() works through the buffers this many samples at a
+   time, so the float accumulator stays in the L1 cache for every source. */
+#define MIX_CHUNK_SAMPLES 256
+
+/* Unsigned formats are centered on zero in the accumulator. AUDIO_S32 has
+   its own mixer below. */
+#define MIX_TO_FLOAT_FUNCS(fn, op) \
+static void \
+fn(float *acc, const Uint8 *src, SDL_AudioFormat format, int count, float scale) \
+{ \
+    int i; \
+    switch (format) { \
+    case AUDIO_U8: \
+        for (i = 0; i < count; i++) { acc[i] op (((float) src[i]) - 128.0f) * scale; } \
+        break; \
+    case AUDIO_S8: \
+        for (i = 0; i < count; i++) { acc[i] op ((float) ((const Sint8 *) src)[i]) * scale; } \
+        break; \
+    case AUDIO_S16LSB: \
+        for (i = 0; i < count; i++) { acc[i] op ((float) ((Sint16) SDL_SwapLE16(((const Uint16 *) src)[i]))) * scale; } \
+        break; \
+    case AUDIO_S16MSB: \
+        for (i = 0; i < count; i++) { acc[i] op ((float) ((Sint16) SDL_SwapBE16(((const Uint16 *) src)[i]))) * scale; } \
+        break; \
+    case AUDIO_U16LSB: \
+        for (i = 0; i < count; i++) { acc[i] op (((float) SDL_SwapLE16(((const Uint16 *) src)[i])) - 32768.0f) * scale; } \
+        break; \
+    case AUDIO_U16MSB: \
+        for (i = 0; i < count; i++) { acc[i] op (((float) SDL_SwapBE16(((const Uint16 *) src)[i])) - 32768.0f) * scale; } \
+        break; \
+    case AUDIO_F32LSB: \
+        for (i = 0; i < count; i++) { acc[i] op SDL_SwapFloatLE(((const float *) src)[i]) * scale; } \
+        break; \
+    case AUDIO_F32MSB: \
+        for (i = 0; i < count; i++) { acc[i] op SDL_SwapFloatBE(((const float *) src)[i]) * scale; } \
+        break; \
+    } \
+}
+
+MIX_TO_FLOAT_FUNCS(SDL_MixLoadFloat, =)
+MIX_TO_FLOAT_FUNCS(SDL_MixAddFloat_Scalar, +=)
+
+#undef MIX_TO_FLOAT_FUNCS
+
+/* Add a source into the accumulator; the common formats get SIMD versions. */
+static void
+SDL_MixAddFloat(float *acc, const Uint8 *src, SDL_AudioFormat format, int count, float scale)
+{
+    int i = 0;
+
+#if HAVE_SSE2_INTRINSICS
+    if (SDL_HasSSE2()) {
+        const __m128 vscale = _mm_set1_ps(scale);
+        if (format == AUDIO_S16SYS) {
+            const __m128i zero = _mm_setzero_si128();
+            for (; i + 8 <= count; i += 8) {   /* 8 * 16-bit */
+                const __m128i s = _mm_loadu_si128((const __m128i *) (src + i * 2));
+                /* sign-extend to sint32 by unpacking into the top half, convert, scale, add. */
+                const __m128 lo = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(zero, s), 16));
+                const __m128 hi = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(zero, s), 16));
+                _mm_storeu_ps(acc + i, _mm_add_ps(_mm_loadu_ps(acc + i), _mm_mul_ps(lo, vscale)));
+                _mm_storeu_ps(acc + i + 4, _mm_add_ps(_mm_loadu_ps(acc + i + 4), _mm_mul_ps(hi, vscale)));
+            }
+        } else if (format == AUDIO_F32SYS) {
+            for (; i + 4 <= count; i += 4) {   /* 4 * float32 */
+                const __m128 s = _mm_loadu_ps((const float *) (src + i * 4));
+                _mm_storeu_ps(acc + i, _mm_add_ps(_mm_loadu_ps(acc + i), _mm_mul_ps(s, vscale)));
+            }
+        }
+    }
+#elif HAVE_NEON_INTRINSICS
+    if (SDL_HasNEON()) {
+        const float32x4_t vscale = vdupq_n_f32(scale);
+        if (format == AUDIO_S16SYS) {
+            for (; i + 8 <= count; i += 8) {   /* 8 * 16-bit */
+                const int16x8_t s = vld1q_s16((const Sint16 *) (src + i * 2));
+                const float32x4_t lo = vcvtq_f32_s32(vmovl_s16(vget_low_s16(s)));
+                const float32x4_t hi = vcvtq_f32_s32(vmovl_s16(vget_high_s16(s)));
+                vst1q_f32(acc + i, vaddq_f32(vld1q_f32(acc + i), vmulq_f32(lo, vscale)));
+                vst1q_f32(acc + i + 4, vaddq_f32(vld1q_f32(acc + i + 4), vmulq_f32(hi, vscale)));
+            }
+        } else if (format == AUDIO_F32SYS) {
+            for (; i + 4 <= count; i += 4) {   /* 4 * float32 */
+                const float32x4_t s = vld1q_f32((const float *) (src + i * 4));
+                vst1q_f32(acc + i, vaddq_f32(vld1q_f32(acc + i), vmulq_f32(s, vscale)));
+            }
+        }
+    }
+#endif
+
+    if (i < count) {
+        SDL_MixAddFloat_Scalar(acc + i, src + i * (SDL_AUDIO_BITSIZE(format) / 8), format, count - i, scale);
+    }
+}
+
+/* Clip an accumulated sample to the range of an integer format, truncating
+   toward zero like the audio type converters do. */
+#define MIX_CLIP(x, lo, hi) (((x) >= (hi)) ? (hi) : ((x) <= (lo)) ? (lo) : (x))
+
+/* Write the accumulator back out, clipping each sample just this once. */
+static void
+SDL_MixStoreFloat(Uint8 *dst, const float *acc, SDL_AudioFormat format, int count)
+{
+    int i = 0;
+
+#if HAVE_SSE2_INTRINSICS
+    if (SDL_HasSSE2() && (format == AUDIO_S16SYS)) {
+        for (; i + 8 <= count; i += 8) {   /* 8 * float32 */
+            /* truncate to sint32, then let the saturating pack do the clipping. */
+            const __m128i lo = _mm_cvttps_epi32(_mm_loadu_ps(acc + i));
+            const __m128i hi = _mm_cvttps_epi32(_mm_loadu_ps(acc + i + 4));
+            _mm_storeu_si128((__m128i *) (dst + i * 2), _mm_packs_epi32(lo, hi));
+        }
+    }
+#elif HAVE_NEON_INTRINSICS
+    if (SDL_HasNEON() && (format == AUDIO_S16SYS)) {
+        for (; i + 8 <= count; i += 8) {   /* 8 * float32 */
+            /* truncate to sint32, then let the saturating narrow do the clipping. */
+            const int32x4_t lo = vcvtq_s32_f32(vld1q_f32(acc + i));
+            const int32x4_t hi = vcvtq_s32_f32(vld1q_f32(acc + i + 4));
+            vst1q_s16((Sint16 *) (dst + i * 2), vcombine_s16(vqmovn_s32(lo), vqmovn_s32(hi)));
+        }
+    }
+#endif
+
+    switch (format) {
+    case AUDIO_U8:
+        for (; i < count; i++) {
+            /* tops out at 0xFE, like SDL_MixAudioFormat() and the mix8 table. */
+            dst[i] = (Uint8) MIX_CLIP(acc[i] + 128.0f, 0.0f, 254.0f);
+        }
+        break;
+    case AUDIO_S8:
+        for (; i < count; i++) {
+            ((Sint8 *) dst)[i] = (Sint8) MIX_CLIP(acc[i], -128.0f, 127.0f);
+        }
+        break;
+    case AUDIO_S16LSB:
+        for (; i < count; i++) {
+            ((Uint16 *) dst)[i] = SDL_SwapLE16((Uint16) ((Sint16) MIX_CLIP(acc[i], -32768.0f, 32767.0f)));
+        }
+        break;
+    case AUDIO_S16MSB:
+        for (; i < count; i++) {
+            ((Uint16 *) dst)[i] = SDL_SwapBE16((Uint16) ((Sint16) MIX_CLIP(acc[i], -32768.0f, 32767.0f)));
+        }
+        break;
+    case AUDIO_U16LSB:
+        for (; i < count; i++) {
+            ((Uint16 *) dst)[i] = SDL_SwapLE16((Uint16) MIX_CLIP(acc[i] + 32768.0f, 0.0f, 65535.0f));
+        }
+        break;
+    case AUDIO_U16MSB:
+        for (; i < count; i++) {
+            ((Uint16 *) dst)[i] = SDL_SwapBE16((Uint16) MIX_CLIP(acc[i] + 32768.0f, 0.0f, 65535.0f));
+        }
+        break;
+    case AUDIO_F32LSB:
+        for (; i < count; i++) {
+            ((float *) dst)[i] = SDL_SwapFloatLE(acc[i]);
+        }
+        break;
+    case AUDIO_F32MSB:
+        for (; i < count; i++) {
+            ((float *) dst)[i] = SDL_SwapFloatBE(acc[i]);
+        }
+        break;
+    }
+}
+
+/* Sint32 samples don't fit in a float, so they're summed in a Sint64. Each
+   source is scaled and truncated with ADJUST_VOLUME like SDL_MixAudioFormat()
+   does, so the mix is the same as one call per source unless those would
+   have clipped along the way. */
+static void
+SDL_MixAudioS32Multi(Uint8 * dst, const Uint8 * const * src, const int * volume,
+                     int num_src, Uint32 offset, SDL_AudioFormat format, int count)
+{
+    const Sint64 max_audioval = ((((Sint64) 1) << (32 - 1)) - 1);
+    const Sint64 min_audioval = -(((Sint64) 1) << (32 - 1));
+    const SDL_bool big = (format == AUDIO_S32MSB) ? SDL_TRUE : SDL_FALSE;
+    Sint64 acc[MIX_CHUNK_SAMPLES];
+    Uint32 *dst32 = (Uint32 *) (dst + offset);
+    int i, j;
+
+    for (j = 0; j < count; j++) {
+        acc[j] = (Sint32) (big ? SDL_SwapBE32(dst32[j]) : SDL_SwapLE32(dst32[j]));
+    }
+    for (i = 0; i < num_src; i++) {
+        if (src[i] && (volume[i] > 0)) {
+            const Uint32 *src32 = (const Uint32 *) (src[i] + offset);
+            const Sint64 vol = volume[i];
+            for (j = 0; j < count; j++) {
+                Sint64 sample = (Sint32) (big ? SDL_SwapBE32(src32[j]) : SDL_SwapLE32(src32[j]));
+                ADJUST_VOLUME(sample, vol);
+                acc[j] += sample;
+            }
+        }
+    }
+    for (j = 0; j < count; j++) {
+        const Sint32 sample = (Sint32) MIX_CLIP(acc[j], min_audioval, max_audioval);
+        dst32[j] = big ? SDL_SwapBE32((Uint32) sample) : SDL_SwapLE32((Uint32) sample);
+    }
+}
+
+#undef MIX_CLIP
+
+void
+SDL_MixAudioFormatMulti(Uint8 * dst, const Uint8 * const * src,
+                        const int * volume, int num_src,
+                        SDL_AudioFormat format, Uint32 len)
+{
+    float acc[MIX_CHUNK_SAMPLES];
+    const int samplesize = SDL_AUDIO_BITSIZE(format) / 8;
+    Uint32 offset = 0;
+    int i;
+
+    switch (format) {
+    case AUDIO_U8: case AUDIO_S8:
+    case AUDIO_S16LSB: case AUDIO_S16MSB: case AUDIO_U16LSB: case AUDIO_U16MSB:
+    case AUDIO_S32LSB: case AUDIO_S32MSB: case AUDIO_F32LSB: case AUDIO_F32MSB:
+        break;
+    default:
+        SDL_SetError("SDL_MixAudioFormatMulti(): unknown audio format");
+        return;
+    }
+
+    if (!src || !volume || (num_src <= 0)) {
+        return;
+    }
+
+    /* If nothing gets added, leave dst exactly as it was */
+    for (i = 0; i < num_src; i++) {
+        if (src[i] && (volume[i] > 0)) {
+            break;
+        }
+    }
+    if (i == num_src) {
+        return;
+    }
+
+    len -= len % samplesize;
+    while (offset < len) {
+        const int count = (int) SDL_min((len - offset) / samplesize, MIX_CHUNK_SAMPLES);
+
+        if ((format == AUDIO_S32LSB) || (format == AUDIO_S32MSB)) {
+            SDL_MixAudioS32Multi(dst, src, volume, num_src, offset, format, count);
+        } else {
+            SDL_MixLoadFloat(acc, dst + offset, format, count, 1.0f);
+            for (i = 0; i < num_src; i++) {
+                if (src[i] && (volume[i] > 0)) {
+                    SDL_MixAddFloat(acc, src[i] + offset, format, count, ((float) volume[i]) / SDL_MIX_MAXVOLUME);
+                }
+            }
+            SDL_MixStoreFloat(dst + offset, acc, format, count);
+        }
+
+        offset += count * samplesize;
+    }
+}
+
 /* vi: set ts=4 sw=4 expandtab: */
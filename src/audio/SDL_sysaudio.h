@@ -23,6 +23,8 @@
 #ifndef SDL_sysaudio_h_
 #define SDL_sysaudio_h_
 
+#include "SDL_atomic.h"
+#include "SDL_cpuinfo.h"
 #include "SDL_mutex.h"
 #include "SDL_thread.h"
 #include "../SDL_dataqueue.h"
@@ -62,6 +64,24 @@ extern void SDL_OpenedAudioDeviceDisconnected(SDL_AudioDevice *device);
    The system preallocates enough packets for 2 callbacks' worth of data. */
 #define SDL_AUDIOBUFFERQUEUE_PACKETLEN (8 * 1024)
 
+/* If SDL_HINT_AUDIO_QUEUE_CAPACITY is set when a queueing device is opened,
+   queued audio goes into a fixed-size ring buffer instead. There is exactly
+   one producer (the app for playback, the audio thread for capture) and one
+   consumer (the other one), so it needs no lock: each side only moves its own
+   position and publishes it with a barrier. Positions are byte counts that
+   wrap at 32 bits, and size is a power of two, so (head - tail) is always the
+   amount queued. head and tail get their own cache lines so the two threads
+   don't fight over them. */
+typedef struct SDL_AudioRing
+{
+    SDL_atomic_t head;  /* bytes written so far; only the producer moves it. */
+    char pad1[SDL_CACHELINE_SIZE - sizeof (SDL_atomic_t)];
+    SDL_atomic_t tail;  /* bytes read so far; the consumer moves it, or a clear. */
+    char pad2[SDL_CACHELINE_SIZE - sizeof (SDL_atomic_t)];
+    Uint32 size;
+    Uint8 *data;
+} SDL_AudioRing;
+
 typedef struct SDL_AudioDriverImpl
 {
     void (*DetectDevices) (void);
@@ -164,6 +184,13 @@ struct SDL_AudioDevice
     /* Queued buffers (if app not using callback). */
     SDL_DataQueue *buffer_queue;
 
+    /* Lock-free ring used instead of buffer_queue, if the app asked for one. */
+    SDL_AudioRing *ring_queue;
+
+    /* Where the playback thread spends its time. */
+    SDL_SpinLock stats_lock;
+    SDL_AudioDeviceStats stats;
+
     /* * * */
     /* Data private to this driver */
     struct SDL_PrivateAudioData *hidden;
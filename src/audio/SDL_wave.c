@@ -25,8 +25,53 @@
 #include "SDL_audio.h"
 #include "SDL_wave.h"
 
+/* How many ADPCM blocks to read from the source at once. */
+#define WAVE_BLOCKS_PER_READ 16
 
-static int ReadChunk(SDL_RWops * src, Chunk * chunk);
+/* How much to decode at a time when feeding an SDL_AudioStream. */
+#define WAVE_PUT_CHUNK_SIZE (16 * 1024)
+
+/* Everything a WAVE file needs to be decoded. Each stream has its own, so
+   any number of them can be decoded at once, from any thread. */
+struct _SDL_WAVStream
+{
+    SDL_RWops *src;
+    int freesrc;
+    SDL_AudioSpec spec;
+
+    Uint16 encoding;            /* PCM_CODE, IEEE_FLOAT_CODE, MS_ADPCM_CODE or IMA_ADPCM_CODE */
+    Uint16 bitspersample;
+    Uint16 blockalign;          /* ADPCM: encoded bytes per block */
+    Uint16 samplesperblock;     /* ADPCM: sample frames per block */
+    Sint16 coeff[7][2];         /* MS ADPCM predictor coefficients */
+    int src_framesize;          /* bytes per sample frame in the file */
+    int framesize;              /* bytes per sample frame after decoding */
+    int blocksize;              /* ADPCM: decoded bytes per block */
+
+    Uint32 data_left;           /* bytes of the data chunk not read yet */
+    Uint64 decoded_len;         /* total bytes the whole data chunk decodes to */
+
+    Uint8 *encoded;             /* ADPCM: WAVE_BLOCKS_PER_READ encoded blocks */
+    Uint8 *block;               /* ADPCM: one decoded block, partly handed out */
+    int block_pos;
+    int block_len;
+    SDL_bool failed;            /* ADPCM: a block couldn't be decoded */
+    Uint8 *putbuf;              /* decoded data on its way to an SDL_AudioStream */
+
+    /* to find the end of the RIFF chunk, for SDL_LoadWAV_RW(). */
+    Uint32 wavelen;
+    Uint32 headerDiff;
+    Uint32 datalen;
+    Sint64 riffend;             /* where the RIFF chunk ends in src, or -1 */
+};
+
+
+/* MS ADPCM */
+
+static const Sint32 MS_ADPCM_adaptive[16] = {
+    230, 230, 230, 230, 307, 409, 512, 614,
+    768, 614, 512, 409, 307, 230, 230, 230
+};
 
 struct MS_ADPCM_decodestate
 {
@@ -35,62 +80,50 @@ struct MS_ADPCM_decodestate
     Sint16 iSamp1;
     Sint16 iSamp2;
 };
-static struct MS_ADPCM_decoder
-{
-    WaveFMT wavefmt;
-    Uint16 wSamplesPerBlock;
-    Uint16 wNumCoef;
-    Sint16 aCoeff[7][2];
-    /* * * */
-    struct MS_ADPCM_decodestate state[2];
-} MS_ADPCM_state;
 
 static int
-InitMS_ADPCM(WaveFMT * format)
+InitMS_ADPCM(SDL_WAVStream *stream, const Uint8 *fmt, const Uint32 fmtlen)
 {
-    Uint8 *rogue_feel;
+    const int channels = stream->spec.channels;
+    /* the cbSize field comes right after the basic 16-byte header. */
+    const Uint8 *rogue_feel = fmt + sizeof (WaveFMT) + sizeof (Uint16);
+    Uint16 wNumCoef;
     int i;
 
-    /* Set the rogue pointer to the MS_ADPCM specific data */
-    MS_ADPCM_state.wavefmt.encoding = SDL_SwapLE16(format->encoding);
-    MS_ADPCM_state.wavefmt.channels = SDL_SwapLE16(format->channels);
-    MS_ADPCM_state.wavefmt.frequency = SDL_SwapLE32(format->frequency);
-    MS_ADPCM_state.wavefmt.byterate = SDL_SwapLE32(format->byterate);
-    MS_ADPCM_state.wavefmt.blockalign = SDL_SwapLE16(format->blockalign);
-    MS_ADPCM_state.wavefmt.bitspersample =
-        SDL_SwapLE16(format->bitspersample);
-    rogue_feel = (Uint8 *) format + sizeof(*format);
-    if (sizeof(*format) == 16) {
-        /* const Uint16 extra_info = ((rogue_feel[1] << 8) | rogue_feel[0]); */
-        rogue_feel += sizeof(Uint16);
+    if (fmtlen < (sizeof (WaveFMT) + (3 + (7 * 2)) * sizeof (Uint16))) {
+        return SDL_SetError("MS ADPCM format chunk too small");
+    } else if ((channels < 1) || (channels > 2)) {
+        return SDL_SetError("MS ADPCM decoder can only handle 2 channels");
     }
-    MS_ADPCM_state.wSamplesPerBlock = ((rogue_feel[1] << 8) | rogue_feel[0]);
+
+    stream->samplesperblock = ((rogue_feel[1] << 8) | rogue_feel[0]);
     rogue_feel += sizeof(Uint16);
-    MS_ADPCM_state.wNumCoef = ((rogue_feel[1] << 8) | rogue_feel[0]);
+    wNumCoef = ((rogue_feel[1] << 8) | rogue_feel[0]);
     rogue_feel += sizeof(Uint16);
-    if (MS_ADPCM_state.wNumCoef != 7) {
-        SDL_SetError("Unknown set of MS_ADPCM coefficients");
-        return (-1);
+    if (wNumCoef != 7) {
+        return SDL_SetError("Unknown set of MS_ADPCM coefficients");
     }
-    for (i = 0; i < MS_ADPCM_state.wNumCoef; ++i) {
-        MS_ADPCM_state.aCoeff[i][0] = ((rogue_feel[1] << 8) | rogue_feel[0]);
+    for (i = 0; i < wNumCoef; ++i) {
+        stream->coeff[i][0] = (Sint16) ((rogue_feel[1] << 8) | rogue_feel[0]);
         rogue_feel += sizeof(Uint16);
-        MS_ADPCM_state.aCoeff[i][1] = ((rogue_feel[1] << 8) | rogue_feel[0]);
+        stream->coeff[i][1] = (Sint16) ((rogue_feel[1] << 8) | rogue_feel[0]);
         rogue_feel += sizeof(Uint16);
     }
-    return (0);
+
+    /* 7 header bytes per channel, then a nibble for every other sample. */
+    if ((stream->samplesperblock < 2) ||
+        ((7 * channels) + ((((stream->samplesperblock - 2) * channels) + 1) / 2)) > stream->blockalign) {
+        return SDL_SetError("MS ADPCM blocks are too small for their samples");
+    }
+    return 0;
 }
 
-static Sint32
+static SDL_INLINE Sint16
 MS_ADPCM_nibble(struct MS_ADPCM_decodestate *state,
-                Uint8 nybble, Sint16 * coeff)
+                const Uint8 nybble, const Sint16 *coeff)
 {
     const Sint32 max_audioval = ((1 << (16 - 1)) - 1);
     const Sint32 min_audioval = -(1 << (16 - 1));
-    const Sint32 adaptive[] = {
-        230, 230, 230, 230, 307, 409, 512, 614,
-        768, 614, 512, 409, 307, 230, 230, 230
-    };
     Sint32 new_sample, delta;
 
     new_sample = ((state->iSamp1 * coeff[0]) +
@@ -105,172 +138,134 @@ MS_ADPCM_nibble(struct MS_ADPCM_decodestate *state,
     } else if (new_sample > max_audioval) {
         new_sample = max_audioval;
     }
-    delta = ((Sint32) state->iDelta * adaptive[nybble]) / 256;
+    delta = ((Sint32) state->iDelta * MS_ADPCM_adaptive[nybble]) / 256;
     if (delta < 16) {
         delta = 16;
     }
     state->iDelta = (Uint16) delta;
     state->iSamp2 = state->iSamp1;
     state->iSamp1 = (Sint16) new_sample;
-    return (new_sample);
+    return (Sint16) new_sample;
 }
 
+/* Decodes one block into stream->blocksize bytes at decoded. */
 static int
-MS_ADPCM_decode(Uint8 ** audio_buf, Uint32 * audio_len)
+MS_ADPCM_decode_block(const SDL_WAVStream *stream, const Uint8 *encoded, Sint16 *decoded)
 {
-    struct MS_ADPCM_decodestate *state[2];
-    Uint8 *freeable, *encoded, *decoded;
-    Sint32 encoded_len, samplesleft;
-    Sint8 nybble;
-    Uint8 stereo;
-    Sint16 *coeff[2];
-    Sint32 new_sample;
-
-    /* Allocate the proper sized output buffer */
-    encoded_len = *audio_len;
-    encoded = *audio_buf;
-    freeable = *audio_buf;
-    *audio_len = (encoded_len / MS_ADPCM_state.wavefmt.blockalign) *
-        MS_ADPCM_state.wSamplesPerBlock *
-        MS_ADPCM_state.wavefmt.channels * sizeof(Sint16);
-    *audio_buf = (Uint8 *) SDL_malloc(*audio_len);
-    if (*audio_buf == NULL) {
-        return SDL_OutOfMemory();
-    }
-    decoded = *audio_buf;
-
-    /* Get ready... Go! */
-    stereo = (MS_ADPCM_state.wavefmt.channels == 2);
-    state[0] = &MS_ADPCM_state.state[0];
-    state[1] = &MS_ADPCM_state.state[stereo];
-    while (encoded_len >= MS_ADPCM_state.wavefmt.blockalign) {
-        /* Grab the initial information for this block */
-        state[0]->hPredictor = *encoded++;
-        if (stereo) {
-            state[1]->hPredictor = *encoded++;
-        }
-        state[0]->iDelta = ((encoded[1] << 8) | encoded[0]);
-        encoded += sizeof(Sint16);
-        if (stereo) {
-            state[1]->iDelta = ((encoded[1] << 8) | encoded[0]);
-            encoded += sizeof(Sint16);
-        }
-        state[0]->iSamp1 = ((encoded[1] << 8) | encoded[0]);
-        encoded += sizeof(Sint16);
-        if (stereo) {
-            state[1]->iSamp1 = ((encoded[1] << 8) | encoded[0]);
-            encoded += sizeof(Sint16);
-        }
-        state[0]->iSamp2 = ((encoded[1] << 8) | encoded[0]);
-        encoded += sizeof(Sint16);
-        if (stereo) {
-            state[1]->iSamp2 = ((encoded[1] << 8) | encoded[0]);
-            encoded += sizeof(Sint16);
+    struct MS_ADPCM_decodestate state[2];
+    const int channels = stream->spec.channels;
+    const Sint16 *coeff[2];
+    int c, samplesleft;
+
+    /* Grab the initial information for this block, one field at a time
+       for each channel. */
+    for (c = 0; c < channels; c++) {
+        state[c].hPredictor = *encoded++;
+        if (state[c].hPredictor >= SDL_arraysize(stream->coeff)) {
+            return SDL_SetError("Invalid MS ADPCM predictor");
         }
-        coeff[0] = MS_ADPCM_state.aCoeff[state[0]->hPredictor];
-        coeff[1] = MS_ADPCM_state.aCoeff[state[1]->hPredictor];
-
-        /* Store the two initial samples we start with */
-        decoded[0] = state[0]->iSamp2 & 0xFF;
-        decoded[1] = state[0]->iSamp2 >> 8;
-        decoded += 2;
-        if (stereo) {
-            decoded[0] = state[1]->iSamp2 & 0xFF;
-            decoded[1] = state[1]->iSamp2 >> 8;
+        coeff[c] = stream->coeff[state[c].hPredictor];
+    }
+    for (c = 0; c < channels; c++, encoded += 2) {
+        state[c].iDelta = ((encoded[1] << 8) | encoded[0]);
+    }
+    for (c = 0; c < channels; c++, encoded += 2) {
+        state[c].iSamp1 = (Sint16) ((encoded[1] << 8) | encoded[0]);
+    }
+    for (c = 0; c < channels; c++, encoded += 2) {
+        state[c].iSamp2 = (Sint16) ((encoded[1] << 8) | encoded[0]);
+    }
+
+    /* Store the two initial samples we start with */
+    for (c = 0; c < channels; c++) {
+        *(decoded++) = (Sint16) SDL_SwapLE16(state[c].iSamp2);
+    }
+    for (c = 0; c < channels; c++) {
+        *(decoded++) = (Sint16) SDL_SwapLE16(state[c].iSamp1);
+    }
+
+    /* Decode and store the other samples in this block. The high nibble
+       goes to the first channel and the low one to the second, so stereo
+       decodes both channels side by side; mono gets both in a row. */
+    samplesleft = (stream->samplesperblock - 2) * channels;
+    if (channels == 2) {
+        for (; samplesleft > 0; samplesleft -= 2, encoded++) {
+            decoded[0] = (Sint16) SDL_SwapLE16(MS_ADPCM_nibble(&state[0], *encoded >> 4, coeff[0]));
+            decoded[1] = (Sint16) SDL_SwapLE16(MS_ADPCM_nibble(&state[1], *encoded & 0x0F, coeff[1]));
             decoded += 2;
         }
-        decoded[0] = state[0]->iSamp1 & 0xFF;
-        decoded[1] = state[0]->iSamp1 >> 8;
-        decoded += 2;
-        if (stereo) {
-            decoded[0] = state[1]->iSamp1 & 0xFF;
-            decoded[1] = state[1]->iSamp1 >> 8;
+    } else {
+        for (; samplesleft > 1; samplesleft -= 2, encoded++) {
+            decoded[0] = (Sint16) SDL_SwapLE16(MS_ADPCM_nibble(&state[0], *encoded >> 4, coeff[0]));
+            decoded[1] = (Sint16) SDL_SwapLE16(MS_ADPCM_nibble(&state[0], *encoded & 0x0F, coeff[0]));
             decoded += 2;
         }
-
-        /* Decode and store the other samples in this block */
-        samplesleft = (MS_ADPCM_state.wSamplesPerBlock - 2) *
-            MS_ADPCM_state.wavefmt.channels;
-        while (samplesleft > 0) {
-            nybble = (*encoded) >> 4;
-            new_sample = MS_ADPCM_nibble(state[0], nybble, coeff[0]);
-            decoded[0] = new_sample & 0xFF;
-            new_sample >>= 8;
-            decoded[1] = new_sample & 0xFF;
-            decoded += 2;
-
-            nybble = (*encoded) & 0x0F;
-            new_sample = MS_ADPCM_nibble(state[1], nybble, coeff[1]);
-            decoded[0] = new_sample & 0xFF;
-            new_sample >>= 8;
-            decoded[1] = new_sample & 0xFF;
-            decoded += 2;
-
-            ++encoded;
-            samplesleft -= 2;
+        if (samplesleft) {  /* odd number of samples: the last byte is half used. */
+            *decoded = (Sint16) SDL_SwapLE16(MS_ADPCM_nibble(&state[0], *encoded >> 4, coeff[0]));
         }
-        encoded_len -= MS_ADPCM_state.wavefmt.blockalign;
     }
-    SDL_free(freeable);
-    return (0);
+    return 0;
 }
 
+
+/* IMA ADPCM */
+
+#define IMA_ADPCM_MAX_CHANNELS 8
+
+static const Sint8 IMA_ADPCM_index_table[16] = {
+    -1, -1, -1, -1,
+    2, 4, 6, 8,
+    -1, -1, -1, -1,
+    2, 4, 6, 8
+};
+
+static const Sint32 IMA_ADPCM_step_table[89] = {
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31,
+    34, 37, 41, 45, 50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130,
+    143, 157, 173, 190, 209, 230, 253, 279, 307, 337, 371, 408,
+    449, 494, 544, 598, 658, 724, 796, 876, 963, 1060, 1166, 1282,
+    1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327,
+    3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630,
+    9493, 10442, 11487, 12635, 13899, 15289, 16818, 18500, 20350,
+    22385, 24623, 27086, 29794, 32767
+};
+
 struct IMA_ADPCM_decodestate
 {
     Sint32 sample;
     Sint8 index;
 };
-static struct IMA_ADPCM_decoder
-{
-    WaveFMT wavefmt;
-    Uint16 wSamplesPerBlock;
-    /* * * */
-    struct IMA_ADPCM_decodestate state[2];
-} IMA_ADPCM_state;
 
 static int
-InitIMA_ADPCM(WaveFMT * format)
+InitIMA_ADPCM(SDL_WAVStream *stream, const Uint8 *fmt, const Uint32 fmtlen)
 {
-    Uint8 *rogue_feel;
-
-    /* Set the rogue pointer to the IMA_ADPCM specific data */
-    IMA_ADPCM_state.wavefmt.encoding = SDL_SwapLE16(format->encoding);
-    IMA_ADPCM_state.wavefmt.channels = SDL_SwapLE16(format->channels);
-    IMA_ADPCM_state.wavefmt.frequency = SDL_SwapLE32(format->frequency);
-    IMA_ADPCM_state.wavefmt.byterate = SDL_SwapLE32(format->byterate);
-    IMA_ADPCM_state.wavefmt.blockalign = SDL_SwapLE16(format->blockalign);
-    IMA_ADPCM_state.wavefmt.bitspersample =
-        SDL_SwapLE16(format->bitspersample);
-    rogue_feel = (Uint8 *) format + sizeof(*format);
-    if (sizeof(*format) == 16) {
-        /* const Uint16 extra_info = ((rogue_feel[1] << 8) | rogue_feel[0]); */
-        rogue_feel += sizeof(Uint16);
+    const int channels = stream->spec.channels;
+    /* the cbSize field comes right after the basic 16-byte header. */
+    const Uint8 *rogue_feel = fmt + sizeof (WaveFMT) + sizeof (Uint16);
+
+    if (fmtlen < (sizeof (WaveFMT) + 2 * sizeof (Uint16))) {
+        return SDL_SetError("IMA ADPCM format chunk too small");
+    } else if ((channels < 1) || (channels > IMA_ADPCM_MAX_CHANNELS)) {
+        return SDL_SetError("IMA ADPCM decoder can only handle %u channels",
+                            (unsigned int) IMA_ADPCM_MAX_CHANNELS);
+    }
+
+    stream->samplesperblock = ((rogue_feel[1] << 8) | rogue_feel[0]);
+
+    /* 4 header bytes per channel, then groups of 8 samples per channel.
+       The last group may be partly used. */
+    if ((stream->samplesperblock < 1) ||
+        ((4 * channels) + (((stream->samplesperblock + 6) / 8) * 4 * channels)) > stream->blockalign) {
+        return SDL_SetError("IMA ADPCM blocks are too small for their samples");
     }
-    IMA_ADPCM_state.wSamplesPerBlock = ((rogue_feel[1] << 8) | rogue_feel[0]);
-    return (0);
+    return 0;
 }
 
-static Sint32
-IMA_ADPCM_nibble(struct IMA_ADPCM_decodestate *state, Uint8 nybble)
+static SDL_INLINE Sint16
+IMA_ADPCM_nibble(struct IMA_ADPCM_decodestate *state, const Uint8 nybble)
 {
     const Sint32 max_audioval = ((1 << (16 - 1)) - 1);
     const Sint32 min_audioval = -(1 << (16 - 1));
-    const int index_table[16] = {
-        -1, -1, -1, -1,
-        2, 4, 6, 8,
-        -1, -1, -1, -1,
-        2, 4, 6, 8
-    };
-    const Sint32 step_table[89] = {
-        7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31,
-        34, 37, 41, 45, 50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130,
-        143, 157, 173, 190, 209, 230, 253, 279, 307, 337, 371, 408,
-        449, 494, 544, 598, 658, 724, 796, 876, 963, 1060, 1166, 1282,
-        1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327,
-        3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630,
-        9493, 10442, 11487, 12635, 13899, 15289, 16818, 18500, 20350,
-        22385, 24623, 27086, 29794, 32767
-    };
     Sint32 delta, step;
 
     /* Compute difference and new sample value */
@@ -280,7 +275,7 @@ IMA_ADPCM_nibble(struct IMA_ADPCM_decodestate *state, Uint8 nybble)
         state->index = 0;
     }
     /* explicit cast to avoid gcc warning about using 'char' as array index */
-    step = step_table[(int)state->index];
+    step = IMA_ADPCM_step_table[(int)state->index];
     delta = step >> 3;
     if (nybble & 0x04)
         delta += step;
@@ -293,7 +288,7 @@ IMA_ADPCM_nibble(struct IMA_ADPCM_decodestate *state, Uint8 nybble)
     state->sample += delta;
 
     /* Update index value */
-    state->index += index_table[nybble];
+    state->index += IMA_ADPCM_index_table[nybble];
 
     /* Clamp output sample */
     if (state->sample > max_audioval) {
@@ -301,158 +296,120 @@ IMA_ADPCM_nibble(struct IMA_ADPCM_decodestate *state, Uint8 nybble)
     } else if (state->sample < min_audioval) {
         state->sample = min_audioval;
     }
-    return (state->sample);
-}
-
-/* Fill the decode buffer with a channel block of data (8 samples) */
-static void
-Fill_IMA_ADPCM_block(Uint8 * decoded, Uint8 * encoded,
-                     int channel, int numchannels,
-                     struct IMA_ADPCM_decodestate *state)
-{
-    int i;
-    Sint8 nybble;
-    Sint32 new_sample;
-
-    decoded += (channel * 2);
-    for (i = 0; i < 4; ++i) {
-        nybble = (*encoded) & 0x0F;
-        new_sample = IMA_ADPCM_nibble(state, nybble);
-        decoded[0] = new_sample & 0xFF;
-        new_sample >>= 8;
-        decoded[1] = new_sample & 0xFF;
-        decoded += 2 * numchannels;
-
-        nybble = (*encoded) >> 4;
-        new_sample = IMA_ADPCM_nibble(state, nybble);
-        decoded[0] = new_sample & 0xFF;
-        new_sample >>= 8;
-        decoded[1] = new_sample & 0xFF;
-        decoded += 2 * numchannels;
-
-        ++encoded;
-    }
+    return (Sint16) state->sample;
 }
 
+/* Decodes one block into stream->blocksize bytes at decoded. */
 static int
-IMA_ADPCM_decode(Uint8 ** audio_buf, Uint32 * audio_len)
+IMA_ADPCM_decode_block(const SDL_WAVStream *stream, const Uint8 *encoded, Sint16 *decoded)
 {
-    struct IMA_ADPCM_decodestate *state;
-    Uint8 *freeable, *encoded, *decoded;
-    Sint32 encoded_len, samplesleft;
-    unsigned int c, channels;
-
-    /* Check to make sure we have enough variables in the state array */
-    channels = IMA_ADPCM_state.wavefmt.channels;
-    if (channels > SDL_arraysize(IMA_ADPCM_state.state)) {
-        SDL_SetError("IMA ADPCM decoder can only handle %u channels",
-                     (unsigned int)SDL_arraysize(IMA_ADPCM_state.state));
-        return (-1);
-    }
-    state = IMA_ADPCM_state.state;
-
-    /* Allocate the proper sized output buffer */
-    encoded_len = *audio_len;
-    encoded = *audio_buf;
-    freeable = *audio_buf;
-    *audio_len = (encoded_len / IMA_ADPCM_state.wavefmt.blockalign) *
-        IMA_ADPCM_state.wSamplesPerBlock *
-        IMA_ADPCM_state.wavefmt.channels * sizeof(Sint16);
-    *audio_buf = (Uint8 *) SDL_malloc(*audio_len);
-    if (*audio_buf == NULL) {
-        return SDL_OutOfMemory();
+    struct IMA_ADPCM_decodestate state[IMA_ADPCM_MAX_CHANNELS];
+    /* InitIMA_ADPCM() checked this already; this just tells the compiler. */
+    const int channels = SDL_min(stream->spec.channels, IMA_ADPCM_MAX_CHANNELS);
+    int samplesleft = stream->samplesperblock - 1;
+    int c, i;
+
+    /* Grab the initial information for this block */
+    for (c = 0; c < channels; ++c) {
+        state[c].sample = (Sint16) ((encoded[1] << 8) | encoded[0]);
+        state[c].index = (Sint8) encoded[2];
+        /* encoded[3] is a reserved byte, should be 0 */
+        encoded += 4;
+
+        /* Store the initial sample we start with */
+        *(decoded++) = (Sint16) SDL_SwapLE16((Sint16) state[c].sample);
     }
-    decoded = *audio_buf;
-
-    /* Get ready... Go! */
-    while (encoded_len >= IMA_ADPCM_state.wavefmt.blockalign) {
-        /* Grab the initial information for this block */
-        for (c = 0; c < channels; ++c) {
-            /* Fill the state information for this block */
-            state[c].sample = ((encoded[1] << 8) | encoded[0]);
-            encoded += 2;
-            if (state[c].sample & 0x8000) {
-                state[c].sample -= 0x10000;
-            }
-            state[c].index = *encoded++;
-            /* Reserved byte in buffer header, should be 0 */
-            if (*encoded++ != 0) {
-                /* Uh oh, corrupt data?  Buggy code? */ ;
-            }
-
-            /* Store the initial sample we start with */
-            decoded[0] = (Uint8) (state[c].sample & 0xFF);
-            decoded[1] = (Uint8) (state[c].sample >> 8);
-            decoded += 2;
-        }
 
-        /* Decode and store the other samples in this block */
-        samplesleft = (IMA_ADPCM_state.wSamplesPerBlock - 1) * channels;
-        while (samplesleft > 0) {
-            for (c = 0; c < channels; ++c) {
-                Fill_IMA_ADPCM_block(decoded, encoded,
-                                     c, channels, &state[c]);
-                encoded += 4;
-                samplesleft -= 8;
+    /* Decode and store the other samples in this block. The file has 8
+       samples of one channel, then 8 of the next, but each channel only
+       depends on itself, so step through all the channels together: the
+       output comes out in order, and the CPU gets several independent
+       samples to work on at a time. */
+    for (; samplesleft > 0; samplesleft -= 8) {
+        const int samples = SDL_min(samplesleft, 8);
+        for (i = 0; i < samples; i++) {
+            const int byteoffset = i >> 1;
+            const int shift = (i & 1) << 2;  /* low nibble first */
+            for (c = 0; c < channels; c++) {
+                const Uint8 nybble = (encoded[(c * 4) + byteoffset] >> shift) & 0x0F;
+                *(decoded++) = (Sint16) SDL_SwapLE16(IMA_ADPCM_nibble(&state[c], nybble));
             }
-            decoded += (channels * 8 * 2);
         }
-        encoded_len -= IMA_ADPCM_state.wavefmt.blockalign;
+        encoded += channels * 4;
     }
-    SDL_free(freeable);
-    return (0);
+    return 0;
 }
 
 
+/* GUIDs that are used by WAVE_FORMAT_EXTENSIBLE */
+static const Uint8 extensible_pcm_guid[16] = { 1, 0, 0, 0, 0, 0, 16, 0, 128, 0, 0, 170, 0, 56, 155, 113 };
+static const Uint8 extensible_ieee_guid[16] = { 3, 0, 0, 0, 0, 0, 16, 0, 128, 0, 0, 170, 0, 56, 155, 113 };
+
 static int
-ConvertSint24ToSint32(Uint8 ** audio_buf, Uint32 * audio_len)
+ReadChunk(SDL_RWops * src, Chunk * chunk)
 {
-    const double DIVBY8388608 = 0.00000011920928955078125;
-    const Uint32 original_len = *audio_len;
-    const Uint32 samples = original_len / 3;
-    const Uint32 expanded_len = samples * sizeof (Uint32);
-    Uint8 *ptr = (Uint8 *) SDL_realloc(*audio_buf, expanded_len);
-    const Uint8 *src;
-    Uint32 *dst;
-    Uint32 i;
-
-    if (!ptr) {
+    chunk->magic = SDL_ReadLE32(src);
+    chunk->length = SDL_ReadLE32(src);
+    chunk->data = (Uint8 *) SDL_malloc(chunk->length);
+    if (chunk->data == NULL) {
         return SDL_OutOfMemory();
     }
+    if (SDL_RWread(src, chunk->data, chunk->length, 1) != 1) {
+        SDL_free(chunk->data);
+        chunk->data = NULL;
+        return SDL_Error(SDL_EFREAD);
+    }
+    return (chunk->length);
+}
 
-    *audio_buf = ptr;
-    *audio_len = expanded_len;
+/* Steps over a chunk we don't care about, without loading it. */
+static int
+SkipChunk(SDL_RWops * src, Uint32 length)
+{
+    Uint8 scratch[1024];
 
-    /* work from end to start, since we're expanding in-place. */
-    src = (ptr + original_len) - 3;
-    dst = ((Uint32 *) (ptr + expanded_len)) - 1;
-    for (i = 0; i < samples; i++) {
-        /* There's probably a faster way to do all this. */
-        const Sint32 converted = ((Sint32) ( (((Uint32) src[2]) << 24) |
-                                             (((Uint32) src[1]) << 16) |
-                                             (((Uint32) src[0]) << 8) )) >> 8;
-        const double scaled = (((double) converted) * DIVBY8388608);
-        src -= 3;
-        *(dst--) = (Sint32) (scaled * 2147483647.0);
+    if (SDL_RWseek(src, length, RW_SEEK_CUR) >= 0) {
+        return 0;
     }
 
+    /* can't seek? Read it instead. */
+    while (length > 0) {
+        const Uint32 amount = SDL_min(length, sizeof (scratch));
+        if (SDL_RWread(src, scratch, amount, 1) != 1) {
+            return SDL_Error(SDL_EFREAD);
+        }
+        length -= amount;
+    }
     return 0;
 }
 
+/* Leaves src at the end of the RIFF chunk, whether or not the data was
+   all read, like SDL_LoadWAV_RW() always has. */
+static void
+SeekToEndOfWAV(SDL_WAVStream *stream)
+{
+    if (stream->riffend >= 0) {
+        SDL_RWseek(stream->src, stream->riffend, RW_SEEK_SET);
+    } else {
+        const Uint32 consumed = stream->datalen - stream->data_left;
+        SDL_RWseek(stream->src, stream->wavelen - consumed - stream->headerDiff, RW_SEEK_CUR);
+    }
+}
 
-/* GUIDs that are used by WAVE_FORMAT_EXTENSIBLE */
-static const Uint8 extensible_pcm_guid[16] = { 1, 0, 0, 0, 0, 0, 16, 0, 128, 0, 0, 170, 0, 56, 155, 113 };
-static const Uint8 extensible_ieee_guid[16] = { 3, 0, 0, 0, 0, 0, 16, 0, 128, 0, 0, 170, 0, 56, 155, 113 };
-
-SDL_AudioSpec *
-SDL_LoadWAV_RW(SDL_RWops * src, int freesrc,
-               SDL_AudioSpec * spec, Uint8 ** audio_buf, Uint32 * audio_len)
+/* Reads the headers and leaves src at the start of the audio data. If that
+   fails after the RIFF header was found, src is left at the end of the RIFF
+   chunk unless the stream is going to close it. */
+static int
+ReadWAVHeader(SDL_WAVStream *stream)
 {
-    int was_error;
+    SDL_RWops *src = stream->src;
+    SDL_AudioSpec *spec = &stream->spec;
     Chunk chunk;
     int lenread;
-    int IEEE_float_encoded, MS_ADPCM_encoded, IMA_ADPCM_encoded;
-    int samplesize;
+    int IEEE_float_encoded;
+    WaveFMT *format = NULL;
+    WaveExtensibleFMT *ext = NULL;
+    int was_error = 0;
 
     /* WAV magic header */
     Uint32 RIFFchunk;
@@ -460,19 +417,8 @@ SDL_LoadWAV_RW(SDL_RWops * src, int freesrc,
     Uint32 WAVEmagic;
     Uint32 headerDiff = 0;
 
-    /* FMT chunk */
-    WaveFMT *format = NULL;
-    WaveExtensibleFMT *ext = NULL;
-
     SDL_zero(chunk);
 
-    /* Make sure we are passed a valid data source */
-    was_error = 0;
-    if (src == NULL) {
-        was_error = 1;
-        goto done;
-    }
-
     /* Check the magic header */
     RIFFchunk = SDL_ReadLE32(src);
     wavelen = SDL_ReadLE32(src);
@@ -484,11 +430,14 @@ SDL_LoadWAV_RW(SDL_RWops * src, int freesrc,
         WAVEmagic = SDL_ReadLE32(src);
     }
     if ((RIFFchunk != RIFF) || (WAVEmagic != WAVE)) {
-        SDL_SetError("Unrecognized file type (not WAVE)");
-        was_error = 1;
-        goto done;
+        return SDL_SetError("Unrecognized file type (not WAVE)");
     }
     headerDiff += sizeof(Uint32);       /* for WAVE */
+    stream->wavelen = wavelen;
+    stream->riffend = SDL_RWtell(src);
+    if (stream->riffend >= 0) {
+        stream->riffend += wavelen - headerDiff;
+    }
 
     /* Read the audio data format chunk */
     chunk.data = NULL;
@@ -511,8 +460,28 @@ SDL_LoadWAV_RW(SDL_RWops * src, int freesrc,
         was_error = 1;
         goto done;
     }
-    IEEE_float_encoded = MS_ADPCM_encoded = IMA_ADPCM_encoded = 0;
-    switch (SDL_SwapLE16(format->encoding)) {
+    if (chunk.length < sizeof (WaveFMT)) {
+        SDL_SetError("WAVE format chunk too small");
+        was_error = 1;
+        goto done;
+    }
+
+    SDL_zerop(spec);
+    spec->freq = SDL_SwapLE32(format->frequency);
+    spec->channels = (Uint8) SDL_SwapLE16(format->channels);
+    spec->samples = 4096;       /* Good default buffer size */
+    stream->encoding = SDL_SwapLE16(format->encoding);
+    stream->bitspersample = SDL_SwapLE16(format->bitspersample);
+    stream->blockalign = SDL_SwapLE16(format->blockalign);
+
+    if (spec->channels == 0) {
+        SDL_SetError("WAVE file has no channels");
+        was_error = 1;
+        goto done;
+    }
+
+    IEEE_float_encoded = 0;
+    switch (stream->encoding) {
     case PCM_CODE:
         /* We can understand this */
         break;
@@ -522,19 +491,17 @@ SDL_LoadWAV_RW(SDL_RWops * src, int freesrc,
         break;
     case MS_ADPCM_CODE:
         /* Try to understand this */
-        if (InitMS_ADPCM(format) < 0) {
+        if (InitMS_ADPCM(stream, chunk.data, chunk.length) < 0) {
             was_error = 1;
             goto done;
         }
-        MS_ADPCM_encoded = 1;
         break;
     case IMA_ADPCM_CODE:
         /* Try to understand this */
-        if (InitIMA_ADPCM(format) < 0) {
+        if (InitIMA_ADPCM(stream, chunk.data, chunk.length) < 0) {
             was_error = 1;
             goto done;
         }
-        IMA_ADPCM_encoded = 1;
         break;
     case EXTENSIBLE_CODE:
         /* note that this ignores channel masks, smaller valid bit counts
@@ -542,14 +509,16 @@ SDL_LoadWAV_RW(SDL_RWops * src, int freesrc,
            to get things that didn't really _need_ WAVE_FORMAT_EXTENSIBLE
            to be useful working when they use this format flag. */
         ext = (WaveExtensibleFMT *) format;
-        if (SDL_SwapLE16(ext->size) < 22) {
+        if ((chunk.length < sizeof (WaveExtensibleFMT)) || (SDL_SwapLE16(ext->size) < 22)) {
             SDL_SetError("bogus extended .wav header");
             was_error = 1;
             goto done;
         }
+        stream->encoding = PCM_CODE;
         if (SDL_memcmp(ext->subformat, extensible_pcm_guid, 16) == 0) {
             break;  /* cool. */
         } else if (SDL_memcmp(ext->subformat, extensible_ieee_guid, 16) == 0) {
+            stream->encoding = IEEE_FLOAT_CODE;
             IEEE_float_encoded = 1;
             break;
         }
@@ -559,24 +528,21 @@ SDL_LoadWAV_RW(SDL_RWops * src, int freesrc,
         was_error = 1;
         goto done;
     default:
-        SDL_SetError("Unknown WAVE data format: 0x%.4x",
-                     SDL_SwapLE16(format->encoding));
+        SDL_SetError("Unknown WAVE data format: 0x%.4x", stream->encoding);
         was_error = 1;
         goto done;
     }
-    SDL_zerop(spec);
-    spec->freq = SDL_SwapLE32(format->frequency);
 
     if (IEEE_float_encoded) {
-        if ((SDL_SwapLE16(format->bitspersample)) != 32) {
+        if (stream->bitspersample != 32) {
             was_error = 1;
         } else {
             spec->format = AUDIO_F32;
         }
     } else {
-        switch (SDL_SwapLE16(format->bitspersample)) {
+        switch (stream->bitspersample) {
         case 4:
-            if (MS_ADPCM_encoded || IMA_ADPCM_encoded) {
+            if ((stream->encoding == MS_ADPCM_CODE) || (stream->encoding == IMA_ADPCM_CODE)) {
                 spec->format = AUDIO_S16;
             } else {
                 was_error = 1;
@@ -601,94 +567,363 @@ SDL_LoadWAV_RW(SDL_RWops * src, int freesrc,
     }
 
     if (was_error) {
-        SDL_SetError("Unknown %d-bit PCM data format",
-                     SDL_SwapLE16(format->bitspersample));
+        SDL_SetError("Unknown %d-bit PCM data format", stream->bitspersample);
         goto done;
     }
-    spec->channels = (Uint8) SDL_SwapLE16(format->channels);
-    spec->samples = 4096;       /* Good default buffer size */
 
-    /* Read the audio data chunk */
-    *audio_buf = NULL;
-    do {
-        SDL_free(*audio_buf);
-        *audio_buf = NULL;
-        lenread = ReadChunk(src, &chunk);
-        if (lenread < 0) {
+    /* Find the audio data chunk, skipping anything else. */
+    for (;;) {
+        chunk.magic = SDL_ReadLE32(src);
+        chunk.length = SDL_ReadLE32(src);
+        headerDiff += 2 * sizeof(Uint32);   /* for the chunk header and len */
+        if (chunk.magic == DATA) {
+            break;
+        } else if (chunk.magic == 0 && chunk.length == 0) {
+            /* ran off the end of the file (or it's full of zeros). */
+            SDL_Error(SDL_EFREAD);
             was_error = 1;
             goto done;
-        }
-        *audio_len = lenread;
-        *audio_buf = chunk.data;
-        if (chunk.magic != DATA)
-            headerDiff += lenread + 2 * sizeof(Uint32);
-    } while (chunk.magic != DATA);
-    headerDiff += 2 * sizeof(Uint32);   /* for the data chunk and len */
-
-    if (MS_ADPCM_encoded) {
-        if (MS_ADPCM_decode(audio_buf, audio_len) < 0) {
+        } else if (SkipChunk(src, chunk.length) < 0) {
             was_error = 1;
             goto done;
         }
+        headerDiff += chunk.length;
     }
-    if (IMA_ADPCM_encoded) {
-        if (IMA_ADPCM_decode(audio_buf, audio_len) < 0) {
-            was_error = 1;
-            goto done;
-        }
+
+    stream->framesize = ((SDL_AUDIO_BITSIZE(spec->format)) / 8) * spec->channels;
+    stream->datalen = stream->data_left = chunk.length;
+    if ((stream->encoding == MS_ADPCM_CODE) || (stream->encoding == IMA_ADPCM_CODE)) {
+        stream->src_framesize = 0;
+        stream->blocksize = stream->samplesperblock * stream->framesize;
+        stream->decoded_len = (Uint64) (chunk.length / stream->blockalign) * stream->blocksize;
+    } else {
+        stream->src_framesize = (stream->bitspersample / 8) * spec->channels;
+        stream->decoded_len = (Uint64) (chunk.length / stream->src_framesize) * stream->framesize;
     }
 
-    if (SDL_SwapLE16(format->bitspersample) == 24) {
-        if (ConvertSint24ToSint32(audio_buf, audio_len) < 0) {
-            was_error = 1;
-            goto done;
+  done:
+    SDL_free(format);
+    stream->headerDiff = headerDiff;
+    if (was_error) {
+        if (!stream->freesrc) {
+            SeekToEndOfWAV(stream);
         }
+        return -1;
     }
+    return 0;
+}
 
-    /* Don't return a buffer that isn't a multiple of samplesize */
-    samplesize = ((SDL_AUDIO_BITSIZE(spec->format)) / 8) * spec->channels;
-    *audio_len &= ~(samplesize - 1);
+SDL_WAVStream *
+SDL_OpenWAVStream_RW(SDL_RWops * src, int freesrc, SDL_AudioSpec * spec)
+{
+    SDL_WAVStream *stream;
 
-  done:
-    SDL_free(format);
-    if (src) {
+    /* Make sure we are passed a valid data source */
+    if (src == NULL) {
+        SDL_InvalidParamError("src");
+        return NULL;
+    }
+
+    stream = (SDL_WAVStream *) SDL_calloc(1, sizeof (SDL_WAVStream));
+    if (!stream) {
+        SDL_OutOfMemory();
         if (freesrc) {
             SDL_RWclose(src);
+        }
+        return NULL;
+    }
+    stream->src = src;
+    stream->freesrc = freesrc;
+
+    if (ReadWAVHeader(stream) < 0) {
+        SDL_CloseWAVStream(stream);
+        return NULL;
+    }
+
+    if (stream->blocksize) {
+        stream->encoded = (Uint8 *) SDL_malloc(stream->blockalign * WAVE_BLOCKS_PER_READ);
+        stream->block = (Uint8 *) SDL_malloc(stream->blocksize);
+        if (!stream->encoded || !stream->block) {
+            SDL_OutOfMemory();
+            SDL_CloseWAVStream(stream);
+            return NULL;
+        }
+    }
+
+    if (spec) {
+        *spec = stream->spec;
+    }
+    return stream;
+}
+
+/* Reads and decodes up to (blocks) ADPCM blocks to decoded. Returns how
+   many blocks that was. Blocks decoded before a truncated file or a bad
+   block are still returned; the bad block's error comes from the next
+   call, so the decoder's error message is the one left set. */
+static int
+ReadADPCMBlocks(SDL_WAVStream *stream, Uint8 *decoded, int blocks)
+{
+    int (*decode_block)(const SDL_WAVStream *, const Uint8 *, Sint16 *);
+    const Uint8 *encoded = stream->encoded;
+    int blocksread, i;
+
+    if (stream->failed) {
+        return -1;
+    }
+
+    decode_block = (stream->encoding == MS_ADPCM_CODE) ? MS_ADPCM_decode_block : IMA_ADPCM_decode_block;
+    blocks = SDL_min(blocks, WAVE_BLOCKS_PER_READ);
+    blocks = (int) SDL_min((Uint32) blocks, stream->data_left / stream->blockalign);
+    if (blocks == 0) {
+        return 0;
+    }
+
+    blocksread = (int) SDL_RWread(stream->src, stream->encoded, stream->blockalign, blocks);
+    if (blocksread < blocks) {
+        stream->data_left = 0;  /* truncated file; we're done. */
+        if (blocksread == 0) {
+            return SDL_Error(SDL_EFREAD);
+        }
+    } else {
+        stream->data_left -= blocks * stream->blockalign;
+    }
+
+    for (i = 0; i < blocksread; i++) {
+        if (decode_block(stream, encoded, (Sint16 *) decoded) < 0) {
+            stream->data_left = 0;
+            stream->failed = SDL_TRUE;
+            return (i == 0) ? -1 : i;
+        }
+        encoded += stream->blockalign;
+        decoded += stream->blocksize;
+    }
+    return blocksread;
+}
+
+static int
+ReadADPCM(SDL_WAVStream *stream, Uint8 *buf, int len)
+{
+    int total = 0;
+
+    while (len >= stream->framesize) {
+        int amount;
+
+        /* Hand out what's left of the last partial block first. */
+        if (stream->block_pos < stream->block_len) {
+            amount = SDL_min(len, stream->block_len - stream->block_pos);
+            SDL_memcpy(buf, stream->block + stream->block_pos, amount);
+            stream->block_pos += amount;
+        } else if (len >= stream->blocksize) {
+            /* Whole blocks decode straight into the caller's buffer. */
+            const int blocks = ReadADPCMBlocks(stream, buf, len / stream->blocksize);
+            if (blocks <= 0) {
+                return (blocks < 0 && total == 0) ? -1 : total;
+            }
+            amount = blocks * stream->blocksize;
         } else {
-            /* seek to the end of the file (given by the RIFF chunk) */
-            SDL_RWseek(src, wavelen - chunk.length - headerDiff, RW_SEEK_CUR);
+            const int blocks = ReadADPCMBlocks(stream, stream->block, 1);
+            if (blocks <= 0) {
+                return (blocks < 0 && total == 0) ? -1 : total;
+            }
+            stream->block_pos = 0;
+            stream->block_len = stream->blocksize;
+            continue;
         }
+        buf += amount;
+        len -= amount;
+        total += amount;
     }
-    if (was_error) {
-        spec = NULL;
+    return total;
+}
+
+static int
+ReadPCM(SDL_WAVStream *stream, Uint8 *buf, int len)
+{
+    const int src_framesize = stream->src_framesize;
+    const int frames = (int) SDL_min((Uint32) (len / stream->framesize), stream->data_left / src_framesize);
+    const int srclen = frames * src_framesize;
+    const int outlen = frames * stream->framesize;
+    Uint8 *srcbuf = buf + (outlen - srclen);  /* 24-bit samples get read in at the end. */
+    int framesread;
+
+    if (frames == 0) {
+        return 0;
     }
-    return (spec);
+
+    framesread = (int) SDL_RWread(stream->src, srcbuf, src_framesize, frames);
+    if (framesread < frames) {
+        stream->data_left = 0;  /* truncated file; we're done. */
+        if (framesread == 0) {
+            return SDL_Error(SDL_EFREAD);
+        }
+        if (srclen != outlen) {
+            /* move what we did get to where the conversion expects it. */
+            SDL_memmove(buf + (framesread * stream->framesize) - (framesread * src_framesize), srcbuf, framesread * src_framesize);
+            srcbuf = buf + (framesread * stream->framesize) - (framesread * src_framesize);
+        }
+    } else {
+        stream->data_left -= srclen;
+    }
+
+    if (stream->bitspersample == 24) {
+        /* Expand to 32 bits in place. The 24-bit data sits at the end of
+           the buffer, so working front to back never overwrites a sample
+           before it's converted. */
+        const double DIVBY8388608 = 0.00000011920928955078125;
+        const int samples = framesread * stream->spec.channels;
+        const Uint8 *src = srcbuf;
+        Uint32 *dst = (Uint32 *) buf;
+        int i;
+        for (i = 0; i < samples; i++) {
+            /* There's probably a faster way to do all this. */
+            const Sint32 converted = ((Sint32) ( (((Uint32) src[2]) << 24) |
+                                                 (((Uint32) src[1]) << 16) |
+                                                 (((Uint32) src[0]) << 8) )) >> 8;
+            const double scaled = (((double) converted) * DIVBY8388608);
+            src += 3;
+            *(dst++) = (Sint32) (scaled * 2147483647.0);
+        }
+    }
+
+    return framesread * stream->framesize;
+}
+
+int
+SDL_ReadWAVStream(SDL_WAVStream * stream, void *buf, int len)
+{
+    if (!stream) {
+        return SDL_InvalidParamError("stream");
+    } else if (!buf) {
+        return SDL_InvalidParamError("buf");
+    } else if (len <= 0) {
+        return 0;  /* nothing to do. */
+    } else if ((len % stream->framesize) != 0) {
+        return SDL_SetError("Can't request partial sample frames");
+    }
+
+    if (stream->blocksize) {
+        return ReadADPCM(stream, (Uint8 *) buf, len);
+    }
+    return ReadPCM(stream, (Uint8 *) buf, len);
+}
+
+int
+SDL_ReadWAVStreamToAudioStream(SDL_WAVStream * stream, SDL_AudioStream * audiostream, int len)
+{
+    int total = 0;
+
+    if (!stream) {
+        return SDL_InvalidParamError("stream");
+    } else if (!audiostream) {
+        return SDL_InvalidParamError("audiostream");
+    }
+
+    if (!stream->putbuf) {
+        stream->putbuf = (Uint8 *) SDL_malloc(WAVE_PUT_CHUNK_SIZE);
+        if (!stream->putbuf) {
+            return SDL_OutOfMemory();
+        }
+    }
+
+    len -= len % stream->framesize;
+    while (len > 0) {
+        const int chunk = SDL_min(len, WAVE_PUT_CHUNK_SIZE - (WAVE_PUT_CHUNK_SIZE % stream->framesize));
+        const int amount = SDL_ReadWAVStream(stream, stream->putbuf, chunk);
+        if (amount < 0) {
+            return (total == 0) ? -1 : total;
+        } else if (amount == 0) {
+            break;  /* end of the data. */
+        } else if (SDL_AudioStreamPut(audiostream, stream->putbuf, amount) < 0) {
+            return -1;
+        }
+        total += amount;
+        len -= amount;
+    }
+    return total;
 }
 
-/* Since the WAV memory is allocated in the shared library, it must also
-   be freed here.  (Necessary under Win32, VC++)
- */
 void
-SDL_FreeWAV(Uint8 * audio_buf)
+SDL_CloseWAVStream(SDL_WAVStream * stream)
 {
-    SDL_free(audio_buf);
+    if (stream) {
+        if (stream->freesrc) {
+            SDL_RWclose(stream->src);
+        }
+        SDL_free(stream->encoded);
+        SDL_free(stream->block);
+        SDL_free(stream->putbuf);
+        SDL_free(stream);
+    }
 }
 
-static int
-ReadChunk(SDL_RWops * src, Chunk * chunk)
+SDL_AudioSpec *
+SDL_LoadWAV_RW(SDL_RWops * src, int freesrc,
+               SDL_AudioSpec * spec, Uint8 ** audio_buf, Uint32 * audio_len)
 {
-    chunk->magic = SDL_ReadLE32(src);
-    chunk->length = SDL_ReadLE32(src);
-    chunk->data = (Uint8 *) SDL_malloc(chunk->length);
-    if (chunk->data == NULL) {
-        return SDL_OutOfMemory();
+    SDL_WAVStream *stream;
+    Uint8 *buf;
+    Uint32 total = 0;
+
+    /* the stream closes src for us, if it's supposed to. */
+    stream = SDL_OpenWAVStream_RW(src, freesrc, spec);
+    if (!stream) {
+        return NULL;
     }
-    if (SDL_RWread(src, chunk->data, chunk->length, 1) != 1) {
-        SDL_free(chunk->data);
-        chunk->data = NULL;
-        return SDL_Error(SDL_EFREAD);
+
+    /* We know exactly how big the decoded data is, so decode it all at
+       once, straight into the buffer we return. 24-bit PCM and ADPCM grow
+       when they're decoded, so a data chunk that fits in a file can still
+       decode to more than audio_len can hold. */
+    if (stream->decoded_len > SDL_MAX_UINT32 || stream->decoded_len > (Uint64) ((size_t) -1)) {
+        SDL_SetError("WAVE data decodes to more than fits in memory at once; use SDL_OpenWAVStream_RW()");
+        goto error;
     }
-    return (chunk->length);
+    buf = (Uint8 *) SDL_malloc(SDL_max((size_t) stream->decoded_len, 1));
+    if (!buf) {
+        SDL_OutOfMemory();
+        goto error;
+    }
+
+    /* SDL_ReadWAVStream() takes an int, so read in whole frames at most
+       SDL_MAX_SINT32 bytes at a time. */
+    while (total < stream->decoded_len) {
+        const Uint32 maxchunk = SDL_MAX_SINT32 - (SDL_MAX_SINT32 % stream->framesize);
+        const int chunk = (int) SDL_min((Uint32) stream->decoded_len - total, maxchunk);
+        const int lenread = SDL_ReadWAVStream(stream, buf + total, chunk);
+        if (lenread <= 0) {
+            if (lenread == 0) {
+                SDL_Error(SDL_EFREAD);  /* truncated file. */
+            }
+            SDL_free(buf);
+            goto error;
+        }
+        total += (Uint32) lenread;
+    }
+
+    if (!freesrc) {
+        SeekToEndOfWAV(stream);
+    }
+    SDL_CloseWAVStream(stream);
+    *audio_buf = buf;
+    *audio_len = total;
+    return spec;
+
+  error:
+    if (!freesrc) {
+        SeekToEndOfWAV(stream);
+    }
+    SDL_CloseWAVStream(stream);
+    *audio_buf = NULL;
+    return NULL;
+}
+
+/* Since the WAV memory is allocated in the shared library, it must also
+   be freed here.  (Necessary under Win32, VC++)
+ */
+void
+SDL_FreeWAV(Uint8 * audio_buf)
+{
+    SDL_free(audio_buf);
 }
 
 /* vi: set ts=4 sw=4 expandtab: */
@@ -42,12 +42,18 @@
 #define DISKENVR_INFILE         "SDL_DISKAUDIOFILEIN"
 #define DISKDEFAULT_INFILE      "sdlaudio-in.raw"
 #define DISKENVR_IODELAY      "SDL_DISKAUDIODELAY"
+#define DISKENVR_FREQ         "SDL_DISKAUDIOFREQ"
+#define DISKENVR_CHANNELS     "SDL_DISKAUDIOCHANNELS"
+#define DISKENVR_FORMAT       "SDL_DISKAUDIOFORMAT"
 
 /* This function waits until it is possible to write a full sound buffer */
 static void
 DISKAUDIO_WaitDevice(_THIS)
 {
-    SDL_Delay(this->hidden->io_delay);
+    /* a delay of 0 runs the audio thread as fast as it can go, for benchmarks. */
+    if (this->hidden->io_delay) {
+        SDL_Delay(this->hidden->io_delay);
+    }
 }
 
 static void
@@ -78,7 +84,9 @@ DISKAUDIO_CaptureFromDevice(_THIS, void *buffer, int buflen)
     struct SDL_PrivateAudioData *h = this->hidden;
     const int origbuflen = buflen;
 
-    SDL_Delay(h->io_delay);
+    if (h->io_delay) {
+        SDL_Delay(h->io_delay);
+    }
 
     if (h->io) {
         const size_t br = SDL_RWread(h->io, buffer, 1, buflen);
@@ -126,6 +134,50 @@ get_filename(const int iscapture, const char *devname)
     return devname;
 }
 
+/* Pretend to be a device that only takes one format, so SDL has to convert
+   to it; this is how the conversion and resampling paths get exercised (and
+   benchmarked) without a sound card. */
+static int
+force_device_format(_THIS)
+{
+    static const struct { const char *name; SDL_AudioFormat format; } formats[] = {
+        { "U8", AUDIO_U8 }, { "S8", AUDIO_S8 }, { "U16", AUDIO_U16SYS },
+        { "S16", AUDIO_S16SYS }, { "S32", AUDIO_S32SYS }, { "F32", AUDIO_F32SYS }
+    };
+    const char *freq = SDL_getenv(DISKENVR_FREQ);
+    const char *channels = SDL_getenv(DISKENVR_CHANNELS);
+    const char *format = SDL_getenv(DISKENVR_FORMAT);
+    int i;
+
+    if (freq) {
+        this->spec.freq = SDL_atoi(freq);
+        if (this->spec.freq <= 0) {
+            return SDL_SetError("Invalid %s: %s", DISKENVR_FREQ, freq);
+        }
+    }
+    if (channels) {
+        const int chans = SDL_atoi(channels);
+        if ((chans != 1) && (chans != 2) && (chans != 4) && (chans != 6) && (chans != 8)) {
+            return SDL_SetError("Invalid %s: %s", DISKENVR_CHANNELS, channels);
+        }
+        this->spec.channels = (Uint8) chans;
+    }
+    if (format) {
+        for (i = 0; i < SDL_arraysize(formats); i++) {
+            if (SDL_strcasecmp(format, formats[i].name) == 0) {
+                this->spec.format = formats[i].format;
+                break;
+            }
+        }
+        if (i == SDL_arraysize(formats)) {
+            return SDL_SetError("Invalid %s: %s", DISKENVR_FORMAT, format);
+        }
+    }
+
+    SDL_CalculateAudioSpec(&this->spec);
+    return 0;
+}
+
 static int
 DISKAUDIO_OpenDevice(_THIS, void *handle, const char *devname, int iscapture)
 {
@@ -133,6 +185,10 @@ DISKAUDIO_OpenDevice(_THIS, void *handle, const char *devname, int iscapture)
     const char *fname = get_filename(iscapture, handle ? NULL : devname);
     const char *envr = SDL_getenv(DISKENVR_IODELAY);
 
+    if (force_device_format(this) < 0) {
+        return -1;
+    }
+
     this->hidden = (struct SDL_PrivateAudioData *)
         SDL_malloc(sizeof(*this->hidden));
     if (this->hidden == NULL) {
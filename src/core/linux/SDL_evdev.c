@@ -33,6 +33,7 @@
 #include "SDL_evdev_kbd.h"
 
 #include <sys/stat.h>
+#include <sys/time.h>
 #include <unistd.h>
 #include <fcntl.h>
 #include <sys/ioctl.h>
@@ -105,6 +106,7 @@ typedef struct SDL_EVDEV_PrivateData
 static _THIS = NULL;
 
 static SDL_Scancode SDL_EVDEV_translate_keycode(int keycode);
+static void SDL_EVDEV_set_source_time(const struct timeval *time);
 static void SDL_EVDEV_sync_device(SDL_evdevlist_item *item);
 static int SDL_EVDEV_device_removed(const char *dev_path);
 
@@ -251,6 +253,8 @@ SDL_EVDEV_Poll(void)
                     break;
                 }
 
+                SDL_EVDEV_set_source_time(&events[i].time);
+
                 switch (events[i].type) {
                 case EV_KEY:
                     if (events[i].code >= BTN_MOUSE && events[i].code < BTN_MOUSE + SDL_arraysize(EVDEV_MouseButtons)) {
@@ -386,6 +390,25 @@ SDL_EVDEV_Poll(void)
             }
         }    
     }
+
+    SDL_SetEventSourceTime(0);
+}
+
+/* Input events are stamped with CLOCK_REALTIME unless asked otherwise. Work
+   out when on SDL's clock that was, so the event queue can pass it along. */
+static void
+SDL_EVDEV_set_source_time(const struct timeval *time)
+{
+    struct timeval now;
+    Uint64 source = 0;
+
+    if (gettimeofday(&now, NULL) == 0) {
+        const Sint64 age = ((Sint64) (now.tv_sec - time->tv_sec) * 1000000) + (now.tv_usec - time->tv_usec);
+        if (age >= 0 && age < 1000000) {
+            source = SDL_GetPerformanceCounter() - (((Uint64) age * SDL_GetPerformanceFrequency()) / 1000000);
+        }
+    }
+    SDL_SetEventSourceTime(source);
 }
 
 static SDL_Scancode
@@ -665,3 +665,17 @@
 #define SDL_GetYUVConversionModeForResolution SDL_GetYUVConversionModeForResolution_REAL
 #define SDL_RenderGetMetalLayer SDL_RenderGetMetalLayer_REAL
 #define SDL_RenderGetMetalCommandEncoder SDL_RenderGetMetalCommandEncoder_REAL
+#define SDL_RenderSetTexturePoolBudget SDL_RenderSetTexturePoolBudget_REAL
+#define SDL_RenderTrimTexturePool SDL_RenderTrimTexturePool_REAL
+#define SDL_MixAudioFormatMulti SDL_MixAudioFormatMulti_REAL
+#define SDL_AudioStreamPeek SDL_AudioStreamPeek_REAL
+#define SDL_AudioStreamCommit SDL_AudioStreamCommit_REAL
+#define SDL_AudioStreamSetRateAdjust SDL_AudioStreamSetRateAdjust_REAL
+#define SDL_OpenWAVStream_RW SDL_OpenWAVStream_RW_REAL
+#define SDL_ReadWAVStream SDL_ReadWAVStream_REAL
+#define SDL_ReadWAVStreamToAudioStream SDL_ReadWAVStreamToAudioStream_REAL
+#define SDL_CloseWAVStream SDL_CloseWAVStream_REAL
+#define SDL_GetAudioDeviceStats SDL_GetAudioDeviceStats_REAL
+#define SDL_PollEvents SDL_PollEvents_REAL
+#define SDL_PeepEventsWithTimestamps SDL_PeepEventsWithTimestamps_REAL
+#define SDL_GetEventLatencyHistogram SDL_GetEventLatencyHistogram_REAL
@@ -699,3 +699,17 @@ SDL_DYNAPI_PROC(SDL_YUV_CONVERSION_MODE,SDL_GetYUVConversionMode,(void),(),retur
 SDL_DYNAPI_PROC(SDL_YUV_CONVERSION_MODE,SDL_GetYUVConversionModeForResolution,(int a, int b),(a,b),return)
 SDL_DYNAPI_PROC(void*,SDL_RenderGetMetalLayer,(SDL_Renderer *a),(a),return)
 SDL_DYNAPI_PROC(void*,SDL_RenderGetMetalCommandEncoder,(SDL_Renderer *a),(a),return)
+SDL_DYNAPI_PROC(int,SDL_RenderSetTexturePoolBudget,(SDL_Renderer *a, size_t b),(a,b),return)
+SDL_DYNAPI_PROC(int,SDL_RenderTrimTexturePool,(SDL_Renderer *a, size_t b),(a,b),return)
+SDL_DYNAPI_PROC(void,SDL_MixAudioFormatMulti,(Uint8 *a, const Uint8 * const *b, const int *c, int d, SDL_AudioFormat e, Uint32 f),(a,b,c,d,e,f),)
+SDL_DYNAPI_PROC(int,SDL_AudioStreamPeek,(SDL_AudioStream *a, const void **b),(a,b),return)
+SDL_DYNAPI_PROC(int,SDL_AudioStreamCommit,(SDL_AudioStream *a, int b),(a,b),return)
+SDL_DYNAPI_PROC(int,SDL_AudioStreamSetRateAdjust,(SDL_AudioStream *a, float b),(a,b),return)
+SDL_DYNAPI_PROC(SDL_WAVStream*,SDL_OpenWAVStream_RW,(SDL_RWops *a, int b, SDL_AudioSpec *c),(a,b,c),return)
+SDL_DYNAPI_PROC(int,SDL_ReadWAVStream,(SDL_WAVStream *a, void *b, int c),(a,b,c),return)
+SDL_DYNAPI_PROC(int,SDL_ReadWAVStreamToAudioStream,(SDL_WAVStream *a, SDL_AudioStream *b, int c),(a,b,c),return)
+SDL_DYNAPI_PROC(void,SDL_CloseWAVStream,(SDL_WAVStream *a),(a),)
+SDL_DYNAPI_PROC(int,SDL_GetAudioDeviceStats,(SDL_AudioDeviceID a, SDL_AudioDeviceStats *b),(a,b),return)
+SDL_DYNAPI_PROC(int,SDL_PollEvents,(SDL_Event *a, int b, Uint32 c, Uint32 d),(a,b,c,d),return)
+SDL_DYNAPI_PROC(int,SDL_PeepEventsWithTimestamps,(SDL_Event *a, SDL_EventTimestamp *b, int c, SDL_eventaction d, Uint32 e, Uint32 f),(a,b,c,d,e,f),return)
+SDL_DYNAPI_PROC(int,SDL_GetEventLatencyHistogram,(Uint32 a, SDL_EventLatencyHistogram *b),(a,b),return)
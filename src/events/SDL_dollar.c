@@ -0,0 +1,357 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2017 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "../SDL_internal.h"
+
+/* The $1 gesture recognizer's template store and matcher */
+
+#include "SDL_cpuinfo.h"
+#include "SDL_dollar_c.h"
+
+#define PHI 0.618033989
+
+#ifdef __SSE__
+#define HAVE_SSE_INTRINSICS 1
+#endif
+
+/* 32-bit ARM has no vector square root, so only AArch64 gets NEON here */
+#if defined(__aarch64__) && defined(__ARM_NEON)
+#define HAVE_NEON_INTRINSICS 1
+#include <arm_neon.h>
+#endif
+
+typedef float (*SDL_DollarDistanceFunc)(const SDL_DollarStroke *stroke, const float *tx, const float *ty, float c, float s);
+typedef float (*SDL_DollarBoundFunc)(const float *radius, const float *tradius, float limit);
+
+static unsigned long
+SDL_HashDollar(const SDL_FloatPoint *points)
+{
+    unsigned long hash = 5381;
+    int i;
+    for (i = 0; i < DOLLARNPOINTS; i++) {
+        hash = ((hash<<5) + hash) + (unsigned long)points[i].x;
+        hash = ((hash<<5) + hash) + (unsigned long)points[i].y;
+    }
+    return hash;
+}
+
+void
+SDL_DollarSplitPath(const SDL_FloatPoint *path, float *x, float *y, float *radius)
+{
+    int i;
+    for (i = 0; i < DOLLARNPOINTS; i++) {
+        x[i] = path[i].x;
+        y[i] = path[i].y;
+        radius[i] = SDL_sqrtf(x[i]*x[i] + y[i]*y[i]);
+    }
+}
+
+void
+SDL_DollarGetPath(const SDL_DollarTemplates *templates, int index, SDL_FloatPoint *path)
+{
+    const float *x = &templates->x[index * DOLLARNPOINTS];
+    const float *y = &templates->y[index * DOLLARNPOINTS];
+    int i;
+    for (i = 0; i < DOLLARNPOINTS; i++) {
+        path[i].x = x[i];
+        path[i].y = y[i];
+    }
+}
+
+int
+SDL_DollarAddTemplate(SDL_DollarTemplates *templates, const SDL_FloatPoint *path)
+{
+    const int index = templates->numTemplates;
+
+    if (index == templates->maxTemplates) {
+        const int maxTemplates = index ? (index * 2) : 16;
+        const size_t rowsize = DOLLARNPOINTS * sizeof (float);
+        unsigned long *hash;
+        float *ptr;
+
+        /* the old rows stay valid if one of these fails */
+        ptr = (float *) SDL_realloc(templates->x, maxTemplates * rowsize);
+        if (!ptr) {
+            return -1;
+        }
+        templates->x = ptr;
+        ptr = (float *) SDL_realloc(templates->y, maxTemplates * rowsize);
+        if (!ptr) {
+            return -1;
+        }
+        templates->y = ptr;
+        ptr = (float *) SDL_realloc(templates->radius, maxTemplates * rowsize);
+        if (!ptr) {
+            return -1;
+        }
+        templates->radius = ptr;
+        hash = (unsigned long *) SDL_realloc(templates->hash, maxTemplates * sizeof (*hash));
+        if (!hash) {
+            return -1;
+        }
+        templates->hash = hash;
+        templates->maxTemplates = maxTemplates;
+    }
+
+    SDL_DollarSplitPath(path,
+                        &templates->x[index * DOLLARNPOINTS],
+                        &templates->y[index * DOLLARNPOINTS],
+                        &templates->radius[index * DOLLARNPOINTS]);
+    templates->hash[index] = SDL_HashDollar(path);
+    templates->numTemplates++;
+    return index;
+}
+
+void
+SDL_DollarFreeTemplates(SDL_DollarTemplates *templates)
+{
+    SDL_free(templates->x);
+    SDL_free(templates->y);
+    SDL_free(templates->radius);
+    SDL_free(templates->hash);
+    SDL_zerop(templates);
+}
+
+/* Sum of the distances between the points of a stroke, rotated by the angle
+   with cosine c and sine s, and the points of a template. */
+static float
+SDL_DollarDistance_Scalar(const SDL_DollarStroke *stroke, const float *tx, const float *ty, float c, float s)
+{
+    float dist = 0;
+    int i;
+    for (i = 0; i < DOLLARNPOINTS; i++) {
+        const float dx = (stroke->x[i] * c - stroke->y[i] * s) - tx[i];
+        const float dy = (stroke->x[i] * s + stroke->y[i] * c) - ty[i];
+        dist += SDL_sqrtf(dx*dx + dy*dy);
+    }
+    return dist;
+}
+
+/* A lower bound on SDL_DollarDistance() at any angle. It's built up sixteen
+   points at a time and gives up once it reaches limit, since the rest can
+   only make it bigger. */
+static float
+SDL_DollarBound_Scalar(const float *radius, const float *tradius, float limit)
+{
+    float bound = 0;
+    int i, j;
+    for (i = 0; i < DOLLARNPOINTS; i += 16) {
+        for (j = i; j < i + 16; j++) {
+            const float d = radius[j] - tradius[j];
+            bound += (d < 0) ? -d : d;
+        }
+        if (bound >= limit) {
+            break;
+        }
+    }
+    return bound;
+}
+
+#if HAVE_SSE_INTRINSICS
+static float
+SDL_DollarDistance_SSE(const SDL_DollarStroke *stroke, const float *tx, const float *ty, float c, float s)
+{
+    const __m128 vc = _mm_set1_ps(c);
+    const __m128 vs = _mm_set1_ps(s);
+    __m128 sum = _mm_setzero_ps();
+    float result[4];
+    int i;
+    for (i = 0; i < DOLLARNPOINTS; i += 4) {
+        const __m128 px = _mm_loadu_ps(&stroke->x[i]);
+        const __m128 py = _mm_loadu_ps(&stroke->y[i]);
+        const __m128 dx = _mm_sub_ps(_mm_sub_ps(_mm_mul_ps(px, vc), _mm_mul_ps(py, vs)), _mm_loadu_ps(&tx[i]));
+        const __m128 dy = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(px, vs), _mm_mul_ps(py, vc)), _mm_loadu_ps(&ty[i]));
+        sum = _mm_add_ps(sum, _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy))));
+    }
+    _mm_storeu_ps(result, sum);
+    return (result[0] + result[1]) + (result[2] + result[3]);
+}
+
+static float
+SDL_DollarBound_SSE(const float *radius, const float *tradius, float limit)
+{
+    const __m128 signmask = _mm_set1_ps(-0.0f);
+    float result[4];
+    float bound = 0;
+    int i, j;
+    for (i = 0; i < DOLLARNPOINTS; i += 16) {
+        __m128 sum = _mm_setzero_ps();
+        for (j = i; j < i + 16; j += 4) {
+            const __m128 d = _mm_sub_ps(_mm_loadu_ps(&radius[j]), _mm_loadu_ps(&tradius[j]));
+            sum = _mm_add_ps(sum, _mm_andnot_ps(signmask, d));
+        }
+        _mm_storeu_ps(result, sum);
+        bound += (result[0] + result[1]) + (result[2] + result[3]);
+        if (bound >= limit) {
+            break;
+        }
+    }
+    return bound;
+}
+#endif
+
+#if HAVE_NEON_INTRINSICS
+static float
+SDL_DollarDistance_NEON(const SDL_DollarStroke *stroke, const float *tx, const float *ty, float c, float s)
+{
+    const float32x4_t vc = vdupq_n_f32(c);
+    const float32x4_t vs = vdupq_n_f32(s);
+    float32x4_t sum = vdupq_n_f32(0.0f);
+    int i;
+    for (i = 0; i < DOLLARNPOINTS; i += 4) {
+        const float32x4_t px = vld1q_f32(&stroke->x[i]);
+        const float32x4_t py = vld1q_f32(&stroke->y[i]);
+        const float32x4_t dx = vsubq_f32(vsubq_f32(vmulq_f32(px, vc), vmulq_f32(py, vs)), vld1q_f32(&tx[i]));
+        const float32x4_t dy = vsubq_f32(vaddq_f32(vmulq_f32(px, vs), vmulq_f32(py, vc)), vld1q_f32(&ty[i]));
+        sum = vaddq_f32(sum, vsqrtq_f32(vaddq_f32(vmulq_f32(dx, dx), vmulq_f32(dy, dy))));
+    }
+    return vaddvq_f32(sum);
+}
+
+static float
+SDL_DollarBound_NEON(const float *radius, const float *tradius, float limit)
+{
+    float bound = 0;
+    int i, j;
+    for (i = 0; i < DOLLARNPOINTS; i += 16) {
+        float32x4_t sum = vdupq_n_f32(0.0f);
+        for (j = i; j < i + 16; j += 4) {
+            sum = vaddq_f32(sum, vabdq_f32(vld1q_f32(&radius[j]), vld1q_f32(&tradius[j])));
+        }
+        bound += vaddvq_f32(sum);
+        if (bound >= limit) {
+            break;
+        }
+    }
+    return bound;
+}
+#endif
+
+static float
+SDL_DollarDifference(SDL_DollarDistanceFunc distance, const SDL_DollarStroke *stroke,
+                     const float *tx, const float *ty, float ang)
+{
+    return distance(stroke, tx, ty, SDL_cosf(ang), SDL_sinf(ang)) / DOLLARNPOINTS;
+}
+
+static float
+SDL_DollarBestDifference(SDL_DollarDistanceFunc distance, const SDL_DollarStroke *stroke,
+                         const SDL_DollarTemplates *templates, int index)
+{
+    /*------------BEGIN DOLLAR BLACKBOX------------------
+      -TRANSLATED DIRECTLY FROM PSUDEO-CODE AVAILABLE AT-
+      -"http://depts.washington.edu/aimgroup/proj/dollar/"
+    */
+    const float *tx = &templates->x[index * DOLLARNPOINTS];
+    const float *ty = &templates->y[index * DOLLARNPOINTS];
+    double ta = -M_PI/4;
+    double tb = M_PI/4;
+    double dt = M_PI/90;
+    float x1 = (float)(PHI*ta + (1-PHI)*tb);
+    float f1 = SDL_DollarDifference(distance,stroke,tx,ty,x1);
+    float x2 = (float)((1-PHI)*ta + PHI*tb);
+    float f2 = SDL_DollarDifference(distance,stroke,tx,ty,x2);
+    while (SDL_fabs(ta-tb) > dt) {
+        if (f1 < f2) {
+            tb = x2;
+            x2 = x1;
+            f2 = f1;
+            x1 = (float)(PHI*ta + (1-PHI)*tb);
+            f1 = SDL_DollarDifference(distance,stroke,tx,ty,x1);
+        }
+        else {
+            ta = x1;
+            x1 = x2;
+            f1 = f2;
+            x2 = (float)((1-PHI)*ta + PHI*tb);
+            f2 = SDL_DollarDifference(distance,stroke,tx,ty,x2);
+        }
+    }
+    return SDL_min(f1,f2);
+}
+
+float
+SDL_DollarRecognize(const SDL_DollarTemplates *templates, const SDL_DollarStroke *stroke,
+                    int flags, int *bestTempl)
+{
+    SDL_DollarDistanceFunc distance = SDL_DollarDistance_Scalar;
+    SDL_DollarBoundFunc bound = SDL_DollarBound_Scalar;
+    float bestDiff = 10000;
+    int first = -1;
+    int i;
+
+#if HAVE_SSE_INTRINSICS
+    if (!(flags & SDL_DOLLAR_SCALAR) && SDL_HasSSE()) {
+        distance = SDL_DollarDistance_SSE;
+        bound = SDL_DollarBound_SSE;
+    }
+#endif
+#if HAVE_NEON_INTRINSICS
+    if (!(flags & SDL_DOLLAR_SCALAR) && SDL_HasNEON()) {
+        distance = SDL_DollarDistance_NEON;
+        bound = SDL_DollarBound_NEON;
+    }
+#endif
+
+    *bestTempl = -1;
+
+    if (!(flags & SDL_DOLLAR_EXHAUSTIVE)) {
+        /* Try the template with the lowest bound first. It's usually the
+           match, and once we know how close that is, most of the others
+           can be ruled out by their bound alone. */
+        float lowest = bestDiff * DOLLARNPOINTS;
+        for (i = 0; i < templates->numTemplates; i++) {
+            const float b = bound(stroke->radius, &templates->radius[i * DOLLARNPOINTS], lowest);
+            if (b < lowest) {
+                lowest = b;
+                first = i;
+            }
+        }
+        if (first >= 0) {
+            const float diff = SDL_DollarBestDifference(distance, stroke, templates, first);
+            if (diff < bestDiff) {
+                bestDiff = diff;
+                *bestTempl = first;
+            }
+        }
+    }
+
+    for (i = 0; i < templates->numTemplates; i++) {
+        float diff;
+        if (i == first) {
+            continue;
+        }
+        if (!(flags & SDL_DOLLAR_EXHAUSTIVE)) {
+            const float limit = bestDiff * DOLLARNPOINTS;
+            if (bound(stroke->radius, &templates->radius[i * DOLLARNPOINTS], limit) >= limit) {
+                continue;
+            }
+        }
+        diff = SDL_DollarBestDifference(distance, stroke, templates, i);
+        if (diff < bestDiff) {
+            bestDiff = diff;
+            *bestTempl = i;
+        }
+    }
+    return bestDiff;
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
@@ -0,0 +1,81 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2017 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "../SDL_internal.h"
+
+#ifndef SDL_dollar_c_h_
+#define SDL_dollar_c_h_
+
+/* The $1 gesture recognizer's template store and matcher */
+
+#define DOLLARNPOINTS 64
+#define DOLLARSIZE 256
+
+/* Flags for SDL_DollarRecognize(), so testgesturebench can time the slow paths */
+#define SDL_DOLLAR_SCALAR       0x01    /* don't use SIMD */
+#define SDL_DOLLAR_EXHAUSTIVE   0x02    /* search every template */
+
+typedef struct {
+    float x,y;
+} SDL_FloatPoint;
+
+/* Templates are rows of DOLLARNPOINTS floats, one array per coordinate, so
+   comparing against one reads straight through memory four points at a time.
+
+   radius holds each point's distance from the centroid. Rotating a stroke
+   doesn't change those, so comparing them gives a lower bound on how well a
+   template could match at any angle, without the search over angles. */
+typedef struct {
+    int numTemplates;
+    int maxTemplates;
+    float *x;
+    float *y;
+    float *radius;
+    unsigned long *hash;
+} SDL_DollarTemplates;
+
+/* A normalized stroke to recognize, laid out like a template row. */
+typedef struct {
+    float x[DOLLARNPOINTS];
+    float y[DOLLARNPOINTS];
+    float radius[DOLLARNPOINTS];
+} SDL_DollarStroke;
+
+/* Splits a normalized path into rows, as kept for templates and strokes */
+extern void SDL_DollarSplitPath(const SDL_FloatPoint *path, float *x, float *y, float *radius);
+
+/* Puts a template back together as a path */
+extern void SDL_DollarGetPath(const SDL_DollarTemplates *templates, int index, SDL_FloatPoint *path);
+
+/* path is an already sampled set of points
+   Returns the index of the new template, or -1 if out of memory */
+extern int SDL_DollarAddTemplate(SDL_DollarTemplates *templates, const SDL_FloatPoint *path);
+
+extern void SDL_DollarFreeTemplates(SDL_DollarTemplates *templates);
+
+/* Returns the difference between the stroke and the template it's closest
+   to, and that template's index in bestTempl, or -1 if nothing was close. */
+extern float SDL_DollarRecognize(const SDL_DollarTemplates *templates, const SDL_DollarStroke *stroke,
+                                 int flags, int *bestTempl);
+
+#endif /* SDL_dollar_c_h_ */
+
+/* vi: set ts=4 sw=4 expandtab: */
@@ -25,6 +25,7 @@
 #include "SDL.h"
 #include "SDL_events.h"
 #include "SDL_thread.h"
+#include "SDL_bits.h"
 #include "SDL_events_c.h"
 #include "../timer/SDL_timer_c.h"
 #if !SDL_JOYSTICK_DISABLED
@@ -38,18 +39,37 @@
 /* An arbitrary limit so we don't have unbounded growth */
 #define SDL_MAX_QUEUED_EVENTS   65535
 
+/* How often SDL_WaitEvent() pumps when something has to be polled */
+#define SDL_EVENT_POLL_INTERVAL 10
+
+/* How often SDL_WaitEvent() checks for a quit signal when nothing else will
+   wake it up; signal handlers can't signal a condition variable. */
+#define SDL_EVENT_SIGNAL_INTERVAL 250
+
 typedef struct SDL_EventWatcher {
     SDL_EventFilter callback;
     void *userdata;
-    SDL_bool removed;
+    SDL_atomic_t removed;
 } SDL_EventWatcher;
 
-static SDL_mutex *SDL_event_watchers_lock;
-static SDL_EventWatcher SDL_EventOK;
-static SDL_EventWatcher *SDL_event_watchers = NULL;
-static int SDL_event_watchers_count = 0;
-static SDL_bool SDL_event_watchers_dispatching = SDL_FALSE;
-static SDL_bool SDL_event_watchers_removed = SDL_FALSE;
+/* SDL_PushEvent() reads the event filter and watchers without locking, so
+   they're never changed in place: changes publish a new list. Old lists, and
+   the watchers removed from them, are freed as soon as no thread is
+   dispatching events: by the change itself, or else by the last dispatch
+   that was still running. */
+typedef struct SDL_EventWatcherList {
+    SDL_EventFilter filter;
+    void *filter_userdata;
+    int count;
+    SDL_EventWatcher **watchers;
+    SDL_EventWatcher *removed;  /* freed along with this list once retired */
+    struct SDL_EventWatcherList *next;  /* in the retired list */
+} SDL_EventWatcherList;
+
+static SDL_mutex *SDL_event_watchers_lock;  /* held while changing the list */
+static SDL_EventWatcherList *SDL_event_watchers = NULL;
+static SDL_EventWatcherList *SDL_event_watchers_retired = NULL;
+static SDL_atomic_t SDL_event_watchers_dispatching;
 
 typedef struct {
     Uint32 bits[8];
@@ -65,6 +85,10 @@ typedef struct _SDL_EventEntry
     SDL_SysWMmsg msg;
     struct _SDL_EventEntry *prev;
     struct _SDL_EventEntry *next;
+    struct _SDL_EventEntry *type_prev;  /* queued events of the same type */
+    struct _SDL_EventEntry *type_next;
+    Uint32 order;  /* when it was queued, to merge the per-type lists */
+    SDL_EventTimestamp times;
 } SDL_EventEntry;
 
 typedef struct _SDL_SysWMEntry
@@ -76,15 +100,98 @@ typedef struct _SDL_SysWMEntry
 static struct
 {
     SDL_mutex *lock;
+    SDL_cond *nonempty;  /* signaled when events are added while threads wait */
+    SDL_atomic_t waiters;
     SDL_atomic_t active;
     SDL_atomic_t count;
-    int max_events_seen;
+    SDL_atomic_t max_events_seen;
     SDL_EventEntry *head;
     SDL_EventEntry *tail;
     SDL_EventEntry *free;
     SDL_SysWMEntry *wmmsg_used;
     SDL_SysWMEntry *wmmsg_free;
-} SDL_EventQ = { NULL, { 1 }, { 0 }, 0, NULL, NULL, NULL, NULL, NULL };
+    int coalesced;
+    int listed;  /* entries in the list, not counting any still in the ring */
+    Uint32 order;
+} SDL_EventQ = { NULL, NULL, { 0 }, { 1 }, { 0 }, { 0 }, NULL, NULL, NULL, NULL, NULL, 0, 0, 0 };
+
+/* The list is also indexed by event type, so looking for a few types doesn't
+   walk past everything else. Like SDL_disabled_events, each block covers 256
+   types, and is allocated the first time one of them is queued. Types above
+   SDL_LASTEVENT share lists with lower ones, so walks still check the type. */
+typedef struct
+{
+    int count;
+    SDL_EventEntry *head;
+    SDL_EventEntry *tail;
+} SDL_EventTypeList;
+
+typedef struct
+{
+    int count;  /* events of any type in this block */
+    SDL_EventTypeList types[256];
+} SDL_EventTypeBlock;
+
+static SDL_EventTypeBlock *SDL_queued_events[256];
+
+/* A walk over the queued events in a type range, in queue order */
+#define SDL_MAX_CURSOR_TYPES 32
+
+typedef struct
+{
+    Uint32 minType;
+    Uint32 maxType;
+    SDL_EventEntry *entry;  /* next entry when walking the whole list */
+    int numtypes;  /* -1 to walk the whole list */
+    SDL_EventEntry *next[SDL_MAX_CURSOR_TYPES];  /* next entry of each type */
+} SDL_EventCursor;
+
+/* Event types that may be merged into an unread event from the same source,
+   see SDL_HINT_COALESCE_MOUSE_MOTION and friends */
+static SDL_bool SDL_coalesce_mouse_motion = SDL_FALSE;
+static SDL_bool SDL_coalesce_finger_motion = SDL_FALSE;
+static SDL_bool SDL_coalesce_axis_motion = SDL_FALSE;
+
+/* How far back past other sources' events to look for one to merge into */
+#define SDL_COALESCE_LOOKBACK   8
+
+/* How long events wait in the queue, by type, see SDL_HINT_EVENT_LATENCY_HISTOGRAM.
+   Blocks of 256 types are allocated as they're needed, like SDL_disabled_events. */
+typedef struct
+{
+    SDL_EventLatencyHistogram types[256];
+} SDL_EventLatencyBlock;
+
+static SDL_bool SDL_event_latency_enabled = SDL_FALSE;
+static SDL_EventLatencyBlock *SDL_event_latency[256];
+
+/* Where SDL_SetEventSourceTime() keeps each thread's source time */
+static SDL_TLSID SDL_event_source_time;
+
+/* Events pushed from any thread go into this ring without taking the queue
+   lock, and get moved onto the end of the list by whoever locks the queue
+   next. Each slot's sequence number says whose turn it is: a producer may
+   fill the slot when it equals the position being pushed, and the reader
+   may take it when it's one past that. */
+#define SDL_EVENT_RING_SIZE 1024  /* must be a power of two */
+
+typedef struct
+{
+    SDL_atomic_t sequence;
+    SDL_Event event;
+    SDL_EventTimestamp times;
+} SDL_EventRingSlot;
+
+static struct
+{
+    SDL_atomic_t ready;
+    SDL_atomic_t enqueue_pos;
+    char pad[SDL_CACHELINE_SIZE];  /* keep the producers off the reader's cache line */
+    Uint32 dequeue_pos;  /* only touched with the queue locked */
+    SDL_EventRingSlot slots[SDL_EVENT_RING_SIZE];
+} SDL_EventRing;
+
+static void SDL_DrainEventRing(void);
 
 
 #ifdef SDL_DEBUG_EVENTS
@@ -311,6 +418,28 @@ SDL_DebugPrintEvent(const SDL_Event *event)
 
 
 
+/* Keeps one of our flags in step with a boolean hint */
+static void SDLCALL
+SDL_EventHintChanged(void *userdata, const char *name, const char *oldValue, const char *hint)
+{
+    *(SDL_bool *)userdata = (hint && *hint && *hint != '0' && SDL_strcasecmp(hint, "false") != 0) ? SDL_TRUE : SDL_FALSE;
+}
+
+static SDL_bool
+SDL_ShouldCoalesce(Uint32 type)
+{
+    switch (type) {
+    case SDL_MOUSEMOTION:
+        return SDL_coalesce_mouse_motion;
+    case SDL_FINGERMOTION:
+        return SDL_coalesce_finger_motion;
+    case SDL_CONTROLLERAXISMOTION:
+        return SDL_coalesce_axis_motion;
+    default:
+        return SDL_FALSE;
+    }
+}
+
 /* Public functions */
 
 void
@@ -329,10 +458,13 @@ SDL_StopEventLoop(void)
 
     if (report && SDL_atoi(report)) {
         SDL_Log("SDL EVENT QUEUE: Maximum events in-flight: %d\n",
-                SDL_EventQ.max_events_seen);
+                SDL_AtomicGet(&SDL_EventQ.max_events_seen));
+        SDL_Log("SDL EVENT QUEUE: Events merged while queued: %d\n",
+                SDL_EventQ.coalesced);
     }
 
     /* Clean out EventQ */
+    SDL_DrainEventRing();
     for (entry = SDL_EventQ.head; entry; ) {
         SDL_EventEntry *next = entry->next;
         SDL_free(entry);
@@ -355,13 +487,31 @@ SDL_StopEventLoop(void)
     }
 
     SDL_AtomicSet(&SDL_EventQ.count, 0);
-    SDL_EventQ.max_events_seen = 0;
+    SDL_AtomicSet(&SDL_EventQ.max_events_seen, 0);
+    SDL_EventQ.coalesced = 0;
+    SDL_EventQ.listed = 0;
+    SDL_EventQ.order = 0;
     SDL_EventQ.head = NULL;
     SDL_EventQ.tail = NULL;
     SDL_EventQ.free = NULL;
     SDL_EventQ.wmmsg_used = NULL;
     SDL_EventQ.wmmsg_free = NULL;
 
+    SDL_DelHintCallback(SDL_HINT_COALESCE_MOUSE_MOTION, SDL_EventHintChanged, &SDL_coalesce_mouse_motion);
+    SDL_DelHintCallback(SDL_HINT_COALESCE_FINGER_MOTION, SDL_EventHintChanged, &SDL_coalesce_finger_motion);
+    SDL_DelHintCallback(SDL_HINT_COALESCE_CONTROLLER_AXIS_MOTION, SDL_EventHintChanged, &SDL_coalesce_axis_motion);
+    SDL_DelHintCallback(SDL_HINT_EVENT_LATENCY_HISTOGRAM, SDL_EventHintChanged, &SDL_event_latency_enabled);
+
+    for (i = 0; i < SDL_arraysize(SDL_queued_events); ++i) {
+        SDL_free(SDL_queued_events[i]);
+        SDL_queued_events[i] = NULL;
+    }
+
+    for (i = 0; i < SDL_arraysize(SDL_event_latency); ++i) {
+        SDL_free(SDL_event_latency[i]);
+        SDL_event_latency[i] = NULL;
+    }
+
     /* Clear disabled event state */
     for (i = 0; i < SDL_arraysize(SDL_disabled_events); ++i) {
         SDL_free(SDL_disabled_events[i]);
@@ -372,12 +522,24 @@ SDL_StopEventLoop(void)
         SDL_DestroyMutex(SDL_event_watchers_lock);
         SDL_event_watchers_lock = NULL;
     }
+    while (SDL_event_watchers_retired) {
+        SDL_EventWatcherList *next = SDL_event_watchers_retired->next;
+        SDL_free(SDL_event_watchers_retired->removed);
+        SDL_free(SDL_event_watchers_retired);
+        SDL_event_watchers_retired = next;
+    }
     if (SDL_event_watchers) {
+        for (i = 0; i < SDL_event_watchers->count; ++i) {
+            SDL_free(SDL_event_watchers->watchers[i]);
+        }
         SDL_free(SDL_event_watchers);
         SDL_event_watchers = NULL;
-        SDL_event_watchers_count = 0;
     }
-    SDL_zero(SDL_EventOK);
+
+    if (SDL_EventQ.nonempty) {
+        SDL_DestroyCond(SDL_EventQ.nonempty);
+        SDL_EventQ.nonempty = NULL;
+    }
 
     if (SDL_EventQ.lock) {
         SDL_UnlockMutex(SDL_EventQ.lock);
@@ -405,6 +567,13 @@ SDL_StartEventLoop(void)
         }
     }
 
+    if (!SDL_EventQ.nonempty) {
+        SDL_EventQ.nonempty = SDL_CreateCond();
+        if (SDL_EventQ.nonempty == NULL) {
+            return -1;
+        }
+    }
+
     if (!SDL_event_watchers_lock) {
         SDL_event_watchers_lock = SDL_CreateMutex();
         if (SDL_event_watchers_lock == NULL) {
@@ -413,49 +582,254 @@ SDL_StartEventLoop(void)
     }
 #endif /* !SDL_THREADS_DISABLED */
 
+    SDL_AddHintCallback(SDL_HINT_COALESCE_MOUSE_MOTION, SDL_EventHintChanged, &SDL_coalesce_mouse_motion);
+    SDL_AddHintCallback(SDL_HINT_COALESCE_FINGER_MOTION, SDL_EventHintChanged, &SDL_coalesce_finger_motion);
+    SDL_AddHintCallback(SDL_HINT_COALESCE_CONTROLLER_AXIS_MOTION, SDL_EventHintChanged, &SDL_coalesce_axis_motion);
+    SDL_AddHintCallback(SDL_HINT_EVENT_LATENCY_HISTOGRAM, SDL_EventHintChanged, &SDL_event_latency_enabled);
+
+    /* TLS slots can't be freed, so this one is kept for next time */
+    if (!SDL_event_source_time) {
+        SDL_event_source_time = SDL_TLSCreate();
+    }
+
     /* Process most event types */
     SDL_EventState(SDL_TEXTINPUT, SDL_DISABLE);
     SDL_EventState(SDL_TEXTEDITING, SDL_DISABLE);
     SDL_EventState(SDL_SYSWMEVENT, SDL_DISABLE);
 
+    /* Set up the ring the first time through. It's never freed, and anything
+       left in it is moved into the list (or thrown away) under the lock. */
+    if (!SDL_AtomicGet(&SDL_EventRing.ready)) {
+        int i;
+        for (i = 0; i < SDL_EVENT_RING_SIZE; ++i) {
+            SDL_AtomicSet(&SDL_EventRing.slots[i].sequence, i);
+        }
+        SDL_AtomicSet(&SDL_EventRing.enqueue_pos, 0);
+        SDL_EventRing.dequeue_pos = 0;
+        SDL_AtomicSet(&SDL_EventRing.ready, 1);
+    }
+
     SDL_AtomicSet(&SDL_EventQ.active, 1);
 
     return 0;
 }
 
 
-/* Add an event to the event queue -- called with the queue locked */
-static int
-SDL_AddEvent(SDL_Event * event)
+/* Make room for one more event without going over SDL_MAX_QUEUED_EVENTS.
+   This is safe to call without the queue locked. */
+static SDL_bool
+SDL_ReserveEvent(void)
 {
-    SDL_EventEntry *entry;
-    const int initial_count = SDL_AtomicGet(&SDL_EventQ.count);
-    int final_count;
+    const int count = SDL_AtomicAdd(&SDL_EventQ.count, 1) + 1;
+    int seen;
 
-    if (initial_count >= SDL_MAX_QUEUED_EVENTS) {
-        SDL_SetError("Event queue is full (%d events)", initial_count);
-        return 0;
+    if (count > SDL_MAX_QUEUED_EVENTS) {
+        SDL_AtomicAdd(&SDL_EventQ.count, -1);
+        SDL_SetError("Event queue is full (%d events)", count - 1);
+        return SDL_FALSE;
     }
 
+    do {
+        seen = SDL_AtomicGet(&SDL_EventQ.max_events_seen);
+    } while ((count > seen) && !SDL_AtomicCAS(&SDL_EventQ.max_events_seen, seen, count));
+
+    return SDL_TRUE;
+}
+
+/* Get an unused entry -- called with the queue locked */
+static SDL_EventEntry *
+SDL_NewEventEntry(void)
+{
+    SDL_EventEntry *entry;
+
     if (SDL_EventQ.free == NULL) {
         entry = (SDL_EventEntry *)SDL_malloc(sizeof(*entry));
-        if (!entry) {
-            return 0;
-        }
     } else {
         entry = SDL_EventQ.free;
         SDL_EventQ.free = entry->next;
     }
+    return entry;
+}
 
-    #ifdef SDL_DEBUG_EVENTS
-    SDL_DebugPrintEvent(event);
-    #endif
+static SDL_bool
+SDL_EventOrderBefore(const SDL_EventEntry *a, const SDL_EventEntry *b)
+{
+    return ((Sint32) (a->order - b->order) < 0) ? SDL_TRUE : SDL_FALSE;
+}
 
-    entry->event = *event;
-    if (event->type == SDL_SYSWMEVENT) {
-        entry->msg = *event->syswm.msg;
-        entry->event.syswm.msg = &entry->msg;
+/* File an entry under its type, in queue order -- called with the queue locked */
+static SDL_bool
+SDL_IndexEventEntry(SDL_EventEntry *entry)
+{
+    const Uint8 hi = ((entry->event.type >> 8) & 0xff);
+    const Uint8 lo = (entry->event.type & 0xff);
+    SDL_EventTypeList *list;
+    SDL_EventEntry *after;
+
+    if (!SDL_queued_events[hi]) {
+        SDL_queued_events[hi] = (SDL_EventTypeBlock *)SDL_calloc(1, sizeof(SDL_EventTypeBlock));
+        if (!SDL_queued_events[hi]) {
+            SDL_OutOfMemory();
+            return SDL_FALSE;
+        }
+    }
+    list = &SDL_queued_events[hi]->types[lo];
+
+    /* This goes on the end, unless SDL_FilterEvents() changed the type */
+    for (after = list->tail; after && SDL_EventOrderBefore(entry, after); after = after->type_prev) {
+    }
+    entry->type_prev = after;
+    entry->type_next = after ? after->type_next : list->head;
+    if (entry->type_next) {
+        entry->type_next->type_prev = entry;
+    } else {
+        list->tail = entry;
     }
+    if (after) {
+        after->type_next = entry;
+    } else {
+        list->head = entry;
+    }
+
+    ++list->count;
+    ++SDL_queued_events[hi]->count;
+    return SDL_TRUE;
+}
+
+/* Take an entry out of the lists for the given type -- called with the queue locked */
+static void
+SDL_UnindexEventEntry(SDL_EventEntry *entry, Uint32 type)
+{
+    SDL_EventTypeBlock *block = SDL_queued_events[(type >> 8) & 0xff];
+    SDL_EventTypeList *list = &block->types[type & 0xff];
+
+    if (entry->type_prev) {
+        entry->type_prev->type_next = entry->type_next;
+    } else {
+        list->head = entry->type_next;
+    }
+    if (entry->type_next) {
+        entry->type_next->type_prev = entry->type_prev;
+    } else {
+        list->tail = entry->type_prev;
+    }
+
+    --list->count;
+    --block->count;
+}
+
+/* Count the queued events in a type range -- called with the queue locked */
+static int
+SDL_CountQueuedEvents(Uint32 minType, Uint32 maxType)
+{
+    int count = 0;
+    Uint32 hi;
+
+    if (minType <= SDL_FIRSTEVENT && maxType >= SDL_LASTEVENT) {
+        return SDL_EventQ.listed;
+    }
+
+    maxType = SDL_min(maxType, SDL_LASTEVENT);
+    for (hi = (minType >> 8); hi <= (maxType >> 8); ++hi) {
+        const SDL_EventTypeBlock *block = SDL_queued_events[hi];
+        const Uint32 first = (hi == (minType >> 8)) ? (minType & 0xff) : 0;
+        const Uint32 last = (hi == (maxType >> 8)) ? (maxType & 0xff) : 0xff;
+        Uint32 lo;
+
+        if (!block || !block->count) {
+            continue;
+        }
+        if (first == 0 && last == 0xff) {
+            count += block->count;
+        } else {
+            for (lo = first; lo <= last; ++lo) {
+                count += block->types[lo].count;
+            }
+        }
+    }
+    return count;
+}
+
+/* Get ready to walk the queued events in a type range. Only the types that
+   have anything queued get looked at, unless everything matches anyway or
+   there are too many of them. -- called with the queue locked */
+static void
+SDL_StartEventCursor(SDL_EventCursor *cursor, Uint32 minType, Uint32 maxType)
+{
+    const int matches = SDL_CountQueuedEvents(minType, maxType);
+    Uint32 hi, lo;
+
+    cursor->minType = minType;
+    cursor->maxType = maxType;
+    cursor->entry = SDL_EventQ.head;
+    cursor->numtypes = -1;
+    if (matches == SDL_EventQ.listed) {
+        return;
+    }
+
+    cursor->numtypes = 0;
+    maxType = SDL_min(maxType, SDL_LASTEVENT);
+    for (hi = (minType >> 8); matches && hi <= (maxType >> 8); ++hi) {
+        const SDL_EventTypeBlock *block = SDL_queued_events[hi];
+        const Uint32 first = (hi == (minType >> 8)) ? (minType & 0xff) : 0;
+        const Uint32 last = (hi == (maxType >> 8)) ? (maxType & 0xff) : 0xff;
+
+        if (!block || !block->count) {
+            continue;
+        }
+        for (lo = first; lo <= last; ++lo) {
+            if (block->types[lo].head) {
+                if (cursor->numtypes == SDL_MAX_CURSOR_TYPES) {
+                    cursor->numtypes = -1;
+                    return;
+                }
+                cursor->next[cursor->numtypes++] = block->types[lo].head;
+            }
+        }
+    }
+}
+
+/* Get the next event from a walk, or NULL at the end. The entry returned
+   can be cut from the queue without upsetting the walk. */
+static SDL_EventEntry *
+SDL_NextEventInCursor(SDL_EventCursor *cursor)
+{
+    SDL_EventEntry *entry;
+
+    for (;;) {
+        if (cursor->numtypes < 0) {
+            entry = cursor->entry;
+            if (entry) {
+                cursor->entry = entry->next;
+            }
+        } else {
+            int i, first = -1;
+            for (i = 0; i < cursor->numtypes; ++i) {
+                if (cursor->next[i] && (first < 0 || SDL_EventOrderBefore(cursor->next[i], cursor->next[first]))) {
+                    first = i;
+                }
+            }
+            entry = (first < 0) ? NULL : cursor->next[first];
+            if (entry) {
+                cursor->next[first] = entry->type_next;
+            }
+        }
+
+        if (!entry || (cursor->minType <= entry->event.type && entry->event.type <= cursor->maxType)) {
+            return entry;
+        }
+    }
+}
+
+/* Put an entry on the end of the queue -- called with the queue locked */
+static SDL_bool
+SDL_AppendEventEntry(SDL_EventEntry *entry)
+{
+    entry->order = SDL_EventQ.order++;
+    if (!SDL_IndexEventEntry(entry)) {
+        return SDL_FALSE;
+    }
+    ++SDL_EventQ.listed;
 
     if (SDL_EventQ.tail) {
         SDL_EventQ.tail->next = entry;
@@ -469,10 +843,215 @@ SDL_AddEvent(SDL_Event * event)
         entry->prev = NULL;
         entry->next = NULL;
     }
+    return SDL_TRUE;
+}
 
-    final_count = SDL_AtomicAdd(&SDL_EventQ.count, 1) + 1;
-    if (final_count > SDL_EventQ.max_events_seen) {
-        SDL_EventQ.max_events_seen = final_count;
+/* Push an event into the ring without locking anything. Returns 1 if it went
+   in, 0 if it has to go through SDL_AddEvent() instead, or -1 if the queue
+   is full. */
+static int
+SDL_AddEventToRing(const SDL_Event * event, const SDL_EventTimestamp * times)
+{
+    SDL_EventRingSlot *slot;
+    Uint32 pos;
+
+    if (event->type == SDL_SYSWMEVENT) {
+        return 0;  /* the message needs copying into a list entry */
+    }
+    if (SDL_ShouldCoalesce(event->type)) {
+        return 0;  /* it might be merged into an event in the list */
+    }
+    if (!SDL_ReserveEvent()) {
+        return -1;
+    }
+
+    pos = (Uint32) SDL_AtomicGet(&SDL_EventRing.enqueue_pos);
+    for (;;) {
+        Sint32 diff;
+        slot = &SDL_EventRing.slots[pos & (SDL_EVENT_RING_SIZE - 1)];
+        diff = (Sint32) ((Uint32) SDL_AtomicGet(&slot->sequence) - pos);
+        if (diff == 0) {
+            if (SDL_AtomicCAS(&SDL_EventRing.enqueue_pos, (int) pos, (int) (pos + 1))) {
+                break;  /* the slot is ours */
+            }
+        } else if (diff < 0) {
+            /* the reader hasn't caught up, the ring is full */
+            SDL_AtomicAdd(&SDL_EventQ.count, -1);
+            return 0;
+        }
+        pos = (Uint32) SDL_AtomicGet(&SDL_EventRing.enqueue_pos);
+    }
+
+    #ifdef SDL_DEBUG_EVENTS
+    SDL_DebugPrintEvent(event);
+    #endif
+
+    slot->event = *event;
+    slot->times = *times;
+
+    /* Hand the slot to the reader. This is a compare-and-swap rather than a
+       plain store because it's a full barrier everywhere, so the reader can't
+       see the new sequence before it can see the event. */
+    SDL_AtomicCAS(&slot->sequence, (int) pos, (int) (pos + 1));
+    return 1;
+}
+
+/* Move everything pushed into the ring so far onto the end of the list, so
+   it's in order with what's already there -- called with the queue locked */
+static void
+SDL_DrainEventRing(void)
+{
+    Uint32 end;
+
+    if (!SDL_AtomicGet(&SDL_EventRing.ready)) {
+        return;
+    }
+
+    end = (Uint32) SDL_AtomicGet(&SDL_EventRing.enqueue_pos);
+    while (SDL_EventRing.dequeue_pos != end) {
+        const Uint32 pos = SDL_EventRing.dequeue_pos;
+        SDL_EventRingSlot *slot = &SDL_EventRing.slots[pos & (SDL_EVENT_RING_SIZE - 1)];
+        SDL_EventEntry *entry;
+
+        if ((Uint32) SDL_AtomicGet(&slot->sequence) != (pos + 1)) {
+            /* A producer has claimed this slot but is still copying into it.
+               Wait for it, so nothing pushed before now gets skipped. */
+            SDL_Delay(0);
+            continue;
+        }
+
+        /* the count was reserved when the event was pushed, so if we run out
+           of memory the event is lost, as it would have been in SDL_AddEvent() */
+        entry = SDL_NewEventEntry();
+        if (entry) {
+            entry->event = slot->event;
+            entry->times = slot->times;
+            if (!SDL_AppendEventEntry(entry)) {
+                entry->next = SDL_EventQ.free;
+                SDL_EventQ.free = entry;
+                entry = NULL;
+            }
+        }
+        if (!entry) {
+            SDL_AtomicAdd(&SDL_EventQ.count, -1);
+        }
+
+        SDL_EventRing.dequeue_pos = pos + 1;
+
+        /* done reading, hand the slot back for the next lap. */
+        SDL_AtomicCAS(&slot->sequence, (int) (pos + 1), (int) (pos + SDL_EVENT_RING_SIZE));
+    }
+}
+
+/* Merge an event into an unread one from the same device (and finger or
+   axis), if that's turned on -- called with the queue locked */
+static SDL_bool
+SDL_CoalesceEvent(const SDL_Event * event)
+{
+    SDL_EventEntry *entry;
+    int i;
+
+    if (!SDL_ShouldCoalesce(event->type)) {
+        return SDL_FALSE;
+    }
+
+    /* Only look back past events of the same type from other sources, so
+       the merged event never jumps ahead of anything else, like a click. */
+    entry = SDL_EventQ.tail;
+    for (i = 0; entry && (i < SDL_COALESCE_LOOKBACK); ++i, entry = entry->prev) {
+        SDL_Event *queued = &entry->event;
+
+        if (queued->type != event->type) {
+            return SDL_FALSE;
+        }
+
+        switch (event->type) {
+        case SDL_MOUSEMOTION:
+            if (queued->motion.windowID == event->motion.windowID &&
+                queued->motion.which == event->motion.which) {
+                queued->motion.timestamp = event->motion.timestamp;
+                queued->motion.state = event->motion.state;
+                queued->motion.x = event->motion.x;
+                queued->motion.y = event->motion.y;
+                queued->motion.xrel += event->motion.xrel;
+                queued->motion.yrel += event->motion.yrel;
+                ++SDL_EventQ.coalesced;
+                return SDL_TRUE;
+            }
+            break;
+
+        case SDL_FINGERMOTION:
+            if (queued->tfinger.touchId == event->tfinger.touchId &&
+                queued->tfinger.fingerId == event->tfinger.fingerId) {
+                queued->tfinger.timestamp = event->tfinger.timestamp;
+                queued->tfinger.x = event->tfinger.x;
+                queued->tfinger.y = event->tfinger.y;
+                queued->tfinger.dx += event->tfinger.dx;
+                queued->tfinger.dy += event->tfinger.dy;
+                queued->tfinger.pressure = event->tfinger.pressure;
+                ++SDL_EventQ.coalesced;
+                return SDL_TRUE;
+            }
+            break;
+
+        case SDL_CONTROLLERAXISMOTION:
+            if (queued->caxis.which == event->caxis.which &&
+                queued->caxis.axis == event->caxis.axis) {
+                queued->caxis.timestamp = event->caxis.timestamp;
+                queued->caxis.value = event->caxis.value;
+                ++SDL_EventQ.coalesced;
+                return SDL_TRUE;
+            }
+            break;
+
+        default:
+            break;
+        }
+    }
+    return SDL_FALSE;
+}
+
+/* Add an event to the event queue -- called with the queue locked */
+static int
+SDL_AddEvent(SDL_Event * event, const SDL_EventTimestamp * times)
+{
+    SDL_EventEntry *entry;
+
+    /* A merged event keeps the times of the one it was merged into, so the
+       wait is counted from when the first of them was queued */
+    if (SDL_CoalesceEvent(event)) {
+        #ifdef SDL_DEBUG_EVENTS
+        SDL_DebugPrintEvent(event);
+        #endif
+        return 1;
+    }
+
+    if (!SDL_ReserveEvent()) {
+        return 0;
+    }
+
+    entry = SDL_NewEventEntry();
+    if (!entry) {
+        SDL_AtomicAdd(&SDL_EventQ.count, -1);
+        return 0;
+    }
+
+    #ifdef SDL_DEBUG_EVENTS
+    SDL_DebugPrintEvent(event);
+    #endif
+
+    entry->event = *event;
+    entry->times = *times;
+    if (event->type == SDL_SYSWMEVENT) {
+        entry->msg = *event->syswm.msg;
+        entry->event.syswm.msg = &entry->msg;
+    }
+
+    if (!SDL_AppendEventEntry(entry)) {
+        entry->next = SDL_EventQ.free;
+        SDL_EventQ.free = entry;
+        SDL_AtomicAdd(&SDL_EventQ.count, -1);
+        return 0;
     }
 
     return 1;
@@ -482,6 +1061,9 @@ SDL_AddEvent(SDL_Event * event)
 static void
 SDL_CutEvent(SDL_EventEntry *entry)
 {
+    SDL_UnindexEventEntry(entry, entry->event.type);
+    --SDL_EventQ.listed;
+
     if (entry->prev) {
         entry->prev->next = entry->next;
     }
@@ -504,11 +1086,73 @@ SDL_CutEvent(SDL_EventEntry *entry)
     SDL_AtomicAdd(&SDL_EventQ.count, -1);
 }
 
+/* Wake up anyone blocked in SDL_WaitForEvents() -- called after adding
+   events, with the queue locked if it's locked */
+static void
+SDL_WakeEventWaiters(SDL_bool locked)
+{
+    SDL_VideoDevice *_this;
+
+    if (SDL_AtomicGet(&SDL_EventQ.waiters) == 0) {
+        return;
+    }
+
+    _this = SDL_GetVideoDevice();
+    if (_this && _this->SendWakeupEvent) {
+        _this->SendWakeupEvent(_this);
+    }
+
+    if (SDL_EventQ.nonempty) {
+        if (!locked) {
+            SDL_LockMutex(SDL_EventQ.lock);
+        }
+        SDL_CondBroadcast(SDL_EventQ.nonempty);
+        if (!locked) {
+            SDL_UnlockMutex(SDL_EventQ.lock);
+        }
+    }
+}
+
+/* Count how long an event waited in the queue -- called with the queue locked */
+static void
+SDL_CountEventLatency(Uint32 type, Uint64 latency)
+{
+    const Uint8 hi = ((type >> 8) & 0xff);
+    const Uint64 freq = SDL_GetPerformanceFrequency();
+    const Uint64 us = (latency * 1000) / (freq / 1000);
+    SDL_EventLatencyHistogram *histogram;
+    int bucket;
+
+    if (!SDL_event_latency[hi]) {
+        SDL_event_latency[hi] = (SDL_EventLatencyBlock *)SDL_calloc(1, sizeof(SDL_EventLatencyBlock));
+        if (!SDL_event_latency[hi]) {
+            return;
+        }
+    }
+    histogram = &SDL_event_latency[hi]->types[type & 0xff];
+
+    bucket = us ? (SDL_MostSignificantBitIndex32((Uint32) SDL_min(us, 0xFFFFFFFF)) + 1) : 0;
+    ++histogram->buckets[SDL_min(bucket, SDL_EVENT_LATENCY_BUCKETS - 1)];
+    ++histogram->count;
+    histogram->total_ticks += latency;
+    histogram->max_ticks = SDL_max(histogram->max_ticks, latency);
+}
+
 /* Lock the event queue, take a peep at it, and unlock it */
 int
 SDL_PeepEvents(SDL_Event * events, int numevents, SDL_eventaction action,
                Uint32 minType, Uint32 maxType)
 {
+    return SDL_PeepEventsWithTimestamps(events, NULL, numevents, action, minType, maxType);
+}
+
+int
+SDL_PeepEventsWithTimestamps(SDL_Event * events, SDL_EventTimestamp * timestamps,
+                             int numevents, SDL_eventaction action,
+                             Uint32 minType, Uint32 maxType)
+{
+    SDL_EventTimestamp times;
+    Uint64 now = 0;
     int i, used;
 
     /* Don't look after we've quit */
@@ -519,17 +1163,57 @@ SDL_PeepEvents(SDL_Event * events, int numevents, SDL_eventaction action,
         }
         return (-1);
     }
-    /* Lock the event queue */
     used = 0;
+    if (action == SDL_ADDEVENT) {
+        now = SDL_GetPerformanceCounter();
+        if (timestamps) {
+            for (i = 0; i < numevents; ++i) {
+                timestamps[i].queued = now;
+            }
+        }
+        times.source = 0;
+        times.queued = now;
+    }
+    if (action == SDL_ADDEVENT && SDL_AtomicGet(&SDL_EventRing.ready)) {
+        /* Most events can go in without taking the lock. If one can't (a
+           window manager message, or the ring is full), it and everything
+           after it go through the list, after what's in the ring. */
+        int rc = 1;
+        for (; used < numevents; ++used) {
+            if (timestamps) {
+                times = timestamps[used];
+            }
+            rc = SDL_AddEventToRing(&events[used], &times);
+            if (rc <= 0) {
+                break;
+            }
+        }
+        if (used > 0) {
+            SDL_WakeEventWaiters(SDL_FALSE);
+        }
+        if (rc != 0) {
+            return used;  /* all done, or the queue is full */
+        }
+    }
+
+    /* Lock the event queue */
     if (!SDL_EventQ.lock || SDL_LockMutex(SDL_EventQ.lock) == 0) {
+        SDL_DrainEventRing();
         if (action == SDL_ADDEVENT) {
-            for (i = 0; i < numevents; ++i) {
-                used += SDL_AddEvent(&events[i]);
+            const int added = used;
+            for (i = used; i < numevents; ++i) {
+                if (timestamps) {
+                    times = timestamps[i];
+                }
+                used += SDL_AddEvent(&events[i], &times);
+            }
+            if (used > added) {
+                SDL_WakeEventWaiters(SDL_TRUE);
             }
         } else {
-            SDL_EventEntry *entry, *next;
+            SDL_EventCursor cursor;
+            SDL_EventEntry *entry;
             SDL_SysWMEntry *wmmsg, *wmmsg_next;
-            Uint32 type;
 
             if (action == SDL_GETEVENT) {
                 /* Clean out any used wmmsg data
@@ -543,32 +1227,41 @@ SDL_PeepEvents(SDL_Event * events, int numevents, SDL_eventaction action,
                 SDL_EventQ.wmmsg_used = NULL;
             }
 
-            for (entry = SDL_EventQ.head; entry && (!events || used < numevents); entry = next) {
-                next = entry->next;
-                type = entry->event.type;
-                if (minType <= type && type <= maxType) {
-                    if (events) {
-                        events[used] = entry->event;
-                        if (entry->event.type == SDL_SYSWMEVENT) {
-                            /* We need to copy the wmmsg somewhere safe.
-                               For now we'll guarantee it's valid at least until
-                               the next call to SDL_PeepEvents()
-                             */
-                            if (SDL_EventQ.wmmsg_free) {
-                                wmmsg = SDL_EventQ.wmmsg_free;
-                                SDL_EventQ.wmmsg_free = wmmsg->next;
-                            } else {
-                                wmmsg = (SDL_SysWMEntry *)SDL_malloc(sizeof(*wmmsg));
-                            }
-                            wmmsg->msg = *entry->event.syswm.msg;
-                            wmmsg->next = SDL_EventQ.wmmsg_used;
-                            SDL_EventQ.wmmsg_used = wmmsg;
-                            events[used].syswm.msg = &wmmsg->msg;
+            if (!events) {
+                used = SDL_CountQueuedEvents(minType, maxType);
+            } else {
+                if (action == SDL_GETEVENT && SDL_event_latency_enabled) {
+                    now = SDL_GetPerformanceCounter();
+                }
+                SDL_StartEventCursor(&cursor, minType, maxType);
+                while (used < numevents && (entry = SDL_NextEventInCursor(&cursor)) != NULL) {
+                    events[used] = entry->event;
+                    if (timestamps) {
+                        timestamps[used] = entry->times;
+                    }
+                    if (entry->event.type == SDL_SYSWMEVENT) {
+                        /* We need to copy the wmmsg somewhere safe.
+                           For now we'll guarantee it's valid at least until
+                           the next call to SDL_PeepEvents()
+                         */
+                        if (SDL_EventQ.wmmsg_free) {
+                            wmmsg = SDL_EventQ.wmmsg_free;
+                            SDL_EventQ.wmmsg_free = wmmsg->next;
+                        } else {
+                            wmmsg = (SDL_SysWMEntry *)SDL_malloc(sizeof(*wmmsg));
                         }
+                        wmmsg->msg = *entry->event.syswm.msg;
+                        wmmsg->next = SDL_EventQ.wmmsg_used;
+                        SDL_EventQ.wmmsg_used = wmmsg;
+                        events[used].syswm.msg = &wmmsg->msg;
+                    }
 
-                        if (action == SDL_GETEVENT) {
-                            SDL_CutEvent(entry);
+                    if (action == SDL_GETEVENT) {
+                        if (now) {
+                            const Uint64 queued = entry->times.queued;
+                            SDL_CountEventLatency(entry->event.type, (now > queued) ? (now - queued) : 0);
                         }
+                        SDL_CutEvent(entry);
                     }
                     ++used;
                 }
@@ -619,14 +1312,12 @@ SDL_FlushEvents(Uint32 minType, Uint32 maxType)
 
     /* Lock the event queue */
     if (!SDL_EventQ.lock || SDL_LockMutex(SDL_EventQ.lock) == 0) {
-        SDL_EventEntry *entry, *next;
-        Uint32 type;
-        for (entry = SDL_EventQ.head; entry; entry = next) {
-            next = entry->next;
-            type = entry->event.type;
-            if (minType <= type && type <= maxType) {
-                SDL_CutEvent(entry);
-            }
+        SDL_EventCursor cursor;
+        SDL_EventEntry *entry;
+        SDL_DrainEventRing();
+        SDL_StartEventCursor(&cursor, minType, maxType);
+        while ((entry = SDL_NextEventInCursor(&cursor)) != NULL) {
+            SDL_CutEvent(entry);
         }
         if (SDL_EventQ.lock) {
             SDL_UnlockMutex(SDL_EventQ.lock);
@@ -656,12 +1347,76 @@ SDL_PumpEvents(void)
 
 /* Public functions */
 
+/* Joysticks, and video drivers that can't wait for their own input, have to
+   be pumped every so often even if nothing wakes us up. That goes for the
+   joysticks even when there are none, since pumping is what notices one
+   being plugged in. The dummy driver has no input at all. */
+static SDL_bool
+SDL_EventsNeedPolling(SDL_VideoDevice *_this)
+{
+    if (_this && !_this->WaitEventTimeout && !_this->is_dummy) {
+        return SDL_TRUE;
+    }
+#if !SDL_JOYSTICK_DISABLED
+    if (SDL_WasInit(SDL_INIT_JOYSTICK) &&
+        (!SDL_disabled_events[SDL_JOYAXISMOTION >> 8] || SDL_JoystickEventState(SDL_QUERY))) {
+        return SDL_TRUE;
+    }
+#endif
+    return SDL_FALSE;
+}
+
+/* Block until another thread adds an event, the video driver has input to
+   pump, or timeout milliseconds pass (-1 to wait forever). This can return
+   early; the caller pumps and checks the queue again either way. */
+static void
+SDL_WaitForEvents(int timeout)
+{
+    SDL_VideoDevice *_this = SDL_GetVideoDevice();
+
+    if (SDL_EventsNeedPolling(_this)) {
+        timeout = (timeout < 0) ? SDL_EVENT_POLL_INTERVAL : SDL_min(timeout, SDL_EVENT_POLL_INTERVAL);
+    }
+
+    /* Anyone adding an event after this sees us waiting and wakes us up,
+       and anything added before it is caught by the count check. */
+    SDL_AtomicAdd(&SDL_EventQ.waiters, 1);
+
+    if (_this && _this->WaitEventTimeout && _this->SendWakeupEvent) {
+        if (SDL_AtomicGet(&SDL_EventQ.count) == 0) {
+            _this->WaitEventTimeout(_this, timeout);
+        }
+    } else if (SDL_EventQ.nonempty && SDL_LockMutex(SDL_EventQ.lock) == 0) {
+        if (SDL_AtomicGet(&SDL_EventQ.count) == 0) {
+            if (timeout < 0 || timeout > SDL_EVENT_SIGNAL_INTERVAL) {
+                timeout = SDL_EVENT_SIGNAL_INTERVAL;
+            }
+            SDL_CondWaitTimeout(SDL_EventQ.nonempty, SDL_EventQ.lock, (Uint32) timeout);
+        }
+        SDL_UnlockMutex(SDL_EventQ.lock);
+    } else {
+        SDL_Delay((timeout < 0) ? SDL_EVENT_POLL_INTERVAL : SDL_min(timeout, SDL_EVENT_POLL_INTERVAL));
+    }
+
+    SDL_AtomicAdd(&SDL_EventQ.waiters, -1);
+}
+
 int
 SDL_PollEvent(SDL_Event * event)
 {
     return SDL_WaitEventTimeout(event, 0);
 }
 
+int
+SDL_PollEvents(SDL_Event * events, int numevents, Uint32 minType, Uint32 maxType)
+{
+    if (!events) {
+        return SDL_InvalidParamError("events");
+    }
+    SDL_PumpEvents();
+    return SDL_PeepEvents(events, numevents, SDL_GETEVENT, minType, maxType);
+}
+
 int
 SDL_WaitEvent(SDL_Event * event)
 {
@@ -686,11 +1441,16 @@ SDL_WaitEventTimeout(SDL_Event * event, int timeout)
                 /* Polling and no events, just return */
                 return 0;
             }
-            if (timeout > 0 && SDL_TICKS_PASSED(SDL_GetTicks(), expiration)) {
-                /* Timeout expired and no events */
-                return 0;
+            if (timeout > 0) {
+                const Uint32 now = SDL_GetTicks();
+                if (SDL_TICKS_PASSED(now, expiration)) {
+                    /* Timeout expired and no events */
+                    return 0;
+                }
+                SDL_WaitForEvents((int) (expiration - now));
+            } else {
+                SDL_WaitForEvents(-1);
             }
-            SDL_Delay(10);
             break;
         default:
             /* Has events */
@@ -699,52 +1459,85 @@ SDL_WaitEventTimeout(SDL_Event * event, int timeout)
     }
 }
 
+/* The source time set for events from this thread, if any */
+static Uint64
+SDL_GetEventSourceTime(void)
+{
+    const Uint64 *source = SDL_event_source_time ? (const Uint64 *) SDL_TLSGet(SDL_event_source_time) : NULL;
+    return source ? *source : 0;
+}
+
+/* Free the retired lists, unless someone dispatching might still be
+   looking at them -- called with SDL_event_watchers_lock held */
+static void
+SDL_FreeRetiredEventWatchers(void)
+{
+    if (SDL_AtomicGet(&SDL_event_watchers_dispatching) == 0) {
+        SDL_EventWatcherList *retired = SDL_event_watchers_retired;
+        while (!SDL_AtomicCASPtr((void **) &SDL_event_watchers_retired, retired, NULL)) {
+        }
+        while (retired) {
+            SDL_EventWatcherList *next = retired->next;
+            SDL_free(retired->removed);
+            SDL_free(retired);
+            retired = next;
+        }
+    }
+}
+
+/* The last dispatch to finish frees any lists that changes made while it
+   was running had to leave behind. The count is dropped before checking for
+   them, and changes retire a list before checking the count, so one of the
+   two always sees the other. */
+static void
+SDL_EndEventWatcherDispatch(void)
+{
+    if (SDL_AtomicDecRef(&SDL_event_watchers_dispatching) &&
+        SDL_AtomicGetPtr((void **) &SDL_event_watchers_retired)) {
+        if (!SDL_event_watchers_lock || SDL_LockMutex(SDL_event_watchers_lock) == 0) {
+            SDL_FreeRetiredEventWatchers();
+            if (SDL_event_watchers_lock) {
+                SDL_UnlockMutex(SDL_event_watchers_lock);
+            }
+        }
+    }
+}
+
 int
 SDL_PushEvent(SDL_Event * event)
 {
+    SDL_EventTimestamp times;
+
     event->common.timestamp = SDL_GetTicks();
 
-    if (SDL_EventOK.callback || SDL_event_watchers_count > 0) {
-        if (!SDL_event_watchers_lock || SDL_LockMutex(SDL_event_watchers_lock) == 0) {
-            if (SDL_EventOK.callback && !SDL_EventOK.callback(SDL_EventOK.userdata, event)) {
-                if (SDL_event_watchers_lock) {
-                    SDL_UnlockMutex(SDL_event_watchers_lock);
-                }
+    if (SDL_AtomicGetPtr((void **) &SDL_event_watchers)) {
+        const SDL_EventWatcherList *list;
+        int i;
+
+        /* Changes won't free the list while we're counted as dispatching */
+        SDL_AtomicIncRef(&SDL_event_watchers_dispatching);
+        list = (const SDL_EventWatcherList *) SDL_AtomicGetPtr((void **) &SDL_event_watchers);
+        if (list) {
+            if (list->filter && !list->filter(list->filter_userdata, event)) {
+                SDL_EndEventWatcherDispatch();
                 return 0;
             }
 
-            if (SDL_event_watchers_count > 0) {
-                /* Make sure we only dispatch the current watcher list */
-                int i, event_watchers_count = SDL_event_watchers_count;
-
-                SDL_event_watchers_dispatching = SDL_TRUE;
-                for (i = 0; i < event_watchers_count; ++i) {
-                    if (!SDL_event_watchers[i].removed) {
-                        SDL_event_watchers[i].callback(SDL_event_watchers[i].userdata, event);
-                    }
+            /* Watchers added by these callbacks see the next event;
+               watchers they remove aren't called again. */
+            for (i = 0; i < list->count; ++i) {
+                SDL_EventWatcher *watcher = list->watchers[i];
+                if (!SDL_AtomicGet(&watcher->removed)) {
+                    watcher->callback(watcher->userdata, event);
                 }
-                SDL_event_watchers_dispatching = SDL_FALSE;
-
-                if (SDL_event_watchers_removed) {
-                    for (i = SDL_event_watchers_count; i--; ) {
-                        if (SDL_event_watchers[i].removed) {
-                            --SDL_event_watchers_count;
-                            if (i < SDL_event_watchers_count) {
-                                SDL_memmove(&SDL_event_watchers[i], &SDL_event_watchers[i+1], (SDL_event_watchers_count - i) * sizeof(SDL_event_watchers[i]));
-                            }
-                        }
-                    }
-                    SDL_event_watchers_removed = SDL_FALSE;
-                }
-            }
-
-            if (SDL_event_watchers_lock) {
-                SDL_UnlockMutex(SDL_event_watchers_lock);
             }
         }
+        SDL_EndEventWatcherDispatch();
     }
 
-    if (SDL_PeepEvents(event, 1, SDL_ADDEVENT, 0, 0) <= 0) {
+    times.source = SDL_GetEventSourceTime();
+    times.queued = 0;
+    if (SDL_PeepEventsWithTimestamps(event, &times, 1, SDL_ADDEVENT, 0, 0) <= 0) {
         return -1;
     }
 
@@ -753,13 +1546,116 @@ SDL_PushEvent(SDL_Event * event)
     return 1;
 }
 
+void
+SDL_SetEventSourceTime(Uint64 counter)
+{
+    Uint64 *source;
+
+    if (!SDL_event_source_time) {
+        return;
+    }
+
+    source = (Uint64 *) SDL_TLSGet(SDL_event_source_time);
+    if (!source) {
+        if (!counter) {
+            return;
+        }
+        source = (Uint64 *) SDL_malloc(sizeof(*source));
+        if (!source) {
+            return;
+        }
+        if (SDL_TLSSet(SDL_event_source_time, source, SDL_free) < 0) {
+            SDL_free(source);
+            return;
+        }
+    }
+    *source = counter;
+}
+
+int
+SDL_GetEventLatencyHistogram(Uint32 type, SDL_EventLatencyHistogram * histogram)
+{
+    if (!histogram) {
+        return SDL_InvalidParamError("histogram");
+    }
+
+    SDL_zerop(histogram);
+    if (!SDL_EventQ.lock || SDL_LockMutex(SDL_EventQ.lock) == 0) {
+        const SDL_EventLatencyBlock *block = SDL_event_latency[(type >> 8) & 0xff];
+        if (block) {
+            *histogram = block->types[type & 0xff];
+        }
+        if (SDL_EventQ.lock) {
+            SDL_UnlockMutex(SDL_EventQ.lock);
+        }
+    } else {
+        return SDL_SetError("Couldn't lock event queue");
+    }
+    return 0;
+}
+
+/* Make a copy of the current filter and watchers, with room for more
+   -- called with SDL_event_watchers_lock held */
+static SDL_EventWatcherList *
+SDL_CopyEventWatchers(int room)
+{
+    const int count = SDL_event_watchers ? SDL_event_watchers->count : 0;
+    SDL_EventWatcherList *list;
+
+    list = (SDL_EventWatcherList *) SDL_malloc(sizeof(*list) + (count + room) * sizeof(SDL_EventWatcher *));
+    if (!list) {
+        return NULL;
+    }
+    SDL_zerop(list);
+    list->watchers = (SDL_EventWatcher **) (list + 1);
+    if (SDL_event_watchers) {
+        list->filter = SDL_event_watchers->filter;
+        list->filter_userdata = SDL_event_watchers->filter_userdata;
+        list->count = count;
+        SDL_memcpy(list->watchers, SDL_event_watchers->watchers, count * sizeof(SDL_EventWatcher *));
+    }
+    return list;
+}
+
+/* Make a new list current, and retire the old one along with a watcher
+   that was taken out of it -- called with SDL_event_watchers_lock held */
+static void
+SDL_PublishEventWatchers(SDL_EventWatcherList *list, SDL_EventWatcher *removed)
+{
+    SDL_EventWatcherList *old = SDL_event_watchers;
+
+    if (list && !list->filter && !list->count) {
+        SDL_free(list);  /* nothing to call, so SDL_PushEvent() can skip it all */
+        list = NULL;
+    }
+
+    /* A full barrier, so the list is all there before anyone can see it */
+    while (!SDL_AtomicCASPtr((void **) &SDL_event_watchers, old, list)) {
+    }
+
+    if (old) {
+        old->removed = removed;
+        old->next = SDL_event_watchers_retired;
+        /* A full barrier again, so this is seen before we check the count */
+        while (!SDL_AtomicCASPtr((void **) &SDL_event_watchers_retired, old->next, old)) {
+        }
+    }
+
+    SDL_FreeRetiredEventWatchers();
+}
+
 void
 SDL_SetEventFilter(SDL_EventFilter filter, void *userdata)
 {
     if (!SDL_event_watchers_lock || SDL_LockMutex(SDL_event_watchers_lock) == 0) {
+        SDL_EventWatcherList *list = SDL_CopyEventWatchers(0);
+
         /* Set filter and discard pending events */
-        SDL_EventOK.callback = filter;
-        SDL_EventOK.userdata = userdata;
+        if (list) {
+            list->filter = filter;
+            list->filter_userdata = userdata;
+            SDL_PublishEventWatchers(list, NULL);
+        }
         SDL_FlushEvents(SDL_FIRSTEVENT, SDL_LASTEVENT);
 
         if (SDL_event_watchers_lock) {
@@ -773,14 +1669,16 @@ SDL_GetEventFilter(SDL_EventFilter * filter, void **userdata)
 {
     SDL_EventWatcher event_ok;
 
+    SDL_zero(event_ok);
     if (!SDL_event_watchers_lock || SDL_LockMutex(SDL_event_watchers_lock) == 0) {
-        event_ok = SDL_EventOK;
+        if (SDL_event_watchers) {
+            event_ok.callback = SDL_event_watchers->filter;
+            event_ok.userdata = SDL_event_watchers->filter_userdata;
+        }
 
         if (SDL_event_watchers_lock) {
             SDL_UnlockMutex(SDL_event_watchers_lock);
         }
-    } else {
-        SDL_zero(event_ok);
     }
 
     if (filter) {
@@ -796,18 +1694,18 @@ void
 SDL_AddEventWatch(SDL_EventFilter filter, void *userdata)
 {
     if (!SDL_event_watchers_lock || SDL_LockMutex(SDL_event_watchers_lock) == 0) {
-        SDL_EventWatcher *event_watchers;
+        SDL_EventWatcherList *list = SDL_CopyEventWatchers(1);
+        SDL_EventWatcher *watcher = (SDL_EventWatcher *) SDL_malloc(sizeof(*watcher));
 
-        event_watchers = SDL_realloc(SDL_event_watchers, (SDL_event_watchers_count + 1) * sizeof(*event_watchers));
-        if (event_watchers) {
-            SDL_EventWatcher *watcher;
-
-            SDL_event_watchers = event_watchers;
-            watcher = &SDL_event_watchers[SDL_event_watchers_count];
+        if (list && watcher) {
             watcher->callback = filter;
             watcher->userdata = userdata;
-            watcher->removed = SDL_FALSE;
-            ++SDL_event_watchers_count;
+            SDL_AtomicSet(&watcher->removed, 0);
+            list->watchers[list->count++] = watcher;
+            SDL_PublishEventWatchers(list, NULL);
+        } else {
+            SDL_free(list);
+            SDL_free(watcher);
         }
 
         if (SDL_event_watchers_lock) {
@@ -820,18 +1718,22 @@ void
 SDL_DelEventWatch(SDL_EventFilter filter, void *userdata)
 {
     if (!SDL_event_watchers_lock || SDL_LockMutex(SDL_event_watchers_lock) == 0) {
+        const int count = SDL_event_watchers ? SDL_event_watchers->count : 0;
         int i;
 
-        for (i = 0; i < SDL_event_watchers_count; ++i) {
-            if (SDL_event_watchers[i].callback == filter && SDL_event_watchers[i].userdata == userdata) {
-                if (SDL_event_watchers_dispatching) {
-                    SDL_event_watchers[i].removed = SDL_TRUE;
-                    SDL_event_watchers_removed = SDL_TRUE;
-                } else {
-                    --SDL_event_watchers_count;
-                    if (i < SDL_event_watchers_count) {
-                        SDL_memmove(&SDL_event_watchers[i], &SDL_event_watchers[i+1], (SDL_event_watchers_count - i) * sizeof(SDL_event_watchers[i]));
-                    }
+        for (i = 0; i < count; ++i) {
+            SDL_EventWatcher *watcher = SDL_event_watchers->watchers[i];
+            if (watcher->callback == filter && watcher->userdata == userdata &&
+                !SDL_AtomicGet(&watcher->removed)) {
+                SDL_EventWatcherList *list = SDL_CopyEventWatchers(0);
+
+                /* Stop calls from lists already being dispatched. If we're
+                   out of memory, it just stays in the list like this. */
+                SDL_AtomicSet(&watcher->removed, 1);
+                if (list) {
+                    --list->count;
+                    SDL_memmove(&list->watchers[i], &list->watchers[i+1], (list->count - i) * sizeof(list->watchers[i]));
+                    SDL_PublishEventWatchers(list, watcher);
                 }
                 break;
             }
@@ -848,9 +1750,23 @@ SDL_FilterEvents(SDL_EventFilter filter, void *userdata)
 {
     if (!SDL_EventQ.lock || SDL_LockMutex(SDL_EventQ.lock) == 0) {
         SDL_EventEntry *entry, *next;
+        SDL_DrainEventRing();
         for (entry = SDL_EventQ.head; entry; entry = next) {
+            const Uint32 type = entry->event.type;
+            int keep;
+
             next = entry->next;
-            if (!filter(userdata, &entry->event)) {
+            keep = filter(userdata, &entry->event);
+            if (entry->event.type != type) {
+                /* The filter changed it; file it under the new type, or put
+                   the old type back if we can't. */
+                SDL_UnindexEventEntry(entry, type);
+                if (!SDL_IndexEventEntry(entry)) {
+                    entry->event.type = type;
+                    SDL_IndexEventEntry(entry);
+                }
+            }
+            if (!keep) {
                 SDL_CutEvent(entry);
             }
         }
@@ -46,4 +46,9 @@ extern void SDL_QuitQuit(void);
 
 extern void SDL_SendPendingQuit(void);
 
+/* Backends that know when the device produced an event set this, in
+   SDL_GetPerformanceCounter() units, before sending it. Events sent from the
+   same thread get that source time until it's set back to 0. */
+extern void SDL_SetEventSourceTime(Uint64 counter);
+
 /* vi: set ts=4 sw=4 expandtab: */
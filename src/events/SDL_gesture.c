@@ -27,6 +27,7 @@
 #include "SDL_endian.h"
 #include "SDL_events_c.h"
 #include "SDL_gesture_c.h"
+#include "SDL_dollar_c.h"
 
 /*
 #include <stdio.h>
@@ -36,17 +37,8 @@
 
 #define MAXPATHSIZE 1024
 
-#define DOLLARNPOINTS 64
-#define DOLLARSIZE 256
-
 #define ENABLE_DOLLAR
 
-#define PHI 0.618033989
-
-typedef struct {
-    float x,y;
-} SDL_FloatPoint;
-
 typedef struct {
     float length;
 
@@ -54,25 +46,20 @@ typedef struct {
     SDL_FloatPoint p[MAXPATHSIZE];
 } SDL_DollarPath;
 
-typedef struct {
-    SDL_FloatPoint path[DOLLARNPOINTS];
-    unsigned long hash;
-} SDL_DollarTemplate;
-
 typedef struct {
     SDL_TouchID id;
     SDL_FloatPoint centroid;
     SDL_DollarPath dollarPath;
     Uint16 numDownFingers;
 
-    int numDollarTemplates;
-    SDL_DollarTemplate *dollarTemplate;
+    SDL_DollarTemplates dollarTemplates;
 
     SDL_bool recording;
 } SDL_GestureTouch;
 
 static SDL_GestureTouch *SDL_gestureTouch;
 static int SDL_numGestureTouches = 0;
+static SDL_TouchTable SDL_gestureTouchTable;    /* touch id to index in SDL_gestureTouch */
 static SDL_bool recordAll;
 
 #if 0
@@ -87,69 +74,67 @@ static void PrintPath(SDL_FloatPoint *path)
 }
 #endif
 
+static SDL_GestureTouch * SDL_GetGestureTouch(SDL_TouchID id)
+{
+    const int index = SDL_TouchTableFind(&SDL_gestureTouchTable, id);
+    if (index < 0)
+        return NULL;
+    return &SDL_gestureTouch[index];
+}
+
 int SDL_RecordGesture(SDL_TouchID touchId)
 {
     int i;
-    if (touchId < 0) recordAll = SDL_TRUE;
+    if (touchId >= 0) {
+        SDL_GestureTouch *touch = SDL_GetGestureTouch(touchId);
+        if (touch == NULL)
+            return 0;
+        touch->recording = SDL_TRUE;
+        return 1;
+    }
+    recordAll = SDL_TRUE;
     for (i = 0; i < SDL_numGestureTouches; i++) {
-        if ((touchId < 0) || (SDL_gestureTouch[i].id == touchId)) {
-            SDL_gestureTouch[i].recording = SDL_TRUE;
-            if (touchId >= 0)
-                return 1;
-        }
+        SDL_gestureTouch[i].recording = SDL_TRUE;
     }
-    return (touchId < 0);
+    return 1;
 }
 
 void SDL_GestureQuit()
 {
     SDL_free(SDL_gestureTouch);
     SDL_gestureTouch = NULL;
+    SDL_TouchTableFree(&SDL_gestureTouchTable);
 }
 
-static unsigned long SDL_HashDollar(SDL_FloatPoint* points)
+static int SaveTemplate(const SDL_DollarTemplates *templates, int index, SDL_RWops *dst)
 {
-    unsigned long hash = 5381;
-    int i;
-    for (i = 0; i < DOLLARNPOINTS; i++) {
-        hash = ((hash<<5) + hash) + (unsigned long)points[i].x;
-        hash = ((hash<<5) + hash) + (unsigned long)points[i].y;
-    }
-    return hash;
-}
-
+    SDL_FloatPoint path[DOLLARNPOINTS];
 
-static int SaveTemplate(SDL_DollarTemplate *templ, SDL_RWops *dst)
-{
     if (dst == NULL) {
         return 0;
     }
 
+    SDL_DollarGetPath(templates, index, path);
+
     /* No Longer storing the Hash, rehash on load */
     /* if (SDL_RWops.write(dst, &(templ->hash), sizeof(templ->hash), 1) != 1) return 0; */
 
-#if SDL_BYTEORDER == SDL_LIL_ENDIAN
-    if (SDL_RWwrite(dst, templ->path,
-                    sizeof(templ->path[0]),DOLLARNPOINTS) != DOLLARNPOINTS) {
-        return 0;
-    }
-#else
+#if SDL_BYTEORDER != SDL_LIL_ENDIAN
     {
-        SDL_DollarTemplate copy = *templ;
-        SDL_FloatPoint *p = copy.path;
+        SDL_FloatPoint *p = path;
         int i;
         for (i = 0; i < DOLLARNPOINTS; i++, p++) {
             p->x = SDL_SwapFloatLE(p->x);
             p->y = SDL_SwapFloatLE(p->y);
         }
-
-        if (SDL_RWwrite(dst, copy.path,
-                        sizeof(copy.path[0]),DOLLARNPOINTS) != DOLLARNPOINTS) {
-            return 0;
-        }
     }
 #endif
 
+    if (SDL_RWwrite(dst, path,
+                    sizeof(path[0]),DOLLARNPOINTS) != DOLLARNPOINTS) {
+        return 0;
+    }
+
     return 1;
 }
 
@@ -159,8 +144,8 @@ int SDL_SaveAllDollarTemplates(SDL_RWops *dst)
     int i,j,rtrn = 0;
     for (i = 0; i < SDL_numGestureTouches; i++) {
         SDL_GestureTouch* touch = &SDL_gestureTouch[i];
-        for (j = 0; j < touch->numDollarTemplates; j++) {
-            rtrn += SaveTemplate(&touch->dollarTemplate[j], dst);
+        for (j = 0; j < touch->dollarTemplates.numTemplates; j++) {
+            rtrn += SaveTemplate(&touch->dollarTemplates, j, dst);
         }
     }
     return rtrn;
@@ -171,9 +156,9 @@ int SDL_SaveDollarTemplate(SDL_GestureID gestureId, SDL_RWops *dst)
     int i,j;
     for (i = 0; i < SDL_numGestureTouches; i++) {
         SDL_GestureTouch* touch = &SDL_gestureTouch[i];
-        for (j = 0; j < touch->numDollarTemplates; j++) {
-            if (touch->dollarTemplate[j].hash == gestureId) {
-                return SaveTemplate(&touch->dollarTemplate[j], dst);
+        for (j = 0; j < touch->dollarTemplates.numTemplates; j++) {
+            if (touch->dollarTemplates.hash[j] == gestureId) {
+                return SaveTemplate(&touch->dollarTemplates, j, dst);
             }
         }
     }
@@ -184,25 +169,10 @@ int SDL_SaveDollarTemplate(SDL_GestureID gestureId, SDL_RWops *dst)
 Returns the index of the gesture on success, or -1 */
 static int SDL_AddDollarGesture_one(SDL_GestureTouch* inTouch, SDL_FloatPoint* path)
 {
-    SDL_DollarTemplate* dollarTemplate;
-    SDL_DollarTemplate *templ;
-    int index;
-
-    index = inTouch->numDollarTemplates;
-    dollarTemplate =
-        (SDL_DollarTemplate *)SDL_realloc(inTouch->dollarTemplate,
-                                          (index + 1) *
-                                          sizeof(SDL_DollarTemplate));
-    if (!dollarTemplate) {
+    const int index = SDL_DollarAddTemplate(&inTouch->dollarTemplates, path);
+    if (index < 0) {
         return SDL_OutOfMemory();
     }
-    inTouch->dollarTemplate = dollarTemplate;
-
-    templ = &inTouch->dollarTemplate[index];
-    SDL_memcpy(templ->path, path, DOLLARNPOINTS*sizeof(SDL_FloatPoint));
-    templ->hash = SDL_HashDollar(templ->path);
-    inTouch->numDollarTemplates++;
-
     return index;
 }
 
@@ -230,20 +200,16 @@ int SDL_LoadDollarTemplates(SDL_TouchID touchId, SDL_RWops *src)
     SDL_GestureTouch *touch = NULL;
     if (src == NULL) return 0;
     if (touchId >= 0) {
-        for (i = 0; i < SDL_numGestureTouches; i++) {
-            if (SDL_gestureTouch[i].id == touchId) {
-                touch = &SDL_gestureTouch[i];
-            }
-        }
+        touch = SDL_GetGestureTouch(touchId);
         if (touch == NULL) {
             return SDL_SetError("given touch id not found");
         }
     }
 
     while (1) {
-        SDL_DollarTemplate templ;
+        SDL_FloatPoint path[DOLLARNPOINTS];
 
-        if (SDL_RWread(src,templ.path,sizeof(templ.path[0]),DOLLARNPOINTS) < DOLLARNPOINTS) {
+        if (SDL_RWread(src,path,sizeof(path[0]),DOLLARNPOINTS) < DOLLARNPOINTS) {
             if (loaded == 0) {
                 return SDL_SetError("could not read any dollar gesture from rwops");
             }
@@ -252,7 +218,7 @@ int SDL_LoadDollarTemplates(SDL_TouchID touchId, SDL_RWops *src)
 
 #if SDL_BYTEORDER != SDL_LIL_ENDIAN
         for (i = 0; i < DOLLARNPOINTS; i++) {
-            SDL_FloatPoint *p = &templ.path[i];
+            SDL_FloatPoint *p = &path[i];
             p->x = SDL_SwapFloatLE(p->x);
             p->y = SDL_SwapFloatLE(p->y);
         }
@@ -260,7 +226,7 @@ int SDL_LoadDollarTemplates(SDL_TouchID touchId, SDL_RWops *src)
 
         if (touchId >= 0) {
             /* printf("Adding loaded gesture to 1 touch\n"); */
-            if (SDL_AddDollarGesture(touch, templ.path) >= 0)
+            if (SDL_AddDollarGesture(touch, path) >= 0)
                 loaded++;
         }
         else {
@@ -269,7 +235,7 @@ int SDL_LoadDollarTemplates(SDL_TouchID touchId, SDL_RWops *src)
                 touch = &SDL_gestureTouch[i];
                 /* printf("Adding loaded gesture to + touches\n"); */
                 /* TODO: What if this fails? */
-                SDL_AddDollarGesture(touch,templ.path);
+                SDL_AddDollarGesture(touch,path);
             }
             loaded++;
         }
@@ -279,60 +245,6 @@ int SDL_LoadDollarTemplates(SDL_TouchID touchId, SDL_RWops *src)
 }
 
 
-static float dollarDifference(SDL_FloatPoint* points,SDL_FloatPoint* templ,float ang)
-{
-    /*  SDL_FloatPoint p[DOLLARNPOINTS]; */
-    float dist = 0;
-    SDL_FloatPoint p;
-    int i;
-    for (i = 0; i < DOLLARNPOINTS; i++) {
-        p.x = (float)(points[i].x * SDL_cos(ang) - points[i].y * SDL_sin(ang));
-        p.y = (float)(points[i].x * SDL_sin(ang) + points[i].y * SDL_cos(ang));
-        dist += (float)(SDL_sqrt((p.x-templ[i].x)*(p.x-templ[i].x)+
-                                 (p.y-templ[i].y)*(p.y-templ[i].y)));
-    }
-    return dist/DOLLARNPOINTS;
-
-}
-
-static float bestDollarDifference(SDL_FloatPoint* points,SDL_FloatPoint* templ)
-{
-    /*------------BEGIN DOLLAR BLACKBOX------------------
-      -TRANSLATED DIRECTLY FROM PSUDEO-CODE AVAILABLE AT-
-      -"http://depts.washington.edu/aimgroup/proj/dollar/"
-    */
-    double ta = -M_PI/4;
-    double tb = M_PI/4;
-    double dt = M_PI/90;
-    float x1 = (float)(PHI*ta + (1-PHI)*tb);
-    float f1 = dollarDifference(points,templ,x1);
-    float x2 = (float)((1-PHI)*ta + PHI*tb);
-    float f2 = dollarDifference(points,templ,x2);
-    while (SDL_fabs(ta-tb) > dt) {
-        if (f1 < f2) {
-            tb = x2;
-            x2 = x1;
-            f2 = f1;
-            x1 = (float)(PHI*ta + (1-PHI)*tb);
-            f1 = dollarDifference(points,templ,x1);
-        }
-        else {
-            ta = x1;
-            x1 = x2;
-            f1 = f2;
-            x2 = (float)((1-PHI)*ta + PHI*tb);
-            f2 = dollarDifference(points,templ,x2);
-        }
-    }
-    /*
-      if (f1 <= f2)
-          printf("Min angle (x1): %f\n",x1);
-      else if (f1 >  f2)
-          printf("Min angle (x2): %f\n",x2);
-    */
-    return SDL_min(f1,f2);
-}
-
 /* DollarPath contains raw points, plus (possibly) the calculated length */
 static int dollarNormalize(const SDL_DollarPath *path,SDL_FloatPoint *points)
 {
@@ -429,20 +341,15 @@ static int dollarNormalize(const SDL_DollarPath *path,SDL_FloatPoint *points)
 static float dollarRecognize(const SDL_DollarPath *path,int *bestTempl,SDL_GestureTouch* touch)
 {
     SDL_FloatPoint points[DOLLARNPOINTS];
-    int i;
-    float bestDiff = 10000;
+    SDL_DollarStroke stroke;
 
     SDL_memset(points, 0, sizeof(points));
 
     dollarNormalize(path,points);
 
     /* PrintPath(points); */
-    *bestTempl = -1;
-    for (i = 0; i < touch->numDollarTemplates; i++) {
-        float diff = bestDollarDifference(points,touch->dollarTemplate[i].path);
-        if (diff < bestDiff) {bestDiff = diff; *bestTempl = i;}
-    }
-    return bestDiff;
+    SDL_DollarSplitPath(points, stroke.x, stroke.y, stroke.radius);
+    return SDL_DollarRecognize(&touch->dollarTemplates, &stroke, 0, bestTempl);
 }
 
 int SDL_GestureAddTouch(SDL_TouchID touchId)
@@ -457,6 +364,10 @@ int SDL_GestureAddTouch(SDL_TouchID touchId)
 
     SDL_gestureTouch = gestureTouch;
 
+    if (SDL_TouchTableSet(&SDL_gestureTouchTable, touchId, SDL_numGestureTouches) < 0) {
+        return -1;
+    }
+
     SDL_zero(SDL_gestureTouch[SDL_numGestureTouches]);
     SDL_gestureTouch[SDL_numGestureTouches].id = touchId;
     SDL_numGestureTouches++;
@@ -465,35 +376,22 @@ int SDL_GestureAddTouch(SDL_TouchID touchId)
 
 int SDL_GestureDelTouch(SDL_TouchID touchId)
 {
-    int i;
-    for (i = 0; i < SDL_numGestureTouches; i++) {
-        if (SDL_gestureTouch[i].id == touchId) {
-            break;
-        }
-    }
-
-    if (i == SDL_numGestureTouches) {
+    int i = SDL_TouchTableFind(&SDL_gestureTouchTable, touchId);
+    if (i < 0) {
         /* not found */
         return -1;
     }
 
-    SDL_free(SDL_gestureTouch[i].dollarTemplate);
+    SDL_DollarFreeTemplates(&SDL_gestureTouch[i].dollarTemplates);
     SDL_zero(SDL_gestureTouch[i]);
+    SDL_TouchTableRemove(&SDL_gestureTouchTable, touchId);
 
     SDL_numGestureTouches--;
-    SDL_memcpy(&SDL_gestureTouch[i], &SDL_gestureTouch[SDL_numGestureTouches], sizeof(SDL_gestureTouch[i]));
-    return 0;
-}
-
-static SDL_GestureTouch * SDL_GetGestureTouch(SDL_TouchID id)
-{
-    int i;
-    for (i = 0; i < SDL_numGestureTouches; i++) {
-        /* printf("%i ?= %i\n",SDL_gestureTouch[i].id,id); */
-        if (SDL_gestureTouch[i].id == id)
-            return &SDL_gestureTouch[i];
+    if (i != SDL_numGestureTouches) {
+        SDL_memcpy(&SDL_gestureTouch[i], &SDL_gestureTouch[SDL_numGestureTouches], sizeof(SDL_gestureTouch[i]));
+        SDL_TouchTableSet(&SDL_gestureTouchTable, SDL_gestureTouch[i].id, i);
     }
-    return NULL;
+    return 0;
 }
 
 static int SDL_SendGestureMulti(SDL_GestureTouch* touch,float dTheta,float dDist)
@@ -580,7 +478,7 @@ void SDL_GestureProcessEvent(SDL_Event* event)
                 }
 
                 if (index >= 0) {
-                    SDL_SendDollarRecord(inTouch,inTouch->dollarTemplate[index].hash);
+                    SDL_SendDollarRecord(inTouch,inTouch->dollarTemplates.hash[index]);
                 }
                 else {
                     SDL_SendDollarRecord(inTouch,-1);
@@ -593,7 +491,7 @@ void SDL_GestureProcessEvent(SDL_Event* event)
                                         &bestTempl,inTouch);
                 if (bestTempl >= 0){
                     /* Send Event */
-                    unsigned long gestureId = inTouch->dollarTemplate[bestTempl].hash;
+                    unsigned long gestureId = inTouch->dollarTemplates.hash[bestTempl];
                     SDL_SendGestureDollar(inTouch,gestureId,error);
                     /* printf ("%s\n",);("Dollar error: %f\n",error); */
                 }
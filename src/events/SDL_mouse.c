@@ -28,6 +28,7 @@
 #include "SDL_events.h"
 #include "SDL_events_c.h"
 #include "../video/SDL_sysvideo.h"
+#include "default_cursor.h"
 
 /* #define DEBUG_MOUSE */
 
@@ -592,6 +593,10 @@ SDL_MouseQuit(void)
         mouse->clickstate = NULL;
     }
 
+    SDL_free(mouse->cursor_save);
+    mouse->cursor_save = NULL;
+    mouse->cursor_save_size = 0;
+
     SDL_DelHintCallback(SDL_HINT_MOUSE_NORMAL_SPEED_SCALE,
                         SDL_MouseNormalSpeedScaleChanged, mouse);
 
@@ -1024,4 +1029,166 @@ SDL_ShowCursor(int toggle)
     return shown;
 }
 
+/* The software cursor, for video drivers that can't show one */
+
+typedef struct
+{
+    SDL_Surface *surface;       /* ARGB8888, blended onto the window surface */
+    int hot_x, hot_y;
+} SDL_SoftwareCursorData;
+
+static SDL_Cursor *
+SDL_SoftwareCreateCursor(SDL_Surface * surface, int hot_x, int hot_y)
+{
+    SDL_Cursor *cursor;
+    SDL_SoftwareCursorData *data;
+
+    cursor = (SDL_Cursor *) SDL_calloc(1, sizeof(*cursor));
+    data = (SDL_SoftwareCursorData *) SDL_calloc(1, sizeof(*data));
+    if (!cursor || !data) {
+        SDL_free(cursor);
+        SDL_free(data);
+        SDL_OutOfMemory();
+        return NULL;
+    }
+
+    data->surface = SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_ARGB8888, 0);
+    if (!data->surface) {
+        SDL_free(cursor);
+        SDL_free(data);
+        return NULL;
+    }
+    SDL_SetSurfaceBlendMode(data->surface, SDL_BLENDMODE_BLEND);
+    data->hot_x = hot_x;
+    data->hot_y = hot_y;
+    cursor->driverdata = data;
+    return cursor;
+}
+
+static int
+SDL_SoftwareShowCursor(SDL_Cursor * cursor)
+{
+    /* It shows up the next time the window surface is updated */
+    return 0;
+}
+
+static void
+SDL_SoftwareFreeCursor(SDL_Cursor * cursor)
+{
+    SDL_SoftwareCursorData *data = (SDL_SoftwareCursorData *) cursor->driverdata;
+
+    SDL_FreeSurface(data->surface);
+    SDL_free(data);
+    SDL_free(cursor);
+}
+
+void
+SDL_EnableSoftwareCursor(void)
+{
+    SDL_Mouse *mouse = SDL_GetMouse();
+
+    if (mouse->CreateCursor) {
+        /* The video driver has cursors of its own */
+        return;
+    }
+
+    mouse->CreateCursor = SDL_SoftwareCreateCursor;
+    mouse->ShowCursor = SDL_SoftwareShowCursor;
+    mouse->FreeCursor = SDL_SoftwareFreeCursor;
+    mouse->software_cursor = SDL_TRUE;
+
+    SDL_SetDefaultCursor(SDL_CreateCursor(default_cdata, default_cmask, DEFAULT_CWIDTH, DEFAULT_CHEIGHT, DEFAULT_CHOTX, DEFAULT_CHOTY));
+}
+
+static void
+SDL_CopyCursorPixels(SDL_Surface * surface, const SDL_Rect * rect, Uint8 * save, SDL_bool restore)
+{
+    const int bpp = surface->format->BytesPerPixel;
+    const size_t length = rect->w * bpp;
+    Uint8 *pixels = (Uint8 *) surface->pixels + rect->y * surface->pitch + rect->x * bpp;
+    int y;
+
+    for (y = 0; y < rect->h; ++y) {
+        if (restore) {
+            SDL_memcpy(pixels, save, length);
+        } else {
+            SDL_memcpy(save, pixels, length);
+        }
+        pixels += surface->pitch;
+        save += length;
+    }
+}
+
+int
+SDL_DrawSoftwareCursor(SDL_Window * window, SDL_Rect * rects, int numrects)
+{
+    SDL_Mouse *mouse = SDL_GetMouse();
+    SDL_Surface *surface = window->surface;
+    SDL_Cursor *cursor = mouse->cur_cursor ? mouse->cur_cursor : mouse->def_cursor;
+    SDL_SoftwareCursorData *data = NULL;
+    SDL_Rect bounds, rect, srcrect;
+    size_t size;
+
+    bounds.x = 0;
+    bounds.y = 0;
+    bounds.w = surface->w;
+    bounds.h = surface->h;
+
+    SDL_zero(rect);
+    if (cursor && mouse->cursor_shown && !mouse->relative_mode && mouse->focus == window) {
+        data = (SDL_SoftwareCursorData *) cursor->driverdata;
+        rect.x = mouse->x - data->hot_x;
+        rect.y = mouse->y - data->hot_y;
+        rect.w = data->surface->w;
+        rect.h = data->surface->h;
+        if (!SDL_IntersectRect(&rect, &bounds, &rect)) {
+            SDL_zero(rect);
+        }
+    }
+
+    /* If it's moved or gone, what it covered needs showing again */
+    if (!SDL_RectEmpty(&window->cursor_rect) && !SDL_RectEquals(&window->cursor_rect, &rect)) {
+        if (SDL_IntersectRect(&window->cursor_rect, &bounds, &rects[numrects])) {
+            ++numrects;
+        }
+    }
+
+    SDL_zero(window->cursor_rect);
+    if (SDL_RectEmpty(&rect)) {
+        return numrects;
+    }
+
+    size = rect.w * rect.h * surface->format->BytesPerPixel;
+    if (size > mouse->cursor_save_size) {
+        Uint8 *save = (Uint8 *) SDL_realloc(mouse->cursor_save, size);
+        if (!save) {
+            /* Leave the cursor out rather than lose what's under it */
+            return numrects;
+        }
+        mouse->cursor_save = save;
+        mouse->cursor_save_size = size;
+    }
+    SDL_CopyCursorPixels(surface, &rect, mouse->cursor_save, SDL_FALSE);
+    window->cursor_rect = rect;
+
+    srcrect.x = rect.x - (mouse->x - data->hot_x);
+    srcrect.y = rect.y - (mouse->y - data->hot_y);
+    srcrect.w = rect.w;
+    srcrect.h = rect.h;
+    SDL_LowerBlit(data->surface, &srcrect, surface, &rect);
+
+    rects[numrects++] = window->cursor_rect;
+    return numrects;
+}
+
+void
+SDL_EraseSoftwareCursor(SDL_Window * window)
+{
+    SDL_Mouse *mouse = SDL_GetMouse();
+
+    if (!SDL_RectEmpty(&window->cursor_rect)) {
+        SDL_CopyCursorPixels(window->surface, &window->cursor_rect, mouse->cursor_save, SDL_TRUE);
+    }
+}
+
 /* vi: set ts=4 sw=4 expandtab: */
@@ -101,6 +101,11 @@ typedef struct
     SDL_Cursor *cur_cursor;
     SDL_bool cursor_shown;
 
+    /* Data for drawing the cursor when the video driver can't */
+    SDL_bool software_cursor;
+    Uint8 *cursor_save;         /* the pixels under the cursor while it's drawn */
+    size_t cursor_save_size;
+
     /* Driver-dependent data. */
     void *driverdata;
 } SDL_Mouse;
@@ -133,6 +138,17 @@ extern int SDL_SendMouseButtonClicks(SDL_Window * window, SDL_MouseID mouseID, U
 /* Send a mouse wheel event */
 extern int SDL_SendMouseWheel(SDL_Window * window, SDL_MouseID mouseID, float x, float y, SDL_MouseWheelDirection direction);
 
+/* Draw the cursor into window surfaces if the video driver can't show one */
+extern void SDL_EnableSoftwareCursor(void);
+
+/* Draw the software cursor into a window surface that's about to be shown.
+   This adds the areas it changed to rects, which must have room for two
+   more, and returns the new number of rects. */
+extern int SDL_DrawSoftwareCursor(SDL_Window * window, SDL_Rect * rects, int numrects);
+
+/* Put back what the software cursor covered once the surface is shown */
+extern void SDL_EraseSoftwareCursor(SDL_Window * window);
+
 /* Shutdown the mouse subsystem */
 extern void SDL_MouseQuit(void);
 
@@ -28,8 +28,130 @@
 #include "../video/SDL_sysvideo.h"
 
 
+/* Enough for every finger on most touch screens, so they never reallocate */
+#define SDL_TOUCH_PREALLOCATED_FINGERS 10
+
 static int SDL_num_touch = 0;
 static SDL_Touch **SDL_touchDevices = NULL;
+static SDL_TouchTable SDL_touchTable;   /* touch id to index in SDL_touchDevices */
+
+
+static int
+SDL_TouchTableHash(const SDL_TouchTable *table, Sint64 id)
+{
+    /* ids are often small sequential numbers or pointers, so mix all the
+       bits into the low ones */
+    Uint32 h = (Uint32) id ^ (Uint32) ((Uint64) id >> 32);
+    h ^= h >> 16;
+    h *= 0x7feb352d;
+    h ^= h >> 15;
+    h *= 0x846ca68b;
+    h ^= h >> 16;
+    return (int) (h & (table->size - 1));
+}
+
+/* Returns the slot holding id, or the empty slot it would go in */
+static SDL_TouchSlot *
+SDL_TouchTableLookup(const SDL_TouchTable *table, Sint64 id)
+{
+    int i = SDL_TouchTableHash(table, id);
+    while (table->slots[i].index >= 0 && table->slots[i].id != id) {
+        i = (i + 1) & (table->size - 1);
+    }
+    return &table->slots[i];
+}
+
+int
+SDL_TouchTableReserve(SDL_TouchTable *table, int count)
+{
+    SDL_TouchTable grown;
+    int i;
+
+    if (count * 2 <= table->size) {
+        return 0;
+    }
+
+    grown.size = table->size ? table->size : 16;
+    while (grown.size < count * 2) {
+        grown.size *= 2;
+    }
+    grown.count = table->count;
+    grown.slots = (SDL_TouchSlot *) SDL_malloc(grown.size * sizeof (*grown.slots));
+    if (!grown.slots) {
+        return SDL_OutOfMemory();
+    }
+    for (i = 0; i < grown.size; i++) {
+        grown.slots[i].index = -1;
+    }
+    for (i = 0; i < table->size; i++) {
+        if (table->slots[i].index >= 0) {
+            *SDL_TouchTableLookup(&grown, table->slots[i].id) = table->slots[i];
+        }
+    }
+    SDL_free(table->slots);
+    *table = grown;
+    return 0;
+}
+
+int
+SDL_TouchTableFind(const SDL_TouchTable *table, Sint64 id)
+{
+    if (!table->size) {
+        return -1;
+    }
+    return SDL_TouchTableLookup(table, id)->index;
+}
+
+int
+SDL_TouchTableSet(SDL_TouchTable *table, Sint64 id, int index)
+{
+    SDL_TouchSlot *slot;
+
+    if (SDL_TouchTableReserve(table, table->count + 1) < 0) {
+        return -1;
+    }
+    slot = SDL_TouchTableLookup(table, id);
+    if (slot->index < 0) {
+        slot->id = id;
+        table->count++;
+    }
+    slot->index = index;
+    return 0;
+}
+
+void
+SDL_TouchTableRemove(SDL_TouchTable *table, Sint64 id)
+{
+    const int mask = table->size - 1;
+    int hole, i;
+
+    if (!table->size) {
+        return;
+    }
+    hole = (int) (SDL_TouchTableLookup(table, id) - table->slots);
+    if (table->slots[hole].index < 0) {
+        return;
+    }
+    table->count--;
+
+    /* Move the entries after it back over the hole where their probe
+       sequence allows, so lookups never need to step over deleted slots. */
+    for (i = (hole + 1) & mask; table->slots[i].index >= 0; i = (i + 1) & mask) {
+        const int home = SDL_TouchTableHash(table, table->slots[i].id);
+        if (((i - home) & mask) >= ((i - hole) & mask)) {
+            table->slots[hole] = table->slots[i];
+            hole = i;
+        }
+    }
+    table->slots[hole].index = -1;
+}
+
+void
+SDL_TouchTableFree(SDL_TouchTable *table)
+{
+    SDL_free(table->slots);
+    SDL_zerop(table);
+}
 
 
 /* Public functions */
@@ -58,16 +180,7 @@ SDL_GetTouchDevice(int index)
 static int
 SDL_GetTouchIndex(SDL_TouchID id)
 {
-    int index;
-    SDL_Touch *touch;
-
-    for (index = 0; index < SDL_num_touch; ++index) {
-        touch = SDL_touchDevices[index];
-        if (touch->id == id) {
-            return index;
-        }
-    }
-    return -1;
+    return SDL_TouchTableFind(&SDL_touchTable, id);
 }
 
 SDL_Touch *
@@ -89,13 +202,7 @@ SDL_GetTouch(SDL_TouchID id)
 static int
 SDL_GetFingerIndex(const SDL_Touch * touch, SDL_FingerID fingerid)
 {
-    int index;
-    for (index = 0; index < touch->num_fingers; ++index) {
-        if (touch->fingers[index]->id == fingerid) {
-            return index;
-        }
-    }
-    return -1;
+    return SDL_TouchTableFind(&touch->finger_table, fingerid);
 }
 
 static SDL_Finger *
@@ -105,7 +212,7 @@ SDL_GetFinger(const SDL_Touch * touch, SDL_FingerID id)
     if (index < 0 || index >= touch->num_fingers) {
         return NULL;
     }
-    return touch->fingers[index];
+    return &touch->fingers[index];
 }
 
 int
@@ -129,13 +236,14 @@ SDL_GetTouchFinger(SDL_TouchID touchID, int index)
         SDL_SetError("Unknown touch finger");
         return NULL;
     }
-    return touch->fingers[index];
+    return &touch->fingers[index];
 }
 
 int
 SDL_AddTouch(SDL_TouchID touchID, const char *name)
 {
     SDL_Touch **touchDevices;
+    SDL_Touch *touch;
     int index;
 
     index = SDL_GetTouchIndex(touchID);
@@ -153,20 +261,27 @@ SDL_AddTouch(SDL_TouchID touchID, const char *name)
     SDL_touchDevices = touchDevices;
     index = SDL_num_touch;
 
-    SDL_touchDevices[index] = (SDL_Touch *) SDL_malloc(sizeof(*SDL_touchDevices[index]));
-    if (!SDL_touchDevices[index]) {
+    /* we're setting the touch properties */
+    touch = (SDL_Touch *) SDL_calloc(1, sizeof(*touch));
+    if (!touch) {
+        return SDL_OutOfMemory();
+    }
+    touch->id = touchID;
+    touch->fingers = (SDL_Finger *) SDL_malloc(SDL_TOUCH_PREALLOCATED_FINGERS * sizeof(*touch->fingers));
+    if (!touch->fingers ||
+        SDL_TouchTableReserve(&touch->finger_table, SDL_TOUCH_PREALLOCATED_FINGERS) < 0 ||
+        SDL_TouchTableSet(&SDL_touchTable, touchID, index) < 0) {
+        SDL_free(touch->fingers);
+        SDL_TouchTableFree(&touch->finger_table);
+        SDL_free(touch);
         return SDL_OutOfMemory();
     }
+    touch->max_fingers = SDL_TOUCH_PREALLOCATED_FINGERS;
 
     /* Added touch to list */
+    SDL_touchDevices[index] = touch;
     ++SDL_num_touch;
 
-    /* we're setting the touch properties */
-    SDL_touchDevices[index]->id = touchID;
-    SDL_touchDevices[index]->num_fingers = 0;
-    SDL_touchDevices[index]->max_fingers = 0;
-    SDL_touchDevices[index]->fingers = NULL;
-
     /* Record this touch device for gestures */
     /* We could do this on the fly in the gesture code if we wanted */
     SDL_GestureAddTouch(touchID);
@@ -180,20 +295,20 @@ SDL_AddFinger(SDL_Touch *touch, SDL_FingerID fingerid, float x, float y, float p
     SDL_Finger *finger;
 
     if (touch->num_fingers == touch->max_fingers) {
-        SDL_Finger **new_fingers;
-        new_fingers = (SDL_Finger **)SDL_realloc(touch->fingers, (touch->max_fingers+1)*sizeof(*touch->fingers));
+        SDL_Finger *new_fingers;
+        new_fingers = (SDL_Finger *)SDL_realloc(touch->fingers, (touch->max_fingers*2)*sizeof(*touch->fingers));
         if (!new_fingers) {
             return SDL_OutOfMemory();
         }
         touch->fingers = new_fingers;
-        touch->fingers[touch->max_fingers] = (SDL_Finger *)SDL_malloc(sizeof(*finger));
-        if (!touch->fingers[touch->max_fingers]) {
-            return SDL_OutOfMemory();
-        }
-        touch->max_fingers++;
+        touch->max_fingers *= 2;
+    }
+
+    if (SDL_TouchTableSet(&touch->finger_table, fingerid, touch->num_fingers) < 0) {
+        return -1;
     }
 
-    finger = touch->fingers[touch->num_fingers++];
+    finger = &touch->fingers[touch->num_fingers++];
     finger->id = fingerid;
     finger->x = x;
     finger->y = y;
@@ -204,17 +319,18 @@ SDL_AddFinger(SDL_Touch *touch, SDL_FingerID fingerid, float x, float y, float p
 static int
 SDL_DelFinger(SDL_Touch* touch, SDL_FingerID fingerid)
 {
-    SDL_Finger *temp;
-
     int index = SDL_GetFingerIndex(touch, fingerid);
     if (index < 0) {
         return -1;
     }
 
+    SDL_TouchTableRemove(&touch->finger_table, fingerid);
     touch->num_fingers--;
-    temp = touch->fingers[index];
-    touch->fingers[index] = touch->fingers[touch->num_fingers];
-    touch->fingers[touch->num_fingers] = temp;
+    if (index != touch->num_fingers) {
+        /* move the last finger into the gap; it's already in the table, so this can't fail */
+        touch->fingers[index] = touch->fingers[touch->num_fingers];
+        SDL_TouchTableSet(&touch->finger_table, touch->fingers[index].id, index);
+    }
     return 0;
 }
 
@@ -336,7 +452,6 @@ SDL_SendTouchMotion(SDL_TouchID id, SDL_FingerID fingerid,
 void
 SDL_DelTouch(SDL_TouchID id)
 {
-    int i;
     int index = SDL_GetTouchIndex(id);
     SDL_Touch *touch = SDL_GetTouch(id);
 
@@ -344,14 +459,16 @@ SDL_DelTouch(SDL_TouchID id)
         return;
     }
 
-    for (i = 0; i < touch->max_fingers; ++i) {
-        SDL_free(touch->fingers[i]);
-    }
+    SDL_TouchTableFree(&touch->finger_table);
     SDL_free(touch->fingers);
     SDL_free(touch);
 
+    SDL_TouchTableRemove(&SDL_touchTable, id);
     SDL_num_touch--;
-    SDL_touchDevices[index] = SDL_touchDevices[SDL_num_touch];
+    if (index != SDL_num_touch) {
+        SDL_touchDevices[index] = SDL_touchDevices[SDL_num_touch];
+        SDL_TouchTableSet(&SDL_touchTable, SDL_touchDevices[index]->id, index);
+    }
 
     /* Delete this touch device for gestures */
     SDL_GestureDelTouch(id);
@@ -369,6 +486,7 @@ SDL_TouchQuit(void)
 
     SDL_free(SDL_touchDevices);
     SDL_touchDevices = NULL;
+    SDL_TouchTableFree(&SDL_touchTable);
     SDL_GestureQuit();
 }
 
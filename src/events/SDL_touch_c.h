@@ -24,15 +24,45 @@
 #ifndef SDL_touch_c_h_
 #define SDL_touch_c_h_
 
+/* A small open addressing hash table, from touch or finger ids to where
+   they are kept in an array. */
+typedef struct SDL_TouchSlot
+{
+    Sint64 id;
+    int index;      /* -1 if the slot is empty */
+} SDL_TouchSlot;
+
+typedef struct SDL_TouchTable
+{
+    int size;       /* a power of two, at least twice count */
+    int count;
+    SDL_TouchSlot *slots;
+} SDL_TouchTable;
+
 typedef struct SDL_Touch
 {
     SDL_TouchID id;
     int num_fingers;
     int max_fingers;
-    SDL_Finger** fingers;
+    SDL_Finger *fingers;
+    SDL_TouchTable finger_table;
 } SDL_Touch;
 
 
+/* Make room in a touch table for count ids. Returns -1 if out of memory. */
+extern int SDL_TouchTableReserve(SDL_TouchTable *table, int count);
+
+/* Get the index stored for an id, or -1 if it isn't in the table */
+extern int SDL_TouchTableFind(const SDL_TouchTable *table, Sint64 id);
+
+/* Add an id, or change its index. Returns -1 if out of memory. */
+extern int SDL_TouchTableSet(SDL_TouchTable *table, Sint64 id, int index);
+
+/* Remove an id from a touch table */
+extern void SDL_TouchTableRemove(SDL_TouchTable *table, Sint64 id);
+
+extern void SDL_TouchTableFree(SDL_TouchTable *table);
+
 /* Initialize the touch subsystem */
 extern int SDL_TouchInit(void);
 
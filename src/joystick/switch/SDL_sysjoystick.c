@@ -27,6 +27,7 @@
 
 #include "../SDL_sysjoystick.h"
 #include "../SDL_joystick_c.h"
+#include "../../events/SDL_events_c.h"
 
 #include "SDL_assert.h"
 #include "SDL_events.h"
@@ -128,6 +129,25 @@ static int32_t clamp(int32_t val, int32_t min, int32_t max) {
     return val < min ? min : (val > max ? max : val);
 }
 
+/* Function to work out when the latest HID entry was sampled.
+ * The entries are stamped with the system tick, which is also what
+ * SDL_GetPerformanceCounter() returns here. A stamp that isn't from the
+ * last second is ignored, and 0 is returned if neither entry has one.
+ */
+static Uint64 GetSourceTime(const hid_controller_state_entry_t *a, const hid_controller_state_entry_t *b) {
+    const Uint64 now = SDL_GetPerformanceCounter();
+    const Uint64 freq = SDL_GetPerformanceFrequency();
+    Uint64 source = 0;
+
+    if (a->timestamp <= now && now - a->timestamp < freq) {
+        source = a->timestamp;
+    }
+    if (b->timestamp <= now && now - b->timestamp < freq && b->timestamp > source) {
+        source = b->timestamp;
+    }
+    return source;
+}
+
 /* Function to update the state of a joystick - called as a device poll.
  * This function shouldn't update the joystick structure directly,
  * but instead should call SDL_PrivateJoystick*() to deliver events
@@ -167,6 +187,7 @@ void SDL_SYS_JoystickUpdate(SDL_Joystick * joystick) {
     int16_t x2 = (int16_t) clamp(ux2, JOYSTICK_MIN, JOYSTICK_MAX);
     int16_t y2 = (int16_t) clamp(uy2, JOYSTICK_MIN, JOYSTICK_MAX);
 
+    SDL_SetEventSourceTime(GetSourceTime(&ent_joycon, &ent_main));
 
     if(x1 != x1_old) {
         SDL_PrivateJoystickAxis(joystick, 0, x1);
@@ -194,6 +215,8 @@ void SDL_SYS_JoystickUpdate(SDL_Joystick * joystick) {
             SDL_PRESSED : SDL_RELEASED
         );
     }
+
+    SDL_SetEventSourceTime(0);
 }
 
 /* Function to close a joystick after use */
@@ -274,6 +274,16 @@ SDL_CreateWindowAndRenderer(int width, int height, Uint32 window_flags,
     return 0;
 }
 
+static size_t
+GetTexturePoolBudgetHint(void)
+{
+    const char *hint = SDL_GetHint(SDL_HINT_RENDER_TEXTURE_POOL_BUDGET);
+    if (hint) {
+        return (size_t)SDL_strtoul(hint, NULL, 0);
+    }
+    return 0;
+}
+
 SDL_Renderer *
 SDL_CreateRenderer(SDL_Window * window, int index, Uint32 flags)
 {
@@ -366,6 +376,8 @@ SDL_CreateRenderer(SDL_Window * window, int index, Uint32 flags)
             renderer->hidden = SDL_FALSE;
         }
 
+        renderer->texture_pool_budget = GetTexturePoolBudgetHint();
+
         SDL_SetWindowData(window, SDL_WINDOWRENDERDATA, renderer);
 
         SDL_RenderSetViewport(renderer, NULL);
@@ -394,6 +406,7 @@ SDL_CreateSoftwareRenderer(SDL_Surface * surface)
         renderer->magic = &renderer_magic;
         renderer->scale.x = 1.0f;
         renderer->scale.y = 1.0f;
+        renderer->texture_pool_budget = GetTexturePoolBudgetHint();
 
         SDL_RenderSetViewport(renderer, NULL);
     }
@@ -493,10 +506,114 @@ GetClosestSupportedFormat(SDL_Renderer * renderer, Uint32 format)
     return renderer->info.texture_formats[0];
 }
 
+static size_t
+GetTexturePoolSize(SDL_Texture * texture)
+{
+    size_t size = (size_t)texture->w * texture->h * SDL_BYTESPERPIXEL(texture->format) * texture->num_buffers;
+    if (texture->native) {
+        size += (size_t)texture->w * texture->h * SDL_BYTESPERPIXEL(texture->native->format);
+    }
+    return size;
+}
+
+static void DestroyTextureInternal(SDL_Texture * texture);
+
+static void
+RemoveTextureFromPool(SDL_Renderer * renderer, SDL_Texture * texture)
+{
+    if (texture->pool_prev) {
+        texture->pool_prev->pool_next = texture->pool_next;
+    } else {
+        renderer->texture_pool = texture->pool_next;
+    }
+    if (texture->pool_next) {
+        texture->pool_next->pool_prev = texture->pool_prev;
+    } else {
+        renderer->texture_pool_tail = texture->pool_prev;
+    }
+    texture->pool_prev = NULL;
+    texture->pool_next = NULL;
+    renderer->texture_pool_size -= GetTexturePoolSize(texture);
+}
+
+static void
+TrimTexturePool(SDL_Renderer * renderer, size_t size)
+{
+    while (renderer->texture_pool_size > size) {
+        /* The least recently destroyed texture is at the end of the pool */
+        SDL_Texture *texture = renderer->texture_pool_tail;
+
+        RemoveTextureFromPool(renderer, texture);
+        DestroyTextureInternal(texture);
+    }
+}
+
+static SDL_Texture *
+TakeTextureFromPool(SDL_Renderer * renderer, Uint32 format, int access, int w, int h, int num_buffers)
+{
+    SDL_Texture *texture;
+
+    for (texture = renderer->texture_pool; texture; texture = texture->pool_next) {
+        if (texture->format == format && texture->access == access &&
+            texture->w == w && texture->h == h &&
+            texture->num_buffers == num_buffers) {
+            RemoveTextureFromPool(renderer, texture);
+
+            /* Give it the state of a newly created texture */
+            texture->magic = &texture_magic;
+            texture->pending = SDL_FALSE;
+            SDL_SetTextureColorMod(texture, 255, 255, 255);
+            SDL_SetTextureAlphaMod(texture, 255);
+            SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_NONE);
+            return texture;
+        }
+    }
+    return NULL;
+}
+
+static SDL_bool
+PutTextureInPool(SDL_Renderer * renderer, SDL_Texture * texture)
+{
+    size_t size = GetTexturePoolSize(texture);
+
+    if (size > renderer->texture_pool_budget) {
+        return SDL_FALSE;
+    }
+
+    /* The texture stays in the renderer's texture list so drivers can
+       release and recreate its storage when the device is reset.
+     */
+    texture->magic = NULL;
+    texture->pool_prev = NULL;
+    texture->pool_next = renderer->texture_pool;
+    if (renderer->texture_pool) {
+        renderer->texture_pool->pool_prev = texture;
+    } else {
+        renderer->texture_pool_tail = texture;
+    }
+    renderer->texture_pool = texture;
+    renderer->texture_pool_size += size;
+
+    TrimTexturePool(renderer, renderer->texture_pool_budget);
+    return SDL_TRUE;
+}
+
+static int
+GetStreamingBuffersHint(void)
+{
+    const char *hint = SDL_GetHint(SDL_HINT_RENDER_STREAMING_BUFFERS);
+    int num_buffers = hint ? SDL_atoi(hint) : 1;
+
+    return SDL_max(1, SDL_min(num_buffers, SDL_MAX_STREAMING_BUFFERS));
+}
+
+static SDL_Texture *CreateTexture(SDL_Renderer * renderer, Uint32 format, int access, int w, int h, int num_buffers);
+
 SDL_Texture *
 SDL_CreateTexture(SDL_Renderer * renderer, Uint32 format, int access, int w, int h)
 {
     SDL_Texture *texture;
+    int num_buffers = 1;
 
     CHECK_RENDERER_MAGIC(renderer, NULL);
 
@@ -520,6 +637,28 @@ SDL_CreateTexture(SDL_Renderer * renderer, Uint32 format, int access, int w, int
         SDL_SetError("Texture dimensions are limited to %dx%d", renderer->info.max_texture_width, renderer->info.max_texture_height);
         return NULL;
     }
+    if (access == SDL_TEXTUREACCESS_STREAMING) {
+        num_buffers = GetStreamingBuffersHint();
+        if (SDL_ISPIXELFORMAT_FOURCC(format) && IsSupportedFormat(renderer, format)) {
+            /* The renderer handles these itself, there's nothing to stage */
+            num_buffers = 1;
+        }
+    }
+    if (renderer->texture_pool) {
+        texture = TakeTextureFromPool(renderer, format, access, w, h, num_buffers);
+        if (texture) {
+            return texture;
+        }
+    }
+    return CreateTexture(renderer, format, access, w, h, num_buffers);
+}
+
+static SDL_Texture *
+CreateTexture(SDL_Renderer * renderer, Uint32 format, int access, int w, int h, int num_buffers)
+{
+    SDL_Texture *texture;
+    int i;
+
     texture = (SDL_Texture *) SDL_calloc(1, sizeof(*texture));
     if (!texture) {
         SDL_OutOfMemory();
@@ -534,6 +673,7 @@ SDL_CreateTexture(SDL_Renderer * renderer, Uint32 format, int access, int w, int
     texture->g = 255;
     texture->b = 255;
     texture->a = 255;
+    texture->num_buffers = num_buffers;
     texture->renderer = renderer;
     texture->next = renderer->textures;
     if (renderer->textures) {
@@ -541,17 +681,22 @@ SDL_CreateTexture(SDL_Renderer * renderer, Uint32 format, int access, int w, int
     }
     renderer->textures = texture;
 
-    if (IsSupportedFormat(renderer, format)) {
+    if (IsSupportedFormat(renderer, format) && num_buffers == 1) {
         if (renderer->CreateTexture(renderer, texture) < 0) {
-            SDL_DestroyTexture(texture);
+            DestroyTextureInternal(texture);
             return NULL;
         }
     } else {
-        texture->native = SDL_CreateTexture(renderer,
-                                GetClosestSupportedFormat(renderer, format),
-                                access, w, h);
+        /* Multi-buffered textures are staged in memory, even when the
+           renderer supports their format.
+         */
+        Uint32 native_format = format;
+        if (!IsSupportedFormat(renderer, format)) {
+            native_format = GetClosestSupportedFormat(renderer, format);
+        }
+        texture->native = CreateTexture(renderer, native_format, access, w, h, 1);
         if (!texture->native) {
-            SDL_DestroyTexture(texture);
+            DestroyTextureInternal(texture);
             return NULL;
         }
 
@@ -569,19 +714,26 @@ SDL_CreateTexture(SDL_Renderer * renderer, Uint32 format, int access, int w, int
         renderer->textures = texture;
 
         if (SDL_ISPIXELFORMAT_FOURCC(texture->format)) {
-            texture->yuv = SDL_SW_CreateYUVTexture(format, w, h);
-            if (!texture->yuv) {
-                SDL_DestroyTexture(texture);
-                return NULL;
+            for (i = 0; i < num_buffers; ++i) {
+                texture->buffer_yuv[i] = SDL_SW_CreateYUVTexture(format, w, h);
+                if (!texture->buffer_yuv[i]) {
+                    DestroyTextureInternal(texture);
+                    return NULL;
+                }
             }
+            texture->yuv = texture->buffer_yuv[0];
         } else if (access == SDL_TEXTUREACCESS_STREAMING) {
             /* The pitch is 4 byte aligned */
             texture->pitch = (((w * SDL_BYTESPERPIXEL(format)) + 3) & ~3);
-            texture->pixels = SDL_calloc(1, texture->pitch * h);
-            if (!texture->pixels) {
-                SDL_DestroyTexture(texture);
-                return NULL;
+            for (i = 0; i < num_buffers; ++i) {
+                texture->buffer_pixels[i] = SDL_calloc(1, texture->pitch * h);
+                if (!texture->buffer_pixels[i]) {
+                    SDL_OutOfMemory();
+                    DestroyTextureInternal(texture);
+                    return NULL;
+                }
             }
+            texture->pixels = texture->buffer_pixels[0];
         }
     }
     return texture;
@@ -805,6 +957,9 @@ SDL_GetTextureBlendMode(SDL_Texture * texture, SDL_BlendMode *blendMode)
     return 0;
 }
 
+static int SDL_SyncStreamingBuffer(SDL_Texture * texture);
+static int SDL_ConvertPendingFrame(SDL_Texture * texture);
+
 static int
 SDL_UpdateTextureYUV(SDL_Texture * texture, const SDL_Rect * rect,
                      const void *pixels, int pitch)
@@ -812,9 +967,14 @@ SDL_UpdateTextureYUV(SDL_Texture * texture, const SDL_Rect * rect,
     SDL_Texture *native = texture->native;
     SDL_Rect full_rect;
 
+    if (SDL_ConvertPendingFrame(texture) < 0 ||
+        SDL_SyncStreamingBuffer(texture) < 0) {
+        return -1;
+    }
     if (SDL_SW_UpdateYUVTexture(texture->yuv, rect, pixels, pitch) < 0) {
         return -1;
     }
+    texture->latest = texture->buffer;
 
     full_rect.x = 0;
     full_rect.y = 0;
@@ -861,6 +1021,10 @@ SDL_UpdateTextureNative(SDL_Texture * texture, const SDL_Rect * rect,
         return 0;  /* nothing to do. */
     }
 
+    if (SDL_ConvertPendingFrame(texture) < 0) {
+        return -1;
+    }
+
     if (texture->access == SDL_TEXTUREACCESS_STREAMING) {
         /* We can lock the texture and copy to it */
         void *native_pixels = NULL;
@@ -937,9 +1101,14 @@ SDL_UpdateTextureYUVPlanar(SDL_Texture * texture, const SDL_Rect * rect,
     SDL_Texture *native = texture->native;
     SDL_Rect full_rect;
 
+    if (SDL_ConvertPendingFrame(texture) < 0 ||
+        SDL_SyncStreamingBuffer(texture) < 0) {
+        return -1;
+    }
     if (SDL_SW_UpdateYUVTexturePlanar(texture->yuv, rect, Yplane, Ypitch, Uplane, Upitch, Vplane, Vpitch) < 0) {
         return -1;
     }
+    texture->latest = texture->buffer;
 
     full_rect.x = 0;
     full_rect.y = 0;
@@ -1040,10 +1209,29 @@ int SDL_UpdateYUVTexture(SDL_Texture * texture, const SDL_Rect * rect,
     }
 }
 
+static int
+SDL_SyncStreamingBuffer(SDL_Texture * texture)
+{
+    /* The buffer handed out next may hold an older frame than the latest */
+    if (texture->buffer == texture->latest) {
+        return 0;
+    }
+    if (texture->yuv) {
+        return SDL_SW_CopyYUVTexture(texture->yuv, texture->buffer_yuv[texture->latest]);
+    }
+    SDL_memcpy(texture->pixels, texture->buffer_pixels[texture->latest], texture->pitch * texture->h);
+    return 0;
+}
+
 static int
 SDL_LockTextureYUV(SDL_Texture * texture, const SDL_Rect * rect,
                    void **pixels, int *pitch)
 {
+    if (rect->w != texture->w || rect->h != texture->h) {
+        if (SDL_SyncStreamingBuffer(texture) < 0) {
+            return -1;
+        }
+    }
     return SDL_SW_LockYUVTexture(texture->yuv, rect, pixels, pitch);
 }
 
@@ -1051,6 +1239,9 @@ static int
 SDL_LockTextureNative(SDL_Texture * texture, const SDL_Rect * rect,
                       void **pixels, int *pitch)
 {
+    if (rect->w != texture->w || rect->h != texture->h) {
+        SDL_SyncStreamingBuffer(texture);
+    }
     texture->locked_rect = *rect;
     *pixels = (void *) ((Uint8 *) texture->pixels +
                         rect->y * texture->pitch +
@@ -1091,7 +1282,30 @@ SDL_LockTexture(SDL_Texture * texture, const SDL_Rect * rect,
 }
 
 static void
-SDL_UnlockTextureYUV(SDL_Texture * texture)
+SDL_UnlockTextureStaged(SDL_Texture * texture, const SDL_Rect * rect)
+{
+    /* The frame is converted to the native texture when it's drawn */
+    if (texture->pending) {
+        SDL_UnionRect(&texture->pending_rect, rect, &texture->pending_rect);
+    } else {
+        texture->pending_rect = *rect;
+        texture->pending = SDL_TRUE;
+    }
+    texture->latest = texture->buffer;
+
+    /* Hand out the next buffer so the frame isn't written while it's drawn */
+    if (texture->num_buffers > 1) {
+        texture->buffer = (texture->buffer + 1) % texture->num_buffers;
+        if (texture->yuv) {
+            texture->yuv = texture->buffer_yuv[texture->buffer];
+        } else {
+            texture->pixels = texture->buffer_pixels[texture->buffer];
+        }
+    }
+}
+
+static int
+SDL_ConvertPendingFrameYUV(SDL_Texture * texture)
 {
     SDL_Texture *native = texture->native;
     void *native_pixels = NULL;
@@ -1104,32 +1318,49 @@ SDL_UnlockTextureYUV(SDL_Texture * texture)
     rect.h = texture->h;
 
     if (SDL_LockTexture(native, &rect, &native_pixels, &native_pitch) < 0) {
-        return;
+        return -1;
     }
-    SDL_SW_CopyYUVToRGB(texture->yuv, &rect, native->format,
+    SDL_SW_CopyYUVToRGB(texture->buffer_yuv[texture->latest], &rect, native->format,
                         rect.w, rect.h, native_pixels, native_pitch);
     SDL_UnlockTexture(native);
+    return 0;
 }
 
-static void
-SDL_UnlockTextureNative(SDL_Texture * texture)
+static int
+SDL_ConvertPendingFrameNative(SDL_Texture * texture)
 {
     SDL_Texture *native = texture->native;
     void *native_pixels = NULL;
     int native_pitch = 0;
-    const SDL_Rect *rect = &texture->locked_rect;
-    const void* pixels = (void *) ((Uint8 *) texture->pixels +
+    const SDL_Rect *rect = &texture->pending_rect;
+    const void* pixels = (void *) ((Uint8 *) texture->buffer_pixels[texture->latest] +
                         rect->y * texture->pitch +
                         rect->x * SDL_BYTESPERPIXEL(texture->format));
     int pitch = texture->pitch;
 
     if (SDL_LockTexture(native, rect, &native_pixels, &native_pitch) < 0) {
-        return;
+        return -1;
     }
     SDL_ConvertPixels(rect->w, rect->h,
                       texture->format, pixels, pitch,
                       native->format, native_pixels, native_pitch);
     SDL_UnlockTexture(native);
+    return 0;
+}
+
+static int
+SDL_ConvertPendingFrame(SDL_Texture * texture)
+{
+    if (!texture->pending) {
+        return 0;
+    }
+    texture->pending = SDL_FALSE;
+
+    if (texture->yuv) {
+        return SDL_ConvertPendingFrameYUV(texture);
+    } else {
+        return SDL_ConvertPendingFrameNative(texture);
+    }
 }
 
 void
@@ -1143,9 +1374,15 @@ SDL_UnlockTexture(SDL_Texture * texture)
         return;
     }
     if (texture->yuv) {
-        SDL_UnlockTextureYUV(texture);
+        SDL_Rect rect;
+
+        rect.x = 0;
+        rect.y = 0;
+        rect.w = texture->w;
+        rect.h = texture->h;
+        SDL_UnlockTextureStaged(texture, &rect);
     } else if (texture->native) {
-        SDL_UnlockTextureNative(texture);
+        SDL_UnlockTextureStaged(texture, &texture->locked_rect);
     } else {
         renderer = texture->renderer;
         renderer->UnlockTexture(renderer, texture);
@@ -1898,6 +2135,9 @@ SDL_RenderCopy(SDL_Renderer * renderer, SDL_Texture * texture,
     }
 
     if (texture->native) {
+        if (SDL_ConvertPendingFrame(texture) < 0) {
+            return -1;
+        }
         texture = texture->native;
     }
 
@@ -1960,6 +2200,9 @@ SDL_RenderCopyEx(SDL_Renderer * renderer, SDL_Texture * texture,
     }
 
     if (texture->native) {
+        if (SDL_ConvertPendingFrame(texture) < 0) {
+            return -1;
+        }
         texture = texture->native;
     }
 
@@ -2030,17 +2273,11 @@ SDL_RenderPresent(SDL_Renderer * renderer)
     renderer->RenderPresent(renderer);
 }
 
-void
-SDL_DestroyTexture(SDL_Texture * texture)
+static void
+DestroyTextureInternal(SDL_Texture * texture)
 {
-    SDL_Renderer *renderer;
-
-    CHECK_TEXTURE_MAGIC(texture, );
-
-    renderer = texture->renderer;
-    if (texture == renderer->target) {
-        SDL_SetRenderTarget(renderer, NULL);
-    }
+    SDL_Renderer *renderer = texture->renderer;
+    int i;
 
     texture->magic = NULL;
 
@@ -2054,17 +2291,56 @@ SDL_DestroyTexture(SDL_Texture * texture)
     }
 
     if (texture->native) {
-        SDL_DestroyTexture(texture->native);
+        DestroyTextureInternal(texture->native);
     }
-    if (texture->yuv) {
-        SDL_SW_DestroyYUVTexture(texture->yuv);
+    for (i = 0; i < SDL_MAX_STREAMING_BUFFERS; ++i) {
+        if (texture->buffer_yuv[i]) {
+            SDL_SW_DestroyYUVTexture(texture->buffer_yuv[i]);
+        }
+        SDL_free(texture->buffer_pixels[i]);
     }
-    SDL_free(texture->pixels);
 
     renderer->DestroyTexture(renderer, texture);
     SDL_free(texture);
 }
 
+void
+SDL_DestroyTexture(SDL_Texture * texture)
+{
+    SDL_Renderer *renderer;
+
+    CHECK_TEXTURE_MAGIC(texture, );
+
+    renderer = texture->renderer;
+    if (texture == renderer->target) {
+        SDL_SetRenderTarget(renderer, NULL);
+    }
+
+    if (renderer->texture_pool_budget && PutTextureInPool(renderer, texture)) {
+        return;
+    }
+    DestroyTextureInternal(texture);
+}
+
+int
+SDL_RenderSetTexturePoolBudget(SDL_Renderer * renderer, size_t budget)
+{
+    CHECK_RENDERER_MAGIC(renderer, -1);
+
+    renderer->texture_pool_budget = budget;
+    TrimTexturePool(renderer, budget);
+    return 0;
+}
+
+int
+SDL_RenderTrimTexturePool(SDL_Renderer * renderer, size_t size)
+{
+    CHECK_RENDERER_MAGIC(renderer, -1);
+
+    TrimTexturePool(renderer, size);
+    return 0;
+}
+
 void
 SDL_DestroyRenderer(SDL_Renderer * renderer)
 {
@@ -2072,6 +2348,10 @@ SDL_DestroyRenderer(SDL_Renderer * renderer)
 
     SDL_DelEventWatch(SDL_RendererEventWatch, renderer);
 
+    /* Free textures kept for reuse */
+    renderer->texture_pool_budget = 0;
+    TrimTexturePool(renderer, 0);
+
     /* Free existing textures for this renderer */
     while (renderer->textures) {
         SDL_Texture *tex = renderer->textures; (void) tex;
@@ -2097,6 +2377,9 @@ int SDL_GL_BindTexture(SDL_Texture *texture, float *texw, float *texh)
     CHECK_TEXTURE_MAGIC(texture, -1);
     renderer = texture->renderer;
     if (texture->native) {
+        if (SDL_ConvertPendingFrame(texture) < 0) {
+            return -1;
+        }
         return SDL_GL_BindTexture(texture->native, texw, texh);
     } else if (renderer && renderer->GL_BindTexture) {
         return renderer->GL_BindTexture(renderer, texture, texw, texh);
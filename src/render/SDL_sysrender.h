@@ -45,6 +45,9 @@ typedef struct
     float h;
 } SDL_FRect;
 
+/* The most staging buffers a streaming texture can rotate through */
+#define SDL_MAX_STREAMING_BUFFERS   3
+
 /* Define the SDL texture structure */
 struct SDL_Texture
 {
@@ -66,10 +69,21 @@ struct SDL_Texture
     int pitch;
     SDL_Rect locked_rect;
 
+    /* Support for multi-buffered streaming textures */
+    int num_buffers;            /**< The number of staging buffers */
+    int buffer;                 /**< The buffer handed out by the next lock */
+    int latest;                 /**< The buffer holding the most recent frame */
+    SDL_SW_YUVTexture *buffer_yuv[SDL_MAX_STREAMING_BUFFERS];
+    void *buffer_pixels[SDL_MAX_STREAMING_BUFFERS];
+    SDL_bool pending;           /**< The latest frame isn't converted to native yet */
+    SDL_Rect pending_rect;
+
     void *driverdata;           /**< Driver specific texture representation */
 
     SDL_Texture *prev;
     SDL_Texture *next;
+    SDL_Texture *pool_prev;     /**< Previous texture in the renderer's reuse pool */
+    SDL_Texture *pool_next;     /**< Next texture in the renderer's reuse pool */
 };
 
 /* Define the SDL renderer structure */
@@ -165,6 +179,12 @@ struct SDL_Renderer
     SDL_Texture *textures;
     SDL_Texture *target;
 
+    /* Destroyed textures kept for reuse, most recently destroyed first */
+    SDL_Texture *texture_pool;
+    SDL_Texture *texture_pool_tail;
+    size_t texture_pool_size;
+    size_t texture_pool_budget;
+
     Uint8 r, g, b, a;                   /**< Color for drawing operations values */
     SDL_BlendMode blendMode;            /**< The drawing blend mode */
 
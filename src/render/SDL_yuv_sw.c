@@ -84,6 +84,7 @@ SDL_SW_CreateYUVTexture(Uint32 format, int w, int h)
                 break;
         }
         swdata->pixels = (Uint8 *) SDL_malloc(dst_size);
+        swdata->size = dst_size;
         if (!swdata->pixels) {
             SDL_SW_DestroyYUVTexture(swdata);
             SDL_OutOfMemory();
@@ -330,6 +331,16 @@ SDL_SW_UnlockYUVTexture(SDL_SW_YUVTexture * swdata)
 {
 }
 
+int
+SDL_SW_CopyYUVTexture(SDL_SW_YUVTexture * dst, const SDL_SW_YUVTexture * src)
+{
+    if (dst->format != src->format || dst->size != src->size) {
+        return SDL_SetError("YUV textures don't match");
+    }
+    SDL_memcpy(dst->pixels, src->pixels, src->size);
+    return 0;
+}
+
 int
 SDL_SW_CopyYUVToRGB(SDL_SW_YUVTexture * swdata, const SDL_Rect * srcrect,
                     Uint32 target_format, int w, int h, void *pixels,
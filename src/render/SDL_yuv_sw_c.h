@@ -30,6 +30,7 @@ struct SDL_SW_YUVTexture
     Uint32 target_format;
     int w, h;
     Uint8 *pixels;
+    int size;
 
     /* These are just so we don't have to allocate them separately */
     Uint16 pitches[3];
@@ -54,6 +55,7 @@ int SDL_SW_UpdateYUVTexturePlanar(SDL_SW_YUVTexture * swdata, const SDL_Rect * r
 int SDL_SW_LockYUVTexture(SDL_SW_YUVTexture * swdata, const SDL_Rect * rect,
                           void **pixels, int *pitch);
 void SDL_SW_UnlockYUVTexture(SDL_SW_YUVTexture * swdata);
+int SDL_SW_CopyYUVTexture(SDL_SW_YUVTexture * dst, const SDL_SW_YUVTexture * src);
 int SDL_SW_CopyYUVToRGB(SDL_SW_YUVTexture * swdata, const SDL_Rect * srcrect,
                         Uint32 target_format, int w, int h, void *pixels,
                         int pitch);
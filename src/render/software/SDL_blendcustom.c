@@ -0,0 +1,774 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2017 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+#include "../../SDL_internal.h"
+
+#if !SDL_RENDER_DISABLED
+
+#include "SDL_cpuinfo.h"
+#include "../SDL_sysrender.h"
+#include "SDL_draw.h"
+#include "SDL_blendcustom.h"
+
+#ifdef __SSE2__
+#define HAVE_SSE2_INTRINSICS 1
+#endif
+
+/* Custom blending works on spans of RGBA bytes. The blend mode is decoded
+   once into a set of span functions, so the per-pixel work is a handful of
+   flat loops over bytes which are either SSE2 or simple enough for the
+   compiler to vectorize.
+ */
+
+/* Pixels handled per pass, small enough to keep the scratch spans in L1 */
+#define SPAN_PIXELS 256
+#define SPAN_BYTES  (SPAN_PIXELS * 4)
+
+typedef void (*FactorFunc) (Uint8 * factor, const Uint8 * src, const Uint8 * dst, int len);
+typedef void (*ScaleFunc) (Uint8 * out, const Uint8 * value, const Uint8 * factor, int len);
+typedef void (*OperationFunc) (Uint8 * out, const Uint8 * src, const Uint8 * dst,
+                               const Uint8 * sterm, const Uint8 * dterm, int len);
+
+typedef struct
+{
+    FactorFunc srcColorFactor;
+    FactorFunc dstColorFactor;
+    SDL_BlendFactor srcAlphaFactor;
+    SDL_BlendFactor dstAlphaFactor;
+    SDL_bool patchAlphaFactors;
+    OperationFunc colorOperation;
+    SDL_BlendOperation alphaOperation;
+    SDL_bool patchAlphaOperation;
+    ScaleFunc scale;
+} BlendSetup;
+
+/* (a * b) / 255, rounded to nearest */
+static SDL_INLINE Uint8
+Mul255(Uint32 a, Uint32 b)
+{
+    Uint32 t = a * b + 128;
+    return (Uint8) ((t + (t >> 8)) >> 8);
+}
+
+
+static void
+Factor_Zero(Uint8 * factor, const Uint8 * src, const Uint8 * dst, int len)
+{
+    SDL_memset(factor, 0, len);
+}
+
+static void
+Factor_One(Uint8 * factor, const Uint8 * src, const Uint8 * dst, int len)
+{
+    SDL_memset(factor, 0xFF, len);
+}
+
+static void
+Factor_SrcColor(Uint8 * factor, const Uint8 * src, const Uint8 * dst, int len)
+{
+    SDL_memcpy(factor, src, len);
+}
+
+static void
+Factor_OneMinusSrcColor(Uint8 * factor, const Uint8 * src, const Uint8 * dst, int len)
+{
+    int i;
+    for (i = 0; i < len; ++i) {
+        factor[i] = 0xFF - src[i];
+    }
+}
+
+static void
+Factor_SrcAlpha(Uint8 * factor, const Uint8 * src, const Uint8 * dst, int len)
+{
+    int i;
+    for (i = 0; i < len; i += 4) {
+        factor[i + 0] = factor[i + 1] = factor[i + 2] = factor[i + 3] = src[i + 3];
+    }
+}
+
+static void
+Factor_OneMinusSrcAlpha(Uint8 * factor, const Uint8 * src, const Uint8 * dst, int len)
+{
+    int i;
+    for (i = 0; i < len; i += 4) {
+        factor[i + 0] = factor[i + 1] = factor[i + 2] = factor[i + 3] = 0xFF - src[i + 3];
+    }
+}
+
+static void
+Factor_DstColor(Uint8 * factor, const Uint8 * src, const Uint8 * dst, int len)
+{
+    SDL_memcpy(factor, dst, len);
+}
+
+static void
+Factor_OneMinusDstColor(Uint8 * factor, const Uint8 * src, const Uint8 * dst, int len)
+{
+    Factor_OneMinusSrcColor(factor, dst, src, len);
+}
+
+static void
+Factor_DstAlpha(Uint8 * factor, const Uint8 * src, const Uint8 * dst, int len)
+{
+    Factor_SrcAlpha(factor, dst, src, len);
+}
+
+static void
+Factor_OneMinusDstAlpha(Uint8 * factor, const Uint8 * src, const Uint8 * dst, int len)
+{
+    Factor_OneMinusSrcAlpha(factor, dst, src, len);
+}
+
+/* Indexed by SDL_BlendFactor */
+static const FactorFunc factor_funcs[] = {
+    NULL,
+    Factor_Zero,
+    Factor_One,
+    Factor_SrcColor,
+    Factor_OneMinusSrcColor,
+    Factor_SrcAlpha,
+    Factor_OneMinusSrcAlpha,
+    Factor_DstColor,
+    Factor_OneMinusDstColor,
+    Factor_DstAlpha,
+    Factor_OneMinusDstAlpha
+};
+
+/* Overwrites the alpha lanes when the alpha factor differs from the color factor */
+static void
+PatchAlphaFactor(Uint8 * factor, const Uint8 * src, const Uint8 * dst, int len, SDL_BlendFactor blendFactor)
+{
+    int i;
+
+    switch (blendFactor) {
+    case SDL_BLENDFACTOR_ZERO:
+        for (i = 3; i < len; i += 4) {
+            factor[i] = 0;
+        }
+        break;
+    case SDL_BLENDFACTOR_ONE:
+        for (i = 3; i < len; i += 4) {
+            factor[i] = 0xFF;
+        }
+        break;
+    case SDL_BLENDFACTOR_SRC_COLOR:
+    case SDL_BLENDFACTOR_SRC_ALPHA:
+        for (i = 3; i < len; i += 4) {
+            factor[i] = src[i];
+        }
+        break;
+    case SDL_BLENDFACTOR_ONE_MINUS_SRC_COLOR:
+    case SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA:
+        for (i = 3; i < len; i += 4) {
+            factor[i] = 0xFF - src[i];
+        }
+        break;
+    case SDL_BLENDFACTOR_DST_COLOR:
+    case SDL_BLENDFACTOR_DST_ALPHA:
+        for (i = 3; i < len; i += 4) {
+            factor[i] = dst[i];
+        }
+        break;
+    case SDL_BLENDFACTOR_ONE_MINUS_DST_COLOR:
+    case SDL_BLENDFACTOR_ONE_MINUS_DST_ALPHA:
+        for (i = 3; i < len; i += 4) {
+            factor[i] = 0xFF - dst[i];
+        }
+        break;
+    }
+}
+
+
+static void
+Scale_Scalar(Uint8 * out, const Uint8 * value, const Uint8 * factor, int len)
+{
+    int i;
+    for (i = 0; i < len; ++i) {
+        out[i] = Mul255(value[i], factor[i]);
+    }
+}
+
+static void
+Operation_Add_Scalar(Uint8 * out, const Uint8 * src, const Uint8 * dst,
+                     const Uint8 * sterm, const Uint8 * dterm, int len)
+{
+    int i;
+    for (i = 0; i < len; ++i) {
+        const Uint32 sum = (Uint32) sterm[i] + dterm[i];
+        out[i] = (Uint8) (sum > 0xFF ? 0xFF : sum);
+    }
+}
+
+static void
+Operation_Subtract_Scalar(Uint8 * out, const Uint8 * src, const Uint8 * dst,
+                          const Uint8 * sterm, const Uint8 * dterm, int len)
+{
+    int i;
+    for (i = 0; i < len; ++i) {
+        out[i] = (dterm[i] > sterm[i]) ? (dterm[i] - sterm[i]) : 0;
+    }
+}
+
+static void
+Operation_RevSubtract_Scalar(Uint8 * out, const Uint8 * src, const Uint8 * dst,
+                             const Uint8 * sterm, const Uint8 * dterm, int len)
+{
+    Operation_Subtract_Scalar(out, dst, src, dterm, sterm, len);
+}
+
+/* Like OpenGL and Direct3D, minimum and maximum ignore the blend factors */
+static void
+Operation_Minimum_Scalar(Uint8 * out, const Uint8 * src, const Uint8 * dst,
+                         const Uint8 * sterm, const Uint8 * dterm, int len)
+{
+    int i;
+    for (i = 0; i < len; ++i) {
+        out[i] = SDL_min(src[i], dst[i]);
+    }
+}
+
+static void
+Operation_Maximum_Scalar(Uint8 * out, const Uint8 * src, const Uint8 * dst,
+                         const Uint8 * sterm, const Uint8 * dterm, int len)
+{
+    int i;
+    for (i = 0; i < len; ++i) {
+        out[i] = SDL_max(src[i], dst[i]);
+    }
+}
+
+/* Indexed by SDL_BlendOperation */
+static const OperationFunc operation_funcs_scalar[] = {
+    NULL,
+    Operation_Add_Scalar,
+    Operation_Subtract_Scalar,
+    Operation_RevSubtract_Scalar,
+    Operation_Minimum_Scalar,
+    Operation_Maximum_Scalar
+};
+
+#if HAVE_SSE2_INTRINSICS
+static void
+Scale_SSE2(Uint8 * out, const Uint8 * value, const Uint8 * factor, int len)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i round = _mm_set1_epi16(128);
+    int i;
+
+    for (i = 0; i + 16 <= len; i += 16) {
+        const __m128i v = _mm_loadu_si128((const __m128i *) (value + i));
+        const __m128i f = _mm_loadu_si128((const __m128i *) (factor + i));
+        __m128i lo = _mm_mullo_epi16(_mm_unpacklo_epi8(v, zero), _mm_unpacklo_epi8(f, zero));
+        __m128i hi = _mm_mullo_epi16(_mm_unpackhi_epi8(v, zero), _mm_unpackhi_epi8(f, zero));
+        lo = _mm_add_epi16(lo, round);
+        hi = _mm_add_epi16(hi, round);
+        lo = _mm_srli_epi16(_mm_add_epi16(lo, _mm_srli_epi16(lo, 8)), 8);
+        hi = _mm_srli_epi16(_mm_add_epi16(hi, _mm_srli_epi16(hi, 8)), 8);
+        _mm_storeu_si128((__m128i *) (out + i), _mm_packus_epi16(lo, hi));
+    }
+    Scale_Scalar(out + i, value + i, factor + i, len - i);
+}
+
+#define OPERATION_SSE2(name, a, b, op) \
+static void \
+Operation_##name##_SSE2(Uint8 * out, const Uint8 * src, const Uint8 * dst, \
+                        const Uint8 * sterm, const Uint8 * dterm, int len) \
+{ \
+    int i; \
+    for (i = 0; i + 16 <= len; i += 16) { \
+        const __m128i x = _mm_loadu_si128((const __m128i *) (a + i)); \
+        const __m128i y = _mm_loadu_si128((const __m128i *) (b + i)); \
+        _mm_storeu_si128((__m128i *) (out + i), op(x, y)); \
+    } \
+    Operation_##name##_Scalar(out + i, src + i, dst + i, sterm + i, dterm + i, len - i); \
+}
+
+OPERATION_SSE2(Add, sterm, dterm, _mm_adds_epu8)
+OPERATION_SSE2(Subtract, dterm, sterm, _mm_subs_epu8)
+OPERATION_SSE2(RevSubtract, sterm, dterm, _mm_subs_epu8)
+OPERATION_SSE2(Minimum, src, dst, _mm_min_epu8)
+OPERATION_SSE2(Maximum, src, dst, _mm_max_epu8)
+
+#undef OPERATION_SSE2
+
+static const OperationFunc operation_funcs_SSE2[] = {
+    NULL,
+    Operation_Add_SSE2,
+    Operation_Subtract_SSE2,
+    Operation_RevSubtract_SSE2,
+    Operation_Minimum_SSE2,
+    Operation_Maximum_SSE2
+};
+#endif /* HAVE_SSE2_INTRINSICS */
+
+
+SDL_bool
+SDL_IsCustomBlendModeValid(SDL_BlendMode blendMode)
+{
+    const SDL_BlendFactor factors[4] = {
+        SDL_GetBlendModeSrcColorFactor(blendMode),
+        SDL_GetBlendModeDstColorFactor(blendMode),
+        SDL_GetBlendModeSrcAlphaFactor(blendMode),
+        SDL_GetBlendModeDstAlphaFactor(blendMode)
+    };
+    const SDL_BlendOperation colorOperation = SDL_GetBlendModeColorOperation(blendMode);
+    const SDL_BlendOperation alphaOperation = SDL_GetBlendModeAlphaOperation(blendMode);
+    int i;
+
+    for (i = 0; i < SDL_arraysize(factors); ++i) {
+        if (factors[i] < SDL_BLENDFACTOR_ZERO || factors[i] > SDL_BLENDFACTOR_ONE_MINUS_DST_ALPHA) {
+            return SDL_FALSE;
+        }
+    }
+    if (colorOperation < SDL_BLENDOPERATION_ADD || colorOperation > SDL_BLENDOPERATION_MAXIMUM ||
+        alphaOperation < SDL_BLENDOPERATION_ADD || alphaOperation > SDL_BLENDOPERATION_MAXIMUM) {
+        return SDL_FALSE;
+    }
+    return SDL_TRUE;
+}
+
+static int
+SetupBlend(BlendSetup * setup, SDL_Surface * dst, SDL_BlendMode blendMode)
+{
+    const SDL_BlendFactor srcColorFactor = SDL_GetBlendModeSrcColorFactor(blendMode);
+    const SDL_BlendFactor dstColorFactor = SDL_GetBlendModeDstColorFactor(blendMode);
+    const SDL_BlendOperation colorOperation = SDL_GetBlendModeColorOperation(blendMode);
+    const OperationFunc *operation_funcs = operation_funcs_scalar;
+
+    if (!dst) {
+        return SDL_SetError("Passed NULL destination surface");
+    }
+    if ((dst->format->BytesPerPixel != 2 && dst->format->BytesPerPixel != 4) ||
+        SDL_ISPIXELFORMAT_INDEXED(dst->format->format) || dst->format->Rloss > 8) {
+        return SDL_SetError("Unsupported surface format for custom blending");
+    }
+    if (!SDL_IsCustomBlendModeValid(blendMode)) {
+        return SDL_SetError("Invalid blend mode");
+    }
+
+    setup->scale = Scale_Scalar;
+#if HAVE_SSE2_INTRINSICS
+    if (SDL_HasSSE2()) {
+        setup->scale = Scale_SSE2;
+        operation_funcs = operation_funcs_SSE2;
+    }
+#endif
+
+    setup->srcColorFactor = factor_funcs[srcColorFactor];
+    setup->dstColorFactor = factor_funcs[dstColorFactor];
+    setup->srcAlphaFactor = SDL_GetBlendModeSrcAlphaFactor(blendMode);
+    setup->dstAlphaFactor = SDL_GetBlendModeDstAlphaFactor(blendMode);
+    setup->patchAlphaFactors = (setup->srcAlphaFactor != srcColorFactor || setup->dstAlphaFactor != dstColorFactor);
+    setup->colorOperation = operation_funcs[colorOperation];
+    setup->alphaOperation = SDL_GetBlendModeAlphaOperation(blendMode);
+    setup->patchAlphaOperation = (setup->alphaOperation != colorOperation);
+    return 0;
+}
+
+/* Blends len bytes of RGBA source into the RGBA destination span in place */
+static void
+BlendSpan(const BlendSetup * setup, const Uint8 * src, Uint8 * dst, int len)
+{
+    Uint8 sterm[SPAN_BYTES];
+    Uint8 dterm[SPAN_BYTES];
+    Uint8 alpha[SPAN_PIXELS];
+    int i;
+
+    setup->srcColorFactor(sterm, src, dst, len);
+    setup->dstColorFactor(dterm, src, dst, len);
+    if (setup->patchAlphaFactors) {
+        PatchAlphaFactor(sterm, src, dst, len, setup->srcAlphaFactor);
+        PatchAlphaFactor(dterm, src, dst, len, setup->dstAlphaFactor);
+    }
+    setup->scale(sterm, src, sterm, len);
+    setup->scale(dterm, dst, dterm, len);
+
+    if (setup->patchAlphaOperation) {
+        for (i = 3; i < len; i += 4) {
+            Uint8 result;
+            operation_funcs_scalar[setup->alphaOperation](&result, &src[i], &dst[i], &sterm[i], &dterm[i], 1);
+            alpha[i / 4] = result;
+        }
+        setup->colorOperation(dst, src, dst, sterm, dterm, len);
+        for (i = 3; i < len; i += 4) {
+            dst[i] = alpha[i / 4];
+        }
+    } else {
+        setup->colorOperation(dst, src, dst, sterm, dterm, len);
+    }
+}
+
+
+static void
+ReadPixels(const SDL_PixelFormat * fmt, const Uint8 * pixels, Uint32 * values, int n)
+{
+    int i;
+
+    if (fmt->BytesPerPixel == 2) {
+        const Uint16 *p = (const Uint16 *) pixels;
+        for (i = 0; i < n; ++i) {
+            values[i] = p[i];
+        }
+    } else {
+        SDL_memcpy(values, pixels, n * sizeof(Uint32));
+    }
+}
+
+static void
+UnpackPixels(const SDL_PixelFormat * fmt, const Uint32 * values, Uint8 * rgba, int n)
+{
+    int i;
+
+    for (i = 0; i < n; ++i, rgba += 4) {
+        const Uint32 v = values[i];
+        rgba[0] = SDL_expand_byte[fmt->Rloss][(v & fmt->Rmask) >> fmt->Rshift];
+        rgba[1] = SDL_expand_byte[fmt->Gloss][(v & fmt->Gmask) >> fmt->Gshift];
+        rgba[2] = SDL_expand_byte[fmt->Bloss][(v & fmt->Bmask) >> fmt->Bshift];
+        rgba[3] = SDL_expand_byte[fmt->Aloss][(v & fmt->Amask) >> fmt->Ashift];
+    }
+}
+
+static void
+PackPixels(const SDL_PixelFormat * fmt, const Uint8 * rgba, Uint8 * pixels, int n)
+{
+    int i;
+
+    if (fmt->BytesPerPixel == 2) {
+        Uint16 *p = (Uint16 *) pixels;
+        for (i = 0; i < n; ++i, rgba += 4) {
+            p[i] = (Uint16) (((rgba[0] >> fmt->Rloss) << fmt->Rshift) |
+                             ((rgba[1] >> fmt->Gloss) << fmt->Gshift) |
+                             ((rgba[2] >> fmt->Bloss) << fmt->Bshift) |
+                             (((Uint32) (rgba[3] >> fmt->Aloss) << fmt->Ashift) & fmt->Amask));
+        }
+    } else {
+        Uint32 *p = (Uint32 *) pixels;
+        for (i = 0; i < n; ++i, rgba += 4) {
+            p[i] = ((Uint32) (rgba[0] >> fmt->Rloss) << fmt->Rshift) |
+                   ((Uint32) (rgba[1] >> fmt->Gloss) << fmt->Gshift) |
+                   ((Uint32) (rgba[2] >> fmt->Bloss) << fmt->Bshift) |
+                   (((Uint32) (rgba[3] >> fmt->Aloss) << fmt->Ashift) & fmt->Amask);
+        }
+    }
+}
+
+/* Blends a solid color over a clipped horizontal run of pixels */
+static void
+BlendColorRow(const BlendSetup * setup, SDL_Surface * dst, const Uint8 * color,
+              int x, int y, int w)
+{
+    Uint8 *pixels = (Uint8 *) dst->pixels + y * dst->pitch + x * dst->format->BytesPerPixel;
+    Uint32 values[SPAN_PIXELS];
+    Uint8 span[SPAN_BYTES];
+
+    while (w > 0) {
+        const int n = SDL_min(w, SPAN_PIXELS);
+
+        ReadPixels(dst->format, pixels, values, n);
+        UnpackPixels(dst->format, values, span, n);
+        BlendSpan(setup, color, span, n * 4);
+        PackPixels(dst->format, span, pixels, n);
+
+        pixels += n * dst->format->BytesPerPixel;
+        w -= n;
+    }
+}
+
+static void
+FillColorSpan(Uint8 * color, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
+{
+    int i;
+    for (i = 0; i < SPAN_BYTES; i += 4) {
+        color[i + 0] = r;
+        color[i + 1] = g;
+        color[i + 2] = b;
+        color[i + 3] = a;
+    }
+}
+
+static void
+BlendColorPoint(const BlendSetup * setup, SDL_Surface * dst, const Uint8 * color, int x, int y)
+{
+    const SDL_Rect *clip = &dst->clip_rect;
+
+    if (x >= clip->x && x < clip->x + clip->w && y >= clip->y && y < clip->y + clip->h) {
+        BlendColorRow(setup, dst, color, x, y, 1);
+    }
+}
+
+int
+SDL_CustomBlendPoints(SDL_Surface * dst, const SDL_Point * points, int count,
+                      SDL_BlendMode blendMode, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
+{
+    BlendSetup setup;
+    Uint8 color[SPAN_BYTES];
+    int i;
+
+    if (SetupBlend(&setup, dst, blendMode) < 0) {
+        return -1;
+    }
+    FillColorSpan(color, r, g, b, a);
+
+    for (i = 0; i < count; ++i) {
+        BlendColorPoint(&setup, dst, color, points[i].x, points[i].y);
+    }
+    return 0;
+}
+
+static void
+BlendColorLine(const BlendSetup * setup, SDL_Surface * dst, const Uint8 * color,
+               int x1, int y1, int x2, int y2, SDL_bool draw_end)
+{
+    int dx = SDL_abs(x2 - x1);
+    int dy = SDL_abs(y2 - y1);
+    int sx = (x1 < x2) ? 1 : -1;
+    int sy = (y1 < y2) ? 1 : -1;
+    int err = dx - dy;
+
+    if (y1 == y2) {
+        /* Horizontal lines are a single run */
+        int x = SDL_min(x1, x2);
+        int w = dx + (draw_end ? 1 : 0);
+        if (x1 > x2 && !draw_end) {
+            ++x;
+        }
+        if (w > 0) {
+            BlendColorRow(setup, dst, color, x, y1, w);
+        }
+        return;
+    }
+
+    for (;;) {
+        int e2;
+
+        if (x1 == x2 && y1 == y2) {
+            if (draw_end) {
+                BlendColorPoint(setup, dst, color, x1, y1);
+            }
+            break;
+        }
+        BlendColorPoint(setup, dst, color, x1, y1);
+
+        e2 = 2 * err;
+        if (e2 > -dy) {
+            err -= dy;
+            x1 += sx;
+        }
+        if (e2 < dx) {
+            err += dx;
+            y1 += sy;
+        }
+    }
+}
+
+int
+SDL_CustomBlendLines(SDL_Surface * dst, const SDL_Point * points, int count,
+                     SDL_BlendMode blendMode, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
+{
+    BlendSetup setup;
+    Uint8 color[SPAN_BYTES];
+    int i;
+    int x1, y1;
+    int x2, y2;
+    SDL_bool draw_end;
+
+    if (SetupBlend(&setup, dst, blendMode) < 0) {
+        return -1;
+    }
+    FillColorSpan(color, r, g, b, a);
+
+    for (i = 1; i < count; ++i) {
+        x1 = points[i-1].x;
+        y1 = points[i-1].y;
+        x2 = points[i].x;
+        y2 = points[i].y;
+
+        /* Perform clipping */
+        if (!SDL_IntersectRectAndLine(&dst->clip_rect, &x1, &y1, &x2, &y2)) {
+            continue;
+        }
+
+        /* Draw the end if it was clipped */
+        draw_end = (x2 != points[i].x || y2 != points[i].y);
+
+        BlendColorLine(&setup, dst, color, x1, y1, x2, y2, draw_end);
+    }
+    if (count > 0 && (points[0].x != points[count-1].x || points[0].y != points[count-1].y)) {
+        BlendColorPoint(&setup, dst, color, points[count-1].x, points[count-1].y);
+    }
+    return 0;
+}
+
+int
+SDL_CustomBlendFillRects(SDL_Surface * dst, const SDL_Rect * rects, int count,
+                         SDL_BlendMode blendMode, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
+{
+    BlendSetup setup;
+    Uint8 color[SPAN_BYTES];
+    SDL_Rect rect;
+    int i, y;
+
+    if (SetupBlend(&setup, dst, blendMode) < 0) {
+        return -1;
+    }
+    FillColorSpan(color, r, g, b, a);
+
+    for (i = 0; i < count; ++i) {
+        if (!SDL_IntersectRect(&rects[i], &dst->clip_rect, &rect)) {
+            continue;
+        }
+        for (y = rect.y; y < rect.y + rect.h; ++y) {
+            BlendColorRow(&setup, dst, color, rect.x, y, rect.w);
+        }
+    }
+    return 0;
+}
+
+int
+SDL_CustomBlendSurface(SDL_Surface * src, const SDL_Rect * srcrect,
+                       SDL_Surface * dst, const SDL_Rect * dstrect,
+                       SDL_BlendMode blendMode)
+{
+    BlendSetup setup;
+    SDL_Rect sr, dr, clipped;
+    Uint8 rMod, gMod, bMod, aMod;
+    Uint8 modulation[SPAN_BYTES];
+    SDL_bool modulate;
+    Uint32 colorkey = 0;
+    Uint32 rgbmask;
+    SDL_bool keyed;
+    Sint64 incx, incy;
+    int x, y, i;
+
+    if (SetupBlend(&setup, dst, blendMode) < 0) {
+        return -1;
+    }
+    if (!src) {
+        return SDL_SetError("Passed NULL source surface");
+    }
+    if ((src->format->BytesPerPixel != 2 && src->format->BytesPerPixel != 4) ||
+        SDL_ISPIXELFORMAT_INDEXED(src->format->format) || src->format->Rloss > 8) {
+        return SDL_SetError("Unsupported surface format for custom blending");
+    }
+
+    if (srcrect) {
+        sr = *srcrect;
+    } else {
+        sr.x = sr.y = 0;
+        sr.w = src->w;
+        sr.h = src->h;
+    }
+    if (dstrect) {
+        dr = *dstrect;
+    } else {
+        dr.x = dr.y = 0;
+        dr.w = dst->w;
+        dr.h = dst->h;
+    }
+    if (sr.w <= 0 || sr.h <= 0 || !SDL_IntersectRect(&dr, &dst->clip_rect, &clipped)) {
+        return 0;
+    }
+
+    SDL_GetSurfaceColorMod(src, &rMod, &gMod, &bMod);
+    SDL_GetSurfaceAlphaMod(src, &aMod);
+    modulate = ((rMod & gMod & bMod & aMod) != 0xFF);
+    if (modulate) {
+        FillColorSpan(modulation, rMod, gMod, bMod, aMod);
+    }
+    keyed = (SDL_GetColorKey(src, &colorkey) == 0);
+    /* like the other colorkey blitters, the key ignores alpha */
+    rgbmask = ~src->format->Amask;
+    colorkey &= rgbmask;
+
+    if (SDL_MUSTLOCK(src)) {
+        SDL_LockSurface(src);
+    }
+    if (SDL_MUSTLOCK(dst)) {
+        SDL_LockSurface(dst);
+    }
+
+    /* Nearest sampling with 16.16 steps, the same mapping SDL_BlitScaled uses */
+    incx = ((Sint64) sr.w << 16) / dr.w;
+    incy = ((Sint64) sr.h << 16) / dr.h;
+
+    for (y = clipped.y; y < clipped.y + clipped.h; ++y) {
+        const int sy = sr.y + SDL_min((int) (((y - dr.y) * incy) >> 16), sr.h - 1);
+        const Uint8 *srcrow = (const Uint8 *) src->pixels + sy * src->pitch;
+        Uint8 *dstpixels = (Uint8 *) dst->pixels + y * dst->pitch + clipped.x * dst->format->BytesPerPixel;
+
+        for (x = clipped.x; x < clipped.x + clipped.w; ) {
+            const int n = SDL_min(clipped.x + clipped.w - x, SPAN_PIXELS);
+            Uint32 values[SPAN_PIXELS];
+            Uint8 srcspan[SPAN_BYTES];
+            Uint8 dstspan[SPAN_BYTES];
+            Uint8 original[SPAN_BYTES];
+            SDL_bool skipped = SDL_FALSE;
+            Uint8 skip[SPAN_PIXELS];
+
+            for (i = 0; i < n; ++i) {
+                const int sx = sr.x + SDL_min((int) (((x + i - dr.x) * incx) >> 16), sr.w - 1);
+                if (src->format->BytesPerPixel == 2) {
+                    values[i] = ((const Uint16 *) srcrow)[sx];
+                } else {
+                    values[i] = ((const Uint32 *) srcrow)[sx];
+                }
+                skip[i] = (keyed && (values[i] & rgbmask) == colorkey);
+                skipped |= skip[i];
+            }
+            UnpackPixels(src->format, values, srcspan, n);
+            if (modulate) {
+                setup.scale(srcspan, srcspan, modulation, n * 4);
+            }
+
+            ReadPixels(dst->format, dstpixels, values, n);
+            UnpackPixels(dst->format, values, dstspan, n);
+            if (skipped) {
+                SDL_memcpy(original, dstspan, n * 4);
+            }
+
+            BlendSpan(&setup, srcspan, dstspan, n * 4);
+
+            if (skipped) {
+                for (i = 0; i < n; ++i) {
+                    if (skip[i]) {
+                        SDL_memcpy(&dstspan[i * 4], &original[i * 4], 4);
+                    }
+                }
+            }
+            PackPixels(dst->format, dstspan, dstpixels, n);
+
+            dstpixels += n * dst->format->BytesPerPixel;
+            x += n;
+        }
+    }
+
+    if (SDL_MUSTLOCK(dst)) {
+        SDL_UnlockSurface(dst);
+    }
+    if (SDL_MUSTLOCK(src)) {
+        SDL_UnlockSurface(src);
+    }
+    return 0;
+}
+
+#endif /* !SDL_RENDER_DISABLED */
+
+/* vi: set ts=4 sw=4 expandtab: */
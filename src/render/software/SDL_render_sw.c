@@ -27,6 +27,7 @@
 #include "SDL_hints.h"
 
 #include "SDL_draw.h"
+#include "SDL_blendcustom.h"
 #include "SDL_blendfillrect.h"
 #include "SDL_blendline.h"
 #include "SDL_blendpoint.h"
@@ -40,6 +41,7 @@ static SDL_Renderer *SW_CreateRenderer(SDL_Window * window, Uint32 flags);
 static void SW_WindowEvent(SDL_Renderer * renderer,
                            const SDL_WindowEvent *event);
 static int SW_GetOutputSize(SDL_Renderer * renderer, int *w, int *h);
+static SDL_bool SW_SupportsBlendMode(SDL_Renderer * renderer, SDL_BlendMode blendMode);
 static int SW_CreateTexture(SDL_Renderer * renderer, SDL_Texture * texture);
 static int SW_SetTextureColorMod(SDL_Renderer * renderer,
                                  SDL_Texture * texture);
@@ -95,13 +97,120 @@ SDL_RenderDriver SW_RenderDriver = {
      0}
 };
 
+/* The maximum number of disjoint rectangles tracked between presents */
+#define SW_MAX_DAMAGE_RECTS 8
+
 typedef struct
 {
     SDL_Surface *surface;
     SDL_Surface *window;
+    SDL_Rect damage[SW_MAX_DAMAGE_RECTS];
+    int num_damage;
+    SDL_bool damage_full;
+    SDL_bool damage_tracking;   /* SDL_HINT_RENDER_SOFTWARE_DAMAGE_TRACKING */
 } SW_RenderData;
 
 
+static void SDLCALL
+SW_DamageTrackingChanged(void *userdata, const char *name, const char *oldValue, const char *hint)
+{
+    SW_RenderData *data = (SW_RenderData *) userdata;
+
+    if (hint && (*hint == '0' || SDL_strcasecmp(hint, "false") == 0)) {
+        data->damage_tracking = SDL_FALSE;
+    } else if (!data->damage_tracking) {
+        /* Nothing was tracked while it was off */
+        data->damage_tracking = SDL_TRUE;
+        data->damage_full = SDL_TRUE;
+    }
+}
+
+
+static void
+SW_DamageAll(SDL_Renderer * renderer)
+{
+    SW_RenderData *data = (SW_RenderData *) renderer->driverdata;
+
+    if (data->surface == data->window) {
+        data->damage_full = SDL_TRUE;
+    }
+}
+
+static void
+SW_AddDamage(SDL_Renderer * renderer, const SDL_Rect * rect)
+{
+    SW_RenderData *data = (SW_RenderData *) renderer->driverdata;
+    SDL_Surface *surface = data->surface;
+    SDL_Rect area, merged;
+    int i, best, best_area;
+
+    /* Drawing into a render target doesn't touch the window */
+    if (!data->damage_tracking || data->damage_full || !surface || surface != data->window) {
+        return;
+    }
+    if (!SDL_IntersectRect(rect, &surface->clip_rect, &area)) {
+        return;
+    }
+
+    for (;;) {
+        /* Fold in every tracked rect that overlaps, starting over whenever
+           the union grows since it may now overlap rects already checked.
+         */
+        i = 0;
+        while (i < data->num_damage) {
+            if (SDL_HasIntersection(&data->damage[i], &area)) {
+                SDL_UnionRect(&data->damage[i], &area, &area);
+                data->damage[i] = data->damage[--data->num_damage];
+                i = 0;
+            } else {
+                ++i;
+            }
+        }
+        if (data->num_damage < SW_MAX_DAMAGE_RECTS) {
+            break;
+        }
+
+        /* Out of slots, merge with the rect whose union grows the least */
+        best = 0;
+        best_area = 0;
+        for (i = 0; i < data->num_damage; ++i) {
+            int grown;
+            SDL_UnionRect(&data->damage[i], &area, &merged);
+            grown = merged.w * merged.h - data->damage[i].w * data->damage[i].h;
+            if (i == 0 || grown < best_area) {
+                best = i;
+                best_area = grown;
+            }
+        }
+        SDL_UnionRect(&data->damage[best], &area, &area);
+        data->damage[best] = data->damage[--data->num_damage];
+    }
+    data->damage[data->num_damage++] = area;
+}
+
+static void
+SW_AddPointsDamage(SDL_Renderer * renderer, const SDL_Point * points, int count)
+{
+    SDL_Rect bounds;
+    int i, maxx, maxy;
+
+    if (count <= 0) {
+        return;
+    }
+    bounds.x = maxx = points[0].x;
+    bounds.y = maxy = points[0].y;
+    for (i = 1; i < count; ++i) {
+        bounds.x = SDL_min(bounds.x, points[i].x);
+        bounds.y = SDL_min(bounds.y, points[i].y);
+        maxx = SDL_max(maxx, points[i].x);
+        maxy = SDL_max(maxy, points[i].y);
+    }
+    bounds.w = maxx - bounds.x + 1;
+    bounds.h = maxy - bounds.y + 1;
+    SW_AddDamage(renderer, &bounds);
+}
+
+
 static SDL_Surface *
 SW_ActivateRenderer(SDL_Renderer * renderer)
 {
@@ -114,6 +223,7 @@ SW_ActivateRenderer(SDL_Renderer * renderer)
         SDL_Surface *surface = SDL_GetWindowSurface(renderer->window);
         if (surface) {
             data->surface = data->window = surface;
+            data->damage_full = SDL_TRUE;
 
             SW_UpdateViewport(renderer);
             SW_UpdateClipRect(renderer);
@@ -147,9 +257,12 @@ SW_CreateRendererForSurface(SDL_Surface * surface)
     }
     data->surface = surface;
     data->window = surface;
+    data->damage_full = SDL_TRUE;
+    SDL_AddHintCallback(SDL_HINT_RENDER_SOFTWARE_DAMAGE_TRACKING, SW_DamageTrackingChanged, data);
 
     renderer->WindowEvent = SW_WindowEvent;
     renderer->GetOutputSize = SW_GetOutputSize;
+    renderer->SupportsBlendMode = SW_SupportsBlendMode;
     renderer->CreateTexture = SW_CreateTexture;
     renderer->SetTextureColorMod = SW_SetTextureColorMod;
     renderer->SetTextureAlphaMod = SW_SetTextureAlphaMod;
@@ -220,6 +333,27 @@ SW_GetOutputSize(SDL_Renderer * renderer, int *w, int *h)
     }
 }
 
+/* Anything other than the standard blend modes goes through the custom blender */
+static SDL_bool
+SW_IsCustomBlendMode(SDL_BlendMode blendMode)
+{
+    switch (blendMode) {
+    case SDL_BLENDMODE_NONE:
+    case SDL_BLENDMODE_BLEND:
+    case SDL_BLENDMODE_ADD:
+    case SDL_BLENDMODE_MOD:
+        return SDL_FALSE;
+    default:
+        return SDL_TRUE;
+    }
+}
+
+static SDL_bool
+SW_SupportsBlendMode(SDL_Renderer * renderer, SDL_BlendMode blendMode)
+{
+    return SDL_IsCustomBlendModeValid(blendMode);
+}
+
 static int
 SW_CreateTexture(SDL_Renderer * renderer, SDL_Texture * texture)
 {
@@ -283,12 +417,17 @@ static int
 SW_SetTextureBlendMode(SDL_Renderer * renderer, SDL_Texture * texture)
 {
     SDL_Surface *surface = (SDL_Surface *) texture->driverdata;
-    /* If add or mod blending are ever enabled, permanently disable RLE (which doesn't support
+    /* If add, mod or custom blending are ever enabled, permanently disable RLE (which doesn't support
      * them) to avoid potentially frequent RLE encoding/decoding.
      */
-    if ((texture->blendMode == SDL_BLENDMODE_ADD || texture->blendMode == SDL_BLENDMODE_MOD)) {
+    if ((texture->blendMode == SDL_BLENDMODE_ADD || texture->blendMode == SDL_BLENDMODE_MOD ||
+         SW_IsCustomBlendMode(texture->blendMode))) {
         SDL_SetSurfaceRLE(surface, 0);
     }
+    if (SW_IsCustomBlendMode(texture->blendMode)) {
+        /* Custom modes are applied at copy time, the surface itself is left unblended */
+        return SDL_SetSurfaceBlendMode(surface, SDL_BLENDMODE_NONE);
+    }
     return SDL_SetSurfaceBlendMode(surface, texture->blendMode);
 }
 
@@ -403,6 +542,8 @@ SW_RenderClear(SDL_Renderer * renderer)
     SDL_SetClipRect(surface, NULL);
     SDL_FillRect(surface, NULL, color);
     SDL_SetClipRect(surface, &clip_rect);
+
+    SW_DamageAll(renderer);
     return 0;
 }
 
@@ -444,12 +585,18 @@ SW_RenderDrawPoints(SDL_Renderer * renderer, const SDL_FPoint * points,
                                    renderer->a);
 
         status = SDL_DrawPoints(surface, final_points, count, color);
+    } else if (SW_IsCustomBlendMode(renderer->blendMode)) {
+        status = SDL_CustomBlendPoints(surface, final_points, count,
+                                      renderer->blendMode,
+                                      renderer->r, renderer->g, renderer->b,
+                                      renderer->a);
     } else {
         status = SDL_BlendPoints(surface, final_points, count,
                                 renderer->blendMode,
                                 renderer->r, renderer->g, renderer->b,
                                 renderer->a);
     }
+    SW_AddPointsDamage(renderer, final_points, count);
     SDL_stack_free(final_points);
 
     return status;
@@ -493,12 +640,18 @@ SW_RenderDrawLines(SDL_Renderer * renderer, const SDL_FPoint * points,
                                    renderer->a);
 
         status = SDL_DrawLines(surface, final_points, count, color);
+    } else if (SW_IsCustomBlendMode(renderer->blendMode)) {
+        status = SDL_CustomBlendLines(surface, final_points, count,
+                                      renderer->blendMode,
+                                      renderer->r, renderer->g, renderer->b,
+                                      renderer->a);
     } else {
         status = SDL_BlendLines(surface, final_points, count,
                                 renderer->blendMode,
                                 renderer->r, renderer->g, renderer->b,
                                 renderer->a);
     }
+    SW_AddPointsDamage(renderer, final_points, count);
     SDL_stack_free(final_points);
 
     return status;
@@ -543,12 +696,20 @@ SW_RenderFillRects(SDL_Renderer * renderer, const SDL_FRect * rects, int count)
                                    renderer->r, renderer->g, renderer->b,
                                    renderer->a);
         status = SDL_FillRects(surface, final_rects, count, color);
+    } else if (SW_IsCustomBlendMode(renderer->blendMode)) {
+        status = SDL_CustomBlendFillRects(surface, final_rects, count,
+                                          renderer->blendMode,
+                                          renderer->r, renderer->g, renderer->b,
+                                          renderer->a);
     } else {
         status = SDL_BlendFillRects(surface, final_rects, count,
                                     renderer->blendMode,
                                     renderer->r, renderer->g, renderer->b,
                                     renderer->a);
     }
+    for (i = 0; i < count; ++i) {
+        SW_AddDamage(renderer, &final_rects[i]);
+    }
     SDL_stack_free(final_rects);
 
     return status;
@@ -576,6 +737,12 @@ SW_RenderCopy(SDL_Renderer * renderer, SDL_Texture * texture,
     final_rect.w = (int)dstrect->w;
     final_rect.h = (int)dstrect->h;
 
+    SW_AddDamage(renderer, &final_rect);
+
+    if (SW_IsCustomBlendMode(texture->blendMode)) {
+        return SDL_CustomBlendSurface(src, srcrect, surface, &final_rect, texture->blendMode);
+    }
+
     if ( srcrect->w == final_rect.w && srcrect->h == final_rect.h ) {
         return SDL_BlitSurface(src, srcrect, surface, &final_rect);
     } else {
@@ -616,6 +783,7 @@ SW_RenderCopyEx(SDL_Renderer * renderer, SDL_Texture * texture,
     int applyModulation = SDL_FALSE;
     int blitRequired = SDL_FALSE;
     int isOpaque = SDL_FALSE;
+    const SDL_bool customBlend = SW_IsCustomBlendMode(texture->blendMode);
 
     if (!surface) {
         return -1;
@@ -656,6 +824,12 @@ SW_RenderCopyEx(SDL_Renderer * renderer, SDL_Texture * texture,
     }
 
     SDL_GetSurfaceBlendMode(src, &blendmode);
+    if (customBlend) {
+        /* Rotate as if for the MOD blend mode, which fills the area outside the rotated
+         * pixels with a white colorkey that the custom blender skips.
+         */
+        blendmode = SDL_BLENDMODE_MOD;
+    }
     SDL_GetSurfaceAlphaMod(src, &alphaMod);
     SDL_GetSurfaceColorMod(src, &rMod, &gMod, &bMod);
 
@@ -764,6 +938,8 @@ SW_RenderCopyEx(SDL_Renderer * renderer, SDL_Texture * texture,
             tmp_rect.w = dstwidth;
             tmp_rect.h = dstheight;
 
+            SW_AddDamage(renderer, &tmp_rect);
+
             /* The NONE blend mode needs some special care with non-opaque surfaces.
              * Other blend modes or opaque surfaces can be blitted directly.
              */
@@ -773,7 +949,11 @@ SW_RenderCopyEx(SDL_Renderer * renderer, SDL_Texture * texture,
                     SDL_SetSurfaceAlphaMod(src_rotated, alphaMod);
                     SDL_SetSurfaceColorMod(src_rotated, rMod, gMod, bMod);
                 }
-                retval = SDL_BlitSurface(src_rotated, NULL, surface, &tmp_rect);
+                if (customBlend) {
+                    retval = SDL_CustomBlendSurface(src_rotated, NULL, surface, &tmp_rect, texture->blendMode);
+                } else {
+                    retval = SDL_BlitSurface(src_rotated, NULL, surface, &tmp_rect);
+                }
             } else {
                 /* The NONE blend mode requires three steps to get the pixels onto the destination surface.
                  * First, the area where the rotated pixels will be blitted to get set to zero.
@@ -865,11 +1045,18 @@ SW_RenderReadPixels(SDL_Renderer * renderer, const SDL_Rect * rect,
 static void
 SW_RenderPresent(SDL_Renderer * renderer)
 {
+    SW_RenderData *data = (SW_RenderData *) renderer->driverdata;
     SDL_Window *window = renderer->window;
 
     if (window) {
-        SDL_UpdateWindowSurface(window);
+        if (data->damage_full || !data->damage_tracking) {
+            SDL_UpdateWindowSurface(window);
+        } else if (data->num_damage > 0) {
+            SDL_UpdateWindowSurfaceRects(window, data->damage, data->num_damage);
+        }
     }
+    data->num_damage = 0;
+    data->damage_full = SDL_FALSE;
 }
 
 static void
@@ -885,6 +1072,9 @@ SW_DestroyRenderer(SDL_Renderer * renderer)
 {
     SW_RenderData *data = (SW_RenderData *) renderer->driverdata;
 
+    if (data) {
+        SDL_DelHintCallback(SDL_HINT_RENDER_SOFTWARE_DAMAGE_TRACKING, SW_DamageTrackingChanged, data);
+    }
     SDL_free(data);
     SDL_free(renderer);
 }
@@ -96,6 +96,7 @@ struct SDL_Window
 
     SDL_Surface *surface;
     SDL_bool surface_valid;
+    SDL_Rect cursor_rect;       /* where the software cursor was last drawn on the surface */
 
     SDL_bool is_hiding;
     SDL_bool is_destroying;
@@ -279,6 +280,13 @@ struct SDL_VideoDevice
      */
     void (*PumpEvents) (_THIS);
 
+    /* Block until there's input for PumpEvents() to handle, SendWakeupEvent()
+       is called from another thread, or timeout milliseconds pass (-1 to
+       wait forever). Returns 1 if woken up early, 0 otherwise. Drivers that
+       leave these NULL get pumped every few milliseconds instead. */
+    int (*WaitEventTimeout) (_THIS, int timeout);
+    void (*SendWakeupEvent) (_THIS);
+
     /* Suspend the screensaver */
     void (*SuspendScreenSaver) (_THIS);
 
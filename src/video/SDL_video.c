@@ -550,6 +550,11 @@ SDL_VideoInit(const char *driver_name)
         _this->DestroyWindowFramebuffer = SDL_DestroyWindowTexture;
     }
 
+    /* Draw the mouse cursor ourselves if asked to and the driver can't */
+    if (SDL_GetHintBoolean(SDL_HINT_MOUSE_SOFTWARE_CURSOR, SDL_FALSE)) {
+        SDL_EnableSoftwareCursor();
+    }
+
     /* Disable the screen saver by default. This is a change from <= 2.0.1,
        but most things using SDL are games or media players; you wouldn't
        want a screensaver to trigger if you're playing exclusively with a
@@ -2248,6 +2253,36 @@ SDL_UpdateWindowSurface(SDL_Window * window)
     return SDL_UpdateWindowSurfaceRects(window, &full_rect, 1);
 }
 
+/* Show the software cursor on the window surface for the length of an
+   update, adding just the areas it changed to the update. */
+static int
+SDL_UpdateWindowFramebufferWithCursor(SDL_Window * window, const SDL_Rect * rects,
+                                      int numrects)
+{
+    SDL_Rect stackrects[16 + 2];
+    SDL_Rect *allrects = stackrects;
+    int status;
+
+    if (numrects > (int) SDL_arraysize(stackrects) - 2) {
+        allrects = (SDL_Rect *) SDL_malloc((numrects + 2) * sizeof(*allrects));
+        if (!allrects) {
+            return SDL_OutOfMemory();
+        }
+    }
+    if (numrects > 0) {
+        SDL_memcpy(allrects, rects, numrects * sizeof(*allrects));
+    }
+
+    numrects = SDL_DrawSoftwareCursor(window, allrects, numrects);
+    status = _this->UpdateWindowFramebuffer(_this, window, allrects, numrects);
+    SDL_EraseSoftwareCursor(window);
+
+    if (allrects != stackrects) {
+        SDL_free(allrects);
+    }
+    return status;
+}
+
 int
 SDL_UpdateWindowSurfaceRects(SDL_Window * window, const SDL_Rect * rects,
                              int numrects)
@@ -2258,6 +2293,9 @@ SDL_UpdateWindowSurfaceRects(SDL_Window * window, const SDL_Rect * rects,
         return SDL_SetError("Window surface is invalid, please call SDL_GetWindowSurface() to get a new surface");
     }
 
+    if (SDL_GetMouse()->software_cursor) {
+        return SDL_UpdateWindowFramebufferWithCursor(window, rects, numrects);
+    }
     return _this->UpdateWindowFramebuffer(_this, window, rects, numrects);
 }
 
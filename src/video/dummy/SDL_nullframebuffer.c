@@ -27,6 +27,7 @@
 
 
 #define DUMMY_SURFACE   "_SDL_DummySurface"
+#define DUMMY_PRESENTED "_SDL_DummyPresented"
 
 int SDL_DUMMY_CreateWindowFramebuffer(_THIS, SDL_Window * window, Uint32 * format, void ** pixels, int *pitch)
 {
@@ -39,6 +40,8 @@ int SDL_DUMMY_CreateWindowFramebuffer(_THIS, SDL_Window * window, Uint32 * forma
     /* Free the old framebuffer surface */
     surface = (SDL_Surface *) SDL_GetWindowData(window, DUMMY_SURFACE);
     SDL_FreeSurface(surface);
+    surface = (SDL_Surface *) SDL_SetWindowData(window, DUMMY_PRESENTED, NULL);
+    SDL_FreeSurface(surface);
 
     /* Create a new one */
     SDL_PixelFormatEnumToMasks(surface_format, &bpp, &Rmask, &Gmask, &Bmask, &Amask);
@@ -59,7 +62,9 @@ int SDL_DUMMY_CreateWindowFramebuffer(_THIS, SDL_Window * window, Uint32 * forma
 int SDL_DUMMY_UpdateWindowFramebuffer(_THIS, SDL_Window * window, const SDL_Rect * rects, int numrects)
 {
     static int frame_number;
-    SDL_Surface *surface;
+    const char *save_frames = SDL_getenv("SDL_VIDEO_DUMMY_SAVE_FRAMES");
+    SDL_Surface *surface, *presented;
+    int i;
 
     surface = (SDL_Surface *) SDL_GetWindowData(window, DUMMY_SURFACE);
     if (!surface) {
@@ -67,11 +72,32 @@ int SDL_DUMMY_UpdateWindowFramebuffer(_THIS, SDL_Window * window, const SDL_Rect
     }
 
     /* Send the data to the display */
-    if (SDL_getenv("SDL_VIDEO_DUMMY_SAVE_FRAMES")) {
+    if (save_frames && *save_frames && SDL_strcmp(save_frames, "0") != 0) {
         char file[128];
+
+        /* Like a real display, only the updated rects change what's shown.
+           The display starts out black when frames start being saved. */
+        presented = (SDL_Surface *) SDL_GetWindowData(window, DUMMY_PRESENTED);
+        if (!presented) {
+            presented = SDL_CreateRGBSurface(0, surface->w, surface->h,
+                                             surface->format->BitsPerPixel,
+                                             surface->format->Rmask,
+                                             surface->format->Gmask,
+                                             surface->format->Bmask,
+                                             surface->format->Amask);
+            if (!presented) {
+                return -1;
+            }
+            SDL_SetWindowData(window, DUMMY_PRESENTED, presented);
+        }
+        for (i = 0; i < numrects; ++i) {
+            SDL_Rect rect = rects[i];
+            SDL_BlitSurface(surface, &rect, presented, &rect);
+        }
+
         SDL_snprintf(file, sizeof(file), "SDL_window%d-%8.8d.bmp",
                      SDL_GetWindowID(window), ++frame_number);
-        SDL_SaveBMP(surface, file);
+        SDL_SaveBMP(presented, file);
     }
     return 0;
 }
@@ -82,6 +108,8 @@ void SDL_DUMMY_DestroyWindowFramebuffer(_THIS, SDL_Window * window)
 
     surface = (SDL_Surface *) SDL_SetWindowData(window, DUMMY_SURFACE, NULL);
     SDL_FreeSurface(surface);
+    surface = (SDL_Surface *) SDL_SetWindowData(window, DUMMY_PRESENTED, NULL);
+    SDL_FreeSurface(surface);
 }
 
 #endif /* SDL_VIDEO_DRIVER_DUMMY */
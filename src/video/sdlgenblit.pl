@@ -27,6 +27,7 @@ my %file;
 
 # The formats we're actually creating blitters for:
 my @src_formats = (
+    "RGB565",
     "RGB888",
     "BGR888",
     "ARGB8888",
@@ -35,12 +36,14 @@ my @src_formats = (
     "BGRA8888",
 );
 my @dst_formats = (
+    "RGB565",
     "RGB888",
     "BGR888",
     "ARGB8888",
 );
 
 my %format_size = (
+    "RGB565" => 2,
     "RGB888" => 4,
     "BGR888" => 4,
     "ARGB8888" => 4,
@@ -50,6 +53,7 @@ my %format_size = (
 );
 
 my %format_type = (
+    "RGB565" => "Uint16",
     "RGB888" => "Uint32",
     "BGR888" => "Uint32",
     "ARGB8888" => "Uint32",
@@ -58,7 +62,9 @@ my %format_type = (
     "BGRA8888" => "Uint32",
 );
 
+# The 16-bit expansions match the SDL_expand_byte tables used by SDL_Blit_Slow
 my %get_rgba_string_ignore_alpha = (
+    "RGB565" => "_R = (Uint8)(((_pixel >> 11) & 0x1F) * 255 / 31); _G = (Uint8)(((_pixel >> 5) & 0x3F) * 255 / 63); _B = (Uint8)((_pixel & 0x1F) * 255 / 31);",
     "RGB888" => "_R = (Uint8)(_pixel >> 16); _G = (Uint8)(_pixel >> 8); _B = (Uint8)_pixel;",
     "BGR888" => "_B = (Uint8)(_pixel >> 16); _G = (Uint8)(_pixel >> 8); _R = (Uint8)_pixel;",
     "ARGB8888" => "_R = (Uint8)(_pixel >> 16); _G = (Uint8)(_pixel >> 8); _B = (Uint8)_pixel;",
@@ -68,6 +74,7 @@ my %get_rgba_string_ignore_alpha = (
 );
 
 my %get_rgba_string = (
+    "RGB565" => $get_rgba_string_ignore_alpha{"RGB565"} . " _A = 0xFF;",
     "RGB888" => $get_rgba_string_ignore_alpha{"RGB888"} . " _A = 0xFF;",
     "BGR888" => $get_rgba_string_ignore_alpha{"BGR888"} . " _A = 0xFF;",
     "ARGB8888" => $get_rgba_string_ignore_alpha{"ARGB8888"} . " _A = (Uint8)(_pixel >> 24);",
@@ -77,6 +84,7 @@ my %get_rgba_string = (
 );
 
 my %set_rgba_string = (
+    "RGB565" => "_pixel = ((Uint32)(_R >> 3) << 11) | ((Uint32)(_G >> 2) << 5) | (_B >> 3);",
     "RGB888" => "_pixel = ((Uint32)_R << 16) | ((Uint32)_G << 8) | _B;",
     "BGR888" => "_pixel = ((Uint32)_B << 16) | ((Uint32)_G << 8) | _R;",
     "ARGB8888" => "_pixel = ((Uint32)_A << 24) | ((Uint32)_R << 16) | ((Uint32)_G << 8) | _B;",
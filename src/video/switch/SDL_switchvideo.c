@@ -144,6 +144,8 @@ static int SWITCH_UpdateWindowFramebuffer(_THIS, SDL_Window *window, const SDL_R
 		return -1;
 	}
 
+	/* The whole surface goes out every time; rects are ignored. So an update
+	   that only moves the software cursor still costs a full blit here. */
 	gfx_slow_swizzling_blit(out_buffer, sdl_surface->pixels, sdl_surface->w, sdl_surface->h, 0, 0);
 
 	if((r = surface_queue_buffer(lt_surface)) != RESULT_OK) {
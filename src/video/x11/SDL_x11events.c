@@ -24,6 +24,7 @@
 
 #include <sys/types.h>
 #include <sys/time.h>
+#include <time.h>
 #include <signal.h>
 #include <unistd.h>
 #include <limits.h> /* For INT_MAX */
@@ -629,6 +630,27 @@ X11_HandleClipboardEvent(_THIS, const XEvent *xevent)
 }
 
 
+/* The X server stamps input with its own millisecond clock, which on Linux
+   is CLOCK_MONOTONIC. If the time looks like it came from that, let the
+   event queue know when the event happened, on SDL's clock. */
+void
+X11_SetEventSourceTime(Time time)
+{
+    Uint64 source = 0;
+#if HAVE_CLOCK_GETTIME && defined(CLOCK_MONOTONIC)
+    struct timespec now;
+
+    if (time != CurrentTime && clock_gettime(CLOCK_MONOTONIC, &now) == 0) {
+        const Uint32 now_ms = (Uint32) ((now.tv_sec * 1000) + (now.tv_nsec / 1000000));
+        const Uint32 age = now_ms - (Uint32) time;
+        if (age < 1000) {
+            source = SDL_GetPerformanceCounter() - ((age * SDL_GetPerformanceFrequency()) / 1000);
+        }
+    }
+#endif
+    SDL_SetEventSourceTime(source);
+}
+
 static void
 X11_DispatchEvent(_THIS)
 {
@@ -649,6 +671,27 @@ X11_DispatchEvent(_THIS)
     SDL_zero(xevent);           /* valgrind fix. --ryan. */
     X11_XNextEvent(display, &xevent);
 
+    switch (xevent.type) {
+    case KeyPress:
+    case KeyRelease:
+        X11_SetEventSourceTime(xevent.xkey.time);
+        break;
+    case ButtonPress:
+    case ButtonRelease:
+        X11_SetEventSourceTime(xevent.xbutton.time);
+        break;
+    case MotionNotify:
+        X11_SetEventSourceTime(xevent.xmotion.time);
+        break;
+    case EnterNotify:
+    case LeaveNotify:
+        X11_SetEventSourceTime(xevent.xcrossing.time);
+        break;
+    default:
+        X11_SetEventSourceTime(CurrentTime);  /* XInput2 sets its own */
+        break;
+    }
+
     /* Save the original keycode for dead keys, which are filtered out by
        the XFilterEvent() call below.
     */
@@ -1448,6 +1491,7 @@ X11_PumpEvents(_THIS)
     while (X11_Pending(data->display)) {
         X11_DispatchEvent(_this);
     }
+    SDL_SetEventSourceTime(0);
 
 #ifdef SDL_USE_IME
     if(SDL_GetEventState(SDL_TEXTINPUT) == SDL_ENABLE){
@@ -1459,6 +1503,82 @@ X11_PumpEvents(_THIS)
     X11_HandleFocusChanges(_this);
 }
 
+/* Shortens timeout (-1 meaning forever) so it ends by the deadline */
+static int
+X11_TimeoutUntil(int timeout, Uint32 now, Uint32 deadline)
+{
+    const int remaining = SDL_TICKS_PASSED(now, deadline) ? 0 : (int) (deadline - now);
+    return (timeout < 0) ? remaining : SDL_min(timeout, remaining);
+}
+
+int
+X11_WaitEventTimeout(_THIS, int timeout)
+{
+    SDL_VideoData *data = (SDL_VideoData *) _this->driverdata;
+    Display *display = data->display;
+    const int xfd = ConnectionNumber(display);
+    const int wakefd = data->wakeup_pipe[0];
+    const Uint32 now = SDL_GetTicks();
+    struct timeval tv;
+    fd_set readfds;
+    char buf[64];
+    int i, result;
+
+    /* X11_PumpEvents() has some timers of its own, so come back in time for them. */
+    if (_this->suspend_screensaver) {
+        timeout = X11_TimeoutUntil(timeout, now, data->screensaver_activity + 30000);
+    }
+    if (data->last_mode_change_deadline) {
+        timeout = X11_TimeoutUntil(timeout, now, data->last_mode_change_deadline);
+    }
+    for (i = 0; i < data->numwindows; ++i) {
+        SDL_WindowData *windowdata = data->windowlist[i];
+        if (windowdata && windowdata->pending_focus != PENDING_FOCUS_NONE) {
+            timeout = X11_TimeoutUntil(timeout, now, windowdata->pending_focus_time);
+        }
+    }
+#ifdef SDL_USE_IME
+    /* the input method talks to us over its own connection, which we can't wait on */
+    if (SDL_GetEventState(SDL_TEXTINPUT) == SDL_ENABLE) {
+        timeout = X11_TimeoutUntil(timeout, now, now + 10);
+    }
+#endif
+
+    /* Send anything we've buffered up, and don't wait for events that Xlib
+       has already read off the connection. */
+    X11_XFlush(display);
+    if (X11_XEventsQueued(display, QueuedAlready)) {
+        return 1;
+    }
+
+    FD_ZERO(&readfds);
+    FD_SET(xfd, &readfds);
+    FD_SET(wakefd, &readfds);
+    if (timeout >= 0) {
+        tv.tv_sec = timeout / 1000;
+        tv.tv_usec = (timeout % 1000) * 1000;
+    }
+    result = select(SDL_max(xfd, wakefd) + 1, &readfds, NULL, NULL, (timeout >= 0) ? &tv : NULL);
+
+    if (result > 0 && FD_ISSET(wakefd, &readfds)) {
+        while (read(wakefd, buf, sizeof (buf)) > 0) {
+            /* empty the pipe, one wakeup covers everything sent so far. */
+        }
+    }
+    return (result != 0);  /* a signal coming in is a reason to wake up, too. */
+}
+
+void
+X11_SendWakeupEvent(_THIS)
+{
+    SDL_VideoData *data = (SDL_VideoData *) _this->driverdata;
+    const char wakeup = 0;
+
+    if (write(data->wakeup_pipe[1], &wakeup, 1) < 0) {
+        /* the pipe is full, so there's a wakeup waiting already. */
+    }
+}
+
 
 void
 X11_SuspendScreenSaver(_THIS)
@@ -22,7 +22,8 @@
 
 #if SDL_VIDEO_DRIVER_X11
 
-#include <unistd.h> /* For getpid() and readlink() */
+#include <unistd.h> /* For getpid(), readlink() and pipe() */
+#include <fcntl.h>
 
 #include "SDL_video.h"
 #include "SDL_mouse.h"
@@ -115,6 +116,10 @@ X11_DeleteDevice(SDL_VideoDevice * device)
     if (data->display) {
         X11_XCloseDisplay(data->display);
     }
+    if (data->wakeup_pipe[0] >= 0) {
+        close(data->wakeup_pipe[0]);
+        close(data->wakeup_pipe[1]);
+    }
     SDL_free(data->windowlist);
     SDL_free(device->driverdata);
     SDL_free(device);
@@ -215,6 +220,17 @@ X11_CreateDevice(int devindex)
     X11_XSynchronize(data->display, True);
 #endif
 
+    /* Other threads wake up SDL_WaitEvent() by writing to this. */
+    if (pipe(data->wakeup_pipe) == 0) {
+        int i;
+        for (i = 0; i < 2; ++i) {
+            fcntl(data->wakeup_pipe[i], F_SETFL, fcntl(data->wakeup_pipe[i], F_GETFL) | O_NONBLOCK);
+            fcntl(data->wakeup_pipe[i], F_SETFD, FD_CLOEXEC);
+        }
+    } else {
+        data->wakeup_pipe[0] = data->wakeup_pipe[1] = -1;
+    }
+
     /* Hook up an X11 error handler to recover the desktop resolution. */
     safety_net_triggered = SDL_FALSE;
     orig_x11_errhandler = X11_XSetErrorHandler(X11_SafetyNetErrHandler);
@@ -230,6 +246,10 @@ X11_CreateDevice(int devindex)
     device->SetDisplayMode = X11_SetDisplayMode;
     device->SuspendScreenSaver = X11_SuspendScreenSaver;
     device->PumpEvents = X11_PumpEvents;
+    if (data->wakeup_pipe[0] >= 0) {
+        device->WaitEventTimeout = X11_WaitEventTimeout;
+        device->SendWakeupEvent = X11_SendWakeupEvent;
+    }
 
     device->CreateSDLWindow = X11_CreateWindow;
     device->CreateSDLWindowFrom = X11_CreateWindowFrom;
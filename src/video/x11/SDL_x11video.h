@@ -130,6 +130,9 @@ typedef struct SDL_VideoData
 
     Uint32 last_mode_change_deadline;
 
+    /* written to by X11_SendWakeupEvent() to end X11_WaitEventTimeout() */
+    int wakeup_pipe[2];
+
     SDL_bool global_mouse_changed;
     SDL_Point global_mouse_position;
     Uint32 global_mouse_buttons;
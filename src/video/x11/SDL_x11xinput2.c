@@ -179,6 +179,7 @@ X11_HandleXinput2Event(SDL_VideoData *videodata,XGenericEventCookie *cookie)
 
             parse_valuators(rawev->raw_values,rawev->valuators.mask,
                             rawev->valuators.mask_len,relative_coords,2);
+            X11_SetEventSourceTime(rawev->time);
 
             if ((rawev->time == prev_time) && (relative_coords[0] == prev_rel_coords[0]) && (relative_coords[1] == prev_rel_coords[1])) {
                 return 0;  /* duplicate event, drop it. */
@@ -203,6 +204,7 @@ X11_HandleXinput2Event(SDL_VideoData *videodata,XGenericEventCookie *cookie)
             float x, y;
             xinput2_normalize_touch_coordinates(videodata, xev->event,
                                   xev->event_x, xev->event_y, &x, &y);
+            X11_SetEventSourceTime(xev->time);
             SDL_SendTouch(xev->sourceid,xev->detail, SDL_TRUE, x, y, 1.0);
             return 1;
             }
@@ -212,6 +214,7 @@ X11_HandleXinput2Event(SDL_VideoData *videodata,XGenericEventCookie *cookie)
             float x, y;
             xinput2_normalize_touch_coordinates(videodata, xev->event,
                                   xev->event_x, xev->event_y, &x, &y);
+            X11_SetEventSourceTime(xev->time);
             SDL_SendTouch(xev->sourceid,xev->detail, SDL_FALSE, x, y, 1.0);
             return 1;
             }
@@ -221,6 +224,7 @@ X11_HandleXinput2Event(SDL_VideoData *videodata,XGenericEventCookie *cookie)
             float x, y;
             xinput2_normalize_touch_coordinates(videodata, xev->event,
                                   xev->event_x, xev->event_y, &x, &y);
+            X11_SetEventSourceTime(xev->time);
             SDL_SendTouchMotion(xev->sourceid,xev->detail, x, y, 1.0);
             return 1;
             }
@@ -0,0 +1,142 @@
+/*
+  Copyright (C) 1997-2017 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely.
+*/
+
+/* Runs the whole audio output path (callback, format and channel
+   conversion, resampling, handing buffers to the device) as fast as it will
+   go, with no sound card, and reports where the time goes.
+
+   It uses the "disk" audio driver with no delay, writing to the null device,
+   and has the driver ask for a different format than the callback makes so
+   SDL has to convert. Set SDL_AUDIO_RESAMPLING_MODE to compare resamplers.
+
+     testaudiobench [seconds per test] */
+
+#include <stdio.h>
+#include "SDL.h"
+
+#ifdef __WIN32__
+#define NULL_DEVICE "NUL"
+#else
+#define NULL_DEVICE "/dev/null"
+#endif
+
+typedef struct
+{
+    const char *name;
+    const char *freq;
+    const char *channels;
+    const char *format;
+} BenchCase;
+
+/* The callback always makes 44100Hz stereo S16; the device wants these. */
+static const BenchCase cases[] = {
+    { "no conversion", "44100", "2", "S16" },
+    { "S16 to F32", "44100", "2", "F32" },
+    { "stereo to 5.1", "44100", "6", "S16" },
+    { "44100 to 48000Hz", "48000", "2", "S16" },
+    { "all of the above", "48000", "6", "F32" }
+};
+
+static void SDLCALL
+fill_audio(void *userdata, Uint8 *stream, int len)
+{
+    /* a cheap square wave, so the callback itself costs next to nothing. */
+    Uint32 *phase = (Uint32 *) userdata;
+    Sint16 *samples = (Sint16 *) stream;
+    int i;
+    for (i = 0; i < len / 4; i++) {
+        const Sint16 val = ((*phase)++ & 64) ? 8192 : -8192;
+        samples[i * 2] = samples[(i * 2) + 1] = val;
+    }
+}
+
+static double
+TicksToMicroseconds(Uint64 ticks, Uint64 count)
+{
+    return count ? ((ticks * 1000000.0) / SDL_GetPerformanceFrequency()) / count : 0.0;
+}
+
+static void
+RunCase(const BenchCase *bench, int seconds)
+{
+    SDL_AudioSpec desired, obtained;
+    SDL_AudioDeviceStats stats;
+    SDL_AudioDeviceID dev;
+    Uint32 phase = 0;
+    double audioseconds;
+
+    SDL_setenv("SDL_DISKAUDIOFREQ", bench->freq, 1);
+    SDL_setenv("SDL_DISKAUDIOCHANNELS", bench->channels, 1);
+    SDL_setenv("SDL_DISKAUDIOFORMAT", bench->format, 1);
+
+    SDL_zero(desired);
+    desired.freq = 44100;
+    desired.format = AUDIO_S16SYS;
+    desired.channels = 2;
+    desired.samples = 1024;
+    desired.callback = fill_audio;
+    desired.userdata = &phase;
+    dev = SDL_OpenAudioDevice(NULL, 0, &desired, &obtained, 0);
+    if (!dev) {
+        SDL_Log("%s: couldn't open audio: %s\n", bench->name, SDL_GetError());
+        return;
+    }
+
+    SDL_PauseAudioDevice(dev, 0);
+    SDL_Delay(seconds * 1000);
+    SDL_GetAudioDeviceStats(dev, &stats);
+    SDL_CloseAudioDevice(dev);
+
+    audioseconds = ((double) stats.callbacks * obtained.samples) / obtained.freq;
+    SDL_Log("%s: %.0f callbacks/s, %.1fx realtime\n", bench->name,
+            (double) stats.callbacks / seconds, audioseconds / seconds);
+    SDL_Log("    average per callback: callback %.2f us, convert %.2f us, resample %.2f us, device %.2f us\n",
+            TicksToMicroseconds(stats.callback_ticks, stats.callbacks),
+            TicksToMicroseconds(stats.convert_ticks, stats.callbacks),
+            TicksToMicroseconds(stats.resample_ticks, stats.callbacks),
+            TicksToMicroseconds(stats.play_ticks, stats.callbacks));
+    SDL_Log("    worst case: callback %.2f us, whole trip through the audio thread %.2f us\n",
+            TicksToMicroseconds(stats.max_callback_ticks, 1),
+            TicksToMicroseconds(stats.max_iteration_ticks, 1));
+}
+
+int
+main(int argc, char **argv)
+{
+    int seconds = 2;
+    int i;
+
+    /* Enable standard application logging */
+    SDL_LogSetPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO);
+
+    if (argc > 1) {
+        seconds = SDL_max(SDL_atoi(argv[1]), 1);
+    }
+
+    /* don't touch the file or delay if they're already set. */
+    SDL_setenv("SDL_AUDIODRIVER", "disk", 1);
+    SDL_setenv("SDL_DISKAUDIOFILE", NULL_DEVICE, 0);
+    SDL_setenv("SDL_DISKAUDIODELAY", "0", 0);
+
+    if (SDL_Init(SDL_INIT_AUDIO) < 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't initialize SDL: %s\n", SDL_GetError());
+        return (1);
+    }
+
+    SDL_Log("Resampler: %s\n", SDL_GetHint(SDL_HINT_AUDIO_RESAMPLING_MODE) ? SDL_GetHint(SDL_HINT_AUDIO_RESAMPLING_MODE) : "default");
+    for (i = 0; i < SDL_arraysize(cases); i++) {
+        RunCase(&cases[i], seconds);
+    }
+
+    SDL_Quit();
+    return (0);
+}
@@ -0,0 +1,126 @@
+/*
+  Copyright (C) 1997-2017 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely.
+*/
+
+/* Hammers SDL_QueueAudio() from one thread while the device plays, and
+   reports how late the audio thread got around to pulling data out of the
+   queue. Run it once with the default queue, and once with a lock-free ring:
+
+     testaudioqueuestress
+     SDL_AUDIO_QUEUE_CAPACITY=1048576 testaudioqueuestress
+
+   Use SDL_AUDIODRIVER=dummy to get numbers that don't depend on the sound
+   card. */
+
+#include <stdio.h>
+#include "SDL.h"
+
+#define CHUNK_SIZE (64 * 1024)
+
+int
+main(int argc, char **argv)
+{
+    const char *hint;
+    SDL_AudioSpec desired, obtained;
+    SDL_AudioDeviceID dev;
+    Uint8 *chunk;
+    Uint64 freq, start, now, last = 0, maxgap = 0, totalgap = 0;
+    Uint32 written = 0, consumed = 0, target, period;
+    int seconds = 5, callbacks = 0, failures = 0;
+
+    /* Enable standard application logging */
+    SDL_LogSetPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO);
+
+    if (argc > 1) {
+        seconds = SDL_atoi(argv[1]);
+    }
+
+    if (SDL_Init(SDL_INIT_AUDIO) < 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't initialize SDL: %s\n", SDL_GetError());
+        return (1);
+    }
+
+    SDL_zero(desired);
+    desired.freq = 48000;
+    desired.format = AUDIO_S16SYS;
+    desired.channels = 2;
+    desired.samples = 256;
+    dev = SDL_OpenAudioDevice(NULL, 0, &desired, &obtained, 0);
+    if (!dev) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't open audio: %s\n", SDL_GetError());
+        SDL_Quit();
+        return (1);
+    }
+
+    chunk = (Uint8 *) SDL_calloc(1, CHUNK_SIZE);
+    if (!chunk) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Out of memory\n");
+        SDL_Quit();
+        return (1);
+    }
+
+    hint = SDL_GetHint(SDL_HINT_AUDIO_QUEUE_CAPACITY);
+    SDL_Log("Driver %s, %d Hz, %u bytes per callback, %s queue\n",
+            SDL_GetCurrentAudioDriver(), obtained.freq, (unsigned int) obtained.size,
+            (hint && SDL_atoi(hint) > 0) ? "ring" : "default");
+
+    /* keep several chunks in flight, so there's always a big copy going on. */
+    target = 8 * CHUNK_SIZE;
+    period = obtained.size;
+    freq = SDL_GetPerformanceFrequency();
+
+    SDL_PauseAudioDevice(dev, 0);
+    start = SDL_GetPerformanceCounter();
+    do {
+        const Uint32 queued = SDL_GetQueuedAudioSize(dev);
+        now = SDL_GetPerformanceCounter();
+
+        /* anything that left the queue since last time was a callback. */
+        if ((written - queued) >= (consumed + period)) {
+            consumed = written - queued;
+            if (last) {
+                const Uint64 gap = now - last;
+                maxgap = SDL_max(maxgap, gap);
+                totalgap += gap;
+                callbacks++;
+            }
+            last = now;
+        }
+
+        if (queued < target) {
+            if (SDL_QueueAudio(dev, chunk, CHUNK_SIZE) == 0) {
+                written += CHUNK_SIZE;
+            } else {
+                failures++;
+            }
+        }
+    } while ((now - start) < (seconds * freq));
+
+    SDL_CloseAudioDevice(dev);
+
+    if (callbacks) {
+        const double expected = (1000.0 * obtained.samples) / obtained.freq;
+        SDL_Log("%d callbacks, expected every %.3f ms\n", callbacks, expected);
+        SDL_Log("average gap %.3f ms, worst gap %.3f ms (%.3f ms late)\n",
+                (1000.0 * totalgap) / (callbacks * freq),
+                (1000.0 * maxgap) / freq,
+                ((1000.0 * maxgap) / freq) - expected);
+    } else {
+        SDL_Log("The device never consumed any data!\n");
+    }
+    if (failures) {
+        SDL_Log("%d calls to SDL_QueueAudio() found the queue full\n", failures);
+    }
+
+    SDL_free(chunk);
+    SDL_Quit();
+    return (0);
+}
@@ -907,6 +907,1173 @@ int audio_convertAudio()
 }
 
 
+/* Scalar reference versions of the sample type converters */
+static float _sampleToFloat(SDL_AudioFormat format, const Uint8 *src)
+{
+  switch (format) {
+    case AUDIO_S8: return ((float) *((const Sint8 *) src)) * 0.0078125f;
+    case AUDIO_U8: return (((float) *src) * 0.0078125f) - 1.0f;
+    case AUDIO_S16SYS: return ((float) *((const Sint16 *) src)) * 0.000030517578125f;
+    case AUDIO_U16SYS: return (((float) *((const Uint16 *) src)) * 0.000030517578125f) - 1.0f;
+    default: return (float) (((double) *((const Sint32 *) src)) * 0.00000000046566128730773926);
+  }
+}
+
+static Sint64 _floatToSample(SDL_AudioFormat format, float sample)
+{
+  switch (format) {
+    case AUDIO_S8: return (sample > 1.0f) ? 127 : (sample < -1.0f) ? -127 : (Sint8) (sample * 127.0f);
+    case AUDIO_U8: return (sample > 1.0f) ? 255 : (sample < -1.0f) ? 0 : (Uint8) ((sample + 1.0f) * 127.0f);
+    case AUDIO_S16SYS: return (sample > 1.0f) ? 32767 : (sample < -1.0f) ? -32767 : (Sint16) (sample * 32767.0f);
+    case AUDIO_U16SYS: return (sample > 1.0f) ? 65534 : (sample < -1.0f) ? 0 : (Uint16) ((sample + 1.0f) * 32767.0f);
+    default: return (sample > 1.0f) ? 2147483647 : (sample < -1.0f) ? -2147483647 : (Sint32) ((double) sample * 2147483647.0);
+  }
+}
+
+static Sint64 _readSample(SDL_AudioFormat format, const Uint8 *src)
+{
+  switch (format) {
+    case AUDIO_S8: return *((const Sint8 *) src);
+    case AUDIO_U8: return *src;
+    case AUDIO_S16SYS: return *((const Sint16 *) src);
+    case AUDIO_U16SYS: return *((const Uint16 *) src);
+    default: return *((const Sint32 *) src);
+  }
+}
+
+/**
+ * \brief Checks the CPU-specific sample type converters against scalar reference code.
+ *
+ * Every length up to a few SIMD blocks, at every alignment, so both the vector
+ * loops and the scalar leftovers get covered. Conversions to float have to be
+ * bit-exact. The SSE2 float to integer converters round instead of truncating,
+ * and the U16 one centers on 32768 instead of 32767, so they get two LSBs of
+ * slack and only see samples in range.
+ */
+int audio_convertSampleTypes()
+{
+  const SDL_AudioFormat formats[] = { AUDIO_S8, AUDIO_U8, AUDIO_S16SYS, AUDIO_U16SYS, AUDIO_S32SYS };
+  const char *formatNames[] = { "AUDIO_S8", "AUDIO_U8", "AUDIO_S16SYS", "AUDIO_U16SYS", "AUDIO_S32SYS" };
+  const int tolerance = (SDL_HasSSE2() && !SDL_HasNEON()) ? 2 : 0;
+  float source[70];
+  Uint8 *buffer;
+  int f, k, i, count, offset;
+
+  /* room for all of the samples as floats at any of the offsets below */
+  buffer = (Uint8 *)SDL_malloc(sizeof (source) + 16);
+  SDLTest_AssertCheck(buffer != NULL, "Check data buffer is not NULL");
+  if (buffer == NULL) return TEST_ABORTED;
+
+  for (f = 0; f < SDL_arraysize(formats); f++) {
+    const int samplesize = SDL_AUDIO_BITSIZE(formats[f]) / 8;
+    for (k = 0; k < 2; k++) {
+      const SDL_AudioFormat srcformat = k ? AUDIO_F32SYS : formats[f];
+      const SDL_AudioFormat dstformat = k ? formats[f] : AUDIO_F32SYS;
+      int mismatches = 0;
+      SDL_AudioCVT cvt;
+      int result;
+
+      result = SDL_BuildAudioCVT(&cvt, srcformat, 1, 48000, dstformat, 1, 48000);
+      SDLTest_AssertPass("Call to SDL_BuildAudioCVT(%s ==> %s)", k ? "AUDIO_F32SYS" : formatNames[f], k ? formatNames[f] : "AUDIO_F32SYS");
+      SDLTest_AssertCheck(result == 1, "Verify result value; expected: 1, got: %i", result);
+      if (result != 1) {
+        continue;
+      }
+
+      for (count = 0; count <= SDL_arraysize(source); count++) {
+        for (offset = 0; offset < 16; offset += 4) {
+          Uint8 *data = buffer + offset;
+
+          /* fill in the source samples, then keep a copy as floats for the reference */
+          for (i = 0; i < count; i++) {
+            if (k) {
+              float sample;
+              switch (SDLTest_RandomIntegerInRange(0, 7)) {
+                case 0: sample = 1.0f; break;
+                case 1: sample = -1.0f; break;
+                case 2: sample = tolerance ? 0.0f : 1.5f; break;
+                case 3: sample = tolerance ? 0.0f : -1.5f; break;
+                default: sample = (SDLTest_RandomUnitFloat() * 2.0f) - 1.0f; break;
+              }
+              ((float *) data)[i] = source[i] = sample;
+            } else {
+              const Uint32 bits = SDLTest_RandomUint32();
+              SDL_memcpy(data + i * samplesize, &bits, samplesize);
+              source[i] = _sampleToFloat(formats[f], data + i * samplesize);
+            }
+          }
+
+          cvt.buf = data;
+          cvt.len = count * (k ? sizeof (float) : samplesize);
+          SDL_ConvertAudio(&cvt);
+
+          for (i = 0; i < count; i++) {
+            if (k) {
+              const Sint64 expected = _floatToSample(formats[f], source[i]);
+              const Sint64 actual = _readSample(formats[f], data + i * samplesize);
+              if (actual - expected > tolerance || expected - actual > tolerance) {
+                mismatches++;
+              }
+            } else if (SDL_memcmp(&((float *) data)[i], &source[i], sizeof (float)) != 0) {
+              mismatches++;
+            }
+          }
+        }
+      }
+
+      SDLTest_AssertCheck(mismatches == 0, "Verify %s ==> %s matches the scalar reference; %i samples differ",
+        k ? "AUDIO_F32SYS" : formatNames[f], k ? formatNames[f] : "AUDIO_F32SYS", mismatches);
+    }
+  }
+
+  SDL_free(buffer);
+  return TEST_COMPLETED;
+}
+
+/**
+ * \brief Converts known AUDIO_U16SYS samples to float.
+ *
+ * Regression test for the SSE2 converter, which used to add 1.0 instead of
+ * subtracting it when the buffer was aligned. The buffer is long enough for
+ * several SIMD blocks and is tried at every 4-byte alignment.
+ */
+int audio_convertU16ToF32()
+{
+  const Uint16 samples[] = { 0x0000, 0x8000, 0xFFFF, 0x4000, 0xC000, 0x0001, 0x7FFF, 0x8001 };
+  const float expected[] = { -1.0f, 0.0f, 0.999969482421875f, -0.5f, 0.5f, -0.999969482421875f, -0.000030517578125f, 0.000030517578125f };
+  const int count = 64;
+  Uint8 *buffer;
+  int i, offset;
+
+  buffer = (Uint8 *)SDL_malloc(count * sizeof (float) + 16);
+  SDLTest_AssertCheck(buffer != NULL, "Check data buffer is not NULL");
+  if (buffer == NULL) return TEST_ABORTED;
+
+  for (offset = 0; offset < 16; offset += 4) {
+    float *data = (float *) (buffer + offset);
+    int mismatches = 0;
+    SDL_AudioCVT cvt;
+    int result;
+
+    result = SDL_BuildAudioCVT(&cvt, AUDIO_U16SYS, 1, 48000, AUDIO_F32SYS, 1, 48000);
+    SDLTest_AssertCheck(result == 1, "Verify result value; expected: 1, got: %i", result);
+    if (result != 1) {
+      break;
+    }
+
+    for (i = 0; i < count; i++) {
+      ((Uint16 *) data)[i] = samples[i % SDL_arraysize(samples)];
+    }
+    cvt.buf = (Uint8 *) data;
+    cvt.len = count * sizeof (Uint16);
+    result = SDL_ConvertAudio(&cvt);
+    SDLTest_AssertPass("Call to SDL_ConvertAudio(AUDIO_U16SYS ==> AUDIO_F32SYS) at offset %i", offset);
+    SDLTest_AssertCheck(result == 0, "Verify result value; expected: 0, got: %i", result);
+    SDLTest_AssertCheck(cvt.len_cvt == count * (int) sizeof (float), "Verify converted length; expected: %i, got: %i", count * (int) sizeof (float), cvt.len_cvt);
+
+    for (i = 0; i < count; i++) {
+      if (data[i] != expected[i % SDL_arraysize(expected)]) {
+        mismatches++;
+      }
+    }
+    SDLTest_AssertCheck(mismatches == 0, "Verify converted samples; expected: 0 mismatches, got: %i", mismatches);
+  }
+
+  SDL_free(buffer);
+  return TEST_COMPLETED;
+}
+
+/* Scalar reference for SDL_MixAudioFormat() on one native-endian sample */
+static void _mixSample(SDL_AudioFormat format, Uint8 *dst, const Uint8 *src, int volume)
+{
+  switch (format) {
+    case AUDIO_U8: {
+      const int sample = *dst + ((*src - 128) * volume) / SDL_MIX_MAXVOLUME;
+      *dst = (Uint8) ((sample < 0) ? 0 : (sample > 0xFE) ? 0xFE : sample);
+      break;
+    }
+    case AUDIO_S8: {
+      const int sample = *((Sint8 *) dst) + (*((const Sint8 *) src) * volume) / SDL_MIX_MAXVOLUME;
+      *((Sint8 *) dst) = (Sint8) ((sample < -128) ? -128 : (sample > 127) ? 127 : sample);
+      break;
+    }
+    case AUDIO_S16SYS: {
+      const int sample = *((Sint16 *) dst) + (*((const Sint16 *) src) * volume) / SDL_MIX_MAXVOLUME;
+      *((Sint16 *) dst) = (Sint16) ((sample < -32768) ? -32768 : (sample > 32767) ? 32767 : sample);
+      break;
+    }
+    case AUDIO_U16SYS: {
+      const int sample = *((Uint16 *) dst) + (*((const Uint16 *) src) * volume) / SDL_MIX_MAXVOLUME;
+      *((Uint16 *) dst) = (Uint16) ((sample > 0xFFFF) ? 0xFFFF : sample);
+      break;
+    }
+    case AUDIO_S32SYS: {
+      const Sint64 sample = *((Sint32 *) dst) + (((Sint64) *((const Sint32 *) src)) * volume) / SDL_MIX_MAXVOLUME;
+      *((Sint32 *) dst) = (Sint32) ((sample < -2147483647 - 1) ? -2147483647 - 1 : (sample > 2147483647) ? 2147483647 : sample);
+      break;
+    }
+    default: {
+      const float scaled = (*((const float *) src) * (float) volume) * (1.0f / SDL_MIX_MAXVOLUME);
+      const double sample = (double) scaled + (double) *((float *) dst);
+      *((float *) dst) = (float) ((sample > 3.402823466e+38F) ? 3.402823466e+38F : (sample < -3.402823466e+38F) ? -3.402823466e+38F : sample);
+      break;
+    }
+  }
+}
+
+/* Fill a buffer with random samples, loud enough that mixing clips some of them */
+static void _fillRandomSamples(SDL_AudioFormat format, Uint8 *buf, int count)
+{
+  int i;
+  for (i = 0; i < count; i++) {
+    if (format == AUDIO_F32SYS) {
+      ((float *) buf)[i] = (SDLTest_RandomUnitFloat() * 2.0f) - 1.0f;
+    } else {
+      const Uint32 bits = SDLTest_RandomUint32();
+      SDL_memcpy(buf + i * (SDL_AUDIO_BITSIZE(format) / 8), &bits, SDL_AUDIO_BITSIZE(format) / 8);
+    }
+  }
+}
+
+/**
+ * \brief Checks SDL_MixAudioFormat against a scalar reference at every length and alignment.
+ *
+ * \sa https://wiki.libsdl.org/SDL_MixAudioFormat
+ */
+int audio_mixAudioFormat()
+{
+  const SDL_AudioFormat formats[] = { AUDIO_U8, AUDIO_S8, AUDIO_S16SYS, AUDIO_U16SYS, AUDIO_S32SYS, AUDIO_F32SYS };
+  const char *formatNames[] = { "AUDIO_U8", "AUDIO_S8", "AUDIO_S16SYS", "AUDIO_U16SYS", "AUDIO_S32SYS", "AUDIO_F32SYS" };
+  const int volumes[] = { 1, 37, 64, 127, SDL_MIX_MAXVOLUME };
+  Uint8 src[80 * 4 + 16], dst[80 * 4 + 16], expected[80 * 4 + 16];
+  int f, v, i, count, offset;
+
+  for (f = 0; f < SDL_arraysize(formats); f++) {
+    const int samplesize = SDL_AUDIO_BITSIZE(formats[f]) / 8;
+    int mismatches = 0;
+
+    for (v = 0; v < SDL_arraysize(volumes); v++) {
+      for (count = 0; count <= 80; count += 3) {
+        for (offset = 0; offset < 16; offset += samplesize) {
+          _fillRandomSamples(formats[f], src + offset, count);
+          _fillRandomSamples(formats[f], dst + offset, count);
+          SDL_memcpy(expected, dst, sizeof (dst));
+          for (i = 0; i < count; i++) {
+            _mixSample(formats[f], expected + offset + i * samplesize, src + offset + i * samplesize, volumes[v]);
+          }
+
+          SDL_MixAudioFormat(dst + offset, src + offset, formats[f], count * samplesize, volumes[v]);
+          if (SDL_memcmp(dst, expected, sizeof (dst)) != 0) {
+            mismatches++;
+          }
+        }
+      }
+    }
+
+    SDLTest_AssertPass("Call to SDL_MixAudioFormat(%s) at various lengths, offsets and volumes", formatNames[f]);
+    SDLTest_AssertCheck(mismatches == 0, "Verify mixed samples match the scalar reference; %i buffers differ", mismatches);
+  }
+
+  return TEST_COMPLETED;
+}
+
+/**
+ * \brief Mixes several buffers at once with SDL_MixAudioFormatMulti.
+ *
+ * \sa https://wiki.libsdl.org/SDL_MixAudioFormatMulti
+ */
+int audio_mixAudioFormatMulti()
+{
+  const int count = 1000;  /* more than one chunk, and not a whole number of SIMD blocks */
+  Sint16 sources[4][1000];
+  Sint16 dst[1000], expected16[1000];
+  const Uint8 *srcs[5];
+  int volumes[5] = { SDL_MIX_MAXVOLUME, SDL_MIX_MAXVOLUME, SDL_MIX_MAXVOLUME, SDL_MIX_MAXVOLUME, SDL_MIX_MAXVOLUME };
+  float fsources[2][1000];
+  float fdst[1000], fexpected[1000];
+  Uint8 u8src[1000], u8dst[1000], u8expected[1000];
+  Sint32 s32sources[3][1000];
+  Sint32 s32dst[1000], s32expected[1000];
+  int i, j, mismatches;
+
+  for (i = 0; i < 4; i++) {
+    for (j = 0; j < count; j++) {
+      sources[i][j] = (Sint16) SDLTest_RandomIntegerInRange(-20000, 20000);
+    }
+    srcs[i] = (const Uint8 *) sources[i];
+  }
+  srcs[4] = NULL;  /* skipped */
+
+  /* Full volume: loud sources should only clip once, at the end */
+  for (j = 0; j < count; j++) {
+    dst[j] = (Sint16) SDLTest_RandomIntegerInRange(-20000, 20000);
+    expected16[j] = dst[j];
+  }
+  SDL_MixAudioFormatMulti((Uint8 *) dst, srcs, volumes, 5, AUDIO_S16SYS, count * sizeof (Sint16));
+  SDLTest_AssertPass("Call to SDL_MixAudioFormatMulti(AUDIO_S16SYS) with 4 sources at full volume");
+  mismatches = 0;
+  for (j = 0; j < count; j++) {
+    /* the accumulator is float, but these sums are all exact integers */
+    const int sum = expected16[j] + sources[0][j] + sources[1][j] + sources[2][j] + sources[3][j];
+    const int expected = (sum < -32768) ? -32768 : (sum > 32767) ? 32767 : sum;
+    if (dst[j] != expected) {
+      mismatches++;
+    }
+  }
+  SDLTest_AssertCheck(mismatches == 0, "Verify the sum of 4 sources clips once; %i samples differ", mismatches);
+
+  /* Partial volume: a quiet mix of loud sources doesn't clip at all */
+  volumes[0] = volumes[1] = volumes[2] = volumes[3] = 32;
+  SDL_memset(dst, 0, sizeof (dst));
+  SDL_MixAudioFormatMulti((Uint8 *) dst, srcs, volumes, 4, AUDIO_S16SYS, count * sizeof (Sint16));
+  SDLTest_AssertPass("Call to SDL_MixAudioFormatMulti(AUDIO_S16SYS) with 4 sources at quarter volume");
+  mismatches = 0;
+  for (j = 0; j < count; j++) {
+    const double sum = (sources[0][j] + sources[1][j] + sources[2][j] + sources[3][j]) / 4.0;
+    const int expected = (int) sum;  /* truncated, like the converters */
+    if (dst[j] != expected) {
+      mismatches++;
+    }
+  }
+  SDLTest_AssertCheck(mismatches == 0, "Verify the quarter volume mix; %i samples differ", mismatches);
+
+  /* Float: one source at a time gives the same result as SDL_MixAudioFormat */
+  for (i = 0; i < 2; i++) {
+    for (j = 0; j < count; j++) {
+      fsources[i][j] = (SDLTest_RandomUnitFloat() * 2.0f) - 1.0f;
+    }
+    srcs[i] = (const Uint8 *) fsources[i];
+  }
+  for (j = 0; j < count; j++) {
+    fdst[j] = fexpected[j] = (SDLTest_RandomUnitFloat() * 2.0f) - 1.0f;
+  }
+  volumes[0] = 100;
+  SDL_MixAudioFormat((Uint8 *) fexpected, srcs[0], AUDIO_F32SYS, count * sizeof (float), volumes[0]);
+  SDL_MixAudioFormatMulti((Uint8 *) fdst, srcs, volumes, 1, AUDIO_F32SYS, count * sizeof (float));
+  SDLTest_AssertPass("Call to SDL_MixAudioFormatMulti(AUDIO_F32SYS) with 1 source");
+  SDLTest_AssertCheck(SDL_memcmp(fdst, fexpected, sizeof (fdst)) == 0, "Verify the float mix matches SDL_MixAudioFormat");
+
+  /* Unsigned formats mix around their silence value */
+  SDL_memset(u8src, 0x80, sizeof (u8src));
+  SDL_memset(u8dst, 0x80, sizeof (u8dst));
+  srcs[0] = srcs[1] = u8src;
+  volumes[0] = volumes[1] = SDL_MIX_MAXVOLUME;
+  SDL_MixAudioFormatMulti(u8dst, srcs, volumes, 2, AUDIO_U8, sizeof (u8dst));
+  SDLTest_AssertPass("Call to SDL_MixAudioFormatMulti(AUDIO_U8) with 2 silent sources");
+  mismatches = 0;
+  for (j = 0; j < count; j++) {
+    if (u8dst[j] != 0x80) {
+      mismatches++;
+    }
+  }
+  SDLTest_AssertCheck(mismatches == 0, "Verify mixing silence stays silent; %i samples differ", mismatches);
+
+  /* Loud unsigned 8-bit mixes top out where SDL_MixAudioFormat's do */
+  SDL_memset(u8src, 0xFF, sizeof (u8src));
+  SDL_memset(u8dst, 0xFF, sizeof (u8dst));
+  SDL_MixAudioFormatMulti(u8dst, srcs, volumes, 2, AUDIO_U8, sizeof (u8dst));
+  SDLTest_AssertPass("Call to SDL_MixAudioFormatMulti(AUDIO_U8) with 2 loud sources");
+  SDL_memset(u8expected, 0xFF, sizeof (u8expected));
+  SDL_MixAudioFormat(u8expected, u8src, AUDIO_U8, sizeof (u8expected), SDL_MIX_MAXVOLUME);
+  mismatches = 0;
+  for (j = 0; j < count; j++) {
+    if (u8dst[j] != 0xFE || u8expected[j] != 0xFE) {
+      mismatches++;
+    }
+  }
+  SDLTest_AssertCheck(mismatches == 0, "Verify both mixers clip AUDIO_U8 to 0xFE; %i samples differ", mismatches);
+
+  /* With nothing to add, dst is left alone, even where a mix would clip it */
+  srcs[0] = NULL;
+  srcs[1] = u8src;
+  volumes[1] = 0;
+  SDL_memset(u8dst, 0xFF, sizeof (u8dst));
+  SDL_MixAudioFormatMulti(u8dst, srcs, volumes, 2, AUDIO_U8, sizeof (u8dst));
+  SDLTest_AssertPass("Call to SDL_MixAudioFormatMulti(AUDIO_U8) with no source to add");
+  mismatches = 0;
+  for (j = 0; j < count; j++) {
+    if (u8dst[j] != 0xFF) {
+      mismatches++;
+    }
+  }
+  SDLTest_AssertCheck(mismatches == 0, "Verify dst is untouched; %i samples differ", mismatches);
+
+  /* 32-bit samples are mixed exactly, the same as one SDL_MixAudioFormat call
+     per source, as long as those don't clip. Floats would lose the low bits. */
+  for (i = 0; i < 3; i++) {
+    for (j = 0; j < count; j++) {
+      s32sources[i][j] = SDLTest_RandomIntegerInRange(-0x20000000, 0x20000000) | 1;
+    }
+    srcs[i] = (const Uint8 *) s32sources[i];
+  }
+  for (j = 0; j < count; j++) {
+    s32dst[j] = s32expected[j] = SDLTest_RandomIntegerInRange(-0x20000000, 0x20000000);
+  }
+  volumes[0] = SDL_MIX_MAXVOLUME;
+  volumes[1] = 77;
+  volumes[2] = 3;
+  for (i = 0; i < 3; i++) {
+    SDL_MixAudioFormat((Uint8 *) s32expected, srcs[i], AUDIO_S32SYS, count * sizeof (Sint32), volumes[i]);
+  }
+  SDL_MixAudioFormatMulti((Uint8 *) s32dst, srcs, volumes, 3, AUDIO_S32SYS, count * sizeof (Sint32));
+  SDLTest_AssertPass("Call to SDL_MixAudioFormatMulti(AUDIO_S32SYS) with 3 sources");
+  mismatches = 0;
+  for (j = 0; j < count; j++) {
+    if (s32dst[j] != s32expected[j]) {
+      mismatches++;
+    }
+  }
+  SDLTest_AssertCheck(mismatches == 0, "Verify the 32-bit mix matches SDL_MixAudioFormat; %i samples differ", mismatches);
+
+  /* Unknown formats are an error */
+  SDL_ClearError();
+  SDL_MixAudioFormatMulti((Uint8 *) dst, srcs, volumes, 1, 0x1234, sizeof (dst));
+  SDLTest_AssertPass("Call to SDL_MixAudioFormatMulti() with an invalid format");
+  SDLTest_AssertCheck(SDL_strlen(SDL_GetError()) > 0, "Verify an error was set");
+  SDL_ClearError();
+
+  return TEST_COMPLETED;
+}
+
+/**
+ * \brief Queue audio through the lock-free ring buffer
+ *
+ * \sa https://wiki.libsdl.org/SDL_QueueAudio
+ * \sa https://wiki.libsdl.org/SDL_GetQueuedAudioSize
+ * \sa https://wiki.libsdl.org/SDL_ClearQueuedAudio
+ */
+int audio_queueAudioRing()
+{
+  SDL_AudioSpec desired;
+  SDL_AudioDeviceID id;
+  Uint8 chunk[256];
+  Uint32 total, queued;
+  int ret, i;
+
+  SDL_SetHint(SDL_HINT_AUDIO_QUEUE_CAPACITY, "4096");
+  SDLTest_AssertPass("Call to SDL_SetHint(SDL_HINT_AUDIO_QUEUE_CAPACITY, \"4096\")");
+
+  SDL_zero(desired);
+  desired.freq = 22050;
+  desired.format = AUDIO_S16SYS;
+  desired.channels = 1;
+  desired.samples = 512;
+  id = SDL_OpenAudioDevice(NULL, 0, &desired, NULL, 0);
+  SDLTest_AssertPass("Call to SDL_OpenAudioDevice() without a callback");
+  SDL_SetHint(SDL_HINT_AUDIO_QUEUE_CAPACITY, NULL);
+  if (id == 0) {
+    SDLTest_Log("No device to test with: %s", SDL_GetError());
+    return TEST_SKIPPED;
+  }
+
+  /* Fill it up while paused; it's a fixed size, so it has to run out */
+  SDL_memset(chunk, 0, sizeof (chunk));
+  total = 0;
+  for (i = 0; i < 1024 * 1024 / sizeof (chunk); i++) {
+    if (SDL_QueueAudio(id, chunk, sizeof (chunk)) < 0) {
+      break;
+    }
+    total += sizeof (chunk);
+  }
+  SDLTest_AssertCheck(total >= 4096, "Verify at least the requested capacity fits; queued %u bytes", (unsigned int) total);
+  SDLTest_AssertCheck((total & (total - 1)) == 0, "Verify the capacity is a power of two; got %u", (unsigned int) total);
+  queued = SDL_GetQueuedAudioSize(id);
+  SDLTest_AssertCheck(queued == total, "Verify SDL_GetQueuedAudioSize(); expected %u, got %u", (unsigned int) total, (unsigned int) queued);
+
+  /* A full queue refuses data instead of growing, and doesn't take part of it */
+  ret = SDL_QueueAudio(id, chunk, 2);
+  SDLTest_AssertCheck(ret == -1, "Verify SDL_QueueAudio() fails on a full queue; got %i", ret);
+  queued = SDL_GetQueuedAudioSize(id);
+  SDLTest_AssertCheck(queued == total, "Verify nothing was queued; expected %u, got %u", (unsigned int) total, (unsigned int) queued);
+
+  SDL_ClearQueuedAudio(id);
+  SDLTest_AssertPass("Call to SDL_ClearQueuedAudio()");
+  queued = SDL_GetQueuedAudioSize(id);
+  SDLTest_AssertCheck(queued == 0, "Verify the queue is empty; got %u", (unsigned int) queued);
+
+  /* Now let the device play it; it should drain in well under a second */
+  ret = SDL_QueueAudio(id, chunk, sizeof (chunk));
+  SDLTest_AssertCheck(ret == 0, "Verify SDL_QueueAudio() works after a clear; got %i", ret);
+  SDL_PauseAudioDevice(id, 0);
+  for (i = 0; (i < 200) && (SDL_GetQueuedAudioSize(id) > 0); i++) {
+    SDL_Delay(10);
+  }
+  queued = SDL_GetQueuedAudioSize(id);
+  SDLTest_AssertCheck(queued == 0, "Verify the device drained the queue; %u bytes left", (unsigned int) queued);
+
+  SDL_CloseAudioDevice(id);
+  SDLTest_AssertPass("Call to SDL_CloseAudioDevice()");
+
+  return TEST_COMPLETED;
+}
+
+
+/**
+ * \brief Read converted audio out of a stream in place
+ *
+ * \sa https://wiki.libsdl.org/SDL_AudioStreamPeek
+ * \sa https://wiki.libsdl.org/SDL_AudioStreamCommit
+ */
+int audio_audioStreamPeekCommit()
+{
+  Sint16 input[1024 * 2];
+  float viaGet[4096 * 2], viaPeek[4096 * 2];
+  SDL_AudioStream *streamA, *streamB;
+  const void *data = NULL;
+  int totalA = 0, totalB = 0;
+  int i, len, ret, offset;
+
+  for (i = 0; i < SDL_arraysize(input); i++) {
+    input[i] = (Sint16) SDLTest_RandomSint16();
+  }
+
+  /* Passthrough: what comes out is exactly what went in */
+  streamA = SDL_NewAudioStream(AUDIO_S16SYS, 2, 44100, AUDIO_S16SYS, 2, 44100);
+  SDLTest_AssertPass("Call to SDL_NewAudioStream() without conversion");
+  SDLTest_AssertCheck(streamA != NULL, "Validate stream is not NULL");
+  if (streamA == NULL) {
+    return TEST_ABORTED;
+  }
+  ret = SDL_AudioStreamPut(streamA, input, sizeof (input));
+  SDLTest_AssertCheck(ret == 0, "Verify SDL_AudioStreamPut(); got %i", ret);
+  len = SDL_AudioStreamPeek(streamA, &data);
+  SDLTest_AssertPass("Call to SDL_AudioStreamPeek()");
+  SDLTest_AssertCheck(len == sizeof (input), "Verify all the data can be peeked at once; expected %i, got %i", (int) sizeof (input), len);
+  SDLTest_AssertCheck(data != NULL && SDL_memcmp(data, input, sizeof (input)) == 0, "Verify peeked data matches the input");
+
+  /* Partial and oversized commits are refused */
+  ret = SDL_AudioStreamCommit(streamA, 2);
+  SDLTest_AssertCheck(ret == -1, "Verify committing half a sample frame fails; got %i", ret);
+  ret = SDL_AudioStreamCommit(streamA, len + 4);
+  SDLTest_AssertCheck(ret == -1, "Verify committing more than available fails; got %i", ret);
+
+  ret = SDL_AudioStreamCommit(streamA, 400);
+  SDLTest_AssertCheck(ret == 0, "Verify SDL_AudioStreamCommit(); got %i", ret);
+  len = SDL_AudioStreamPeek(streamA, &data);
+  SDLTest_AssertCheck(len == sizeof (input) - 400, "Verify the commit removed 400 bytes; got %i left", len);
+  SDLTest_AssertCheck(SDL_memcmp(data, ((Uint8 *) input) + 400, len) == 0, "Verify the rest of the data is still there");
+  SDLTest_AssertCheck(SDL_AudioStreamAvailable(streamA) == len, "Verify SDL_AudioStreamAvailable() agrees with SDL_AudioStreamPeek()");
+  SDL_FreeAudioStream(streamA);
+
+  /* Resampling: peek/commit hands out the same data as SDL_AudioStreamGet() */
+  streamA = SDL_NewAudioStream(AUDIO_S16SYS, 2, 44100, AUDIO_F32SYS, 2, 48000);
+  streamB = SDL_NewAudioStream(AUDIO_S16SYS, 2, 44100, AUDIO_F32SYS, 2, 48000);
+  SDLTest_AssertPass("Call to SDL_NewAudioStream() with resampling");
+  SDLTest_AssertCheck(streamA != NULL && streamB != NULL, "Validate streams are not NULL");
+  if (streamA == NULL || streamB == NULL) {
+    SDL_FreeAudioStream(streamA);
+    SDL_FreeAudioStream(streamB);
+    return TEST_ABORTED;
+  }
+
+  /* odd chunk sizes, reading a bit in between, so the output has to slide down */
+  for (offset = 0; offset < SDL_arraysize(input); offset += len / sizeof (Sint16)) {
+    len = SDL_min(SDLTest_RandomIntegerInRange(1, 300) * 4, (int) ((SDL_arraysize(input) - offset) * sizeof (Sint16)));
+    SDL_AudioStreamPut(streamA, input + offset, len);
+    SDL_AudioStreamPut(streamB, input + offset, len);
+
+    totalA += SDL_AudioStreamGet(streamA, ((Uint8 *) viaGet) + totalA, 256);
+    ret = SDL_AudioStreamPeek(streamB, &data);
+    ret = SDL_min(ret, 256);
+    SDL_memcpy(((Uint8 *) viaPeek) + totalB, data, ret);
+    SDL_AudioStreamCommit(streamB, ret);
+    totalB += ret;
+  }
+  SDL_AudioStreamFlush(streamA);
+  SDL_AudioStreamFlush(streamB);
+  totalA += SDL_AudioStreamGet(streamA, ((Uint8 *) viaGet) + totalA, sizeof (viaGet) - totalA);
+  ret = SDL_AudioStreamPeek(streamB, &data);
+  SDL_memcpy(((Uint8 *) viaPeek) + totalB, data, ret);
+  SDL_AudioStreamCommit(streamB, ret);
+  totalB += ret;
+
+  SDLTest_AssertCheck(totalA == totalB, "Verify both streams produced the same amount; got %i and %i", totalA, totalB);
+  SDLTest_AssertCheck(totalA > 0, "Verify the streams produced some data; got %i bytes", totalA);
+  SDLTest_AssertCheck(SDL_memcmp(viaGet, viaPeek, totalA) == 0, "Verify both streams produced the same data");
+  SDLTest_AssertCheck(SDL_AudioStreamAvailable(streamB) == 0, "Verify the committed stream is empty");
+
+  SDL_FreeAudioStream(streamA);
+  SDL_FreeAudioStream(streamB);
+
+  return TEST_COMPLETED;
+}
+
+/**
+ * \brief Change the resampling ratio of a live stream
+ *
+ * \sa https://wiki.libsdl.org/SDL_AudioStreamSetRateAdjust
+ */
+int audio_audioStreamRateAdjust()
+{
+  const float adjusts[] = { 0.99f, 1.01f, 0.0f };  /* 0 means alternate between 0.99 and 1.01 */
+  float input[441];
+  float *output;
+  SDL_AudioStream *stream;
+  double phase;
+  int a, i, chunk, ret, frames, failures;
+
+  /* Only resampling streams, and only small adjustments */
+  stream = SDL_NewAudioStream(AUDIO_F32SYS, 1, 48000, AUDIO_F32SYS, 1, 48000);
+  SDLTest_AssertCheck(stream != NULL, "Validate stream is not NULL");
+  ret = SDL_AudioStreamSetRateAdjust(stream, 1.01f);
+  SDLTest_AssertCheck(ret == -1, "Verify a stream that doesn't resample can't be adjusted; got %i", ret);
+  SDL_FreeAudioStream(stream);
+
+  stream = SDL_NewAudioStream(AUDIO_F32SYS, 1, 44100, AUDIO_F32SYS, 1, 48000);
+  SDLTest_AssertCheck(stream != NULL, "Validate stream is not NULL");
+  ret = SDL_AudioStreamSetRateAdjust(stream, 2.0f);
+  SDLTest_AssertCheck(ret == -1, "Verify an adjustment of 2.0 is refused; got %i", ret);
+  ret = SDL_AudioStreamSetRateAdjust(NULL, 1.0f);
+  SDLTest_AssertCheck(ret == -1, "Verify a NULL stream is refused; got %i", ret);
+  SDL_FreeAudioStream(stream);
+
+  output = (float *) SDL_malloc(60000 * sizeof (float));
+  SDLTest_AssertCheck(output != NULL, "Validate output buffer is not NULL");
+  if (output == NULL) {
+    return TEST_ABORTED;
+  }
+
+  for (a = 0; a < SDL_arraysize(adjusts); a++) {
+    /* the last 512 input frames are held back as resampler padding, and
+       100 puts of 441 frames leave 68 in the staging buffer */
+    const double consumed = 44100 - 512 - 68;
+    const double expected = (adjusts[a] == 0.0f) ? (consumed * 48000.0 / 44100.0) : (consumed * 48000.0 / (44100.0 * adjusts[a]));
+    float maxdelta = 0.0f;
+
+    stream = SDL_NewAudioStream(AUDIO_F32SYS, 1, 44100, AUDIO_F32SYS, 1, 48000);
+    SDLTest_AssertCheck(stream != NULL, "Validate stream is not NULL");
+    if (stream == NULL) {
+      break;
+    }
+
+    /* one second of a 440Hz sine at half volume */
+    phase = 0.0;
+    frames = 0;
+    failures = 0;
+    for (chunk = 0; chunk < 100; chunk++) {
+      const float adjust = (adjusts[a] != 0.0f) ? adjusts[a] : ((chunk & 1) ? 0.99f : 1.01f);
+      for (i = 0; i < SDL_arraysize(input); i++) {
+        input[i] = (float) (0.5 * SDL_sin(phase));
+        phase += 2.0 * M_PI * 440.0 / 44100.0;
+      }
+      if (SDL_AudioStreamSetRateAdjust(stream, adjust) < 0) {
+        failures++;
+      }
+      SDL_AudioStreamPut(stream, input, sizeof (input));
+      frames += SDL_AudioStreamGet(stream, output + frames, (60000 - frames) * sizeof (float)) / sizeof (float);
+    }
+
+    SDLTest_AssertCheck(failures == 0, "Verify SDL_AudioStreamSetRateAdjust() succeeded; %i calls failed", failures);
+    if (adjusts[a] != 0.0f) {
+      SDLTest_AssertCheck(SDL_fabs(frames - expected) <= 1.0, "Verify the output length; expected %.1f frames, got %i", expected, frames);
+    } else {
+      /* the staging buffer doesn't line up with the puts, so this is only close */
+      SDLTest_AssertCheck(SDL_fabs(frames - expected) <= 50.0, "Verify the output length; expected about %.1f frames, got %i", expected, frames);
+    }
+
+    /* Output position doesn't jump between puts: the sine never moves
+       faster than it can, about 0.029 per frame at 48000Hz (1% more when sped up) */
+    for (i = 600; i < frames; i++) {
+      maxdelta = SDL_max(maxdelta, (float) SDL_fabs(output[i] - output[i - 1]));
+    }
+    SDLTest_AssertCheck(maxdelta < 0.0300f, "Verify the output is continuous; largest step is %f", maxdelta);
+
+    SDL_FreeAudioStream(stream);
+  }
+
+  SDL_free(output);
+  return TEST_COMPLETED;
+}
+
+/**
+ * \brief Check that an adjustment of 1.0 resamples exactly like no adjustment
+ *
+ * \sa https://wiki.libsdl.org/SDL_AudioStreamSetRateAdjust
+ */
+int audio_audioStreamRateAdjustNominal()
+{
+  const float adjusts[] = { 1.0f, 1.05f, 0.95f };  /* each set before 1.0 */
+  float input[441];
+  float *expected, *output;
+  SDL_AudioStream *stream;
+  double phase;
+  int a, i, chunk, expectedlen, outputlen;
+
+  expected = (float *) SDL_malloc(2 * 20000 * sizeof (float));
+  SDLTest_AssertCheck(expected != NULL, "Validate output buffer is not NULL");
+  if (expected == NULL) {
+    return TEST_ABORTED;
+  }
+  output = expected + 20000;
+
+  /* a = -1 is the stream that's never adjusted */
+  for (a = -1; a < (int) SDL_arraysize(adjusts); a++) {
+    float *buf = (a < 0) ? expected : output;
+    int len = 0;
+
+    stream = SDL_NewAudioStream(AUDIO_F32SYS, 1, 44100, AUDIO_F32SYS, 1, 48000);
+    SDLTest_AssertCheck(stream != NULL, "Validate stream is not NULL");
+    if (stream == NULL) {
+      break;
+    }
+    if (a >= 0) {
+      SDLTest_AssertCheck(SDL_AudioStreamSetRateAdjust(stream, adjusts[a]) == 0, "Verify SDL_AudioStreamSetRateAdjust(%f)", adjusts[a]);
+      SDLTest_AssertCheck(SDL_AudioStreamSetRateAdjust(stream, 1.0f) == 0, "Verify SDL_AudioStreamSetRateAdjust(1.0)");
+    }
+
+    /* 0.4 seconds of a 440Hz sine at half volume */
+    phase = 0.0;
+    for (chunk = 0; chunk < 40; chunk++) {
+      for (i = 0; i < SDL_arraysize(input); i++) {
+        input[i] = (float) (0.5 * SDL_sin(phase));
+        phase += 2.0 * M_PI * 440.0 / 44100.0;
+      }
+      SDL_AudioStreamPut(stream, input, sizeof (input));
+      len += SDL_AudioStreamGet(stream, ((Uint8 *) buf) + len, (20000 * sizeof (float)) - len);
+    }
+    SDL_AudioStreamFlush(stream);
+    len += SDL_AudioStreamGet(stream, ((Uint8 *) buf) + len, (20000 * sizeof (float)) - len);
+    SDL_FreeAudioStream(stream);
+
+    if (a < 0) {
+      expectedlen = len;
+    } else {
+      outputlen = len;
+      SDLTest_AssertCheck(outputlen == expectedlen && SDL_memcmp(expected, output, expectedlen) == 0,
+                          "Verify adjusting by %f and back to 1.0 matches an unadjusted stream; expected %i bytes, got %i",
+                          adjusts[a], expectedlen, outputlen);
+    }
+  }
+
+  SDL_free(expected);
+  return TEST_COMPLETED;
+}
+
+
+/* Builds a little-endian WAVE file in buf: a format chunk, a chunk to skip,
+   and (datalen) bytes of noise. Returns the file size. */
+static int
+_audio_makeWAV(Uint8 *buf, Uint16 encoding, Uint16 channels, Uint16 bits,
+               Uint16 blockalign, Uint16 samplesperblock, Uint32 datalen)
+{
+  Uint8 *p = buf;
+  Uint32 i, fmtlen = (encoding == 0x0011) ? 20 : 16;
+  Uint32 seed = 0x12345678;
+
+  SDL_memcpy(p, "RIFF", 4);
+  SDL_memcpy(p + 8, "WAVE", 4);
+  p += 12;
+  SDL_memcpy(p, "fmt ", 4);
+  *(Uint32 *) (p + 4) = SDL_SwapLE32(fmtlen);
+  *(Uint16 *) (p + 8) = SDL_SwapLE16(encoding);
+  *(Uint16 *) (p + 10) = SDL_SwapLE16(channels);
+  *(Uint32 *) (p + 12) = SDL_SwapLE32(22050);
+  *(Uint32 *) (p + 16) = 0;
+  *(Uint16 *) (p + 20) = SDL_SwapLE16(blockalign);
+  *(Uint16 *) (p + 22) = SDL_SwapLE16(bits);
+  if (encoding == 0x0011) {
+    *(Uint16 *) (p + 24) = SDL_SwapLE16(2);
+    *(Uint16 *) (p + 26) = SDL_SwapLE16(samplesperblock);
+  }
+  p += 8 + fmtlen;
+  SDL_memcpy(p, "junk", 4);
+  *(Uint32 *) (p + 4) = SDL_SwapLE32(4);
+  p += 12;
+  SDL_memcpy(p, "data", 4);
+  *(Uint32 *) (p + 4) = SDL_SwapLE32(datalen);
+  p += 8;
+  for (i = 0; i < datalen; i++) {
+    seed = (seed * 1103515245) + 12345;
+    p[i] = (Uint8) (seed >> 16);
+  }
+  if (encoding == 0x0011) {
+    /* keep the step index in each block header in range */
+    for (i = 0; i < datalen; i += blockalign) {
+      Uint16 c;
+      for (c = 0; c < channels; c++) {
+        p[i + (c * 4) + 2] %= 89;
+        p[i + (c * 4) + 3] = 0;
+      }
+    }
+  }
+  p += datalen;
+  *(Uint32 *) (buf + 4) = SDL_SwapLE32((Uint32) (p - buf) - 8);
+  return (int) (p - buf);
+}
+
+/**
+ * \brief Decode WAVE files a piece at a time, and compare with loading them at once.
+ *
+ * \sa https://wiki.libsdl.org/SDL_OpenWAVStream_RW
+ * \sa https://wiki.libsdl.org/SDL_ReadWAVStream
+ * \sa https://wiki.libsdl.org/SDL_ReadWAVStreamToAudioStream
+ */
+int audio_readWAVStream()
+{
+  /* encoding, channels, bits, blockalign, samples per block */
+  const Uint16 formats[][5] = {
+    { 0x0001, 2, 16, 4, 0 },
+    { 0x0001, 2, 24, 6, 0 },
+    { 0x0011, 1, 4, 256, 505 },
+    { 0x0011, 2, 4, 512, 505 },
+    { 0x0011, 6, 4, 1536, 505 }
+  };
+  const Uint32 datalen = 20000;
+  Uint8 *wav, *streamed;
+  int f;
+
+  wav = (Uint8 *) SDL_malloc(datalen + 128);
+  streamed = (Uint8 *) SDL_malloc(datalen * 4);
+  SDLTest_AssertCheck(wav != NULL && streamed != NULL, "Validate buffers were allocated");
+  if (wav == NULL || streamed == NULL) {
+    SDL_free(wav);
+    SDL_free(streamed);
+    return TEST_ABORTED;
+  }
+
+  for (f = 0; f < SDL_arraysize(formats); f++) {
+    const int wavlen = _audio_makeWAV(wav, formats[f][0], formats[f][1], formats[f][2], formats[f][3], formats[f][4], datalen);
+    SDL_AudioSpec spec, streamspec;
+    SDL_AudioStream *audiostream;
+    SDL_WAVStream *stream;
+    Uint8 *loaded = NULL;
+    Uint32 loadedlen = 0;
+    int framesize, total, amount, chunk;
+
+    SDLTest_AssertCheck(SDL_LoadWAV_RW(SDL_RWFromConstMem(wav, wavlen), 1, &spec, &loaded, &loadedlen) != NULL,
+                        "Validate SDL_LoadWAV_RW() on format 0x%.4x, %d channels", formats[f][0], formats[f][1]);
+    if (loaded == NULL) {
+      continue;
+    }
+
+    /* read it in odd-sized pieces */
+    stream = SDL_OpenWAVStream_RW(SDL_RWFromConstMem(wav, wavlen), 1, &streamspec);
+    SDLTest_AssertCheck(stream != NULL, "Validate SDL_OpenWAVStream_RW()");
+    if (stream == NULL) {
+      SDL_FreeWAV(loaded);
+      continue;
+    }
+    SDLTest_AssertCheck(streamspec.format == spec.format && streamspec.channels == spec.channels && streamspec.freq == spec.freq,
+                        "Verify the stream reports the same format as SDL_LoadWAV_RW()");
+    framesize = (SDL_AUDIO_BITSIZE(streamspec.format) / 8) * streamspec.channels;
+    SDLTest_AssertCheck(SDL_ReadWAVStream(stream, streamed, framesize + 1) == -1, "Verify partial frames are rejected");
+    total = 0;
+    chunk = 1;
+    do {
+      chunk = (chunk * 7) % 997;
+      amount = SDL_ReadWAVStream(stream, streamed + total, chunk * framesize);
+      total += (amount > 0) ? amount : 0;
+    } while (amount > 0);
+    SDLTest_AssertCheck(amount == 0, "Verify the stream ends without an error");
+    SDLTest_AssertCheck(total == (int) loadedlen, "Verify streamed length; expected %u, got %i", (unsigned int) loadedlen, total);
+    SDLTest_AssertCheck(total == (int) loadedlen && SDL_memcmp(loaded, streamed, total) == 0, "Verify streamed data matches SDL_LoadWAV_RW()");
+    SDL_CloseWAVStream(stream);
+
+    /* now through an audio stream that doesn't change anything */
+    stream = SDL_OpenWAVStream_RW(SDL_RWFromConstMem(wav, wavlen), 1, &streamspec);
+    audiostream = SDL_NewAudioStream(streamspec.format, streamspec.channels, streamspec.freq,
+                                     streamspec.format, streamspec.channels, streamspec.freq);
+    SDLTest_AssertCheck(stream != NULL && audiostream != NULL, "Validate streams were created");
+    if (stream != NULL && audiostream != NULL) {
+      total = 0;
+      while ((amount = SDL_ReadWAVStreamToAudioStream(stream, audiostream, 3001)) > 0) {
+        total += amount;
+      }
+      SDLTest_AssertCheck(amount == 0, "Verify SDL_ReadWAVStreamToAudioStream() ends without an error");
+      SDLTest_AssertCheck(total == (int) loadedlen, "Verify length put; expected %u, got %i", (unsigned int) loadedlen, total);
+      SDL_AudioStreamFlush(audiostream);
+      amount = SDL_AudioStreamGet(audiostream, streamed, ((datalen * 4) / framesize) * framesize);
+      SDLTest_AssertCheck(amount == (int) loadedlen && SDL_memcmp(loaded, streamed, amount) == 0, "Verify audio stream data matches SDL_LoadWAV_RW()");
+    }
+    SDL_FreeAudioStream(audiostream);
+    SDL_CloseWAVStream(stream);
+    SDL_FreeWAV(loaded);
+  }
+
+  SDL_free(wav);
+  SDL_free(streamed);
+  return TEST_COMPLETED;
+}
+
+
+/* Wraps a format chunk body and audio data up as a WAVE file in buf.
+   Returns the file size. */
+static int
+_audio_wrapWAV(Uint8 *buf, const Uint8 *fmt, Uint32 fmtlen, const Uint8 *data, Uint32 datalen)
+{
+  Uint8 *p = buf;
+
+  SDL_memcpy(p, "RIFF", 4);
+  *(Uint32 *) (p + 4) = SDL_SwapLE32(4 + 8 + fmtlen + 8 + datalen);
+  SDL_memcpy(p + 8, "WAVE", 4);
+  p += 12;
+  SDL_memcpy(p, "fmt ", 4);
+  *(Uint32 *) (p + 4) = SDL_SwapLE32(fmtlen);
+  SDL_memcpy(p + 8, fmt, fmtlen);
+  p += 8 + fmtlen;
+  SDL_memcpy(p, "data", 4);
+  *(Uint32 *) (p + 4) = SDL_SwapLE32(datalen);
+  SDL_memcpy(p + 8, data, datalen);
+  p += 8 + datalen;
+  return (int) (p - buf);
+}
+
+/* Loads a WAVE file with both SDL_LoadWAV_RW() and SDL_ReadWAVStream() and
+   checks each decodes to the expected samples. */
+static void
+_audio_checkWAV(const char *name, const Uint8 *wav, int wavlen, SDL_AudioFormat format,
+                const void *expected, Uint32 expectedlen)
+{
+  SDL_AudioSpec spec;
+  SDL_WAVStream *stream;
+  Uint8 *loaded = NULL;
+  Uint8 streamed[64];
+  Uint32 loadedlen = 0;
+  int amount;
+
+  SDLTest_AssertCheck(SDL_LoadWAV_RW(SDL_RWFromConstMem(wav, wavlen), 1, &spec, &loaded, &loadedlen) != NULL,
+                      "Validate SDL_LoadWAV_RW() on %s", name);
+  if (loaded != NULL) {
+    SDLTest_AssertCheck(spec.format == format, "Verify %s format; expected: 0x%.4x, got: 0x%.4x", name, format, spec.format);
+    SDLTest_AssertCheck(loadedlen == expectedlen, "Verify %s length; expected: %u, got: %u", name, (unsigned int) expectedlen, (unsigned int) loadedlen);
+    SDLTest_AssertCheck(loadedlen == expectedlen && SDL_memcmp(loaded, expected, expectedlen) == 0, "Verify %s samples", name);
+    SDL_FreeWAV(loaded);
+  }
+
+  stream = SDL_OpenWAVStream_RW(SDL_RWFromConstMem(wav, wavlen), 1, NULL);
+  SDLTest_AssertCheck(stream != NULL, "Validate SDL_OpenWAVStream_RW() on %s", name);
+  if (stream != NULL) {
+    amount = SDL_ReadWAVStream(stream, streamed, (int) expectedlen);
+    SDLTest_AssertCheck(amount == (int) expectedlen && SDL_memcmp(streamed, expected, expectedlen) == 0,
+                        "Verify %s streamed samples; expected length: %u, got: %i", name, (unsigned int) expectedlen, amount);
+    amount = SDL_ReadWAVStream(stream, streamed, sizeof (streamed));  /* whole frames of any of these files */
+    SDLTest_AssertCheck(amount == 0, "Verify %s stream ends; expected: 0, got: %i", name, amount);
+    SDL_CloseWAVStream(stream);
+  }
+}
+
+/**
+ * \brief Decode small WAVE files whose samples were worked out by hand.
+ *
+ * One MS ADPCM block, one IMA ADPCM block, and 24-bit PCM with a partial
+ * frame at the end. Also checks that SDL_LoadWAV_RW() refuses files that
+ * decode to more than it can return, and that a failed load still leaves
+ * the source at the end of the file when it isn't closed.
+ *
+ * \sa https://wiki.libsdl.org/SDL_LoadWAV_RW
+ * \sa https://wiki.libsdl.org/SDL_ReadWAVStream
+ */
+int audio_loadWAVKnownAnswers()
+{
+  /* mono, 8 samples in a 10-byte block, the standard coefficients */
+  const Uint8 msfmt[50] = {
+    0x02, 0x00, 0x01, 0x00, 0x22, 0x56, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0A, 0x00, 0x04, 0x00,
+    0x20, 0x00, 0x08, 0x00, 0x07, 0x00,
+    0x00, 0x01, 0x00, 0x00,  0x00, 0x02, 0x00, 0xFF,  0x00, 0x00, 0x00, 0x00,  0xC0, 0x00, 0x40, 0x00,
+    0xF0, 0x00, 0x00, 0x00,  0xCC, 0x01, 0x30, 0xFF,  0x88, 0x01, 0x18, 0xFF
+  };
+  /* predictor 1, delta 20, sample1 100, sample2 50, then nibbles 1 7 8 F 4 C */
+  const Uint8 msdata[10] = { 0x01, 0x14, 0x00, 0x64, 0x00, 0x32, 0x00, 0x17, 0x8F, 0x4C };
+  const Sint16 msexpected[8] = { 50, 100, 170, 359, 228, -23, 154, -181 };
+
+  /* stereo, 9 samples in a 16-byte block */
+  const Uint8 imafmt[20] = {
+    0x11, 0x00, 0x02, 0x00, 0x22, 0x56, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x04, 0x00,
+    0x02, 0x00, 0x09, 0x00
+  };
+  /* left starts at 0 with step index 0, right at -1000 with step index 40 */
+  const Uint8 imadata[16] = {
+    0x00, 0x00, 0x00, 0x00,  0x18, 0xFC, 0x28, 0x00,
+    0x31, 0x75, 0x9F, 0x0C,  0x77, 0x77, 0x88, 0x80
+  };
+  const Sint16 imaexpected[18] = {
+    0, -1000,  1, -369,  5, 988,  13, 3898,  32, 10134,
+    -9, 9243,  -27, 8433,  -77, 9169,  -71, 8500
+  };
+
+  /* mono, 5 samples in an 8-byte block: the 8-sample group is half used */
+  const Uint8 imashortfmt[20] = {
+    0x11, 0x00, 0x01, 0x00, 0x22, 0x56, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x08, 0x00, 0x04, 0x00,
+    0x02, 0x00, 0x05, 0x00
+  };
+  const Uint8 imashortdata[8] = { 0x00, 0x00, 0x00, 0x00,  0x31, 0x75, 0x9F, 0x0C };
+  const Sint16 imashortexpected[5] = { 0, 1, 5, 13, 32 };
+
+  /* stereo, three whole frames and four bytes of a fourth */
+  const Uint8 pcm24fmt[16] = {
+    0x01, 0x00, 0x02, 0x00, 0x22, 0x56, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x06, 0x00, 0x18, 0x00
+  };
+  const Uint8 pcm24data[22] = {
+    0x00, 0x00, 0x00,  0xFF, 0xFF, 0x7F,
+    0x00, 0x00, 0x80,  0x01, 0x00, 0x00,
+    0xFF, 0xFF, 0xFF,  0x00, 0x00, 0x40,
+    0x12, 0x34, 0x56, 0x78
+  };
+  const Sint32 pcm24expected[6] = { 0, 2147483391, -2147483647, 255, -255, 1073741823 };
+
+  Uint8 wav[128], badfmt[50], badblock[10], twoblocks[20], streamed[64];
+  SDL_AudioSpec spec;
+  SDL_WAVStream *stream;
+  Sint16 expected16[18];
+  Sint32 expected32[6];
+  SDL_RWops *rw;
+  Uint8 *loaded = NULL;
+  Uint32 loadedlen = 0;
+  int i, wavlen, amount;
+
+  /* the decoders write little-endian samples */
+  for (i = 0; i < SDL_arraysize(msexpected); i++) {
+    expected16[i] = (Sint16) SDL_SwapLE16(msexpected[i]);
+  }
+  wavlen = _audio_wrapWAV(wav, msfmt, sizeof (msfmt), msdata, sizeof (msdata));
+  _audio_checkWAV("MS ADPCM", wav, wavlen, AUDIO_S16LSB, expected16, sizeof (msexpected));
+
+  for (i = 0; i < SDL_arraysize(imaexpected); i++) {
+    expected16[i] = (Sint16) SDL_SwapLE16(imaexpected[i]);
+  }
+  wavlen = _audio_wrapWAV(wav, imafmt, sizeof (imafmt), imadata, sizeof (imadata));
+  _audio_checkWAV("IMA ADPCM", wav, wavlen, AUDIO_S16LSB, expected16, sizeof (imaexpected));
+
+  for (i = 0; i < SDL_arraysize(imashortexpected); i++) {
+    expected16[i] = (Sint16) SDL_SwapLE16(imashortexpected[i]);
+  }
+  wavlen = _audio_wrapWAV(wav, imashortfmt, sizeof (imashortfmt), imashortdata, sizeof (imashortdata));
+  _audio_checkWAV("IMA ADPCM with a partial group", wav, wavlen, AUDIO_S16LSB, expected16, sizeof (imashortexpected));
+
+  for (i = 0; i < SDL_arraysize(pcm24expected); i++) {
+    expected32[i] = (Sint32) SDL_SwapLE32(pcm24expected[i]);
+  }
+  wavlen = _audio_wrapWAV(wav, pcm24fmt, sizeof (pcm24fmt), pcm24data, sizeof (pcm24data));
+  _audio_checkWAV("24-bit PCM", wav, wavlen, AUDIO_S32LSB, expected32, sizeof (pcm24expected));
+
+  /* 3.75 GB of 24-bit data would decode to 5 GB. It's refused before
+     anything is read, so the file doesn't need to be that big. */
+  *(Uint32 *) (wav + wavlen - sizeof (pcm24data) - 4) = SDL_SwapLE32(0xF0000000);
+  SDLTest_AssertCheck(SDL_LoadWAV_RW(SDL_RWFromConstMem(wav, wavlen), 1, &spec, &loaded, &loadedlen) == NULL,
+                      "Verify SDL_LoadWAV_RW() refuses data that decodes to more than 4 GB");
+  stream = SDL_OpenWAVStream_RW(SDL_RWFromConstMem(wav, wavlen), 1, NULL);
+  SDLTest_AssertCheck(stream != NULL, "Verify SDL_OpenWAVStream_RW() still opens it");
+  SDL_CloseWAVStream(stream);
+
+  /* an MS ADPCM block with a predictor that doesn't exist can't be decoded */
+  SDL_memcpy(badblock, msdata, sizeof (msdata));
+  badblock[0] = 9;
+  wavlen = _audio_wrapWAV(wav, msfmt, sizeof (msfmt), badblock, sizeof (badblock));
+  rw = SDL_RWFromConstMem(wav, wavlen);
+  SDLTest_AssertCheck(rw != NULL, "Validate SDL_RWFromConstMem()");
+  if (rw != NULL) {
+    SDLTest_AssertCheck(SDL_LoadWAV_RW(rw, 0, &spec, &loaded, &loadedlen) == NULL, "Verify SDL_LoadWAV_RW() fails on a bad block");
+    SDLTest_AssertCheck(loaded == NULL, "Verify no buffer is returned");
+    SDLTest_AssertCheck(SDL_strstr(SDL_GetError(), "predictor") != NULL, "Verify the decoder's error is reported; got: %s", SDL_GetError());
+    SDLTest_AssertCheck(SDL_RWtell(rw) == wavlen, "Verify the source is left at the end of the file; expected: %i, got: %i", wavlen, (int) SDL_RWtell(rw));
+    SDL_RWclose(rw);
+  }
+
+  /* a good block before the bad one is still handed out by the stream */
+  SDL_memcpy(twoblocks, msdata, sizeof (msdata));
+  SDL_memcpy(twoblocks + sizeof (msdata), badblock, sizeof (badblock));
+  wavlen = _audio_wrapWAV(wav, msfmt, sizeof (msfmt), twoblocks, sizeof (twoblocks));
+  stream = SDL_OpenWAVStream_RW(SDL_RWFromConstMem(wav, wavlen), 1, NULL);
+  SDLTest_AssertCheck(stream != NULL, "Validate SDL_OpenWAVStream_RW() on a good and a bad block");
+  if (stream != NULL) {
+    for (i = 0; i < SDL_arraysize(msexpected); i++) {
+      expected16[i] = (Sint16) SDL_SwapLE16(msexpected[i]);
+    }
+    amount = SDL_ReadWAVStream(stream, streamed, 2 * sizeof (msexpected));
+    SDLTest_AssertCheck(amount == sizeof (msexpected) && SDL_memcmp(streamed, expected16, sizeof (msexpected)) == 0,
+                        "Verify the good block is returned; expected length: %i, got: %i", (int) sizeof (msexpected), amount);
+    SDL_SetError("");
+    amount = SDL_ReadWAVStream(stream, streamed, 2 * sizeof (msexpected));
+    SDLTest_AssertCheck(amount == -1, "Verify the bad block is an error; expected: -1, got: %i", amount);
+    SDL_CloseWAVStream(stream);
+  }
+
+  /* a data chunk cut short still gives the whole blocks that are there */
+  SDL_memcpy(twoblocks + sizeof (msdata), msdata, sizeof (msdata));
+  wavlen = _audio_wrapWAV(wav, msfmt, sizeof (msfmt), twoblocks, sizeof (twoblocks));
+  *(Uint32 *) (wav + wavlen - sizeof (twoblocks) - 4) = SDL_SwapLE32(3 * sizeof (msdata));
+  stream = SDL_OpenWAVStream_RW(SDL_RWFromConstMem(wav, wavlen), 1, NULL);
+  SDLTest_AssertCheck(stream != NULL, "Validate SDL_OpenWAVStream_RW() on a truncated file");
+  if (stream != NULL) {
+    amount = SDL_ReadWAVStream(stream, streamed, 3 * sizeof (msexpected));
+    SDLTest_AssertCheck(amount == 2 * sizeof (msexpected), "Verify the blocks that were there are returned; expected: %i, got: %i", (int) (2 * sizeof (msexpected)), amount);
+    SDLTest_AssertCheck(SDL_memcmp(streamed + sizeof (msexpected), expected16, sizeof (msexpected)) == 0, "Verify the second block's samples");
+    amount = SDL_ReadWAVStream(stream, streamed, sizeof (msexpected));
+    SDLTest_AssertCheck(amount == 0, "Verify the stream ends; expected: 0, got: %i", amount);
+    SDL_CloseWAVStream(stream);
+  }
+
+  /* a format that can't be used leaves the source at the end of the file too */
+  SDL_memcpy(badfmt, msfmt, sizeof (msfmt));
+  badfmt[20] = 6;  /* wNumCoef */
+  wavlen = _audio_wrapWAV(wav, badfmt, sizeof (badfmt), msdata, sizeof (msdata));
+  rw = SDL_RWFromConstMem(wav, wavlen);
+  SDLTest_AssertCheck(rw != NULL, "Validate SDL_RWFromConstMem()");
+  if (rw != NULL) {
+    SDLTest_AssertCheck(SDL_LoadWAV_RW(rw, 0, &spec, &loaded, &loadedlen) == NULL, "Verify SDL_LoadWAV_RW() fails on a bad format chunk");
+    SDLTest_AssertCheck(SDL_RWtell(rw) == wavlen, "Verify the source is left at the end of the file; expected: %i, got: %i", wavlen, (int) SDL_RWtell(rw));
+    SDL_RWclose(rw);
+  }
+
+  return TEST_COMPLETED;
+}
+
+/**
+ * \brief Check the timing statistics of an output device's audio thread.
+ *
+ * \sa https://wiki.libsdl.org/SDL_GetAudioDeviceStats
+ */
+int audio_getAudioDeviceStats()
+{
+  SDL_AudioSpec desired;
+  SDL_AudioDeviceStats stats;
+  SDL_AudioDeviceID id;
+  int ret, i;
+
+  /* Negative cases */
+  ret = SDL_GetAudioDeviceStats(0, &stats);
+  SDLTest_AssertCheck(ret == -1, "Verify SDL_GetAudioDeviceStats() fails on an invalid device; got %i", ret);
+
+  SDL_zero(desired);
+  desired.freq = 22050;
+  desired.format = AUDIO_S16SYS;
+  desired.channels = 2;
+  desired.samples = 512;
+  desired.callback = _audio_testCallback;
+  id = SDL_OpenAudioDevice(NULL, 0, &desired, NULL, 0);
+  SDLTest_AssertPass("Call to SDL_OpenAudioDevice()");
+  if (id == 0) {
+    SDLTest_Log("No device to test with: %s", SDL_GetError());
+    return TEST_SKIPPED;
+  }
+
+  ret = SDL_GetAudioDeviceStats(id, NULL);
+  SDLTest_AssertCheck(ret == -1, "Verify SDL_GetAudioDeviceStats() fails without a stats struct; got %i", ret);
+
+  /* The device starts paused, and plays silence without calling back */
+  SDL_Delay(100);
+  ret = SDL_GetAudioDeviceStats(id, &stats);
+  SDLTest_AssertCheck(ret == 0 && stats.callbacks == 0, "Verify a paused device doesn't count callbacks; counted %u", (unsigned int) stats.callbacks);
+
+  /* Let the audio thread run a few times */
+  SDL_PauseAudioDevice(id, 0);
+  SDL_zero(stats);
+  for (i = 0; (i < 200) && (stats.callbacks < 4); i++) {
+    SDL_Delay(10);
+    ret = SDL_GetAudioDeviceStats(id, &stats);
+  }
+  SDL_CloseAudioDevice(id);
+  SDLTest_AssertPass("Call to SDL_CloseAudioDevice()");
+
+  SDLTest_AssertCheck(ret == 0, "Verify SDL_GetAudioDeviceStats() succeeded; got %i", ret);
+  SDLTest_AssertCheck(stats.callbacks >= 4, "Verify the callback ran; ran %u times", (unsigned int) stats.callbacks);
+  SDLTest_AssertCheck(stats.max_callback_ticks <= stats.callback_ticks, "Verify the longest callback is no longer than all of them together");
+  SDLTest_AssertCheck(stats.max_iteration_ticks >= stats.max_callback_ticks, "Verify the longest trip through the loop includes the longest callback");
+
+  return TEST_COMPLETED;
+}
+
+
 /**
  * \brief Opens, checks current connected status, and closes a device.
  *
@@ -1022,11 +2189,47 @@ static const SDLTest_TestCaseReference audioTest14 =
 static const SDLTest_TestCaseReference audioTest15 =
         { (SDLTest_TestCaseFp)audio_pauseUnpauseAudio, "audio_pauseUnpauseAudio", "Pause and Unpause audio for various audio specs while testing callback.", TEST_ENABLED };
 
+static const SDLTest_TestCaseReference audioTest16 =
+        { (SDLTest_TestCaseFp)audio_convertSampleTypes, "audio_convertSampleTypes", "Compare the sample type converters with scalar reference code.", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference audioTest17 =
+        { (SDLTest_TestCaseFp)audio_mixAudioFormat, "audio_mixAudioFormat", "Compare SDL_MixAudioFormat with scalar reference code.", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference audioTest18 =
+        { (SDLTest_TestCaseFp)audio_mixAudioFormatMulti, "audio_mixAudioFormatMulti", "Mix several buffers at once with SDL_MixAudioFormatMulti.", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference audioTest19 =
+        { (SDLTest_TestCaseFp)audio_queueAudioRing, "audio_queueAudioRing", "Queue audio through the lock-free ring buffer.", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference audioTest20 =
+        { (SDLTest_TestCaseFp)audio_audioStreamPeekCommit, "audio_audioStreamPeekCommit", "Read converted audio out of a stream in place.", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference audioTest21 =
+        { (SDLTest_TestCaseFp)audio_audioStreamRateAdjust, "audio_audioStreamRateAdjust", "Change the resampling ratio of a live stream.", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference audioTest22 =
+        { (SDLTest_TestCaseFp)audio_readWAVStream, "audio_readWAVStream", "Decode WAVE files a piece at a time.", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference audioTest23 =
+        { (SDLTest_TestCaseFp)audio_getAudioDeviceStats, "audio_getAudioDeviceStats", "Check the timing statistics of an output device.", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference audioTest24 =
+        { (SDLTest_TestCaseFp)audio_convertU16ToF32, "audio_convertU16ToF32", "Convert known U16 samples to float.", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference audioTest25 =
+        { (SDLTest_TestCaseFp)audio_loadWAVKnownAnswers, "audio_loadWAVKnownAnswers", "Decode WAVE files with known samples.", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference audioTest26 =
+        { (SDLTest_TestCaseFp)audio_audioStreamRateAdjustNominal, "audio_audioStreamRateAdjustNominal", "Check an adjustment of 1.0 matches an unadjusted stream.", TEST_ENABLED };
+
 /* Sequence of Audio test cases */
 static const SDLTest_TestCaseReference *audioTests[] =  {
     &audioTest1, &audioTest2, &audioTest3, &audioTest4, &audioTest5, &audioTest6,
     &audioTest7, &audioTest8, &audioTest9, &audioTest10, &audioTest11,
-    &audioTest12, &audioTest13, &audioTest14, &audioTest15, NULL
+    &audioTest12, &audioTest13, &audioTest14, &audioTest15, &audioTest16,
+    &audioTest17, &audioTest18, &audioTest19, &audioTest20,
+    &audioTest21, &audioTest22, &audioTest23, &audioTest24, &audioTest25,
+    &audioTest26, NULL
 };
 
 /* Audio test suite (global) */
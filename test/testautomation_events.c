@@ -7,6 +7,12 @@
 #include "SDL.h"
 #include "SDL_test.h"
 
+#if defined(__LINUX__) || defined(__MACOSX__)
+#include <signal.h>
+#include <unistd.h>
+#define EVENTS_HAVE_KILL 1
+#endif
+
 /* ================= Test Case Implementation ================== */
 
 /* Test case functions */
@@ -175,6 +181,592 @@ events_addDelEventWatchWithUserdata(void *arg)
 }
 
 
+#define EVENTS_PUSH_THREADS 4
+#define EVENTS_PER_THREAD 5000
+
+/* Pushes numbered user events; odd threads use a second event type */
+static int SDLCALL _events_pushThread(void *arg)
+{
+   const int thread = (int)(size_t)arg;
+   SDL_Event event;
+   int i;
+
+   for (i = 0; i < EVENTS_PER_THREAD; i++) {
+      SDL_zero(event);
+      event.type = SDL_USEREVENT + (thread & 1);
+      event.user.code = thread;
+      event.user.data1 = (void *)(size_t)i;
+      while (SDL_PushEvent(&event) != 1) {
+         SDL_Delay(1);
+      }
+   }
+   return 0;
+}
+
+/**
+ * @brief Pushes events from several threads at once while polling, and checks none are lost or reordered.
+ *
+ * @sa http://wiki.libsdl.org/moin.cgi/SDL_PushEvent
+ * @sa http://wiki.libsdl.org/moin.cgi/SDL_PeepEvents
+ */
+int
+events_pushFromThreads(void *arg)
+{
+   SDL_Thread *threads[EVENTS_PUSH_THREADS];
+   int next[EVENTS_PUSH_THREADS];
+   int received[2] = { 0, 0 };
+   int misordered = 0;
+   int i, result;
+   SDL_Event event;
+   Uint32 start;
+
+   /* Start with an empty queue */
+   SDL_FlushEvents(SDL_FIRSTEVENT, SDL_LASTEVENT);
+
+   for (i = 0; i < EVENTS_PUSH_THREADS; i++) {
+      next[i] = 0;
+      threads[i] = SDL_CreateThread(_events_pushThread, "PushEvents", (void *)(size_t)i);
+      SDLTest_AssertCheck(threads[i] != NULL, "Check thread %d was created", i);
+   }
+
+   /* Take only the first event type while the threads are pushing */
+   start = SDL_GetTicks();
+   while (received[0] < (EVENTS_PUSH_THREADS / 2) * EVENTS_PER_THREAD && !SDL_TICKS_PASSED(SDL_GetTicks(), start + 10000)) {
+      result = SDL_PeepEvents(&event, 1, SDL_GETEVENT, SDL_USEREVENT, SDL_USEREVENT);
+      if (result == 1) {
+         if (event.user.code < 0 || event.user.code >= EVENTS_PUSH_THREADS || (int)(size_t)event.user.data1 != next[event.user.code]) {
+            misordered++;
+         } else {
+            next[event.user.code]++;
+         }
+         received[0]++;
+      }
+   }
+
+   for (i = 0; i < EVENTS_PUSH_THREADS; i++) {
+      SDL_WaitThread(threads[i], NULL);
+   }
+   SDLTest_AssertPass("Waited for all pushing threads");
+
+   /* The second type should all still be waiting, in order */
+   result = SDL_PeepEvents(NULL, 0, SDL_PEEKEVENT, SDL_USEREVENT + 1, SDL_USEREVENT + 1);
+   SDLTest_AssertCheck(result == (EVENTS_PUSH_THREADS / 2) * EVENTS_PER_THREAD, "Check queued events of the second type, expected: %d, got: %d", (EVENTS_PUSH_THREADS / 2) * EVENTS_PER_THREAD, result);
+   while (SDL_PollEvent(&event)) {
+      if (event.type != SDL_USEREVENT + 1) {
+         continue;
+      }
+      if (event.user.code < 0 || event.user.code >= EVENTS_PUSH_THREADS || (int)(size_t)event.user.data1 != next[event.user.code]) {
+         misordered++;
+      } else {
+         next[event.user.code]++;
+      }
+      received[1]++;
+   }
+
+   SDLTest_AssertCheck(received[0] == (EVENTS_PUSH_THREADS / 2) * EVENTS_PER_THREAD, "Check events of the first type, expected: %d, got: %d", (EVENTS_PUSH_THREADS / 2) * EVENTS_PER_THREAD, received[0]);
+   SDLTest_AssertCheck(received[1] == (EVENTS_PUSH_THREADS / 2) * EVENTS_PER_THREAD, "Check events of the second type, expected: %d, got: %d", (EVENTS_PUSH_THREADS / 2) * EVENTS_PER_THREAD, received[1]);
+   SDLTest_AssertCheck(misordered == 0, "Check each thread's events arrived in order, got %d out of order", misordered);
+
+   return TEST_COMPLETED;
+}
+
+
+/* Pushes a user event after a short delay */
+static int SDLCALL _events_delayedPushThread(void *arg)
+{
+   SDL_Event event;
+
+   SDL_Delay(100);
+   SDL_zero(event);
+   event.type = SDL_USEREVENT;
+   event.user.code = *(int *)arg;
+   SDL_PushEvent(&event);
+   return 0;
+}
+
+/**
+ * @brief Waits for an event pushed from another thread, and waits for one that never comes.
+ *
+ * @sa http://wiki.libsdl.org/moin.cgi/SDL_WaitEventTimeout
+ */
+int
+events_waitEventFromThread(void *arg)
+{
+   SDL_Thread *thread;
+   SDL_Event event;
+   int code = SDLTest_RandomSint32();
+   int result;
+   Uint32 start, elapsed;
+
+   /* Start with an empty queue */
+   SDL_FlushEvents(SDL_FIRSTEVENT, SDL_LASTEVENT);
+
+   /* Nothing to wait for */
+   start = SDL_GetTicks();
+   result = SDL_WaitEventTimeout(&event, 50);
+   elapsed = SDL_GetTicks() - start;
+   SDLTest_AssertPass("Call to SDL_WaitEventTimeout(&event, 50)");
+   SDLTest_AssertCheck(result == 0, "Check result from SDL_WaitEventTimeout, expected: 0, got: %d", result);
+   SDLTest_AssertCheck(elapsed >= 50, "Check it waited for the timeout, expected: >= 50 ms, got: %u ms", (unsigned int) elapsed);
+
+   /* Another thread wakes us up */
+   thread = SDL_CreateThread(_events_delayedPushThread, "DelayedPush", &code);
+   SDLTest_AssertCheck(thread != NULL, "Check thread was created");
+   start = SDL_GetTicks();
+   result = SDL_WaitEventTimeout(&event, 5000);
+   elapsed = SDL_GetTicks() - start;
+   SDLTest_AssertPass("Call to SDL_WaitEventTimeout(&event, 5000)");
+   SDLTest_AssertCheck(result == 1, "Check result from SDL_WaitEventTimeout, expected: 1, got: %d", result);
+   SDLTest_AssertCheck(event.type == SDL_USEREVENT && event.user.code == code, "Check the pushed event was returned");
+   SDLTest_AssertCheck(elapsed < 5000, "Check it didn't wait for the timeout, got: %u ms", (unsigned int) elapsed);
+   SDL_WaitThread(thread, NULL);
+
+   return TEST_COMPLETED;
+}
+
+#ifdef EVENTS_HAVE_KILL
+/* Sends the process SIGINT after a short delay. SDL's threads block it, so
+   it goes to the waiting thread. */
+static int SDLCALL _events_delayedSignalThread(void *arg)
+{
+   SDL_Delay(100);
+   kill(getpid(), SIGINT);
+   return 0;
+}
+#endif
+
+/**
+ * @brief Waits with the joystick subsystem up and no joysticks connected.
+ *
+ * Only pumping notices a joystick being plugged in, so a wait has to keep
+ * pumping even when there are none. Nothing shows a joystick update from
+ * outside, but SDL also only turns a quit signal into an SDL_QUIT event
+ * when it pumps, so this checks how soon that shows up.
+ *
+ * @sa http://wiki.libsdl.org/moin.cgi/SDL_WaitEventTimeout
+ */
+int
+events_waitPumpsJoysticks(void *arg)
+{
+#ifdef EVENTS_HAVE_KILL
+   SDL_Thread *thread;
+   SDL_Event event;
+   void (*handler)(int);
+   int result;
+   Uint32 start, elapsed;
+
+   /* Only raise the signal if SDL is the one handling it */
+   handler = signal(SIGINT, SIG_IGN);
+   signal(SIGINT, handler);
+   if (handler == SIG_DFL || handler == SIG_IGN || handler == SIG_ERR) {
+      SDLTest_Log("Skipping: SDL isn't handling SIGINT");
+      return TEST_SKIPPED;
+   }
+
+   result = SDL_InitSubSystem(SDL_INIT_JOYSTICK);
+   SDLTest_AssertCheck(result == 0, "Check result from SDL_InitSubSystem(SDL_INIT_JOYSTICK), expected: 0, got: %d", result);
+   if (result != 0) {
+      return TEST_ABORTED;
+   }
+   if (SDL_NumJoysticks() > 0) {
+      SDLTest_Log("Skipping: there are joysticks connected");
+      SDL_QuitSubSystem(SDL_INIT_JOYSTICK);
+      return TEST_SKIPPED;
+   }
+
+   /* Start with an empty queue */
+   SDL_FlushEvents(SDL_FIRSTEVENT, SDL_LASTEVENT);
+
+   thread = SDL_CreateThread(_events_delayedSignalThread, "DelayedSignal", NULL);
+   SDLTest_AssertCheck(thread != NULL, "Check thread was created");
+   start = SDL_GetTicks();
+   result = SDL_WaitEventTimeout(&event, 5000);
+   elapsed = SDL_GetTicks() - start;
+   SDL_WaitThread(thread, NULL);
+   SDLTest_AssertPass("Call to SDL_WaitEventTimeout(&event, 5000)");
+   SDLTest_AssertCheck(result == 1, "Check result from SDL_WaitEventTimeout, expected: 1, got: %d", result);
+   SDLTest_AssertCheck(result == 1 && event.type == SDL_QUIT, "Check the quit event was returned");
+   SDLTest_AssertCheck(elapsed < 200, "Check it kept pumping while waiting, expected: < 200 ms, got: %u ms", (unsigned int) elapsed);
+
+   SDL_QuitSubSystem(SDL_INIT_JOYSTICK);
+   return TEST_COMPLETED;
+#else
+   SDLTest_Log("Skipping: can't send a signal on this platform");
+   return TEST_SKIPPED;
+#endif
+}
+
+/* Pushes a mouse motion event */
+static void _events_pushMotion(Uint32 which, Sint32 x, Sint32 xrel)
+{
+   SDL_Event event;
+
+   SDL_zero(event);
+   event.type = SDL_MOUSEMOTION;
+   event.motion.which = which;
+   event.motion.x = x;
+   event.motion.xrel = xrel;
+   SDL_PushEvent(&event);
+}
+
+/**
+ * @brief Checks that queued motion events are merged when the coalescing hints are set, and only then.
+ *
+ * @sa http://wiki.libsdl.org/moin.cgi/SDL_PushEvent
+ * @sa http://wiki.libsdl.org/moin.cgi/SDL_PeepEvents
+ */
+int
+events_coalesceMotion(void *arg)
+{
+   SDL_Event events[16];
+   int result, i;
+
+   SDL_FlushEvents(SDL_FIRSTEVENT, SDL_LASTEVENT);
+   SDL_SetHint(SDL_HINT_COALESCE_MOUSE_MOTION, "1");
+   SDLTest_AssertPass("Call to SDL_SetHint(SDL_HINT_COALESCE_MOUSE_MOTION, \"1\")");
+
+   /* Two mice moving at once, then a click, then more motion */
+   _events_pushMotion(0, 10, 1);
+   _events_pushMotion(1, 100, 5);
+   _events_pushMotion(0, 12, 2);
+   _events_pushMotion(0, 15, 3);
+   SDL_zero(events[0]);
+   events[0].type = SDL_MOUSEBUTTONDOWN;
+   SDL_PushEvent(&events[0]);
+   _events_pushMotion(0, 20, 5);
+   _events_pushMotion(0, 21, 1);
+
+   result = SDL_PeepEvents(events, SDL_arraysize(events), SDL_GETEVENT, SDL_FIRSTEVENT, SDL_LASTEVENT);
+   SDLTest_AssertCheck(result == 4, "Check number of queued events, expected: 4, got: %d", result);
+   if (result == 4) {
+      SDLTest_AssertCheck(events[0].type == SDL_MOUSEMOTION && events[0].motion.which == 0 &&
+                          events[0].motion.x == 15 && events[0].motion.xrel == 6,
+                          "Check first mouse's motion was merged, expected: x=15 xrel=6, got: x=%d xrel=%d", (int) events[0].motion.x, (int) events[0].motion.xrel);
+      SDLTest_AssertCheck(events[1].type == SDL_MOUSEMOTION && events[1].motion.which == 1 && events[1].motion.xrel == 5,
+                          "Check second mouse's motion was left alone");
+      SDLTest_AssertCheck(events[2].type == SDL_MOUSEBUTTONDOWN, "Check the click stayed in order");
+      SDLTest_AssertCheck(events[3].type == SDL_MOUSEMOTION && events[3].motion.x == 21 && events[3].motion.xrel == 6,
+                          "Check motion after the click was merged separately, expected: x=21 xrel=6, got: x=%d xrel=%d", (int) events[3].motion.x, (int) events[3].motion.xrel);
+   }
+
+   /* Controller axes are merged per axis */
+   SDL_SetHint(SDL_HINT_COALESCE_CONTROLLER_AXIS_MOTION, "1");
+   for (i = 0; i < 6; i++) {
+      SDL_zero(events[0]);
+      events[0].type = SDL_CONTROLLERAXISMOTION;
+      events[0].caxis.axis = i % 2;
+      events[0].caxis.value = i;
+      SDL_PushEvent(&events[0]);
+   }
+   result = SDL_PeepEvents(events, SDL_arraysize(events), SDL_GETEVENT, SDL_FIRSTEVENT, SDL_LASTEVENT);
+   SDLTest_AssertCheck(result == 2, "Check number of queued axis events, expected: 2, got: %d", result);
+   if (result == 2) {
+      SDLTest_AssertCheck(events[0].caxis.value == 4 && events[1].caxis.value == 5,
+                          "Check latest axis values were kept, expected: 4 and 5, got: %d and %d", (int) events[0].caxis.value, (int) events[1].caxis.value);
+   }
+
+   /* Nothing is merged with the hints off */
+   SDL_SetHint(SDL_HINT_COALESCE_MOUSE_MOTION, "0");
+   SDL_SetHint(SDL_HINT_COALESCE_CONTROLLER_AXIS_MOTION, NULL);
+   SDLTest_AssertPass("Reset coalescing hints");
+   _events_pushMotion(0, 10, 1);
+   _events_pushMotion(0, 11, 1);
+   _events_pushMotion(0, 12, 1);
+   result = SDL_PeepEvents(events, SDL_arraysize(events), SDL_GETEVENT, SDL_FIRSTEVENT, SDL_LASTEVENT);
+   SDLTest_AssertCheck(result == 3, "Check number of queued events, expected: 3, got: %d", result);
+
+   return TEST_COMPLETED;
+}
+
+/**
+ * @brief Filter for events_peepByType: makes odd motion events into user events.
+ */
+int SDLCALL _events_retypeFilter(void *userdata, SDL_Event *event)
+{
+   if (event->type == SDL_MOUSEMOTION && (event->motion.x % 2) == 1) {
+      const Sint32 x = event->motion.x;
+      SDL_zero(*event);
+      event->type = SDL_USEREVENT + 1;
+      event->user.code = x;
+   }
+   return 1;
+}
+
+/**
+ * @brief Checks that looking for some types of event finds them in order among lots of others.
+ *
+ * @sa http://wiki.libsdl.org/moin.cgi/SDL_HasEvent
+ * @sa http://wiki.libsdl.org/moin.cgi/SDL_PeepEvents
+ * @sa http://wiki.libsdl.org/moin.cgi/SDL_FilterEvents
+ */
+int
+events_peepByType(void *arg)
+{
+   SDL_Event events[600];
+   SDL_Event event;
+   int result, i, ordered;
+
+   SDL_FlushEvents(SDL_FIRSTEVENT, SDL_LASTEVENT);
+
+   /* Lots of motion, with a user event every 100 */
+   for (i = 0; i < 1000; i++) {
+      _events_pushMotion(0, i, 1);
+      if ((i % 100) == 0) {
+         SDL_zero(event);
+         event.type = SDL_USEREVENT;
+         event.user.code = i;
+         SDL_PushEvent(&event);
+      }
+   }
+   SDL_zero(event);
+   event.type = SDL_USEREVENT + 1;
+   event.user.code = 1000;
+   SDL_PushEvent(&event);
+   SDL_zero(event);
+   event.type = SDL_QUIT;
+   SDL_PushEvent(&event);
+
+   SDLTest_AssertCheck(SDL_HasEvent(SDL_QUIT), "Check SDL_HasEvent(SDL_QUIT) is true");
+   SDLTest_AssertCheck(!SDL_HasEvent(SDL_KEYDOWN), "Check SDL_HasEvent(SDL_KEYDOWN) is false");
+   result = SDL_PeepEvents(NULL, 0, SDL_PEEKEVENT, SDL_MOUSEMOTION, SDL_MOUSEWHEEL);
+   SDLTest_AssertCheck(result == 1000, "Check number of queued mouse events, expected: 1000, got: %d", result);
+   result = SDL_PeepEvents(NULL, 0, SDL_PEEKEVENT, SDL_FIRSTEVENT, SDL_LASTEVENT);
+   SDLTest_AssertCheck(result == 1012, "Check number of queued events, expected: 1012, got: %d", result);
+
+   /* Only the user events come out, in order */
+   result = SDL_PeepEvents(events, SDL_arraysize(events), SDL_GETEVENT, SDL_USEREVENT, SDL_USEREVENT);
+   SDLTest_AssertCheck(result == 10, "Check number of user events, expected: 10, got: %d", result);
+   for (i = 0, ordered = 1; i < result; i++) {
+      ordered &= (events[i].type == SDL_USEREVENT && events[i].user.code == i * 100);
+   }
+   SDLTest_AssertCheck(ordered, "Check user events came out in the order they were pushed");
+   SDLTest_AssertCheck(!SDL_HasEvent(SDL_USEREVENT), "Check SDL_HasEvent(SDL_USEREVENT) is false after getting them");
+
+   /* Events a filter changes the type of are found under their new type, still in order */
+   SDL_FilterEvents(_events_retypeFilter, NULL);
+   SDLTest_AssertPass("Call to SDL_FilterEvents()");
+   result = SDL_PeepEvents(events, SDL_arraysize(events), SDL_GETEVENT, SDL_USEREVENT, SDL_USEREVENT + 1);
+   SDLTest_AssertCheck(result == 501, "Check number of retyped events, expected: 501, got: %d", result);
+   for (i = 0, ordered = (result == 501); i < result; i++) {
+      ordered &= (events[i].type == SDL_USEREVENT + 1 && events[i].user.code == ((i < 500) ? (i * 2) + 1 : 1000));
+   }
+   SDLTest_AssertCheck(ordered, "Check retyped events came out in queue order, before the one pushed after them");
+
+   /* Flushing one type leaves the rest */
+   SDL_FlushEvent(SDL_MOUSEMOTION);
+   SDLTest_AssertPass("Call to SDL_FlushEvent(SDL_MOUSEMOTION)");
+   SDLTest_AssertCheck(!SDL_HasEvent(SDL_MOUSEMOTION), "Check SDL_HasEvent(SDL_MOUSEMOTION) is false after flushing");
+   result = SDL_PeepEvents(events, SDL_arraysize(events), SDL_GETEVENT, SDL_FIRSTEVENT, SDL_LASTEVENT);
+   SDLTest_AssertCheck(result == 1 && events[0].type == SDL_QUIT, "Check only the quit event is left, got %d events", result);
+
+   return TEST_COMPLETED;
+}
+
+/**
+ * @brief Polls events in batches, with and without a type range.
+ *
+ * @sa http://wiki.libsdl.org/moin.cgi/SDL_PollEvents
+ */
+int
+events_pollEvents(void *arg)
+{
+   SDL_Event events[8];
+   SDL_Event event;
+   int result, i, ordered;
+
+   SDL_FlushEvents(SDL_FIRSTEVENT, SDL_LASTEVENT);
+
+   for (i = 0; i < 12; i++) {
+      SDL_zero(event);
+      event.type = (i % 3) ? SDL_USEREVENT : SDL_MOUSEMOTION;
+      event.user.code = i;
+      SDL_PushEvent(&event);
+   }
+
+   /* No more than asked for, in order */
+   result = SDL_PollEvents(events, SDL_arraysize(events), SDL_FIRSTEVENT, SDL_LASTEVENT);
+   SDLTest_AssertPass("Call to SDL_PollEvents()");
+   SDLTest_AssertCheck(result == 8, "Check number of events, expected: 8, got: %d", result);
+   for (i = 0, ordered = (result == 8); i < result; i++) {
+      ordered &= (events[i].user.code == i);
+   }
+   SDLTest_AssertCheck(ordered, "Check events came out in the order they were pushed");
+
+   /* Only the types asked for */
+   result = SDL_PollEvents(events, SDL_arraysize(events), SDL_USEREVENT, SDL_USEREVENT);
+   SDLTest_AssertCheck(result == 3, "Check number of user events, expected: 3, got: %d", result);
+   SDLTest_AssertCheck(result == 3 && events[0].user.code == 8 && events[1].user.code == 10 && events[2].user.code == 11,
+                       "Check the remaining user events came out");
+   result = SDL_PollEvents(events, SDL_arraysize(events), SDL_FIRSTEVENT, SDL_LASTEVENT);
+   SDLTest_AssertCheck(result == 1, "Check number of remaining events, expected: 1, got: %d", result);
+   SDLTest_AssertCheck(result == 1 && events[0].type == SDL_MOUSEMOTION && events[0].user.code == 9,
+                       "Check the remaining event is the motion event skipped over");
+   result = SDL_PollEvents(events, SDL_arraysize(events), SDL_FIRSTEVENT, SDL_LASTEVENT);
+   SDLTest_AssertCheck(result == 0, "Check the queue is empty, got: %d", result);
+
+   /* Invalid parameters */
+   result = SDL_PollEvents(NULL, 1, SDL_FIRSTEVENT, SDL_LASTEVENT);
+   SDLTest_AssertCheck(result == -1, "Check SDL_PollEvents(NULL, ...) fails, expected: -1, got: %d", result);
+
+   return TEST_COMPLETED;
+}
+
+/* Counts of calls to the watchers in events_changeEventWatchFromWatch */
+int _watchCalls[3];
+
+/* Watcher that replaces itself and watcher 2 with watcher 1 the first time it's called */
+int SDLCALL _events_countingWatch(void *userdata, SDL_Event *event)
+{
+   const int which = *(int *)userdata;
+
+   if (which == 0 && ++_watchCalls[0] == 1) {
+      SDL_AddEventWatch(_events_countingWatch, &_userdataValue1);
+      SDL_DelEventWatch(_events_countingWatch, &_userdataValue);
+      SDL_DelEventWatch(_events_countingWatch, &_userdataValue2);
+   } else if (which != 0) {
+      ++_watchCalls[which];
+   }
+   return 0;
+}
+
+/**
+ * @brief Adds and deletes event watchers from inside an event watcher.
+ *
+ * Also checks that the lists replaced during the dispatch, and the watchers
+ * deleted from them, are freed as soon as the dispatch is over.
+ *
+ * @sa http://wiki.libsdl.org/moin.cgi/SDL_AddEventWatch
+ * @sa http://wiki.libsdl.org/moin.cgi/SDL_DelEventWatch
+ */
+int
+events_changeEventWatchFromWatch(void *arg)
+{
+   SDL_Event event;
+   int i, allocations;
+
+   SDL_zero(event);
+   event.type = SDL_USEREVENT;
+   _userdataValue = 0;
+   SDL_zero(_watchCalls);
+
+   /* Let the queue allocate what it needs for these events up front */
+   for (i = 0; i < 3; i++) {
+      SDL_PushEvent(&event);
+   }
+   SDL_FlushEvents(SDL_FIRSTEVENT, SDL_LASTEVENT);
+
+   SDL_AddEventWatch(_events_countingWatch, &_userdataValue);
+   SDL_AddEventWatch(_events_countingWatch, &_userdataValue2);
+   SDLTest_AssertPass("Call to SDL_AddEventWatch()");
+   allocations = SDL_GetNumAllocations();
+
+   /* The first watcher adds one, and deletes itself and the one after it */
+   SDL_PushEvent(&event);
+   SDLTest_AssertCheck(_watchCalls[0] == 1, "Check first watcher was called once, got: %d", _watchCalls[0]);
+   SDLTest_AssertCheck(_watchCalls[1] == 0, "Check added watcher waits for the next event, got: %d calls", _watchCalls[1]);
+   SDLTest_AssertCheck(_watchCalls[2] == 0, "Check deleted watcher wasn't called, got: %d calls", _watchCalls[2]);
+
+   /* The list and two watchers there were are now one list and one watcher */
+   SDLTest_AssertCheck(SDL_GetNumAllocations() == allocations - 1,
+                       "Check replaced lists were freed after the dispatch, expected: %d allocations, got: %d",
+                       allocations - 1, SDL_GetNumAllocations());
+
+   SDL_PushEvent(&event);
+   SDLTest_AssertCheck(_watchCalls[0] == 1, "Check first watcher wasn't called again, got: %d calls", _watchCalls[0]);
+   SDLTest_AssertCheck(_watchCalls[1] == 1, "Check added watcher was called, got: %d calls", _watchCalls[1]);
+   SDLTest_AssertCheck(_watchCalls[2] == 0, "Check deleted watcher wasn't called, got: %d calls", _watchCalls[2]);
+
+   SDL_DelEventWatch(_events_countingWatch, &_userdataValue1);
+   SDLTest_AssertPass("Call to SDL_DelEventWatch()");
+   SDL_PushEvent(&event);
+   SDLTest_AssertCheck(_watchCalls[1] == 1, "Check deleted watcher wasn't called again, got: %d calls", _watchCalls[1]);
+
+   SDL_FlushEvents(SDL_FIRSTEVENT, SDL_LASTEVENT);
+
+   return TEST_COMPLETED;
+}
+
+/**
+ * @brief Checks the times passed along with events, and the latency histogram.
+ *
+ * @sa http://wiki.libsdl.org/moin.cgi/SDL_PeepEventsWithTimestamps
+ * @sa http://wiki.libsdl.org/moin.cgi/SDL_GetEventLatencyHistogram
+ */
+int
+events_timestamps(void *arg)
+{
+   SDL_Event events[10];
+   SDL_EventTimestamp timestamps[10];
+   SDL_EventLatencyHistogram histogram;
+   Uint64 before, after;
+   Uint32 total;
+   int result, i;
+
+   SDL_FlushEvents(SDL_FIRSTEVENT, SDL_LASTEVENT);
+
+   /* A source time given with the event comes back out with it */
+   SDL_zero(events[0]);
+   events[0].type = SDL_USEREVENT;
+   timestamps[0].source = 12345;
+   before = SDL_GetPerformanceCounter();
+   result = SDL_PeepEventsWithTimestamps(events, timestamps, 1, SDL_ADDEVENT, 0, 0);
+   SDLTest_AssertCheck(result == 1, "Check SDL_PeepEventsWithTimestamps(SDL_ADDEVENT) result, expected: 1, got: %d", result);
+   SDL_PushEvent(&events[0]);
+   after = SDL_GetPerformanceCounter();
+
+   SDL_zero(timestamps);
+   result = SDL_PeepEventsWithTimestamps(events, timestamps, SDL_arraysize(events), SDL_GETEVENT, SDL_FIRSTEVENT, SDL_LASTEVENT);
+   SDLTest_AssertCheck(result == 2, "Check number of events, expected: 2, got: %d", result);
+   if (result == 2) {
+      SDLTest_AssertCheck(timestamps[0].source == 12345, "Check source time was kept, got: %" SDL_PRIu64, timestamps[0].source);
+      SDLTest_AssertCheck(timestamps[1].source == 0, "Check pushed event has no source time, got: %" SDL_PRIu64, timestamps[1].source);
+      for (i = 0; i < 2; i++) {
+         SDLTest_AssertCheck(timestamps[i].queued >= before && timestamps[i].queued <= after,
+                             "Check queued time of event %d is when it was queued", i);
+      }
+   }
+
+   /* Nothing is counted until asked for */
+   SDL_zero(events[0]);
+   events[0].type = SDL_USEREVENT + 1;
+   SDL_PushEvent(&events[0]);
+   SDL_PollEvent(&events[0]);
+   result = SDL_GetEventLatencyHistogram(SDL_USEREVENT + 1, &histogram);
+   SDLTest_AssertCheck(result == 0 && histogram.count == 0, "Check no latency is counted by default, got: %d", (int) histogram.count);
+
+   SDL_SetHint(SDL_HINT_EVENT_LATENCY_HISTOGRAM, "1");
+   SDLTest_AssertPass("Call to SDL_SetHint(SDL_HINT_EVENT_LATENCY_HISTOGRAM, \"1\")");
+   for (i = 0; i < 10; i++) {
+      SDL_PushEvent(&events[0]);
+   }
+   SDL_Delay(2);
+   result = SDL_PeepEvents(events, 5, SDL_PEEKEVENT, SDL_FIRSTEVENT, SDL_LASTEVENT);
+   SDLTest_AssertCheck(result == 5, "Check peeking events, expected: 5, got: %d", result);
+   while (SDL_PollEvent(&events[0])) {
+   }
+
+   result = SDL_GetEventLatencyHistogram(SDL_USEREVENT + 1, &histogram);
+   SDLTest_AssertCheck(result == 0, "Check SDL_GetEventLatencyHistogram() result, expected: 0, got: %d", result);
+   SDLTest_AssertCheck(histogram.count == 10, "Check number of events counted, expected: 10, got: %d", (int) histogram.count);
+   for (i = 0, total = 0; i < SDL_EVENT_LATENCY_BUCKETS; i++) {
+      total += histogram.buckets[i];
+   }
+   SDLTest_AssertCheck(total == 10, "Check buckets add up to the count, got: %d", (int) total);
+   SDLTest_AssertCheck(histogram.max_ticks >= SDL_GetPerformanceFrequency() / 1000,
+                       "Check the longest wait was at least the delay");
+   SDLTest_AssertCheck(histogram.total_ticks >= histogram.max_ticks, "Check the total wait is at least the longest");
+
+   result = SDL_GetEventLatencyHistogram(SDL_USEREVENT + 2, &histogram);
+   SDLTest_AssertCheck(result == 0 && histogram.count == 0, "Check other types have nothing counted, got: %d", (int) histogram.count);
+   result = SDL_GetEventLatencyHistogram(SDL_USEREVENT, NULL);
+   SDLTest_AssertCheck(result == -1, "Check NULL histogram fails, expected: -1, got: %d", result);
+
+   SDL_SetHint(SDL_HINT_EVENT_LATENCY_HISTOGRAM, NULL);
+   SDLTest_AssertPass("Reset SDL_HINT_EVENT_LATENCY_HISTOGRAM");
+
+   return TEST_COMPLETED;
+}
+
 /* ================= Test References ================== */
 
 /* Events test cases */
@@ -187,9 +779,33 @@ static const SDLTest_TestCaseReference eventsTest2 =
 static const SDLTest_TestCaseReference eventsTest3 =
         { (SDLTest_TestCaseFp)events_addDelEventWatchWithUserdata, "events_addDelEventWatchWithUserdata", "Adds and deletes an event watch function with userdata", TEST_ENABLED };
 
+static const SDLTest_TestCaseReference eventsTest4 =
+        { (SDLTest_TestCaseFp)events_pushFromThreads, "events_pushFromThreads", "Pushes events from several threads while polling", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference eventsTest5 =
+        { (SDLTest_TestCaseFp)events_waitEventFromThread, "events_waitEventFromThread", "Waits for an event pushed from another thread", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference eventsTest6 =
+        { (SDLTest_TestCaseFp)events_coalesceMotion, "events_coalesceMotion", "Merges queued motion events when asked to", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference eventsTest7 =
+        { (SDLTest_TestCaseFp)events_peepByType, "events_peepByType", "Gets and flushes events of some types from a queue full of others", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference eventsTest8 =
+        { (SDLTest_TestCaseFp)events_pollEvents, "events_pollEvents", "Polls events in batches", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference eventsTest9 =
+        { (SDLTest_TestCaseFp)events_changeEventWatchFromWatch, "events_changeEventWatchFromWatch", "Adds and deletes event watch functions from inside one", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference eventsTest10 =
+        { (SDLTest_TestCaseFp)events_timestamps, "events_timestamps", "Passes precise times along with events and counts how long they wait", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference eventsTest11 =
+        { (SDLTest_TestCaseFp)events_waitPumpsJoysticks, "events_waitPumpsJoysticks", "Waits with the joystick subsystem up and no joysticks connected", TEST_ENABLED };
+
 /* Sequence of Events test cases */
 static const SDLTest_TestCaseReference *eventsTests[] =  {
-    &eventsTest1, &eventsTest2, &eventsTest3, NULL
+    &eventsTest1, &eventsTest2, &eventsTest3, &eventsTest4, &eventsTest5, &eventsTest6, &eventsTest7, &eventsTest8, &eventsTest9, &eventsTest10, &eventsTest11, NULL
 };
 
 /* Events test suite (global) */
@@ -558,6 +558,176 @@ mouse_getMouseFocus(void *arg)
     return TEST_COMPLETED;
 }
 
+/* How many frames the dummy video driver has saved, for the next file name */
+static int _mouseSavedFrames = 0;
+
+/* Loads the frame the dummy video driver saved for the last update and
+   checks it shows the test fill color, with the arrow cursor drawn at
+   (cursorX, cursorY) unless cursorX is negative. Helper function. */
+static void
+_checkPresentedFrame(SDL_Window *window, int cursorX, int cursorY)
+{
+    char file[128];
+    SDL_Surface *frame, *converted;
+    int x, y, mismatches = 0;
+
+    SDL_snprintf(file, sizeof(file), "SDL_window%d-%8.8d.bmp", SDL_GetWindowID(window), ++_mouseSavedFrames);
+    frame = SDL_LoadBMP(file);
+    SDLTest_AssertCheck(frame != NULL, "Validate the dummy video driver saved %s", file);
+    if (frame == NULL) {
+        return;
+    }
+    remove(file);
+    converted = SDL_ConvertSurfaceFormat(frame, SDL_PIXELFORMAT_ARGB8888, 0);
+    SDL_FreeSurface(frame);
+    SDLTest_AssertCheck(converted != NULL, "Validate result from SDL_ConvertSurfaceFormat() is not NULL");
+    if (converted == NULL) {
+        return;
+    }
+
+    for (y = 0; y < converted->h; y++) {
+        const Uint32 *row = (const Uint32 *) ((const Uint8 *) converted->pixels + y * converted->pitch);
+        for (x = 0; x < converted->w; x++) {
+            Uint32 expected = 0xFF336699;
+            if (cursorX >= 0 && x >= cursorX && x < cursorX + 32 && y >= cursorY && y < cursorY + 32) {
+                switch (_mouseArrowData[y - cursorY][x - cursorX]) {
+                    case 'X': expected = 0xFF000000; break;
+                    case '.': expected = 0xFFFFFFFF; break;
+                }
+            }
+            if (row[x] != expected) {
+                mismatches++;
+            }
+        }
+    }
+    SDL_FreeSurface(converted);
+
+    if (cursorX >= 0) {
+        SDLTest_AssertCheck(mismatches == 0, "Validate the presented frame shows only the cursor at %i,%i; %i pixels differ", cursorX, cursorY, mismatches);
+    } else {
+        SDLTest_AssertCheck(mismatches == 0, "Validate the presented frame shows no cursor; %i pixels differ", mismatches);
+    }
+}
+
+/**
+ * @brief Check the cursor SDL draws into the window surface
+ *
+ * With SDL_HINT_MOUSE_SOFTWARE_CURSOR set and a video driver that has no
+ * cursor of its own, SDL draws the cursor into the window surface during
+ * each update and has to put back what it covered afterwards.
+ *
+ * With the dummy video driver, SDL_VIDEO_DUMMY_SAVE_FRAMES also shows what
+ * got presented. Only the updated rects change that, so it has the cursor
+ * only if its new spot was updated, and still has it at its old spot
+ * unless that was updated too.
+ *
+ * @sa http://wiki.libsdl.org/moin.cgi/SDL_UpdateWindowSurfaceRects
+ */
+int
+mouse_updateSurfaceUnderCursor(void *arg)
+{
+    const int w = MOUSE_TESTWINDOW_WIDTH, h = MOUSE_TESTWINDOW_HEIGHT;
+    const int xPositions[4] = { 0, w / 2, w - 1, 3 };
+    const int yPositions[4] = { 0, h / 2, h - 1, h - 2 };
+    const char *saveFrames = SDL_getenv("SDL_VIDEO_DUMMY_SAVE_FRAMES");
+    SDL_bool checkFrames;
+    SDL_Window *window;
+    SDL_Surface *surface;
+    SDL_Cursor *cursor;
+    Uint8 *expected;
+    size_t size;
+    int i, result;
+
+    if (!SDL_GetHintBoolean(SDL_HINT_MOUSE_SOFTWARE_CURSOR, SDL_FALSE)) {
+        SDLTest_Log("Skipping: set SDL_MOUSE_SOFTWARE_CURSOR=1 to have SDL draw the cursor");
+        return TEST_SKIPPED;
+    }
+
+    window = _createMouseSuiteTestWindow();
+    if (window == NULL) return TEST_ABORTED;
+
+    surface = SDL_GetWindowSurface(window);
+    SDLTest_AssertPass("Call to SDL_GetWindowSurface()");
+    if (surface == NULL) {
+        /* drivers that can only do OpenGL have no surface */
+        _destroyMouseSuiteTestWindow(window);
+        return TEST_SKIPPED;
+    }
+
+    SDL_FillRect(surface, NULL, SDL_MapRGB(surface->format, 0x33, 0x66, 0x99));
+    size = surface->h * surface->pitch;
+    expected = (Uint8 *) SDL_malloc(size);
+    if (expected == NULL) {
+        _destroyMouseSuiteTestWindow(window);
+        return TEST_ABORTED;
+    }
+    SDL_memcpy(expected, surface->pixels, size);
+
+    /* Leave the frames alone if someone else is already saving them */
+    checkFrames = (SDL_strcmp(SDL_GetCurrentVideoDriver(), "dummy") == 0 &&
+                   (saveFrames == NULL || SDL_strcmp(saveFrames, "0") == 0)) ? SDL_TRUE : SDL_FALSE;
+    if (checkFrames) {
+        SDL_setenv("SDL_VIDEO_DUMMY_SAVE_FRAMES", "1", 1);
+    } else {
+        SDLTest_Log("Not checking presented frames; that needs the dummy video driver without SDL_VIDEO_DUMMY_SAVE_FRAMES set");
+    }
+
+    /* This may fail if the driver doesn't do cursors */
+    cursor = _initArrowCursor(_mouseArrowData);
+    SDLTest_AssertPass("Call to SDL_CreateCursor()");
+    SDLTest_AssertCheck(cursor != NULL, "Validate result from SDL_CreateCursor() is not NULL");
+    if (cursor != NULL) {
+        SDL_SetCursor(cursor);
+        SDLTest_AssertPass("Call to SDL_SetCursor(cursor)");
+    }
+    SDL_ShowCursor(SDL_ENABLE);
+
+    /* Present the whole window once, with the cursor on it */
+    SDL_WarpMouseInWindow(window, xPositions[0], yPositions[0]);
+    result = SDL_UpdateWindowSurface(window);
+    SDLTest_AssertCheck(result == 0, "Validate result from SDL_UpdateWindowSurface(), expected: 0, got: %i", result);
+    if (checkFrames) {
+        _checkPresentedFrame(window, xPositions[0], yPositions[0]);
+    }
+
+    for (i = 0; i < SDL_arraysize(xPositions); i++) {
+        SDL_WarpMouseInWindow(window, xPositions[i], yPositions[i]);
+        SDLTest_AssertPass("SDL_WarpMouseInWindow(...,%i,%i)", xPositions[i], yPositions[i]);
+
+        /* Just moving the cursor */
+        result = SDL_UpdateWindowSurfaceRects(window, NULL, 0);
+        SDLTest_AssertCheck(result == 0, "Validate result from SDL_UpdateWindowSurfaceRects(window, NULL, 0), expected: 0, got: %i", result);
+        SDLTest_AssertCheck(SDL_memcmp(surface->pixels, expected, size) == 0, "Validate window surface is unchanged");
+        if (checkFrames) {
+            _checkPresentedFrame(window, xPositions[i], yPositions[i]);
+        }
+
+        result = SDL_UpdateWindowSurface(window);
+        SDLTest_AssertCheck(result == 0, "Validate result from SDL_UpdateWindowSurface(), expected: 0, got: %i", result);
+        SDLTest_AssertCheck(SDL_memcmp(surface->pixels, expected, size) == 0, "Validate window surface is unchanged");
+        if (checkFrames) {
+            _checkPresentedFrame(window, xPositions[i], yPositions[i]);
+        }
+    }
+
+    /* Hiding the cursor again */
+    SDL_ShowCursor(SDL_DISABLE);
+    result = SDL_UpdateWindowSurfaceRects(window, NULL, 0);
+    SDLTest_AssertCheck(result == 0, "Validate result from SDL_UpdateWindowSurfaceRects(window, NULL, 0), expected: 0, got: %i", result);
+    SDLTest_AssertCheck(SDL_memcmp(surface->pixels, expected, size) == 0, "Validate window surface is unchanged");
+    if (checkFrames) {
+        _checkPresentedFrame(window, -1, -1);
+        SDL_setenv("SDL_VIDEO_DUMMY_SAVE_FRAMES", "0", 1);
+    }
+    SDL_ShowCursor(SDL_ENABLE);
+
+    SDL_FreeCursor(cursor);
+    SDL_free(expected);
+    _destroyMouseSuiteTestWindow(window);
+
+    return TEST_COMPLETED;
+}
+
 /* ================= Test References ================== */
 
 /* Mouse test cases */
@@ -591,10 +761,13 @@ static const SDLTest_TestCaseReference mouseTest9 =
 static const SDLTest_TestCaseReference mouseTest10 =
         { (SDLTest_TestCaseFp)mouse_getSetRelativeMouseMode, "mouse_getSetRelativeMouseMode", "Check call to SDL_GetRelativeMouseMode and SDL_SetRelativeMouseMode", TEST_ENABLED };
 
+static const SDLTest_TestCaseReference mouseTest11 =
+        { (SDLTest_TestCaseFp)mouse_updateSurfaceUnderCursor, "mouse_updateSurfaceUnderCursor", "Check the cursor SDL draws into the window surface", TEST_ENABLED };
+
 /* Sequence of Mouse test cases */
 static const SDLTest_TestCaseReference *mouseTests[] =  {
     &mouseTest1, &mouseTest2, &mouseTest3, &mouseTest4, &mouseTest5, &mouseTest6,
-    &mouseTest7, &mouseTest8, &mouseTest9, &mouseTest10, NULL
+    &mouseTest7, &mouseTest8, &mouseTest9, &mouseTest10, &mouseTest11, NULL
 };
 
 /* Mouse test suite (global) */
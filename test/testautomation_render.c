@@ -766,6 +766,452 @@ render_testBlitBlend (void *arg)
 }
 
 
+/**
+ * @brief Tests custom blend modes with the software renderer.
+ *
+ * \sa
+ * http://wiki.libsdl.org/moin.cgi/SDL_ComposeCustomBlendMode
+ */
+int
+render_testCustomBlendSoftware (void *arg)
+{
+   SDL_Surface *surface;
+   SDL_Renderer *swrenderer;
+   SDL_Texture *tface;
+   SDL_BlendMode multiply, screen;
+   SDL_Rect rect;
+   Uint32 pixel;
+   Uint8 r, g, b, a;
+   int ret;
+
+   /* Multiply: dstRGB = srcRGB * dstRGB, dstA = dstA */
+   multiply = SDL_ComposeCustomBlendMode(SDL_BLENDFACTOR_DST_COLOR, SDL_BLENDFACTOR_ZERO, SDL_BLENDOPERATION_ADD,
+                                         SDL_BLENDFACTOR_ZERO, SDL_BLENDFACTOR_ONE, SDL_BLENDOPERATION_ADD);
+   /* Screen: dstRGB = srcRGB + dstRGB * (1-srcRGB), dstA = dstA */
+   screen = SDL_ComposeCustomBlendMode(SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_COLOR, SDL_BLENDOPERATION_ADD,
+                                       SDL_BLENDFACTOR_ZERO, SDL_BLENDFACTOR_ONE, SDL_BLENDOPERATION_ADD);
+
+   surface = SDL_CreateRGBSurfaceWithFormat(0, 16, 16, 32, SDL_PIXELFORMAT_ARGB8888);
+   SDLTest_AssertCheck(surface != NULL, "Verify SDL_CreateRGBSurfaceWithFormat result");
+   if (surface == NULL) {
+      return TEST_ABORTED;
+   }
+   swrenderer = SDL_CreateSoftwareRenderer(surface);
+   SDLTest_AssertCheck(swrenderer != NULL, "Verify SDL_CreateSoftwareRenderer result");
+   if (swrenderer == NULL) {
+      SDL_FreeSurface(surface);
+      return TEST_ABORTED;
+   }
+
+   SDL_FillRect(surface, NULL, SDL_MapRGBA(surface->format, 200, 100, 50, 255));
+   ret = SDL_SetRenderDrawBlendMode(swrenderer, multiply);
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_SetRenderDrawBlendMode(multiply), expected: 0, got: %i", ret);
+   SDL_SetRenderDrawColor(swrenderer, 128, 255, 0, 64);
+   rect.x = 0;
+   rect.y = 0;
+   rect.w = 8;
+   rect.h = 16;
+   ret = SDL_RenderFillRect(swrenderer, &rect);
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_RenderFillRect, expected: 0, got: %i", ret);
+
+   pixel = ((Uint32 *) surface->pixels)[0];
+   SDL_GetRGBA(pixel, surface->format, &r, &g, &b, &a);
+   SDLTest_AssertCheck(r == 100 && g == 100 && b == 0 && a == 255,
+                       "Verify multiplied pixel, expected: (100,100,0,255), got: (%i,%i,%i,%i)", r, g, b, a);
+   pixel = ((Uint32 *) surface->pixels)[8];
+   SDL_GetRGBA(pixel, surface->format, &r, &g, &b, &a);
+   SDLTest_AssertCheck(r == 200 && g == 100 && b == 50,
+                       "Verify pixel outside the rect is untouched, got: (%i,%i,%i)", r, g, b);
+
+   /* Textures accept the mode too, and the color modulation applies before blending */
+   tface = SDL_CreateTexture(swrenderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC, 4, 4);
+   SDLTest_AssertCheck(tface != NULL, "Verify SDL_CreateTexture result");
+   if (tface != NULL) {
+      Uint32 white[16];
+      SDL_memset(white, 0xFF, sizeof(white));
+      SDL_UpdateTexture(tface, NULL, white, 4 * sizeof(Uint32));
+      ret = SDL_SetTextureBlendMode(tface, screen);
+      SDLTest_AssertCheck(ret == 0, "Validate result from SDL_SetTextureBlendMode(screen), expected: 0, got: %i", ret);
+      SDL_SetTextureColorMod(tface, 0, 0, 255);
+      rect.x = 8;
+      rect.y = 0;
+      rect.w = 8;
+      rect.h = 8;
+      ret = SDL_RenderCopy(swrenderer, tface, NULL, &rect);
+      SDLTest_AssertCheck(ret == 0, "Validate result from SDL_RenderCopy, expected: 0, got: %i", ret);
+
+      pixel = ((Uint32 *) surface->pixels)[8];
+      SDL_GetRGBA(pixel, surface->format, &r, &g, &b, &a);
+      SDLTest_AssertCheck(r == 200 && g == 100 && b == 255 && a == 255,
+                          "Verify screened pixel, expected: (200,100,255,255), got: (%i,%i,%i,%i)", r, g, b, a);
+      SDL_DestroyTexture(tface);
+   }
+
+   SDL_DestroyRenderer(swrenderer);
+   SDL_FreeSurface(surface);
+
+   return TEST_COMPLETED;
+}
+
+/* Fills an 8x8 streaming texture with a marker color and destroys it, then
+   creates another one the same size and checks whether the marker is still
+   there. New software textures start out cleared, so it only is if the
+   storage was recycled. Helper function. */
+static SDL_bool
+_recreatedTextureIsRecycled(SDL_Renderer *renderer)
+{
+   SDL_Texture *texture;
+   void *pixels;
+   int pitch, x, y;
+   SDL_bool marked = SDL_TRUE;
+
+   texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING, 8, 8);
+   if (texture == NULL || SDL_LockTexture(texture, NULL, &pixels, &pitch) < 0) {
+      SDLTest_AssertCheck(SDL_FALSE, "Verify the texture could be created and locked");
+      return SDL_FALSE;
+   }
+   for (y = 0; y < 8; ++y) {
+      for (x = 0; x < 8; ++x) {
+         ((Uint32 *)((Uint8 *)pixels + y * pitch))[x] = 0xFF123456;
+      }
+   }
+   SDL_UnlockTexture(texture);
+   SDL_DestroyTexture(texture);
+
+   texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING, 8, 8);
+   if (texture == NULL || SDL_LockTexture(texture, NULL, &pixels, &pitch) < 0) {
+      SDLTest_AssertCheck(SDL_FALSE, "Verify the texture could be created and locked again");
+      return SDL_FALSE;
+   }
+   for (y = 0; y < 8; ++y) {
+      for (x = 0; x < 8; ++x) {
+         if (((Uint32 *)((Uint8 *)pixels + y * pitch))[x] != 0xFF123456) {
+            marked = SDL_FALSE;
+         }
+      }
+   }
+   SDL_UnlockTexture(texture);
+   SDL_DestroyTexture(texture);
+   return marked;
+}
+
+/**
+ * @brief Tests recycling of destroyed textures with the software renderer.
+ *
+ * \sa
+ * http://wiki.libsdl.org/moin.cgi/SDL_RenderSetTexturePoolBudget
+ * http://wiki.libsdl.org/moin.cgi/SDL_RenderTrimTexturePool
+ */
+int
+render_testTexturePoolSoftware (void *arg)
+{
+   SDL_Surface *surface;
+   SDL_Renderer *swrenderer;
+   SDL_Texture *first, *second, *third;
+   SDL_BlendMode blendMode;
+   Uint8 r, g, b, a;
+   int ret;
+
+   surface = SDL_CreateRGBSurfaceWithFormat(0, 16, 16, 32, SDL_PIXELFORMAT_ARGB8888);
+   SDLTest_AssertCheck(surface != NULL, "Verify SDL_CreateRGBSurfaceWithFormat result");
+   if (surface == NULL) {
+      return TEST_ABORTED;
+   }
+   swrenderer = SDL_CreateSoftwareRenderer(surface);
+   SDLTest_AssertCheck(swrenderer != NULL, "Verify SDL_CreateSoftwareRenderer result");
+   if (swrenderer == NULL) {
+      SDL_FreeSurface(surface);
+      return TEST_ABORTED;
+   }
+
+   ret = SDL_RenderSetTexturePoolBudget(swrenderer, 64 * 64 * 4);
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_RenderSetTexturePoolBudget, expected: 0, got: %i", ret);
+
+   first = SDL_CreateTexture(swrenderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET, 32, 32);
+   SDLTest_AssertCheck(first != NULL, "Verify SDL_CreateTexture result");
+   if (first == NULL) {
+      SDL_DestroyRenderer(swrenderer);
+      SDL_FreeSurface(surface);
+      return TEST_ABORTED;
+   }
+   SDL_SetTextureBlendMode(first, SDL_BLENDMODE_ADD);
+   SDL_SetTextureColorMod(first, 10, 20, 30);
+   SDL_SetTextureAlphaMod(first, 40);
+   SDL_DestroyTexture(first);
+
+   /* A destroyed texture handle stays invalid while its storage is pooled */
+   ret = SDL_QueryTexture(first, NULL, NULL, NULL, NULL);
+   SDLTest_AssertCheck(ret == -1, "Validate result from SDL_QueryTexture on a destroyed texture, expected: -1, got: %i", ret);
+
+   /* A different size doesn't match the pooled texture */
+   second = SDL_CreateTexture(swrenderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET, 16, 16);
+   SDLTest_AssertCheck(second != NULL && second != first, "Verify a texture of another size is not recycled");
+
+   third = SDL_CreateTexture(swrenderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET, 32, 32);
+   SDLTest_AssertCheck(third == first, "Verify the pooled texture is recycled");
+   if (third != NULL) {
+      SDL_GetTextureBlendMode(third, &blendMode);
+      SDL_GetTextureColorMod(third, &r, &g, &b);
+      SDL_GetTextureAlphaMod(third, &a);
+      SDLTest_AssertCheck(blendMode == SDL_BLENDMODE_NONE && r == 255 && g == 255 && b == 255 && a == 255,
+                          "Verify the recycled texture has default state, got: blend %i, mod (%i,%i,%i,%i)", blendMode, r, g, b, a);
+      ret = SDL_SetRenderTarget(swrenderer, third);
+      SDLTest_AssertCheck(ret == 0, "Validate result from SDL_SetRenderTarget, expected: 0, got: %i", ret);
+      SDL_SetRenderTarget(swrenderer, NULL);
+      SDL_DestroyTexture(third);
+   }
+
+   ret = SDL_RenderTrimTexturePool(swrenderer, 0);
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_RenderTrimTexturePool, expected: 0, got: %i", ret);
+   ret = SDL_RenderTrimTexturePool(NULL, 0);
+   SDLTest_AssertCheck(ret == -1, "Validate result from SDL_RenderTrimTexturePool(NULL), expected: -1, got: %i", ret);
+
+   /* Textures larger than the budget are freed right away, so the same
+      texture created again is a new one */
+   SDLTest_AssertCheck(_recreatedTextureIsRecycled(swrenderer),
+                       "Verify a texture within the budget comes back with its pixels");
+   SDL_RenderTrimTexturePool(swrenderer, 0);
+   SDL_RenderSetTexturePoolBudget(swrenderer, 16);
+   SDLTest_AssertCheck(!_recreatedTextureIsRecycled(swrenderer),
+                       "Verify a texture larger than the budget is not recycled");
+
+   /* The renderer frees whatever is still pooled */
+   SDL_RenderSetTexturePoolBudget(swrenderer, 64 * 64 * 4);
+   SDL_DestroyTexture(second);
+   SDL_DestroyRenderer(swrenderer);
+   SDL_FreeSurface(surface);
+
+   return TEST_COMPLETED;
+}
+
+/* Fills a locked ARGB8888 area with one color. Helper function. */
+static void
+_fillLocked(void *pixels, int pitch, int w, int h, Uint32 color)
+{
+   int x, y;
+   for (y = 0; y < h; ++y) {
+      Uint32 *row = (Uint32 *)((Uint8 *)pixels + y * pitch);
+      for (x = 0; x < w; ++x) {
+         row[x] = color;
+      }
+   }
+}
+
+/**
+ * @brief Tests double-buffered streaming textures with the software renderer.
+ *
+ * \sa
+ * http://wiki.libsdl.org/moin.cgi/SDL_LockTexture
+ * http://wiki.libsdl.org/moin.cgi/SDL_UnlockTexture
+ */
+int
+render_testStreamingBuffersSoftware (void *arg)
+{
+   SDL_Surface *surface;
+   SDL_Renderer *swrenderer;
+   SDL_Texture *texture;
+   SDL_Rect rect;
+   void *first, *second, *pixels;
+   Uint32 *dst;
+   int pitch;
+   int ret;
+
+   surface = SDL_CreateRGBSurfaceWithFormat(0, 4, 4, 32, SDL_PIXELFORMAT_ARGB8888);
+   SDLTest_AssertCheck(surface != NULL, "Verify SDL_CreateRGBSurfaceWithFormat result");
+   if (surface == NULL) {
+      return TEST_ABORTED;
+   }
+   swrenderer = SDL_CreateSoftwareRenderer(surface);
+   SDLTest_AssertCheck(swrenderer != NULL, "Verify SDL_CreateSoftwareRenderer result");
+   if (swrenderer == NULL) {
+      SDL_FreeSurface(surface);
+      return TEST_ABORTED;
+   }
+   dst = (Uint32 *) surface->pixels;
+
+   SDL_SetHint(SDL_HINT_RENDER_STREAMING_BUFFERS, "2");
+   texture = SDL_CreateTexture(swrenderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING, 4, 4);
+   SDL_SetHint(SDL_HINT_RENDER_STREAMING_BUFFERS, NULL);
+   SDLTest_AssertCheck(texture != NULL, "Verify SDL_CreateTexture result");
+   if (texture == NULL) {
+      SDL_DestroyRenderer(swrenderer);
+      SDL_FreeSurface(surface);
+      return TEST_ABORTED;
+   }
+
+   ret = SDL_LockTexture(texture, NULL, &first, &pitch);
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_LockTexture, expected: 0, got: %i", ret);
+   _fillLocked(first, pitch, 4, 4, 0xFFFF0000);
+   SDL_UnlockTexture(texture);
+
+   /* The next frame goes into the other buffer, the unlocked one is still drawn */
+   ret = SDL_LockTexture(texture, NULL, &second, &pitch);
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_LockTexture, expected: 0, got: %i", ret);
+   SDLTest_AssertCheck(second != first, "Verify the second lock returns another buffer");
+   _fillLocked(second, pitch, 4, 4, 0xFF00FF00);
+   SDL_RenderCopy(swrenderer, texture, NULL, NULL);
+   SDLTest_AssertCheck(dst[0] == 0xFFFF0000, "Verify the unlocked frame is drawn, expected: 0xFFFF0000, got: 0x%.8x", dst[0]);
+   SDL_UnlockTexture(texture);
+   SDL_RenderCopy(swrenderer, texture, NULL, NULL);
+   SDLTest_AssertCheck(dst[0] == 0xFF00FF00, "Verify the new frame is drawn, expected: 0xFF00FF00, got: 0x%.8x", dst[0]);
+
+   /* A partial lock starts from the latest frame */
+   rect.x = 0;
+   rect.y = 0;
+   rect.w = 1;
+   rect.h = 1;
+   ret = SDL_LockTexture(texture, &rect, &pixels, &pitch);
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_LockTexture, expected: 0, got: %i", ret);
+   SDLTest_AssertCheck(pixels == first, "Verify the buffers are rotated");
+   _fillLocked(pixels, pitch, 1, 1, 0xFF0000FF);
+   SDL_UnlockTexture(texture);
+   SDL_RenderCopy(swrenderer, texture, NULL, NULL);
+   SDLTest_AssertCheck(dst[0] == 0xFF0000FF && dst[1] == 0xFF00FF00,
+                       "Verify the partial frame is drawn, expected: 0xFF0000FF 0xFF00FF00, got: 0x%.8x 0x%.8x", dst[0], dst[1]);
+
+   SDL_DestroyTexture(texture);
+   SDL_DestroyRenderer(swrenderer);
+   SDL_FreeSurface(surface);
+
+   return TEST_COMPLETED;
+}
+
+/* Loads the next frame the dummy video driver saved for a window and removes
+   the file. The frame numbers count every window's presents, so this looks a
+   little past the last one it found. Helper function. */
+static SDL_Surface *
+_loadPresentedFrame(SDL_Window *win, int *frameNumber)
+{
+   char file[128];
+   SDL_Surface *frame = NULL, *converted;
+   int i;
+
+   for (i = 0; i < 1000 && frame == NULL; ++i) {
+      SDL_snprintf(file, sizeof(file), "SDL_window%d-%8.8d.bmp", SDL_GetWindowID(win), ++*frameNumber);
+      frame = SDL_LoadBMP(file);
+   }
+   SDLTest_AssertCheck(frame != NULL, "Validate the dummy video driver saved a frame for the window");
+   if (frame == NULL) {
+      return NULL;
+   }
+   remove(file);
+   converted = SDL_ConvertSurfaceFormat(frame, SDL_PIXELFORMAT_ARGB8888, 0);
+   SDL_FreeSurface(frame);
+   SDLTest_AssertCheck(converted != NULL, "Validate result from SDL_ConvertSurfaceFormat() is not NULL");
+   return converted;
+}
+
+/* Counts the pixels of an ARGB8888 surface that aren't one color inside a
+   rect and another outside it. Helper function. */
+static int
+_countMismatches(SDL_Surface *surface, const SDL_Rect *rect, Uint32 inside, Uint32 outside)
+{
+   int x, y, mismatches = 0;
+   for (y = 0; y < surface->h; ++y) {
+      const Uint32 *row = (const Uint32 *)((const Uint8 *)surface->pixels + y * surface->pitch);
+      for (x = 0; x < surface->w; ++x) {
+         const SDL_bool in = (x >= rect->x && x < rect->x + rect->w &&
+                              y >= rect->y && y < rect->y + rect->h) ? SDL_TRUE : SDL_FALSE;
+         if (row[x] != (in ? inside : outside)) {
+            mismatches++;
+         }
+      }
+   }
+   return mismatches;
+}
+
+/**
+ * @brief Tests that the software renderer only presents what was drawn.
+ *
+ * The window surface is painted behind the renderer's back before a small
+ * fill, so the frame the dummy video driver saves shows which parts were
+ * updated.
+ *
+ * \sa
+ * http://wiki.libsdl.org/moin.cgi/SDL_RenderPresent
+ * http://wiki.libsdl.org/moin.cgi/SDL_HINT_RENDER_SOFTWARE_DAMAGE_TRACKING
+ */
+int
+render_testSoftwareDamageTracking (void *arg)
+{
+   const char *saveFrames = SDL_getenv("SDL_VIDEO_DUMMY_SAVE_FRAMES");
+   SDL_Window *swwindow;
+   SDL_Renderer *swrenderer;
+   SDL_Surface *surface, *presented;
+   SDL_Rect rect;
+   int frameNumber = 0;
+
+   /* Leave the frames alone if someone else is already saving them */
+   if (SDL_strcmp(SDL_GetCurrentVideoDriver(), "dummy") != 0 ||
+       (saveFrames != NULL && SDL_strcmp(saveFrames, "0") != 0)) {
+      SDLTest_Log("Skipping: needs the dummy video driver without SDL_VIDEO_DUMMY_SAVE_FRAMES set");
+      return TEST_SKIPPED;
+   }
+
+   SDL_SetHint(SDL_HINT_RENDER_SOFTWARE_DAMAGE_TRACKING, "1");
+   swwindow = SDL_CreateWindow("render_testSoftwareDamageTracking", 100, 100, 64, 48, 0);
+   SDLTest_AssertCheck(swwindow != NULL, "Verify SDL_CreateWindow result");
+   if (swwindow == NULL) {
+      return TEST_ABORTED;
+   }
+   swrenderer = SDL_CreateRenderer(swwindow, -1, SDL_RENDERER_SOFTWARE);
+   SDLTest_AssertCheck(swrenderer != NULL, "Verify SDL_CreateRenderer result");
+   if (swrenderer == NULL) {
+      SDL_DestroyWindow(swwindow);
+      return TEST_ABORTED;
+   }
+   SDL_setenv("SDL_VIDEO_DUMMY_SAVE_FRAMES", "1", 1);
+
+   /* The first present shows the whole window */
+   rect.x = 10;
+   rect.y = 20;
+   rect.w = 8;
+   rect.h = 6;
+   SDL_SetRenderDrawColor(swrenderer, 0, 0, 0, SDL_ALPHA_OPAQUE);
+   SDL_RenderClear(swrenderer);
+   SDL_RenderPresent(swrenderer);
+   presented = _loadPresentedFrame(swwindow, &frameNumber);
+   if (presented != NULL) {
+      const int mismatches = _countMismatches(presented, &rect, 0xFF000000, 0xFF000000);
+      SDLTest_AssertCheck(mismatches == 0, "Validate the first present is all black; %i pixels differ", mismatches);
+      SDL_FreeSurface(presented);
+   }
+
+   /* After one small fill only that rect is updated */
+   surface = SDL_GetWindowSurface(swwindow);
+   SDLTest_AssertCheck(surface != NULL, "Verify SDL_GetWindowSurface result");
+   if (surface != NULL) {
+      SDL_FillRect(surface, NULL, SDL_MapRGB(surface->format, 0, 0, 255));
+   }
+   SDL_SetRenderDrawColor(swrenderer, 255, 0, 0, SDL_ALPHA_OPAQUE);
+   SDL_RenderFillRect(swrenderer, &rect);
+   SDL_RenderPresent(swrenderer);
+   presented = _loadPresentedFrame(swwindow, &frameNumber);
+   if (presented != NULL) {
+      const int mismatches = _countMismatches(presented, &rect, 0xFFFF0000, 0xFF000000);
+      SDLTest_AssertCheck(mismatches == 0, "Validate only the filled rect was presented; %i pixels differ", mismatches);
+      SDL_FreeSurface(presented);
+   }
+
+   /* Without damage tracking every present shows the whole window */
+   SDL_SetHint(SDL_HINT_RENDER_SOFTWARE_DAMAGE_TRACKING, "0");
+   SDL_RenderFillRect(swrenderer, &rect);
+   SDL_RenderPresent(swrenderer);
+   presented = _loadPresentedFrame(swwindow, &frameNumber);
+   if (presented != NULL) {
+      const int mismatches = _countMismatches(presented, &rect, 0xFFFF0000, 0xFF0000FF);
+      SDLTest_AssertCheck(mismatches == 0, "Validate the whole window was presented with the hint off; %i pixels differ", mismatches);
+      SDL_FreeSurface(presented);
+   }
+
+   SDL_setenv("SDL_VIDEO_DUMMY_SAVE_FRAMES", "0", 1);
+   SDL_SetHint(SDL_HINT_RENDER_SOFTWARE_DAMAGE_TRACKING, "1");
+   SDL_DestroyRenderer(swrenderer);
+   SDL_DestroyWindow(swwindow);
+
+   return TEST_COMPLETED;
+}
+
 /**
  * @brief Checks to see if functionality is supported. Helper function.
  */
@@ -1085,9 +1531,21 @@ static const SDLTest_TestCaseReference renderTest6 =
 static const SDLTest_TestCaseReference renderTest7 =
         {  (SDLTest_TestCaseFp)render_testBlitBlend, "render_testBlitBlend", "Tests blitting with blending", TEST_DISABLED };
 
+static const SDLTest_TestCaseReference renderTest8 =
+        {  (SDLTest_TestCaseFp)render_testCustomBlendSoftware, "render_testCustomBlendSoftware", "Tests custom blend modes with the software renderer", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference renderTest9 =
+        {  (SDLTest_TestCaseFp)render_testTexturePoolSoftware, "render_testTexturePoolSoftware", "Tests recycling of destroyed textures with the software renderer", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference renderTest10 =
+        {  (SDLTest_TestCaseFp)render_testStreamingBuffersSoftware, "render_testStreamingBuffersSoftware", "Tests double-buffered streaming textures with the software renderer", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference renderTest11 =
+        {  (SDLTest_TestCaseFp)render_testSoftwareDamageTracking, "render_testSoftwareDamageTracking", "Tests that the software renderer only presents what was drawn", TEST_ENABLED };
+
 /* Sequence of Render test cases */
 static const SDLTest_TestCaseReference *renderTests[] =  {
-    &renderTest1, &renderTest2, &renderTest3, &renderTest4, &renderTest5, &renderTest6, &renderTest7, NULL
+    &renderTest1, &renderTest2, &renderTest3, &renderTest4, &renderTest5, &renderTest6, &renderTest7, &renderTest8, &renderTest9, &renderTest10, &renderTest11, NULL
 };
 
 /* Render test suite (global) */
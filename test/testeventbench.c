@@ -0,0 +1,218 @@
+/*
+  Copyright (C) 1997-2017 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely.
+*/
+
+/* Pushes user events from several threads as fast as they'll go while the
+   main thread polls them out, and reports how many got through and how long
+   each one sat in the queue, as the event queue's own latency histogram sees
+   it too. Then it times how long SDL_WaitEvent() takes to wake up for an
+   event pushed from another thread, and how much CPU it uses waiting for
+   nothing.
+
+     testeventbench [producer threads] [seconds] */
+
+#include <stdio.h>
+#include <time.h>
+#include "SDL.h"
+
+#define WAKEUPS 200
+
+static SDL_atomic_t done;
+
+static int SDLCALL
+Producer(void *arg)
+{
+    SDL_atomic_t *pushed = (SDL_atomic_t *) arg;
+    SDL_Event event;
+    Uint64 *when;
+    int count = 0, failures = 0;
+
+    SDL_zero(event);
+    event.type = SDL_USEREVENT;
+    while (!SDL_AtomicGet(&done)) {
+        /* the main thread frees this once it has timed the event. */
+        when = (Uint64 *) SDL_malloc(sizeof (*when));
+        if (!when) {
+            break;
+        }
+        *when = SDL_GetPerformanceCounter();
+        event.user.data1 = when;
+        if (SDL_PushEvent(&event) == 1) {
+            count++;
+        } else {
+            SDL_free(when);
+            failures++;
+            SDL_Delay(0);  /* the queue is full, let the main thread catch up */
+        }
+    }
+    SDL_AtomicAdd(pushed, count);
+    return failures;
+}
+
+static int SDLCALL
+SlowProducer(void *arg)
+{
+    SDL_Event event;
+    int i;
+
+    SDL_zero(event);
+    event.type = SDL_USEREVENT;
+    for (i = 0; i < WAKEUPS; i++) {
+        Uint64 *when = (Uint64 *) SDL_malloc(sizeof (*when));
+        if (!when) {
+            break;
+        }
+        SDL_Delay(5);  /* long enough that the main thread is asleep */
+        *when = SDL_GetPerformanceCounter();
+        event.user.data1 = when;
+        SDL_PushEvent(&event);
+    }
+    return 0;
+}
+
+static void
+PrintLatencyHistogram(Uint32 type)
+{
+    SDL_EventLatencyHistogram histogram;
+    int i;
+
+    if (SDL_GetEventLatencyHistogram(type, &histogram) < 0 || !histogram.count) {
+        return;
+    }
+    SDL_Log("queue's latency histogram: %u events, average %.3f us, worst %.3f us\n",
+            (unsigned int) histogram.count,
+            (1000000.0 * histogram.total_ticks) / (histogram.count * (double) SDL_GetPerformanceFrequency()),
+            (1000000.0 * histogram.max_ticks) / SDL_GetPerformanceFrequency());
+    for (i = 0; i < SDL_EVENT_LATENCY_BUCKETS; i++) {
+        if (histogram.buckets[i]) {
+            SDL_Log("    under %u us: %u\n", 1u << i, (unsigned int) histogram.buckets[i]);
+        }
+    }
+}
+
+static void
+RunWakeupLatency(void)
+{
+    const Uint64 freq = SDL_GetPerformanceFrequency();
+    Uint64 latency, total = 0, worst = 0;
+    SDL_Thread *thread;
+    SDL_Event event;
+    clock_t cpu;
+    int received = 0;
+
+    thread = SDL_CreateThread(SlowProducer, "SlowProducer", NULL);
+    if (!thread) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't create thread: %s\n", SDL_GetError());
+        return;
+    }
+    while (received < WAKEUPS && SDL_WaitEventTimeout(&event, 1000)) {
+        if (event.type == SDL_USEREVENT) {
+            latency = SDL_GetPerformanceCounter() - *(Uint64 *) event.user.data1;
+            SDL_free(event.user.data1);
+            total += latency;
+            worst = SDL_max(worst, latency);
+            received++;
+        }
+    }
+    SDL_WaitThread(thread, NULL);
+
+    if (received) {
+        SDL_Log("SDL_WaitEvent() woke up for %d events: average %.3f us, worst %.3f us after the push\n",
+                received, (1000000.0 * total) / (received * (double) freq),
+                (1000000.0 * worst) / freq);
+    }
+
+    cpu = clock();
+    SDL_WaitEventTimeout(NULL, 1000);
+    SDL_Log("CPU time spent waiting 1 second for nothing: %.3f ms\n",
+            ((clock() - cpu) * 1000.0) / CLOCKS_PER_SEC);
+}
+
+int
+main(int argc, char **argv)
+{
+    SDL_Thread *threads[64];
+    SDL_atomic_t pushed;
+    SDL_Event event;
+    Uint64 freq, start, now, latency, total = 0, worst = 0;
+    int numthreads = 4, seconds = 3, received = 0, failures = 0;
+    int i, status;
+
+    /* Enable standard application logging */
+    SDL_LogSetPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO);
+
+    if (argc > 1) {
+        numthreads = SDL_min(SDL_max(SDL_atoi(argv[1]), 1), (int) SDL_arraysize(threads));
+    }
+    if (argc > 2) {
+        seconds = SDL_max(SDL_atoi(argv[2]), 1);
+    }
+
+    SDL_SetHint(SDL_HINT_EVENT_LATENCY_HISTOGRAM, "1");
+    if (SDL_Init(SDL_INIT_EVENTS) < 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't initialize SDL: %s\n", SDL_GetError());
+        return (1);
+    }
+
+    SDL_AtomicSet(&done, 0);
+    SDL_AtomicSet(&pushed, 0);
+    for (i = 0; i < numthreads; i++) {
+        threads[i] = SDL_CreateThread(Producer, "Producer", &pushed);
+        if (!threads[i]) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't create thread: %s\n", SDL_GetError());
+            numthreads = i;
+            break;
+        }
+    }
+
+    freq = SDL_GetPerformanceFrequency();
+    start = SDL_GetPerformanceCounter();
+    do {
+        now = SDL_GetPerformanceCounter();
+        if (SDL_PollEvent(&event) && event.type == SDL_USEREVENT) {
+            latency = SDL_GetPerformanceCounter() - *(Uint64 *) event.user.data1;
+            SDL_free(event.user.data1);
+            total += latency;
+            worst = SDL_max(worst, latency);
+            received++;
+        }
+    } while ((now - start) < (seconds * freq));
+
+    SDL_AtomicSet(&done, 1);
+    for (i = 0; i < numthreads; i++) {
+        SDL_WaitThread(threads[i], &status);
+        failures += status;
+    }
+
+    /* free whatever was still in flight */
+    while (SDL_PeepEvents(&event, 1, SDL_GETEVENT, SDL_USEREVENT, SDL_USEREVENT) == 1) {
+        SDL_free(event.user.data1);
+    }
+
+    SDL_Log("%d producer threads for %d seconds\n", numthreads, seconds);
+    SDL_Log("pushed %d events (%.0f/s), polled %d (%.0f/s)\n",
+            SDL_AtomicGet(&pushed), (double) SDL_AtomicGet(&pushed) / seconds,
+            received, (double) received / seconds);
+    if (received) {
+        SDL_Log("time in the queue: average %.3f us, worst %.3f us\n",
+                (1000000.0 * total) / (received * (double) freq),
+                (1000000.0 * worst) / freq);
+    }
+    if (failures) {
+        SDL_Log("%d calls to SDL_PushEvent() found the queue full\n", failures);
+    }
+    PrintLatencyHistogram(SDL_USEREVENT);
+
+    RunWakeupLatency();
+
+    SDL_Quit();
+    return (0);
+}
@@ -0,0 +1,271 @@
+/*
+  Copyright (C) 1997-2017 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely.
+*/
+
+/* Times the $1 gesture recognizer against thousands of made up templates.
+
+   There's no way to make a touch device without hardware, so this calls the
+   recognizer's matcher in src/events/SDL_dollar.c directly and feeds it
+   strokes that are noisy, rotated copies of random templates. It compares
+   the way it used to search every template with the matcher's scalar, SIMD
+   and indexed searches, and checks they all pick the same template.
+
+   The matcher isn't part of the API, so this is built by CMake against the
+   static library, with src/events on the include path; see
+   SDL_TEST_INTERNALS.
+
+     testgesturebench [templates] [strokes] */
+
+#include "SDL_dollar_c.h"  /* brings in SDL_internal.h, which has to come first */
+#include <stdio.h>
+#include "SDL.h"
+
+#define PHI 0.618033989
+
+typedef struct
+{
+    const char *name;
+    int flags;
+} BenchCase;
+
+static const BenchCase cases[] = {
+    { "every template, scalar", SDL_DOLLAR_EXHAUSTIVE | SDL_DOLLAR_SCALAR },
+    { "every template, SIMD", SDL_DOLLAR_EXHAUSTIVE },
+    { "indexed, scalar", SDL_DOLLAR_SCALAR },
+    { "indexed, SIMD", 0 }
+};
+
+static Uint32 seed = 0x12345678;
+
+static float
+RandomFloat(float min, float max)
+{
+    seed = seed * 1664525 + 1013904223;
+    return min + ((seed >> 8) / 16777216.0f) * (max - min);
+}
+
+/* A random wiggly stroke, a few sine waves added together. */
+static void
+MakeStroke(SDL_FloatPoint *points)
+{
+    float amp[6], freq[6], phase[6];
+    int i, k;
+    for (k = 0; k < 6; k++) {
+        amp[k] = RandomFloat(0.2f, 1.0f);
+        freq[k] = RandomFloat(0.2f, 1.5f);
+        phase[k] = RandomFloat(0.0f, (float) (2 * M_PI));
+    }
+    for (i = 0; i < DOLLARNPOINTS; i++) {
+        const float t = (float) i / (DOLLARNPOINTS - 1);
+        points[i].x = points[i].y = 0;
+        for (k = 0; k < 3; k++) {
+            points[i].x += amp[k] * SDL_sinf((float) (2 * M_PI) * freq[k] * t + phase[k]);
+            points[i].y += amp[k + 3] * SDL_sinf((float) (2 * M_PI) * freq[k + 3] * t + phase[k + 3]);
+        }
+    }
+}
+
+/* Like what the recognizer does to a resampled path: center it, turn it so
+   the first point is left of the centroid, and scale it to DOLLARSIZE. */
+static void
+NormalizeStroke(SDL_FloatPoint *points)
+{
+    SDL_FloatPoint centroid = { 0, 0 };
+    float xmin, xmax, ymin, ymax;
+    float ang, c, s;
+    int i;
+
+    for (i = 0; i < DOLLARNPOINTS; i++) {
+        centroid.x += points[i].x / DOLLARNPOINTS;
+        centroid.y += points[i].y / DOLLARNPOINTS;
+    }
+    ang = SDL_atan2f(centroid.y - points[0].y, centroid.x - points[0].x);
+    c = SDL_cosf(ang);
+    s = SDL_sinf(ang);
+    xmin = xmax = ymin = ymax = 0;
+    for (i = 0; i < DOLLARNPOINTS; i++) {
+        const float px = points[i].x - centroid.x;
+        const float py = points[i].y - centroid.y;
+        points[i].x = px * c - py * s;
+        points[i].y = px * s + py * c;
+        xmin = SDL_min(xmin, points[i].x);
+        xmax = SDL_max(xmax, points[i].x);
+        ymin = SDL_min(ymin, points[i].y);
+        ymax = SDL_max(ymax, points[i].y);
+    }
+    for (i = 0; i < DOLLARNPOINTS; i++) {
+        points[i].x *= DOLLARSIZE / (xmax - xmin);
+        points[i].y *= DOLLARSIZE / (ymax - ymin);
+    }
+}
+
+/* How the recognizer matched before its templates were indexed: every
+   template, one point at a time, working out the rotation for each point. */
+static float
+OriginalDifference(const SDL_FloatPoint *points, const SDL_FloatPoint *templ, float ang)
+{
+    float dist = 0;
+    SDL_FloatPoint p;
+    int i;
+    for (i = 0; i < DOLLARNPOINTS; i++) {
+        p.x = (float)(points[i].x * SDL_cos(ang) - points[i].y * SDL_sin(ang));
+        p.y = (float)(points[i].x * SDL_sin(ang) + points[i].y * SDL_cos(ang));
+        dist += (float)(SDL_sqrt((p.x-templ[i].x)*(p.x-templ[i].x)+
+                                 (p.y-templ[i].y)*(p.y-templ[i].y)));
+    }
+    return dist/DOLLARNPOINTS;
+}
+
+static float
+OriginalRecognize(const SDL_FloatPoint *points, const SDL_FloatPoint *templates, int numtemplates, int *bestTempl)
+{
+    float bestDiff = 10000;
+    int i;
+    *bestTempl = -1;
+    for (i = 0; i < numtemplates; i++) {
+        const SDL_FloatPoint *templ = &templates[i * DOLLARNPOINTS];
+        double ta = -M_PI/4;
+        double tb = M_PI/4;
+        double dt = M_PI/90;
+        float x1 = (float)(PHI*ta + (1-PHI)*tb);
+        float f1 = OriginalDifference(points,templ,x1);
+        float x2 = (float)((1-PHI)*ta + PHI*tb);
+        float f2 = OriginalDifference(points,templ,x2);
+        float diff;
+        while (SDL_fabs(ta-tb) > dt) {
+            if (f1 < f2) {
+                tb = x2;
+                x2 = x1;
+                f2 = f1;
+                x1 = (float)(PHI*ta + (1-PHI)*tb);
+                f1 = OriginalDifference(points,templ,x1);
+            } else {
+                ta = x1;
+                x1 = x2;
+                f1 = f2;
+                x2 = (float)((1-PHI)*ta + PHI*tb);
+                f2 = OriginalDifference(points,templ,x2);
+            }
+        }
+        diff = SDL_min(f1,f2);
+        if (diff < bestDiff) {
+            bestDiff = diff;
+            *bestTempl = i;
+        }
+    }
+    return bestDiff;
+}
+
+static double
+TicksToMilliseconds(Uint64 ticks, int count)
+{
+    return ((ticks * 1000.0) / SDL_GetPerformanceFrequency()) / count;
+}
+
+int
+main(int argc, char **argv)
+{
+    SDL_DollarTemplates templates;
+    SDL_FloatPoint *paths, *strokes;
+    SDL_DollarStroke *split;
+    int *expected, *original;
+    int numtemplates = 5000, numstrokes = 20;
+    int i, j, status = 0;
+    Uint64 start;
+
+    /* Enable standard application logging */
+    SDL_LogSetPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO);
+
+    if (argc > 1) {
+        numtemplates = SDL_max(SDL_atoi(argv[1]), 1);
+    }
+    if (argc > 2) {
+        numstrokes = SDL_max(SDL_atoi(argv[2]), 1);
+    }
+
+    SDL_zero(templates);
+    paths = (SDL_FloatPoint *) SDL_malloc(numtemplates * DOLLARNPOINTS * sizeof (SDL_FloatPoint));
+    strokes = (SDL_FloatPoint *) SDL_malloc(numstrokes * DOLLARNPOINTS * sizeof (SDL_FloatPoint));
+    split = (SDL_DollarStroke *) SDL_malloc(numstrokes * sizeof (SDL_DollarStroke));
+    expected = (int *) SDL_malloc(numstrokes * sizeof (int));
+    original = (int *) SDL_malloc(numstrokes * sizeof (int));
+    if (!paths || !strokes || !split || !expected || !original) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Out of memory\n");
+        return 1;
+    }
+
+    /* keep the raw strokes around to make the noisy copies from */
+    for (i = 0; i < numtemplates; i++) {
+        SDL_FloatPoint *path = &paths[i * DOLLARNPOINTS];
+        SDL_FloatPoint normalized[DOLLARNPOINTS];
+        MakeStroke(path);
+        SDL_memcpy(normalized, path, sizeof (normalized));
+        NormalizeStroke(normalized);
+        if (SDL_DollarAddTemplate(&templates, normalized) < 0) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Out of memory\n");
+            return 1;
+        }
+    }
+
+    for (i = 0; i < numstrokes; i++) {
+        SDL_FloatPoint *stroke = &strokes[i * DOLLARNPOINTS];
+        const float ang = RandomFloat(-0.3f, 0.3f);
+        const float c = SDL_cosf(ang), s = SDL_sinf(ang);
+        expected[i] = (int) RandomFloat(0, (float) numtemplates) % numtemplates;
+        for (j = 0; j < DOLLARNPOINTS; j++) {
+            const SDL_FloatPoint *p = &paths[expected[i] * DOLLARNPOINTS + j];
+            stroke[j].x = p->x * c - p->y * s + RandomFloat(-0.05f, 0.05f);
+            stroke[j].y = p->x * s + p->y * c + RandomFloat(-0.05f, 0.05f);
+        }
+        NormalizeStroke(stroke);
+        SDL_DollarSplitPath(stroke, split[i].x, split[i].y, split[i].radius);
+    }
+
+    /* the original matcher wants the templates the way they used to be stored */
+    for (i = 0; i < numtemplates; i++) {
+        SDL_DollarGetPath(&templates, i, &paths[i * DOLLARNPOINTS]);
+    }
+
+    SDL_Log("%d templates, %d strokes, SIMD %s\n", numtemplates, numstrokes,
+            SDL_HasSSE() ? "available" : "not available");
+
+    start = SDL_GetPerformanceCounter();
+    for (i = 0; i < numstrokes; i++) {
+        OriginalRecognize(&strokes[i * DOLLARNPOINTS], paths, numtemplates, &original[i]);
+    }
+    SDL_Log("%-24s %9.3f ms per stroke\n", "original",
+            TicksToMilliseconds(SDL_GetPerformanceCounter() - start, numstrokes));
+
+    for (i = 0; i < SDL_arraysize(cases); i++) {
+        int matched = 0, disagreed = 0;
+        int best;
+        start = SDL_GetPerformanceCounter();
+        for (j = 0; j < numstrokes; j++) {
+            SDL_DollarRecognize(&templates, &split[j], cases[i].flags, &best);
+            matched += (best == expected[j]);
+            disagreed += (best != original[j]);
+        }
+        SDL_Log("%-24s %9.3f ms per stroke, %d/%d recognized, %d disagree with the original\n",
+                cases[i].name, TicksToMilliseconds(SDL_GetPerformanceCounter() - start, numstrokes),
+                matched, numstrokes, disagreed);
+        if (disagreed) {
+            status = 1;
+        }
+    }
+
+    SDL_DollarFreeTemplates(&templates);
+    SDL_free(paths);
+    SDL_free(strokes);
+    SDL_free(split);
+    SDL_free(expected);
+    SDL_free(original);
+    return status;
+}
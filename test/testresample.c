@@ -12,6 +12,186 @@
 
 #include "SDL.h"
 
+/* Converts the whole buffer to float with the polyphase resampler on or off. */
+static float *
+convert_to_float(const SDL_AudioSpec *spec, const Uint8 *data, Uint32 len,
+                 int cvtchans, int cvtfreq, const char *polyphase, int *outlen)
+{
+    SDL_AudioCVT cvt;
+    float *result;
+
+    SDL_SetHint(SDL_HINT_AUDIO_RESAMPLING_POLYPHASE, polyphase);
+    if (SDL_BuildAudioCVT(&cvt, spec->format, spec->channels, spec->freq,
+                          AUDIO_F32SYS, cvtchans, cvtfreq) == -1) {
+        return NULL;
+    }
+    cvt.len = len;
+    cvt.buf = (Uint8 *) SDL_malloc(len * cvt.len_mult);
+    if (cvt.buf == NULL) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    SDL_memcpy(cvt.buf, data, len);
+    if (SDL_ConvertAudio(&cvt) == -1) {
+        SDL_free(cvt.buf);
+        return NULL;
+    }
+    result = (float *) cvt.buf;
+    *outlen = cvt.len_cvt / sizeof (float);
+    return result;
+}
+
+/* Reports how far the polyphase output is from the general resampler. */
+static int
+compare_resamplers(const SDL_AudioSpec *spec, const Uint8 *data, Uint32 len, int cvtchans, int cvtfreq)
+{
+    float *reference, *polyphase;
+    int reflen = 0, polylen = 0;
+    double signal = 0.0, noise = 0.0, maxdiff = 0.0;
+    int i, count;
+
+    reference = convert_to_float(spec, data, len, cvtchans, cvtfreq, "0", &reflen);
+    polyphase = convert_to_float(spec, data, len, cvtchans, cvtfreq, "1", &polylen);
+    SDL_SetHint(SDL_HINT_AUDIO_RESAMPLING_POLYPHASE, NULL);
+    if (!reference || !polyphase) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Conversion failed: %s\n", SDL_GetError());
+        SDL_free(reference);
+        SDL_free(polyphase);
+        return -1;
+    }
+
+    count = SDL_min(reflen, polylen);
+    for (i = 0; i < count; i++) {
+        const double diff = (double) polyphase[i] - (double) reference[i];
+        signal += (double) reference[i] * reference[i];
+        noise += diff * diff;
+        if (SDL_fabs(diff) > maxdiff) {
+            maxdiff = SDL_fabs(diff);
+        }
+    }
+
+    SDL_Log("Compared %d samples (general: %d, polyphase: %d)\n", count, reflen, polylen);
+    SDL_Log("Maximum difference: %g\n", maxdiff);
+    if (noise > 0.0) {
+        SDL_Log("Signal to difference ratio: %.2f dB\n", 10.0 * SDL_log(signal / noise) / SDL_log(10.0));
+    } else {
+        SDL_Log("Signal to difference ratio: identical output\n");
+    }
+
+    SDL_free(reference);
+    SDL_free(polyphase);
+    return 0;
+}
+
+/* Times repeated conversions of the whole buffer. */
+static int
+benchmark_conversion(const SDL_AudioSpec *spec, const Uint8 *data, Uint32 len, int cvtchans, int cvtfreq, int iterations)
+{
+    SDL_AudioCVT cvt;
+    Uint64 start, elapsed;
+    double seconds, audioseconds;
+    int i;
+
+    if (SDL_BuildAudioCVT(&cvt, spec->format, spec->channels, spec->freq,
+                          spec->format, cvtchans, cvtfreq) == -1) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "failed to build CVT: %s\n", SDL_GetError());
+        return -1;
+    }
+    cvt.buf = (Uint8 *) SDL_malloc(len * cvt.len_mult);
+    if (cvt.buf == NULL) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Out of memory.\n");
+        return -1;
+    }
+
+    elapsed = 0;
+    for (i = 0; i < iterations; i++) {
+        cvt.len = len;
+        SDL_memcpy(cvt.buf, data, len);
+        start = SDL_GetPerformanceCounter();
+        SDL_ConvertAudio(&cvt);
+        elapsed += SDL_GetPerformanceCounter() - start;
+    }
+    SDL_free(cvt.buf);
+
+    seconds = (double) elapsed / SDL_GetPerformanceFrequency();
+    audioseconds = ((double) len / ((SDL_AUDIO_BITSIZE(spec->format) / 8) * spec->channels)) / spec->freq;
+    SDL_Log("%d conversions of %.2f seconds of audio: %.3f ms each, %.1fx realtime\n",
+            iterations, audioseconds, (seconds * 1000.0) / iterations,
+            (audioseconds * iterations) / seconds);
+    return 0;
+}
+
+/* Resamples a sine and reports how far it is from the ideal sine at the new rate. */
+static int
+measure_sine_snr(int srcfreq, int cvtfreq, double tone)
+{
+    const double pi = 3.14159265358979323846;
+    const int inframes = srcfreq;
+    SDL_AudioCVT cvt;
+    float *samples;
+    double signal = 0.0, noise = 0.0;
+    int i, outframes, edge;
+
+    if (SDL_BuildAudioCVT(&cvt, AUDIO_F32SYS, 1, srcfreq, AUDIO_F32SYS, 1, cvtfreq) == -1) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "failed to build CVT: %s\n", SDL_GetError());
+        return -1;
+    }
+    cvt.len = inframes * sizeof (float);
+    cvt.buf = (Uint8 *) SDL_malloc(cvt.len * cvt.len_mult);
+    if (cvt.buf == NULL) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Out of memory.\n");
+        return -1;
+    }
+    samples = (float *) cvt.buf;
+    for (i = 0; i < inframes; i++) {
+        samples[i] = (float) (0.5 * SDL_sin((2.0 * pi * tone * i) / srcfreq));
+    }
+    if (SDL_ConvertAudio(&cvt) == -1) {
+        SDL_free(cvt.buf);
+        return -1;
+    }
+
+    /* the edges are resampled against silence, so leave them out */
+    outframes = cvt.len_cvt / sizeof (float);
+    edge = cvtfreq / 100;
+    for (i = edge; i < outframes - edge; i++) {
+        const double ideal = 0.5 * SDL_sin((2.0 * pi * tone * i) / cvtfreq);
+        const double diff = (double) samples[i] - ideal;
+        signal += ideal * ideal;
+        noise += diff * diff;
+    }
+    SDL_free(cvt.buf);
+
+    if (noise > 0.0) {
+        SDL_Log("%g Hz sine, %d Hz to %d Hz: %.2f dB SNR\n", tone, srcfreq, cvtfreq, 10.0 * SDL_log(signal / noise) / SDL_log(10.0));
+    } else {
+        SDL_Log("%g Hz sine, %d Hz to %d Hz: exact\n", tone, srcfreq, cvtfreq);
+    }
+    return 0;
+}
+
+/* Runs the sine test and the benchmark with each internal resampling tier. */
+static int
+compare_tiers(const SDL_AudioSpec *spec, const Uint8 *data, Uint32 len, int cvtchans, int cvtfreq, int iterations)
+{
+    static const char *tiers[] = { "default", "linear", "cubic", "short_sinc" };
+    int i, retval = 0;
+
+    for (i = 0; i < SDL_arraysize(tiers) && retval == 0; i++) {
+        SDL_SetHint(SDL_HINT_AUDIO_RESAMPLING_MODE, tiers[i]);
+        SDL_Log("Resampling mode: %s\n", tiers[i]);
+        retval = measure_sine_snr(spec->freq, cvtfreq, 1000.0);
+        if (retval == 0) {
+            retval = measure_sine_snr(spec->freq, cvtfreq, 8000.0);
+        }
+        if (retval == 0 && iterations > 0) {
+            retval = benchmark_conversion(spec, data, len, cvtchans, cvtfreq, iterations);
+        }
+    }
+    SDL_SetHint(SDL_HINT_AUDIO_RESAMPLING_MODE, NULL);
+    return retval;
+}
+
 int
 main(int argc, char **argv)
 {
@@ -24,13 +204,34 @@ main(int argc, char **argv)
     int bitsize = 0;
     int blockalign = 0;
     int avgbytes = 0;
+    int iterations = 0;
+    SDL_bool compare = SDL_FALSE;
+    SDL_bool tiers = SDL_FALSE;
     SDL_RWops *io = NULL;
 
     /* Enable standard application logging */
     SDL_LogSetPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO);
 
+    while (argc > 1 && argv[1][0] == '-') {
+        if (SDL_strcmp(argv[1], "--benchmark") == 0 && argc > 2) {
+            iterations = SDL_atoi(argv[2]);
+            argv += 2;
+            argc -= 2;
+        } else if (SDL_strcmp(argv[1], "--compare") == 0) {
+            compare = SDL_TRUE;
+            argv++;
+            argc--;
+        } else if (SDL_strcmp(argv[1], "--tiers") == 0) {
+            tiers = SDL_TRUE;
+            argv++;
+            argc--;
+        } else {
+            break;
+        }
+    }
+
     if (argc != 5) {
-        SDL_Log("USAGE: %s in.wav out.wav newfreq newchans\n", argv[0]);
+        SDL_Log("USAGE: %s [--benchmark iterations] [--compare] [--tiers] in.wav out.wav newfreq newchans\n", argv[0]);
         return 1;
     }
 
@@ -48,6 +249,24 @@ main(int argc, char **argv)
         return 3;
     }
 
+    if (compare && compare_resamplers(&spec, data, len, cvtchans, cvtfreq) < 0) {
+        SDL_FreeWAV(data);
+        SDL_Quit();
+        return 9;
+    }
+
+    if (tiers) {
+        if (compare_tiers(&spec, data, len, cvtchans, cvtfreq, iterations) < 0) {
+            SDL_FreeWAV(data);
+            SDL_Quit();
+            return 11;
+        }
+    } else if (iterations > 0 && benchmark_conversion(&spec, data, len, cvtchans, cvtfreq, iterations) < 0) {
+        SDL_FreeWAV(data);
+        SDL_Quit();
+        return 10;
+    }
+
     if (SDL_BuildAudioCVT(&cvt, spec.format, spec.channels, spec.freq,
                           spec.format, cvtchans, cvtfreq) == -1) {
         SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "failed to build CVT: %s\n", SDL_GetError());
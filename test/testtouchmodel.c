@@ -0,0 +1,183 @@
+/*
+  Copyright (C) 1997-2017 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely.
+*/
+
+/* Adds and removes made up touch devices and fingers at random, and checks
+   that SDL's view of them matches a simple model after every few steps.
+
+   There's no way to make a touch device without hardware, so this calls
+   the functions the video drivers use to report touches, from
+   src/events/SDL_touch_c.h. Those aren't part of the API, so this is built
+   by CMake against the static library, with src/events on the include
+   path; see SDL_TEST_INTERNALS.
+
+     testtouchmodel [steps] [seed] */
+
+#include "SDL_touch_c.h"  /* brings in SDL_internal.h, which has to come first */
+#include <stdio.h>
+#include "SDL.h"
+
+#define NUM_DEVICES 40
+#define NUM_FINGERS 64
+
+typedef struct
+{
+    SDL_bool present;
+    SDL_bool down[NUM_FINGERS];
+    float x[NUM_FINGERS];
+} ModelTouch;
+
+static ModelTouch model[NUM_DEVICES];
+static Uint32 seed;
+
+static int
+Random(int limit)
+{
+    seed = seed * 1664525 + 1013904223;
+    return (int) ((seed >> 8) % limit);
+}
+
+/* Spread the ids out so they don't land in order in the hash tables. */
+static SDL_TouchID
+DeviceID(int device)
+{
+    return (SDL_TouchID) device * 7919 + ((SDL_TouchID) device << 33);
+}
+
+static SDL_FingerID
+FingerID(int finger)
+{
+    return (SDL_FingerID) finger * 16 + 3;
+}
+
+static int
+CheckModel(void)
+{
+    int errors = 0;
+    int numdevices = 0;
+    int i, j;
+
+    for (i = 0; i < NUM_DEVICES; i++) {
+        numdevices += model[i].present;
+    }
+    if (SDL_GetNumTouchDevices() != numdevices) {
+        SDL_Log("%d touch devices, expected %d\n", SDL_GetNumTouchDevices(), numdevices);
+        errors++;
+    }
+
+    for (i = 0; i < SDL_GetNumTouchDevices(); i++) {
+        const SDL_TouchID id = SDL_GetTouchDevice(i);
+        const int device = (int) ((id & 0xFFFFFFFF) / 7919);
+        if (device >= NUM_DEVICES || DeviceID(device) != id || !model[device].present) {
+            SDL_Log("Unexpected touch device %" SDL_PRIs64 "\n", id);
+            errors++;
+        }
+    }
+
+    for (i = 0; i < NUM_DEVICES; i++) {
+        int numfingers = 0;
+        if (!model[i].present) {
+            continue;
+        }
+        for (j = 0; j < NUM_FINGERS; j++) {
+            numfingers += model[i].down[j];
+        }
+        if (SDL_GetNumTouchFingers(DeviceID(i)) != numfingers) {
+            SDL_Log("Device %d has %d fingers, expected %d\n", i, SDL_GetNumTouchFingers(DeviceID(i)), numfingers);
+            errors++;
+        }
+        for (j = 0; j < SDL_GetNumTouchFingers(DeviceID(i)); j++) {
+            const SDL_Finger *finger = SDL_GetTouchFinger(DeviceID(i), j);
+            const int index = (int) ((finger->id - 3) / 16);
+            if (index < 0 || index >= NUM_FINGERS || FingerID(index) != finger->id ||
+                !model[i].down[index] || finger->x != model[i].x[index]) {
+                SDL_Log("Device %d has an unexpected finger %" SDL_PRIs64 "\n", i, finger->id);
+                errors++;
+            }
+        }
+    }
+    return errors;
+}
+
+int
+main(int argc, char **argv)
+{
+    int steps = 400000;
+    int errors = 0;
+    int i;
+
+    /* Enable standard application logging */
+    SDL_LogSetPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO);
+
+    seed = (Uint32) SDL_GetPerformanceCounter();
+    if (argc > 1) {
+        steps = SDL_atoi(argv[1]);
+    }
+    if (argc > 2) {
+        seed = (Uint32) SDL_atoi(argv[2]);
+    }
+    SDL_Log("%d steps, seed %u\n", steps, (unsigned int) seed);
+
+    if (SDL_Init(SDL_INIT_EVENTS) < 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't initialize SDL: %s\n", SDL_GetError());
+        return 1;
+    }
+
+    for (i = 0; i < steps; i++) {
+        const int device = Random(NUM_DEVICES);
+        const int finger = Random(NUM_FINGERS);
+        const int op = Random(100);
+        ModelTouch *touch = &model[device];
+
+        if (!touch->present) {
+            if (SDL_AddTouch(DeviceID(device), "model") < 0) {
+                SDL_Log("Couldn't add touch device %d: %s\n", device, SDL_GetError());
+                errors++;
+            }
+            touch->present = SDL_TRUE;
+        } else if (op < 1) {
+            SDL_DelTouch(DeviceID(device));
+            SDL_zerop(touch);
+        } else if (op < 40) {
+            /* motion of a finger that isn't down puts it down */
+            const float x = Random(1000) / 1000.0f;
+            SDL_SendTouchMotion(DeviceID(device), FingerID(finger), x, 0.5f, 1.0f);
+            touch->down[finger] = SDL_TRUE;
+            touch->x[finger] = x;
+        } else if (op < 70) {
+            /* a finger that's already down stays where it was */
+            SDL_SendTouch(DeviceID(device), FingerID(finger), SDL_TRUE, 0.1f, 0.1f, 1.0f);
+            if (!touch->down[finger]) {
+                touch->down[finger] = SDL_TRUE;
+                touch->x[finger] = 0.1f;
+            }
+        } else {
+            SDL_SendTouch(DeviceID(device), FingerID(finger), SDL_FALSE, 0.0f, 0.0f, 1.0f);
+            touch->down[finger] = SDL_FALSE;
+        }
+
+        if ((i % 256) == 0) {
+            SDL_FlushEvents(SDL_FIRSTEVENT, SDL_LASTEVENT);
+            errors += CheckModel();
+        }
+    }
+    errors += CheckModel();
+
+    for (i = 0; i < NUM_DEVICES; i++) {
+        if (model[i].present) {
+            SDL_DelTouch(DeviceID(i));
+        }
+    }
+
+    SDL_Log("%d differences from the model\n", errors);
+    SDL_Quit();
+    return (errors == 0) ? 0 : 1;
+}
@@ -0,0 +1,262 @@
+/*
+  Copyright (C) 1997-2017 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely.
+*/
+
+/* Times decoding big WAVE files with SDL_LoadWAV_RW() against decoding them
+   a piece at a time with SDL_ReadWAVStream(), and shows how much memory
+   each one needs for the decoded audio.
+
+     testwavbench               (made up PCM, MS ADPCM and IMA ADPCM files)
+     testwavbench file.wav ...  (your own files)
+
+   The made up files are built in memory, so the numbers are all decoding
+   and no disk. */
+
+#include <stdio.h>
+#include "SDL.h"
+
+#define SECONDS 300
+#define FREQ 44100
+#define CHANNELS 2
+#define READ_SIZE (64 * 1024)
+
+typedef struct
+{
+    const char *name;
+    Uint8 *data;
+    Uint32 len;
+} WaveFile;
+
+static Uint32 seed = 0x12345678;
+
+static Uint8
+noise(void)
+{
+    seed = (seed * 1103515245) + 12345;
+    return (Uint8) (seed >> 16);
+}
+
+static Uint8 *
+write16(Uint8 *p, Uint16 val)
+{
+    *(p++) = (Uint8) val;
+    *(p++) = (Uint8) (val >> 8);
+    return p;
+}
+
+static Uint8 *
+write32(Uint8 *p, Uint32 val)
+{
+    p = write16(p, (Uint16) val);
+    return write16(p, (Uint16) (val >> 16));
+}
+
+/* Makes a WAVE file of SECONDS seconds of noise. */
+static SDL_bool
+MakeWave(WaveFile *wave, const char *name, Uint16 encoding, Uint16 bits)
+{
+    const Sint16 coeff[7][2] = {
+        { 256, 0 }, { 512, -256 }, { 0, 0 }, { 192, 64 },
+        { 240, 0 }, { 460, -208 }, { 392, -232 }
+    };
+    Uint16 blockalign, samplesperblock = 0, fmtlen = 16;
+    Uint32 frames = SECONDS * FREQ, blocks, datalen, i;
+    Uint8 *p;
+    int c;
+
+    if (encoding == 0x0002) {  /* MS ADPCM */
+        samplesperblock = 1012;
+        blockalign = 7 * CHANNELS + ((samplesperblock - 2) * CHANNELS) / 2;
+        fmtlen = 50;
+    } else if (encoding == 0x0011) {  /* IMA ADPCM */
+        samplesperblock = 1017;
+        blockalign = 4 * CHANNELS + ((samplesperblock - 1) / 2) * CHANNELS;
+        fmtlen = 20;
+    } else {
+        blockalign = (bits / 8) * CHANNELS;
+    }
+    blocks = samplesperblock ? (frames / samplesperblock) : frames;
+    datalen = blocks * blockalign;
+
+    wave->name = name;
+    wave->len = 12 + 8 + fmtlen + 8 + datalen;
+    wave->data = (Uint8 *) SDL_malloc(wave->len);
+    if (!wave->data) {
+        return SDL_FALSE;
+    }
+
+    p = wave->data;
+    SDL_memcpy(p, "RIFF", 4);
+    p = write32(p + 4, wave->len - 8);
+    SDL_memcpy(p, "WAVE", 4);
+    SDL_memcpy(p + 4, "fmt ", 4);
+    p = write32(p + 8, fmtlen);
+    p = write16(p, encoding);
+    p = write16(p, CHANNELS);
+    p = write32(p, FREQ);
+    p = write32(p, (FREQ * blockalign) / (samplesperblock ? samplesperblock : 1));
+    p = write16(p, blockalign);
+    p = write16(p, bits);
+    if (encoding == 0x0002) {
+        p = write16(p, 32);
+        p = write16(p, samplesperblock);
+        p = write16(p, 7);
+        for (i = 0; i < 7; i++) {
+            p = write16(p, (Uint16) coeff[i][0]);
+            p = write16(p, (Uint16) coeff[i][1]);
+        }
+    } else if (encoding == 0x0011) {
+        p = write16(p, 2);
+        p = write16(p, samplesperblock);
+    }
+    SDL_memcpy(p, "data", 4);
+    p = write32(p + 4, datalen);
+
+    for (i = 0; i < datalen; i++) {
+        p[i] = noise();
+    }
+
+    /* make the block headers sensible */
+    for (i = 0; samplesperblock && (i < blocks); i++) {
+        Uint8 *block = p + (i * blockalign);
+        for (c = 0; c < CHANNELS; c++) {
+            if (encoding == 0x0002) {
+                block[c] %= 7;  /* predictor */
+                write16(block + CHANNELS + (c * 2), 16 + (block[CHANNELS + (c * 2)] % 512));  /* delta */
+            } else {
+                block[(c * 4) + 2] %= 89;  /* step index */
+                block[(c * 4) + 3] = 0;
+            }
+        }
+    }
+    return SDL_TRUE;
+}
+
+static SDL_bool
+LoadWave(WaveFile *wave, const char *file)
+{
+    SDL_RWops *rw = SDL_RWFromFile(file, "rb");
+    Sint64 size;
+
+    if (!rw) {
+        return SDL_FALSE;
+    }
+    size = SDL_RWsize(rw);
+    wave->name = file;
+    wave->len = (Uint32) size;
+    wave->data = (size > 0) ? (Uint8 *) SDL_malloc(wave->len) : NULL;
+    if (!wave->data || SDL_RWread(rw, wave->data, wave->len, 1) != 1) {
+        SDL_free(wave->data);
+        SDL_RWclose(rw);
+        return SDL_FALSE;
+    }
+    SDL_RWclose(rw);
+    return SDL_TRUE;
+}
+
+static double
+Milliseconds(Uint64 start)
+{
+    return ((SDL_GetPerformanceCounter() - start) * 1000.0) / SDL_GetPerformanceFrequency();
+}
+
+static void
+Bench(const WaveFile *wave, Uint8 *buf)
+{
+    SDL_AudioSpec spec;
+    SDL_WAVStream *stream;
+    Uint8 *audio_buf;
+    Uint32 audio_len = 0, streamed = 0;
+    double loadms = 1e9, streamms = 1e9;
+    int run, amount, framesize;
+
+    for (run = 0; run < 3; run++) {
+        const Uint64 start = SDL_GetPerformanceCounter();
+        if (!SDL_LoadWAV_RW(SDL_RWFromConstMem(wave->data, wave->len), 1, &spec, &audio_buf, &audio_len)) {
+            SDL_Log("%s: couldn't load: %s\n", wave->name, SDL_GetError());
+            return;
+        }
+        loadms = SDL_min(loadms, Milliseconds(start));
+        SDL_FreeWAV(audio_buf);
+    }
+
+    for (run = 0; run < 3; run++) {
+        const Uint64 start = SDL_GetPerformanceCounter();
+        stream = SDL_OpenWAVStream_RW(SDL_RWFromConstMem(wave->data, wave->len), 1, &spec);
+        if (!stream) {
+            SDL_Log("%s: couldn't open: %s\n", wave->name, SDL_GetError());
+            return;
+        }
+        framesize = (SDL_AUDIO_BITSIZE(spec.format) / 8) * spec.channels;
+        streamed = 0;
+        while ((amount = SDL_ReadWAVStream(stream, buf, (READ_SIZE / framesize) * framesize)) > 0) {
+            streamed += amount;
+        }
+        SDL_CloseWAVStream(stream);
+        streamms = SDL_min(streamms, Milliseconds(start));
+    }
+
+    SDL_Log("%s: %u bytes in, %u bytes decoded (%s)\n", wave->name,
+            (unsigned int) wave->len, (unsigned int) audio_len,
+            (streamed == audio_len) ? "both the same length" : "LENGTHS DIFFER");
+    SDL_Log("    SDL_LoadWAV_RW:    %8.2f ms, %7.1f MB/s, %u bytes of memory\n",
+            loadms, audio_len / (loadms * 1000.0), (unsigned int) audio_len);
+    SDL_Log("    SDL_ReadWAVStream: %8.2f ms, %7.1f MB/s, %u bytes of memory\n",
+            streamms, streamed / (streamms * 1000.0), (unsigned int) READ_SIZE);
+}
+
+int
+main(int argc, char **argv)
+{
+    WaveFile waves[4];
+    int numwaves = 0, i;
+    Uint8 *buf;
+
+    /* Enable standard application logging */
+    SDL_LogSetPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO);
+
+    if (SDL_Init(0) < 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't initialize SDL: %s\n", SDL_GetError());
+        return (1);
+    }
+
+    if (argc > 1) {
+        for (i = 1; (i < argc) && (numwaves < SDL_arraysize(waves)); i++) {
+            if (LoadWave(&waves[numwaves], argv[i])) {
+                numwaves++;
+            } else {
+                SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't read %s\n", argv[i]);
+            }
+        }
+    } else {
+        SDL_Log("Making %d seconds of %d Hz stereo noise in each format...\n", SECONDS, FREQ);
+        numwaves += MakeWave(&waves[numwaves], "PCM 16-bit", 0x0001, 16);
+        numwaves += MakeWave(&waves[numwaves], "PCM 24-bit", 0x0001, 24);
+        numwaves += MakeWave(&waves[numwaves], "MS ADPCM", 0x0002, 4);
+        numwaves += MakeWave(&waves[numwaves], "IMA ADPCM", 0x0011, 4);
+    }
+
+    buf = (Uint8 *) SDL_malloc(READ_SIZE);
+    if (!buf) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Out of memory\n");
+        SDL_Quit();
+        return (1);
+    }
+
+    for (i = 0; i < numwaves; i++) {
+        Bench(&waves[i], buf);
+        SDL_free(waves[i].data);
+    }
+
+    SDL_free(buf);
+    SDL_Quit();
+    return (0);
+}